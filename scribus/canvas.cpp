@@ -16,8 +16,10 @@
 #if defined(_MSC_VER) && !defined(_USE_MATH_DEFINES)
 #define _USE_MATH_DEFINES
 #endif
+#include <algorithm>
 #include <cmath>
 
+#include <QDataStream>
 // #include <QDebug>
 #include <QToolTip>
 #include <QWidget>
@@ -464,17 +466,32 @@ PageItem* Canvas::itemUnderCursor(QPointF globalPos, PageItem* itemAbove, bool a
 
 	QList<PageItem*> *itemList = (itemAbove && itemAbove->isGroupChild()) ? &itemAbove->parentGroup()->groupItemList : m_doc->Items;
 	int currNr = itemAbove ? itemList->indexOf(itemAbove) - 1 : itemList->count() - 1;
+	// Document items are looked up in the spatial index, group members are few enough to test them all
+	QList<int> candidates;
+	int candidateNr = -1;
+	if (itemList == m_doc->Items)
+	{
+		candidates = m_doc->itemsIntersecting(mouseArea);
+		candidateNr = static_cast<int>(std::upper_bound(candidates.cbegin(), candidates.cend(), currNr) - candidates.cbegin()) - 1;
+		currNr = (candidateNr >= 0) ? candidates.at(candidateNr) : -1;
+	}
+	auto nextNr = [&]() {
+		if (itemList != m_doc->Items)
+			return currNr - 1;
+		--candidateNr;
+		return (candidateNr >= 0) ? candidates.at(candidateNr) : -1;
+	};
 	while (currNr >= 0)
 	{
 		currItem = itemList->at(currNr);
 		if ((m_doc->masterPageMode())  && (!((currItem->OwnPage == -1) || (currItem->OwnPage == m_doc->currentPage()->pageNr()))))
 		{
-			--currNr;
+			currNr = nextNr();
 			continue;
 		}
 		if ((m_doc->drawAsPreview && !m_doc->editOnPreview) && !(currItem->isAnnotation() || currItem->isGroup()))
 		{
-			--currNr;
+			currNr = nextNr();
 			continue;
 		}
 		if (m_doc->canSelectItemOnLayer(currItem->m_layerID))
@@ -516,7 +533,7 @@ PageItem* Canvas::itemUnderCursor(QPointF globalPos, PageItem* itemAbove, bool a
 				return currItem;
 			}
 		}
-		--currNr;
+		currNr = nextNr();
 	}
 	return nullptr;
 }
@@ -635,6 +652,13 @@ void Canvas::clearBuffers()
 	m_bufferRect = QRect();
 	m_selectionBuffer = QPixmap();
 	m_selectionRect = QRect();
+	m_tileCache.clear();
+}
+
+void Canvas::invalidate(const QRectF& docRect)
+{
+	m_tileCache.invalidate(docRect);
+	m_viewMode.forceRedraw = true;
 }
 
 void Canvas::setScale(double scale)
@@ -642,7 +666,11 @@ void Canvas::setScale(double scale)
 	if (m_viewMode.scale == scale)
 		return;
 	m_viewMode.scale = scale;
-	clearBuffers();
+	// Tiles are cached per scale and stay valid
+	m_buffer = QPixmap();
+	m_bufferRect = QRect();
+	m_selectionBuffer = QPixmap();
+	m_selectionRect = QRect();
 	update();
 }
 
@@ -792,10 +820,82 @@ void Canvas::fillBuffer(QPaintDevice* buffer, QPoint bufferOrigin, QRect clipRec
 // 	qDebug()<<"Canvas::fillBuffer"<<clipRect<<m_viewMode.forceRedraw<<m_viewMode.operItemSelecting;
 	QPainter painter(buffer);
 	painter.translate(-bufferOrigin.x(), -bufferOrigin.y());
-	drawContents(&painter, clipRect.x(), clipRect.y(), clipRect.width(), clipRect.height());
+	if (canUseTileCache())
+		drawContentsTiled(&painter, clipRect);
+	else
+		drawContents(&painter, clipRect.x(), clipRect.y(), clipRect.width(), clipRect.height());
 	painter.end();
 }
 
+bool Canvas::canUseTileCache() const
+{
+	// Selection, edit modes and frame links add decorations and side effects
+	// (rulers, linked frames) which must not be cached or skipped
+	return (m_renderMode == RENDER_NORMAL)
+		&& (m_doc->appMode == modeNormal)
+		&& m_doc->m_Selection->isEmpty()
+		&& !m_doc->guidesPrefs().linkShown
+		&& !m_viewMode.drawFramelinksWithContents
+		&& !m_viewMode.operItemMoving
+		&& !m_viewMode.operItemResizing
+		&& !m_viewMode.operItemSelecting
+		&& !m_viewMode.operTextSelecting;
+}
+
+QByteArray Canvas::tileViewState() const
+{
+	QByteArray viewState;
+	QDataStream ds(&viewState, QIODevice::WriteOnly);
+	bool masterPageMode = m_doc->masterPageMode();
+	ds << m_doc->minCanvasCoordinate.x() << m_doc->minCanvasCoordinate.y();
+	ds << masterPageMode << (masterPageMode ? m_doc->currentPageNumber() : -1);
+	ds << m_viewMode.previewMode << m_viewMode.viewAsPreview << m_viewMode.previewVisual;
+	ds << devicePixelRatioF();
+	return viewState;
+}
+
+void Canvas::drawContentsTiled(QPainter *p, QRect clipRect)
+{
+	m_tileCache.setViewState(tileViewState());
+
+	const int tileSize = CanvasTileCache::tileSize;
+	const double scale = m_viewMode.scale;
+	const double dpr = devicePixelRatioF();
+	int firstColumn = static_cast<int>(std::floor(clipRect.left() / static_cast<double>(tileSize)));
+	int lastColumn = static_cast<int>(std::floor(clipRect.right() / static_cast<double>(tileSize)));
+	int firstRow = static_cast<int>(std::floor(clipRect.top() / static_cast<double>(tileSize)));
+	int lastRow = static_cast<int>(std::floor(clipRect.bottom() / static_cast<double>(tileSize)));
+
+	p->save();
+	p->setClipRect(clipRect);
+	for (int row = firstRow; row <= lastRow; ++row)
+	{
+		for (int column = firstColumn; column <= lastColumn; ++column)
+		{
+			QRect tileRect(column * tileSize, row * tileSize, tileSize, tileSize);
+			const QImage* cached = m_tileCache.find(scale, column, row);
+			if (cached != nullptr)
+			{
+				p->drawImage(tileRect.topLeft(), *cached);
+				continue;
+			}
+			QImage tile(qRound(tileSize * dpr), qRound(tileSize * dpr), QImage::Format_ARGB32_Premultiplied);
+			tile.setDevicePixelRatio(dpr);
+			tile.fill(Qt::transparent);
+			QPainter tilePainter(&tile);
+			tilePainter.translate(-tileRect.x(), -tileRect.y());
+			drawContents(&tilePainter, tileRect.x(), tileRect.y(), tileRect.width(), tileRect.height());
+			tilePainter.end();
+
+			QRectF docRect(tileRect.x() / scale + m_doc->minCanvasCoordinate.x(), tileRect.y() / scale + m_doc->minCanvasCoordinate.y(),
+			               tileSize / scale, tileSize / scale);
+			m_tileCache.insert(scale, column, row, tile, docRect);
+			p->drawImage(tileRect.topLeft(), tile);
+		}
+	}
+	p->restore();
+}
+
 /**
   Actually we have at least three super-layers:
   - background (page outlines, guides if below)
@@ -1437,9 +1537,12 @@ void Canvas::DrawPageItems(ScPainter *painter, const ScLayer& layer, QRect clip,
 	//then we must be sure that text frames are valid and all notes frames are created before we start drawing
 	if (!notesFramesPass && !m_doc->notesList().isEmpty())
 	{
-		for (auto it = m_doc->Items->cbegin(); it != m_doc->Items->cend(); ++it)
+		const QList<int> layoutCandidates = m_doc->itemsIntersecting(cullingArea);
+		for (int it : layoutCandidates)
 		{
-			PageItem* currItem = *it;
+			if (it >= m_doc->Items->count())
+				break;
+			PageItem* currItem = m_doc->Items->at(it);
 			if ( !currItem->isTextFrame()
 				|| currItem->isNoteFrame()
 				|| !currItem->invalid
@@ -1453,7 +1556,9 @@ void Canvas::DrawPageItems(ScPainter *painter, const ScLayer& layer, QRect clip,
 				currItem->layout();
 		}
 	}
-	for (int it = 0; it < m_doc->Items->count(); ++it)
+	// Only visit items near the culling area, layout above may have created or removed notes frames
+	const QList<int> candidates = m_doc->itemsIntersecting(cullingArea);
+	for (int it : candidates)
 	{
 		currItem = m_doc->Items->at(it);
 		if (notesFramesPass && !currItem->isNoteFrame())
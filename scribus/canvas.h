@@ -33,6 +33,7 @@ scribusview.h  -  description
 
 #include "scribusapi.h"
 
+#include "canvastilecache.h"
 #include "commonstrings.h"
 #include "fpoint.h"
 #include "fpointarray.h"
@@ -136,6 +137,8 @@ public:
 	void setRenderMode(RenderMode m);
 	
 	void clearBuffers();              // very expensive
+	/** Marks the document area \a docRect as changed, all of it if \a docRect is invalid, and forces a redraw */
+	void invalidate(const QRectF& docRect);
 	
 	// deprecated:
 	void resetRenderMode() { m_renderMode = RENDER_NORMAL; clearBuffers(); }
@@ -187,7 +190,7 @@ public:
 		m_viewMode.redrawPolygon.clear();
 		return m_viewMode.redrawPolygon;
 	}
-	void setForcedRedraw(bool on) { m_viewMode.forceRedraw = on; }
+	void setForcedRedraw(bool on) { m_viewMode.forceRedraw = on; if (on) m_tileCache.clear(); }
 	bool isForcedRedraw() const { return m_viewMode.forceRedraw; }
 	void setPreviewMode(bool on) { m_viewMode.previewMode = on; }
 	bool isPreviewMode() const { return m_viewMode.previewMode || m_viewMode.viewAsPreview; }
@@ -247,6 +250,16 @@ private:
 	    bufferOrigin and clipRect are in local coordinates
 	 */
 	void fillBuffer(QPaintDevice* buffer, QPoint bufferOrigin, QRect clipRect);
+	/**
+		Draws contents for clipRect from cached tiles, rendering missing ones.
+	 */
+	void drawContentsTiled(QPainter *p, QRect clipRect);
+	/**
+		Returns true if contents do not depend on selection or edit state, so
+		that tiles can be cached.
+	 */
+	bool canUseTileCache() const;
+	QByteArray tileViewState() const;
 	void drawContents(QPainter *p, int clipx, int clipy, int clipw, int cliph);
 	void drawBackgroundMasterpage(ScPainter* painter, int clipx, int clipy, int clipw, int cliph);
 	void drawBackgroundPageOutlines(ScPainter* painter, int clipx, int clipy, int clipw, int cliph);
@@ -272,6 +285,7 @@ private:
 	RenderMode m_renderMode;
 	QPixmap m_buffer;
 	QRect   m_bufferRect;
+	CanvasTileCache m_tileCache;
 	QPixmap m_selectionBuffer;
 	QRect   m_selectionRect;
 	QPoint  m_oldMinCanvasCoordinate;
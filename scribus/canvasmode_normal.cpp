@@ -1204,7 +1204,9 @@ void CanvasMode_Normal::mouseReleaseEvent(QMouseEvent *m)
 			bool altPressed = m->modifiers() & Qt::AltModifier;
 			bool shiftPressed = m->modifiers() & Qt::ShiftModifier;
 
-			for (int a = 0; a < docItemCount; ++a)
+			// Items entirely outside of the rectangle can neither be contained nor intersected
+			const QList<int> candidates = m_doc->itemsIntersecting(canvasSele);
+			for (int a : candidates)
 			{
 				PageItem* docItem = m_doc->Items->at(a);
 				if ((m_doc->masterPageMode()) && (docItem->OnMasterPage != m_doc->currentPage()->pageName()))
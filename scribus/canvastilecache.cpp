@@ -0,0 +1,65 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QHashFunctions>
+
+#include "canvastilecache.h"
+
+size_t qHash(const CanvasTileCache::TileKey& key, size_t seed)
+{
+	return qHashMulti(seed, key.scale, key.column, key.row);
+}
+
+CanvasTileCache::CanvasTileCache()
+{
+	// Cost is in KiB, allow for about 128 MiB of tiles
+	m_tiles.setMaxCost(128 * 1024);
+}
+
+void CanvasTileCache::setViewState(const QByteArray& viewState)
+{
+	if (viewState == m_viewState)
+		return;
+	m_tiles.clear();
+	m_viewState = viewState;
+}
+
+const QImage* CanvasTileCache::find(double scale, int column, int row) const
+{
+	const Tile* tile = m_tiles.object({ scale, column, row });
+	return (tile != nullptr) ? &tile->image : nullptr;
+}
+
+void CanvasTileCache::insert(double scale, int column, int row, const QImage& image, const QRectF& docRect)
+{
+	auto* tile = new Tile { image, docRect };
+	m_tiles.insert({ scale, column, row }, tile, qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+}
+
+void CanvasTileCache::invalidate(const QRectF& docRect)
+{
+	if (!docRect.isValid())
+	{
+		m_tiles.clear();
+		return;
+	}
+
+	const QList<TileKey> keys = m_tiles.keys();
+	for (const TileKey& key : keys)
+	{
+		// Same margin of 10 pixels as ScribusView::updateCanvas()
+		double margin = 10.0 / key.scale;
+		const Tile* tile = m_tiles.object(key);
+		if (tile->docRect.intersects(docRect.adjusted(-margin, -margin, margin, margin)))
+			m_tiles.remove(key);
+	}
+}
+
+void CanvasTileCache::clear()
+{
+	m_tiles.clear();
+}
@@ -0,0 +1,67 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#ifndef CANVASTILECACHE_H
+#define CANVASTILECACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QImage>
+#include <QRectF>
+
+/**
+ * LRU cache of rendered canvas tiles.
+ *
+ * Canvas renders its contents in square tiles of tileSize local pixels, aligned
+ * to the canvas origin. Tiles are kept per zoom level, so that scrolling back
+ * to a region or returning to a previous zoom level only needs to copy pixels.
+ * Each tile remembers the area of the document it shows and is dropped when a
+ * change touches that area. All tiles are dropped when the view state, i.e.
+ * everything but the zoom level that influences rendering, changes.
+ */
+class CanvasTileCache
+{
+public:
+	static const int tileSize = 256;
+
+	CanvasTileCache();
+
+	/// Drops all tiles if \a viewState differs from the state of the cached tiles
+	void setViewState(const QByteArray& viewState);
+
+	const QImage* find(double scale, int column, int row) const;
+	void insert(double scale, int column, int row, const QImage& image, const QRectF& docRect);
+
+	/// Drops all tiles showing part of \a docRect, or all tiles if \a docRect is invalid
+	void invalidate(const QRectF& docRect);
+	void clear();
+
+private:
+	struct TileKey
+	{
+		double scale { 0.0 };
+		int column { 0 };
+		int row { 0 };
+
+		bool operator==(const TileKey& other) const
+		{
+			return (scale == other.scale) && (column == other.column) && (row == other.row);
+		}
+	};
+	friend size_t qHash(const TileKey& key, size_t seed);
+
+	struct Tile
+	{
+		QImage image;
+		QRectF docRect;
+	};
+
+	QCache<TileKey, Tile> m_tiles;
+	QByteArray m_viewState;
+};
+
+#endif // CANVASTILECACHE_H
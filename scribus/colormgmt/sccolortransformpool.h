@@ -9,6 +9,7 @@ for which a new license (GPL+exception) is in place.
 #define SCCOLORTRANSFORMPOOL_H
 
 #include <QList>
+#include <QMutex>
 #include <QWeakPointer>
 #include "sccolormgmtstructs.h"
 #include "sccolortransform.h"
@@ -29,6 +30,8 @@ public:
 
 private:
 	int m_engineID { 0 };
+	// Image loaders create transforms from background threads
+	mutable QRecursiveMutex m_mutex;
 	QList< QWeakPointer<ScColorTransformData> > m_pool;
 };
 
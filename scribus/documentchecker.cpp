@@ -388,6 +388,8 @@ void DocumentChecker::checkItems(ScribusDoc *currDoc, const CheckerPrefs& checke
 			}
 			if ((currItem->isTextFrame()) || (currItem->isPathText()))
 			{
+				if (currItem->invalid)
+					currItem->layout();
 				if ( currItem->frameOverflows() && (checkerSettings.checkOverflow) && (!((currItem->isAnnotation()) && ((currItem->annotation().Type() == Annotation::Combobox) || (currItem->annotation().Type() == Annotation::Listbox)))))
 					itemError.insert(PreflightError::TextOverflow, 0);
 
@@ -666,6 +668,8 @@ void DocumentChecker::checkItems(ScribusDoc *currDoc, const CheckerPrefs& checke
 			}
 			if ((currItem->isTextFrame()) || (currItem->isPathText()))
 			{
+				if (currItem->invalid)
+					currItem->layout();
 				if ( currItem->frameOverflows() && (checkerSettings.checkOverflow) && (!((currItem->isAnnotation()) && ((currItem->annotation().Type() == Annotation::Combobox) || (currItem->annotation().Type() == Annotation::Listbox)))))
 					itemError.insert(PreflightError::TextOverflow, 0);
 
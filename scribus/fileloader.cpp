@@ -30,6 +30,7 @@ for which a new license (GPL+exception) is in place.
 #include "scclocale.h"
 #include "scconfig.h"
 #include "scribuscore.h"
+#include "text/shapedruncache.h"
 #include "ui/fontreplacedialog.h"
 #include "util.h"
 
@@ -227,6 +228,8 @@ bool FileLoader::loadFile(ScribusDoc* currDoc)
 	currDoc->setAutoSaveInDocDir(m_prefsManager.appPrefs.docSetupPrefs.AutoSaveLocation);
 	currDoc->setAutoSaveDir(m_prefsManager.appPrefs.docSetupPrefs.AutoSaveDir);
 	m_ReplacedFonts = currDoc->AllFonts->getSubstitutions();
+	if (m_prefsManager.appPrefs.miscPrefs.persistShapingCache)
+		ShapedRunCache::instance().load(ShapedRunCache::cacheFileName(m_fileName));
 	//dummyScFaces.clear();
 	bool ret = false;
 	QList<FileFormat>::const_iterator it;
@@ -278,6 +281,15 @@ bool FileLoader::saveFile(const QString& fileName, ScribusDoc *doc, QString *sav
 	return ret;
 }
 
+ScDocumentSaveJob* FileLoader::saveFileInBackground(const QString& fileName, ScribusDoc *doc, uint formatID)
+{
+	QList<FileFormat>::const_iterator it;
+	if (!findFormat(formatID, it))
+		return nullptr;
+	it->setupTargets(doc, doc->view(), doc->scMW(), doc->scMW()->mainWindowProgressBar, &(m_prefsManager.appPrefs.fontPrefs.AvailFonts));
+	return it->saveFileInBackground(fileName);
+}
+
 bool FileLoader::readStyles(ScribusDoc* doc, StyleSet<ParagraphStyle> &docParagraphStyles)
 {
 	QList<FileFormat>::const_iterator it;
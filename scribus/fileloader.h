@@ -28,6 +28,7 @@ class ScribusView;
 class SCFonts;
 class PrefsManager;
 class FileFormat;
+class ScDocumentSaveJob;
 class MultiLine;
 
 class SCRIBUS_API FileLoader : public QObject
@@ -43,6 +44,8 @@ public:
 	bool loadPage(ScribusDoc* currDoc, int PageToLoad, bool Mpage, const QString& renamedPageName = QString());
 	bool loadFile(ScribusDoc* currDoc);
 	bool saveFile(const QString& fileName, ScribusDoc *doc, QString *savedFile = nullptr, uint formatID = FORMATID_CURRENTEXPORT);
+	/// Serializes \a doc and returns the job writing it in the background, nullptr if the format cannot do that
+	ScDocumentSaveJob* saveFileInBackground(const QString& fileName, ScribusDoc *doc, uint formatID = FORMATID_CURRENTEXPORT);
 	bool readStyles(ScribusDoc* doc, StyleSet<ParagraphStyle> &docParagraphStyles);
 	bool readCharStyles(ScribusDoc* doc, StyleSet<CharStyle> &docCharStyles);
 	bool readPageCount(int *num1, int *num2, QStringList & masterPageNames);
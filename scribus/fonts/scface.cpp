@@ -13,6 +13,8 @@ for which a new license (GPL+exception) is in place.
 #include <ft2build.h>
 #include FT_TRUETYPE_TABLES_H
 
+#include <QMutexLocker>
+
 #include "scribusapi.h"
 #include "fonts/scface.h"
 #include "text/storytext.h"
@@ -51,6 +53,11 @@ static hb_blob_t* referenceTable(hb_face_t*, hb_tag_t tag, void *userData)
 
 void* ScFace::ScFaceData::hbFont()
 {
+	// Faces are created through the shared FreeType library, which
+	// must not be used concurrently
+	static QMutex creationMutex;
+	QMutexLocker locker(&creationMutex);
+
 	if (!m_hbFont)
 	{
 		FT_Face face = ftFace();
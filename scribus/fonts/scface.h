@@ -22,6 +22,7 @@ virtual:      dispatch to constituents, handle embedding (-)
 
 #include <QHash>
 #include <QMap>
+#include <QMutex>
 #include <QString>
 #include <QStringList>
 #include <utility>
@@ -155,6 +156,7 @@ public:
 		mutable QHash<gid_type, qreal>     m_glyphWidth;
 		mutable QHash<gid_type, GlyphData> m_glyphOutline;
 		void* m_hbFont {nullptr};
+		mutable QMutex m_hbFontMutex;
 
 		// fill caches & members
 
@@ -290,6 +292,9 @@ public:
 	/// a HarfBuzz font for this font
 	void* hbFont() const { return m_m->hbFont(); }
 
+	/// serializes use of the HarfBuzz font, whose scale is changed for each shaping call
+	QMutex* hbFontMutex() const { return &m_m->m_hbFontMutex; }
+
 	/// path name of the document this face is local to
 	QString localForDocument()  const { return m_m->forDocument; }
 
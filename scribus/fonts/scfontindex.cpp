@@ -0,0 +1,154 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include "fonts/scfontindex.h"
+
+namespace
+{
+	const quint32 indexMagic = 0x53434649; // "SCFI"
+	const quint32 indexVersion = 1;
+	// magic, version and number of entries, followed by the offset of each entry
+	const qint64 headerSize = 3 * sizeof(quint32);
+}
+
+static QDataStream& operator<<(QDataStream& ds, const ScFontIndex::Face& face)
+{
+	ds << face.family << face.style << face.psName;
+	ds << static_cast<qint32>(face.faceIndex) << static_cast<qint8>(face.format) << static_cast<qint8>(face.type);
+	ds << face.hasGlyphNames << face.subset << face.features;
+	return ds;
+}
+
+static QDataStream& operator>>(QDataStream& ds, ScFontIndex::Face& face)
+{
+	qint32 faceIndex = 0;
+	qint8 format = 0;
+	qint8 type = 0;
+	ds >> face.family >> face.style >> face.psName;
+	ds >> faceIndex >> format >> type;
+	ds >> face.hasGlyphNames >> face.subset >> face.features;
+	face.faceIndex = faceIndex;
+	face.format = format;
+	face.type = type;
+	return ds;
+}
+
+ScFontIndex::~ScFontIndex()
+{
+	close();
+}
+
+bool ScFontIndex::open(const QString& fileName)
+{
+	close();
+	m_file.setFileName(fileName);
+	if (!m_file.open(QIODevice::ReadOnly))
+		return false;
+	m_size = m_file.size();
+	if (m_size >= headerSize)
+		m_data = m_file.map(0, m_size);
+	if (!m_data || (qFromBigEndian<quint32>(m_data) != indexMagic) || (qFromBigEndian<quint32>(m_data + 4) != indexVersion))
+	{
+		close();
+		return false;
+	}
+
+	quint32 entryCount = qFromBigEndian<quint32>(m_data + 8);
+	if (headerSize + static_cast<qint64>(entryCount) * sizeof(quint32) > m_size)
+	{
+		close();
+		return false;
+	}
+	m_offsets.reserve(entryCount);
+	for (quint32 i = 0; i < entryCount; ++i)
+	{
+		quint32 offset = qFromBigEndian<quint32>(m_data + headerSize + i * sizeof(quint32));
+		if (offset >= m_size)
+		{
+			close();
+			return false;
+		}
+		QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char*>(m_data) + offset, m_size - offset);
+		QDataStream ds(data);
+		ds.setVersion(QDataStream::Qt_6_0);
+		QString path;
+		ds >> path;
+		if (ds.status() != QDataStream::Ok)
+		{
+			close();
+			return false;
+		}
+		m_offsets.insert(path, offset);
+	}
+	return true;
+}
+
+void ScFontIndex::close()
+{
+	if (m_data)
+		m_file.unmap(const_cast<uchar*>(m_data));
+	m_data = nullptr;
+	m_size = 0;
+	m_file.close();
+	m_offsets.clear();
+}
+
+bool ScFontIndex::find(const QString& path, Entry& entry) const
+{
+	auto it = m_offsets.constFind(path);
+	if (it == m_offsets.constEnd())
+		return false;
+
+	QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char*>(m_data) + *it, m_size - *it);
+	QDataStream ds(data);
+	ds.setVersion(QDataStream::Qt_6_0);
+	QString entryPath;
+	qint64 lastMod = 0;
+	Entry decoded;
+	ds >> entryPath >> lastMod >> decoded.size >> decoded.isOK >> decoded.faces;
+	if (ds.status() != QDataStream::Ok)
+		return false;
+	decoded.lastMod = QDateTime::fromSecsSinceEpoch(lastMod);
+	entry = decoded;
+	return true;
+}
+
+bool ScFontIndex::write(const QString& fileName, const QMap<QString, Entry>& entries)
+{
+	QByteArray entryData;
+	QList<quint32> offsets;
+	offsets.reserve(entries.count());
+	QDataStream es(&entryData, QIODevice::WriteOnly);
+	es.setVersion(QDataStream::Qt_6_0);
+	qint64 dataStart = headerSize + entries.count() * sizeof(quint32);
+	for (auto it = entries.cbegin(); it != entries.cend(); ++it)
+	{
+		offsets.append(static_cast<quint32>(dataStart + entryData.size()));
+		es << it.key() << it->lastMod.toSecsSinceEpoch() << it->size << it->isOK << it->faces;
+	}
+
+	QSaveFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	ds << indexMagic << indexVersion << static_cast<quint32>(entries.count());
+	for (quint32 offset : std::as_const(offsets))
+		ds << offset;
+	ds.writeRawData(entryData.constData(), entryData.size());
+	if ((es.status() != QDataStream::Ok) || (ds.status() != QDataStream::Ok))
+	{
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
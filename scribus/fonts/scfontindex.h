@@ -0,0 +1,81 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCFONTINDEX_H
+#define SCFONTINDEX_H
+
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include "scribusapi.h"
+
+/*
+	Class ScFontIndex
+	Binary index of the font files found by SCFonts, with the metadata of
+	their faces, so that later runs can create the faces without opening
+	the files.
+
+	The index file is memory mapped. Opening it only reads the path of each
+	entry, the entry itself is decoded when SCFonts asks for that file, which
+	happens once the file has been found again. Entries are valid as long as
+	the size and modification time of the file are unchanged; the faces are
+	opened by FreeType when they are first used.
+*/
+
+class SCRIBUS_API ScFontIndex
+{
+public:
+	struct Face
+	{
+		QString family;
+		QString style;
+		QString psName;
+		int faceIndex { 0 };
+		int format { 0 };          //!< ScFace::FontFormat as detected from the file header
+		int type { 0 };            //!< ScFace::FontType of sfnt based faces
+		bool hasGlyphNames { false };
+		bool subset { false };
+		QStringList features;
+	};
+
+	struct Entry
+	{
+		QDateTime lastMod;
+		qint64 size { -1 };
+		bool isOK { false };
+		QList<Face> faces;
+	};
+
+	ScFontIndex() = default;
+	~ScFontIndex();
+	ScFontIndex(const ScFontIndex&) = delete;
+	ScFontIndex& operator=(const ScFontIndex&) = delete;
+
+	/// Maps the index file \a fileName, returns false if it is missing or invalid
+	bool open(const QString& fileName);
+	void close();
+
+	int count() const { return m_offsets.count(); }
+	bool contains(const QString& path) const { return m_offsets.contains(path); }
+	QStringList paths() const { return m_offsets.keys(); }
+	/// Decodes the entry of font file \a path
+	bool find(const QString& path, Entry& entry) const;
+
+	static bool write(const QString& fileName, const QMap<QString, Entry>& entries);
+
+private:
+	QFile m_file;
+	const uchar* m_data { nullptr };
+	qint64 m_size { 0 };
+	QHash<QString, quint32> m_offsets;
+};
+
+#endif
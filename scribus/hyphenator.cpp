@@ -29,15 +29,17 @@ for which a new license (GPL+exception) is in place.
 #include <QCursor>
 #include <QCheckBox>
 #include <QByteArray>
+#include <QLocale>
 #include <QStringView>
+#include <QtConcurrent>
 #include <unicode/brkiter.h>
 
-#include "langmgr.h"
 #include "scpaths.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
 #include "prefsfile.h"
 #include "prefsmanager.h"
+#include "schyphenationcache.h"
 
 using namespace icu;
 
@@ -52,42 +54,6 @@ Hyphenator::Hyphenator(QWidget* parent, ScribusDoc *dok) : QObject( parent ),
 	specialWords.clear();
 }
 
-Hyphenator::~Hyphenator()
-{
-	if (m_hdict)
-		hnj_hyphen_free(m_hdict);
-}
-
-bool Hyphenator::loadDict(const QString& name)
-{
-	if (LanguageManager::instance()->getHyphFilename(name).isEmpty())
-		return false;
-		
-	if (m_language == name)
-		return (m_codec != nullptr && m_hdict != nullptr);
-
-	m_language = name;
-	QFile file(LanguageManager::instance()->getHyphFilename(m_language));
-
-	if (m_hdict != nullptr)
-		hnj_hyphen_free(m_hdict);
-	m_hdict = nullptr;
-
-	if (!file.open(QIODevice::ReadOnly))
-		return false;
-
-	m_codec = QTextCodec::codecForName(file.readLine());
-	if (!m_codec)
-	{
-		qDebug()<<"Unable to load lines from Hyphenator file";
-		file.close();
-		return false;
-	}
-	m_hdict = hnj_hyphen_load(file.fileName().toLocal8Bit().data());
-	file.close();
-	return true;
-}
-
 void Hyphenator::slotNewSettings(bool Autom, bool ACheck)
 {
 	m_autoCheck = ACheck;
@@ -104,32 +70,9 @@ void Hyphenator::slotHyphenateWord(PageItem* it, const QString& text, int firstC
 	if (text.length() < style.hyphenWordMin())
 		return;
 
-	bool ok = loadDict(style.language());
-	if (!ok)
-		return;
-
-	QByteArray te = m_codec->fromUnicode(text);
-	char *buffer = static_cast<char*>(malloc(te.length() + 5));
-	if (buffer == nullptr)
-		return;
-	char **rep = nullptr;
-	int *pos = nullptr;
-	int *cut = nullptr;
-	// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
-	if (!hnj_hyphen_hyphenate2(m_hdict, te.data(), te.length(), buffer, nullptr, &rep, &pos, &cut))
-	{
-		buffer[te.length()] = '\0';
-		it->itemText.hyphenateWord(firstC, text.length(), buffer);
-	}
-	free(buffer);
-	if (rep)
-	{
-		for (int i = 0; i < te.length() - 1; ++i)
-			free(rep[i]);
-	}
-	free(rep);
-	free(pos);
-	free(cut);
+	QByteArray hyphens = ScHyphenationCache::instance().hyphenate(style.language(), text);
+	if (!hyphens.isEmpty())
+		it->itemText.hyphenateWord(firstC, text.length(), hyphens.constData());
 }
 
 void Hyphenator::slotHyphenate(PageItem* it)
@@ -153,6 +96,13 @@ void Hyphenator::slotHyphenate(PageItem* it)
 	rememberedWords.clear();
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
+	// Words to hyphenate are collected per paragraph, the paragraphs are then
+	// hyphenated in parallel and the result is applied to the text in order
+	ScHyphenationCache& hyphenationCache = ScHyphenationCache::instance();
+	QList< QList<HyphenatedWord> > paragraphs;
+	paragraphs.append(QList<HyphenatedWord>());
+	int paragraphEnd = text.indexOf(SpecialChars::PARSEP);
+
 	BreakIterator* bi = StoryText::getWordIterator();
 	icu::UnicodeString unicodeStr((const UChar*) text.utf16(), text.length());
 	bi->setText(unicodeStr);
@@ -165,180 +115,166 @@ void Hyphenator::slotHyphenate(PageItem* it)
 		int lastC = pos;
 		int countC = lastC - firstC;
 
-		const CharStyle& style = it->itemText.charStyle(firstC);
-		if (countC > 0 && countC > style.hyphenWordMin() - 1)
+		const CharStyle& style = it->itemText.charStyle(startC + firstC);
+		if (countC <= 0 || countC < style.hyphenWordMin())
+			continue;
+		QString word = text.mid(firstC, countC);
+		if (word.contains(SpecialChars::SHYPHEN))
+			continue;
+		if (!hyphenationCache.hasDictionary(style.language()))
+			continue;
+
+		if ((paragraphEnd >= 0) && (firstC > paragraphEnd))
 		{
-			QString word = text.mid(firstC, countC);
-			QString wordLower = QLocale(style.language()).toLower(word);
-			if (wordLower.contains(SpecialChars::SHYPHEN))
-				continue;
+			if (!paragraphs.last().isEmpty())
+				paragraphs.append(QList<HyphenatedWord>());
+			paragraphEnd = text.indexOf(SpecialChars::PARSEP, firstC);
+		}
+		HyphenatedWord hyWord;
+		hyWord.firstC = firstC;
+		hyWord.language = style.language();
+		hyWord.word = word;
+		paragraphs.last().append(hyWord);
+	}
 
-			bool ok = loadDict(style.language());
-			if (!ok)
-				continue;
+	QtConcurrent::blockingMap(paragraphs, [&hyphenationCache](QList<HyphenatedWord>& words) {
+		QString language;
+		QLocale locale;
+		for (HyphenatedWord& hyWord : words)
+		{
+			if (hyWord.language != language)
+			{
+				language = hyWord.language;
+				locale = QLocale(language);
+			}
+			hyWord.wordLower = locale.toLower(hyWord.word);
+			hyWord.hyphens = hyphenationCache.hyphenate(language, hyWord.wordLower);
+		}
+	});
 
-			QByteArray te = m_codec->fromUnicode(wordLower);
-			char *buffer = static_cast<char*>(malloc(te.length() + 5));
-			if (buffer == nullptr)
+	bool canceled = false;
+	for (const QList<HyphenatedWord>& words : std::as_const(paragraphs))
+	{
+		for (const HyphenatedWord& hyWord : words)
+		{
+			if (hyWord.hyphens.isEmpty())
+				continue;
+			if (!hyphenateWord(it, startC + hyWord.firstC, hyWord))
+			{
+				canceled = true;
 				break;
+			}
+		}
+		if (canceled)
+			break;
+	}
+	QApplication::restoreOverrideCursor();
+	m_doc->DoDrawing = true;
+	rememberedWords.clear();
+}
+
+bool Hyphenator::hyphenateWord(PageItem* it, int firstC, const HyphenatedWord& hyWord)
+{
+	const QString& word = hyWord.word;
+	const QString& wordLower = hyWord.wordLower;
+	QByteArray buffer(hyWord.hyphens);
+
+	int i = 0;
+	bool hasHyphen = false;
+	for (i = 1; i < wordLower.length() - 1; ++i)
+	{
+		if (buffer[i] & 1)
+		{
+			hasHyphen = true;
+			break;
+		}
+	}
+	QString outs;
+	QString input;
+	outs += word[0];
+	for (i = 1; i < wordLower.length() - 1; ++i)
+	{
+		outs += word[i];
+		if (buffer[i] & 1)
+			outs += "-";
+	}
+	outs += QStringView(word).last();
+	input = outs;
+	if (ignoredWords.contains(word))
+		return true;
 
-			char **rep = nullptr;
-			int *pos = nullptr;
-			int *cut = nullptr;
-			// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
-			if (!hnj_hyphen_hyphenate2(m_hdict, te.data(), te.length(), buffer, nullptr, &rep, &pos, &cut))
+	if (!hasHyphen)
+		it->itemText.hyphenateWord(firstC, wordLower.length(), nullptr);
+	else if (m_automatic || !ScCore->usingGUI())
+	{
+		if (specialWords.contains(word))
+			applyHyphenationPattern(specialWords.value(word), buffer);
+		it->itemText.hyphenateWord(firstC, wordLower.length(), buffer.constData());
+	}
+	else
+	{
+		if (specialWords.contains(word))
+			applyHyphenationPattern(specialWords.value(word), buffer);
+		if (rememberedWords.contains(input))
+		{
+			applyHyphenationPattern(rememberedWords.value(input), buffer);
+			it->itemText.hyphenateWord(firstC, wordLower.length(), buffer.constData());
+		}
+		else
+		{
+			QApplication::changeOverrideCursor(QCursor(Qt::ArrowCursor));
+			PrefsContext* prefs = PrefsManager::instance().prefsFile->getContext("hyhpen_options");
+			int xpos = prefs->getInt("Xposition", -9999);
+			int ypos = prefs->getInt("Yposition", -9999);
+			HyAsk *dia = new HyAsk((QWidget*) parent(), outs);
+			if ((xpos != -9999) && (ypos != -9999))
+				dia->move(xpos, ypos);
+			QApplication::processEvents();
+			if (!dia->exec())
+			{
+				prefs->set("Xposition", dia->xpos);
+				prefs->set("Yposition", dia->ypos);
+				delete dia;
+				return false;
+			}
+			outs = dia->Wort->text();
+			applyHyphenationPattern(outs, buffer);
+			if (!rememberedWords.contains(input))
+				rememberedWords.insert(input, outs);
+			if (dia->addToIgnoreList->isChecked())
 			{
-				int i = 0;
-				buffer[te.length()] = '\0';
-				bool hasHyphen = false;
-				for (i = 1; i < wordLower.length() - 1; ++i)
-				{
-					if (buffer[i] & 1)
-					{
-						hasHyphen = true;
-						break;
-					}
-				}
-				QString outs;
-				QString input;
-				outs += word[0];
-				for (i = 1; i < wordLower.length() - 1; ++i)
-				{
-					outs += word[i];
-					if (buffer[i] & 1)
-						outs += "-";
-				}
-				outs += QStringView(word).last();
-				input = outs;
 				if (!ignoredWords.contains(word))
-				{
-					if (!hasHyphen)
-						it->itemText.hyphenateWord(startC + firstC, wordLower.length(), nullptr);
-					else if (m_automatic || !ScCore->usingGUI())
-					{
-						if (specialWords.contains(word))
-						{
-							outs = specialWords.value(word);
-							uint ii = 1;
-							for (i = 1; i < outs.length() - 1; ++i)
-							{
-								QChar cht = outs[i];
-								if (cht == '-')
-									buffer[ii - 1] = 1;
-								else
-								{
-									buffer[ii] = 0;
-									++ii;
-								}
-							}
-						}
-						it->itemText.hyphenateWord(startC + firstC, wordLower.length(), buffer);
-					}
-					else
-					{
-						if (specialWords.contains(word))
-						{
-							outs = specialWords.value(word);
-							uint ii = 1;
-							for (i = 1; i < outs.length() - 1; ++i)
-							{
-								QChar cht = outs[i];
-								if (cht == '-')
-									buffer[ii - 1] = 1;
-								else
-								{
-									buffer[ii] = 0;
-									++ii;
-								}
-							}
-						}
-						if (rememberedWords.contains(input))
-						{
-							outs = rememberedWords.value(input);
-							uint ii = 1;
-							for (i = 1; i < outs.length() - 1; ++i)
-							{
-								QChar cht = outs[i];
-								if (cht == '-')
-									buffer[ii - 1] = 1;
-								else
-								{
-									buffer[ii] = 0;
-									++ii;
-								}
-							}
-							it->itemText.hyphenateWord(firstC, wordLower.length(), buffer);
-						}
-						else
-						{
-							QApplication::changeOverrideCursor(QCursor(Qt::ArrowCursor));
-							PrefsContext* prefs = PrefsManager::instance().prefsFile->getContext("hyhpen_options");
-							int xpos = prefs->getInt("Xposition", -9999);
-							int ypos = prefs->getInt("Yposition", -9999);
-							HyAsk *dia = new HyAsk((QWidget*) parent(), outs);
-							if ((xpos != -9999) && (ypos != -9999))
-								dia->move(xpos, ypos);
-							QApplication::processEvents();
-							if (dia->exec())
-							{
-								outs = dia->Wort->text();
-								uint ii = 1;
-								for (i = 1; i < outs.length() - 1; ++i)
-								{
-									QChar cht = outs[i];
-									if (cht == '-')
-										buffer[ii - 1] = 1;
-									else
-									{
-										buffer[ii] = 0;
-										++ii;
-									}
-								}
-								if (!rememberedWords.contains(input))
-									rememberedWords.insert(input, outs);
-								if (dia->addToIgnoreList->isChecked())
-								{
-									if (!ignoredWords.contains(word))
-										ignoredWords.insert(word);
-								}
-								if (dia->addToExceptionList->isChecked())
-								{
-									if (!specialWords.contains(word))
-										specialWords.insert(word, outs);
-								}
-								it->itemText.hyphenateWord(firstC, wordLower.length(), buffer);
-							}
-							else
-							{
-								free(buffer);
-								buffer = nullptr;
-								prefs->set("Xposition", dia->xpos);
-								prefs->set("Yposition", dia->ypos);
-								delete dia;
-								break;
-							}
-							prefs->set("Xposition", dia->xpos);
-							prefs->set("Yposition", dia->ypos);
-							delete dia;
-							QApplication::changeOverrideCursor(QCursor(Qt::WaitCursor));
-						}
-					}
-				}
+					ignoredWords.insert(word);
 			}
-			free(buffer);
-			if (rep)
+			if (dia->addToExceptionList->isChecked())
 			{
-				for (int i = 0; i < te.length() - 1; ++i)
-					free(rep[i]);
+				if (!specialWords.contains(word))
+					specialWords.insert(word, outs);
 			}
-			free(rep);
-			free(pos);
-			free(cut);
+			it->itemText.hyphenateWord(firstC, wordLower.length(), buffer.constData());
+			prefs->set("Xposition", dia->xpos);
+			prefs->set("Yposition", dia->ypos);
+			delete dia;
+			QApplication::changeOverrideCursor(QCursor(Qt::WaitCursor));
+		}
+	}
+	return true;
+}
+
+void Hyphenator::applyHyphenationPattern(const QString& pattern, QByteArray& hyphens)
+{
+	uint ii = 1;
+	for (int i = 1; i < pattern.length() - 1; ++i)
+	{
+		QChar cht = pattern[i];
+		if (cht == '-')
+			hyphens[ii - 1] = 1;
+		else
+		{
+			hyphens[ii] = 0;
+			++ii;
 		}
 	}
-	QApplication::restoreOverrideCursor();
-	m_doc->DoDrawing = true;
-	rememberedWords.clear();
 }
 
 void Hyphenator::slotDeHyphenate(PageItem* it)
@@ -7,13 +7,13 @@ for which a new license (GPL+exception) is in place.
 #ifndef HYPLUG_H
 #define HYPLUG_H
 
+#include <QByteArray>
 #include <QObject>
-#include <QTextCodec>
 #include <QHash>
 #include <QSet>
+#include <QString>
 
 #include "scribusapi.h"
-#include "third_party/hyphen/hyphen.h"
 
 class ScribusDoc;
 class ScribusMainWindow;
@@ -36,13 +36,6 @@ public:
 	\param dok ScribusDoc reference. It's used for preferences accessing.
 	*/
 	Hyphenator(QWidget* parent, ScribusDoc *dok);
-	/*!
-	\fn Hyphenator::~Hyphenator()
-	\brief Safely cleans hyphen. 
-	\date
-	\author Franz Schmid
-	*/
-	~Hyphenator() override;
 
 	bool autoCheck() const { return m_autoCheck; }
 	
@@ -50,26 +43,33 @@ private:
 
 	/*! Embedded reference to the \see ScribusDoc filled by \a dok */
 	ScribusDoc *m_doc { nullptr };
-	/*! Reference to the hyphen dictionary structure. */
-	HyphenDict *m_hdict { nullptr };
-	/*! Qt text codec which handles local characters. */
-	QTextCodec *m_codec { nullptr };
-	/*! Language in use */
-	QString m_language;
-
 	/*! Flag - if user set auto hyphen processing.*/
 	bool m_automatic { false };
 
 	/*! Flag - obsolete? */
 	bool m_autoCheck { false };
 
+	/*! A word of the text hyphenated by \see slotHyphenate */
+	struct HyphenatedWord
+	{
+		int firstC { 0 };
+		QString language;
+		QString word;
+		QString wordLower;
+		/*! Hyphenation points returned by \see ScHyphenationCache */
+		QByteArray hyphens;
+	};
+
+	/*!
+	\brief Applies the hyphenation points of \a hyWord to the text of \a it at \a firstC,
+	asking the user if hyphenation is not automatic.
+	\retval bool false if the user canceled hyphenation
+	*/
+	bool hyphenateWord(PageItem* it, int firstC, const HyphenatedWord& hyWord);
 	/*!
-		\brief Loads dictionary and fills parameters like \a m_codec, \a m_hdict.
-	 \date
-	 \author Franz Schmid
-	 \param name is the name of specified language.
-	 */
-	bool loadDict(const QString& name);
+	\brief Sets \a hyphens from a word hyphenated by the user, e.g. "hy-phen-ation".
+	*/
+	static void applyHyphenationPattern(const QString& pattern, QByteArray& hyphens);
 	
 public:
 	QHash<QString, QString> rememberedWords;
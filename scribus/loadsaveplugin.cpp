@@ -220,6 +220,12 @@ bool LoadSavePlugin::saveFile(const QString & /* fileName */,
 	return false;
 }
 
+ScDocumentSaveJob* LoadSavePlugin::saveFileInBackground(const QString & /* fileName */,
+												const FileFormat & /* fmt */)
+{
+	return nullptr;
+}
+
 bool LoadSavePlugin::loadElements(const QString &  /*data*/, const QString&  /*fileDir*/, int /*toLayer*/, double /*Xp_in*/, double /*Yp_in*/, bool /*loc*/)
 {
 	return false;
@@ -473,6 +479,11 @@ bool FileFormat::saveFile(const QString & fileName) const
 	return (plug && save) ? plug->saveFile(fileName, *this) : false;
 }
 
+ScDocumentSaveJob* FileFormat::saveFileInBackground(const QString & fileName) const
+{
+	return (plug && save) ? plug->saveFileInBackground(fileName, *this) : nullptr;
+}
+
 bool FileFormat::savePalette(const QString & fileName) const
 {
 	return (plug && save) ? plug->savePalette(fileName) : false;
@@ -16,6 +16,7 @@ for which a new license (GPL+exception) is in place.
 #include <QList>
 
 class FileFormat;
+class ScDocumentSaveJob;
 //TODO REmove includes one day
 class ScribusView;
 #include "scfonts.h"
@@ -87,6 +88,10 @@ class SCRIBUS_API LoadSavePlugin : public ScPlugin
 
 		// Save the requested format to the requested path.
 		virtual bool saveFile(const QString & fileName, const FileFormat & fmt);
+		// Serialize the document and return a job writing it to the requested
+		// path on a worker thread, the caller takes ownership of the job.
+		// Default implementation returns nullptr, callers then use saveFile().
+		virtual ScDocumentSaveJob* saveFileInBackground(const QString & fileName, const FileFormat & fmt);
 		virtual bool savePalette(const QString & fileName);
 		virtual QString saveElements(double, double, double, double, Selection*, QByteArray &prevData);
 
@@ -216,6 +221,7 @@ class SCRIBUS_API FileFormat
 
 		// Save a file with this format
 		bool saveFile(const QString & fileName) const;
+		ScDocumentSaveJob* saveFileInBackground(const QString & fileName) const;
 		bool savePalette(const QString & fileName) const;
 		QString saveElements(double xp, double yp, double wp, double hp, Selection* selection, QByteArray &prevData) const;
 
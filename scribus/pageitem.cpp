@@ -729,6 +729,7 @@ bool PageItem::isTableCell() const
 void PageItem::setXPos(double newXPos, bool drawingOnly)
 {
 	m_xPos = newXPos;
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -737,6 +738,7 @@ void PageItem::setXPos(double newXPos, bool drawingOnly)
 void PageItem::setYPos(double newYPos, bool drawingOnly)
 {
 	m_yPos = newYPos;
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -746,6 +748,7 @@ void PageItem::setXYPos(double newXPos, double newYPos, bool drawingOnly)
 {
 	m_xPos = newXPos;
 	m_yPos = newYPos;
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -780,6 +783,7 @@ void PageItem::moveBy(double dX, double dY, bool drawingOnly)
 		gYpos += dY;
 		BoundingY += dY;
 	}
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	moveWelded(dX, dY);
@@ -790,6 +794,7 @@ void PageItem::setWidth(double newWidth)
 {
 	m_width = newWidth;
 	updateConstants();
+	m_Doc->itemBoundsChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -799,6 +804,7 @@ void PageItem::setHeight(double newHeight)
 {
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemBoundsChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -809,6 +815,7 @@ void PageItem::setWidthHeight(double newWidth, double newHeight, bool drawingOnl
 	m_width = newWidth;
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly)
 		return;
 	checkChanges();
@@ -819,6 +826,7 @@ void PageItem::setWidthHeight(double newWidth, double newHeight)
 	m_width = newWidth;
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemBoundsChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -833,6 +841,7 @@ void PageItem::resizeBy(double dH, double dW)
 	if (dW != 0.0)
 		m_height += dW;
 	updateConstants();
+	m_Doc->itemBoundsChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -847,6 +856,7 @@ void PageItem::setRotation(double newRotation, bool drawingOnly)
 		m_rotation += 360.0;
 	while (m_rotation > 360.0)
 		m_rotation -= 360.0;
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	rotateWelded(dR, oldRot);
@@ -862,6 +872,7 @@ void PageItem::rotateBy(double dR)
 		m_rotation += 360.0;
 	while (m_rotation > 360.0)
 		m_rotation -= 360.0;
+	m_Doc->itemBoundsChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -2076,14 +2087,14 @@ void PageItem::DrawObj_Embedded(ScPainter *p, const QRectF& cullingArea, const C
 		p->save();
 		double x = embedded->xPos();
 		double y = embedded->yPos();
-		embedded->m_xPos = embedded->gXpos;
-		embedded->m_yPos = (embedded->gHeight * (style.scaleV() / 1000.0)) + embedded->gYpos;
+		double embeddedY = (embedded->gHeight * (style.scaleV() / 1000.0)) + embedded->gYpos;
 		p->translate((embedded->gXpos * (style.scaleH() / 1000.0)), ( - (embedded->gHeight * (style.scaleV() / 1000.0)) + embedded->gYpos * (style.scaleV() / 1000.0)));
 		if (style.baselineOffset() != 0)
 		{
 			p->translate(0, -embedded->gHeight * (style.baselineOffset() / 1000.0));
-			embedded->m_yPos -= embedded->gHeight * (style.baselineOffset() / 1000.0);
+			embeddedY -= embedded->gHeight * (style.baselineOffset() / 1000.0);
 		}
+		embedded->setXYPos(embedded->gXpos, embeddedY, true);
 		p->scale(style.scaleH() / 1000.0, style.scaleV() / 1000.0);
 		embedded->invalid = true;
 		double pws = embedded->m_lineWidth;
@@ -2114,8 +2125,7 @@ void PageItem::DrawObj_Embedded(ScPainter *p, const QRectF& cullingArea, const C
 		}
 		embedded->m_lineWidth = pws * qMin(style.scaleH() / 1000.0, style.scaleV() / 1000.0);
 		embedded->DrawObj_Post(p);
-		embedded->m_xPos = x;
-		embedded->m_yPos = y;
+		embedded->setXYPos(x, y, true);
 		p->restore();
 		embedded->m_lineWidth = pws;
 	}
@@ -4009,6 +4019,7 @@ void PageItem::setLineWidth(double newWidth)
 	}
 	m_oldLineWidth = m_lineWidth;
 	m_lineWidth = newWidth;
+	m_Doc->itemBoundsChanged(this);
 }
 
 void PageItem::setLineEnd(Qt::PenCapStyle newStyle)
@@ -10784,6 +10795,7 @@ void PageItem::updateClip(bool updateWelded)
 {
 	if (m_Doc->appMode == modeDrawBezierLine)
 		return;
+	m_Doc->itemBoundsChanged(this);
 	if (ContourLine.empty())
 		ContourLine = PoLine.copy();
 //	int ph = static_cast<int>(qMax(1.0, lineWidth() / 2.0));
@@ -0,0 +1,192 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <QPolygonF>
+#include <QTransform>
+
+#include "pageitem.h"
+#include "pageitemindex.h"
+
+namespace
+{
+	// Unlike QRectF::intersects() this also accepts rectangles of zero width or height
+	bool overlaps(const QRectF& a, const QRectF& b)
+	{
+		return (a.left() <= b.right()) && (b.left() <= a.right()) && (a.top() <= b.bottom()) && (b.top() <= a.bottom());
+	}
+}
+
+QList<int> PageItemIndex::intersecting(const QList<PageItem*>& items, const QRectF& rect)
+{
+	QList<int> result;
+	sync(items);
+	updateChangedEntries();
+	if (m_root < 0)
+		return result;
+
+	QRectF area = rect.normalized();
+	QVector<int> stack;
+	stack.append(m_root);
+	while (!stack.isEmpty())
+	{
+		const Node& node = m_nodes.at(stack.takeLast());
+		if (!overlaps(node.bounds, area))
+			continue;
+		if (!node.isLeaf)
+		{
+			stack += node.children;
+			continue;
+		}
+		for (int entry : node.children)
+		{
+			if (overlaps(m_entries.at(entry).bounds, area))
+				result.append(entry);
+		}
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+void PageItemIndex::itemChanged(const PageItem* item)
+{
+	if (m_valid && m_entryIndex.contains(item))
+		m_changed.insert(item);
+}
+
+void PageItemIndex::clear()
+{
+	m_items.clear();
+	m_entries.clear();
+	m_nodes.clear();
+	m_entryIndex.clear();
+	m_changed.clear();
+	m_root = -1;
+	m_enlargedCount = 0;
+	m_valid = false;
+}
+
+QRectF PageItemIndex::itemBounds(const PageItem* item)
+{
+	QRectF bounds = item->getBoundingRect().united(item->getVisualBoundingRect());
+	if (item->Clip.size() > 0)
+	{
+		QTransform itemPos = item->getTransform();
+		bounds = bounds.united(itemPos.map(QPolygonF(item->Clip)).boundingRect());
+	}
+	double margin = item->lineWidth() / 2.0 + 1.0;
+	return bounds.normalized().adjusted(-margin, -margin, margin, margin);
+}
+
+void PageItemIndex::sync(const QList<PageItem*>& items)
+{
+	// Lists sharing their data compare equal without looking at the elements
+	if (m_valid && (items == m_items))
+		return;
+
+	clear();
+	m_items = items;
+	m_entries.resize(m_items.count());
+	m_entryIndex.reserve(m_items.count());
+	for (int i = 0; i < m_items.count(); ++i)
+	{
+		PageItem* item = m_items.at(i);
+		m_entries[i].bounds = itemBounds(item);
+		m_entryIndex.insert(item, i);
+	}
+	rebuild();
+	m_valid = true;
+}
+
+void PageItemIndex::rebuild()
+{
+	m_nodes.clear();
+	m_root = -1;
+	m_enlargedCount = 0;
+	if (m_entries.isEmpty())
+		return;
+
+	QVector<int> members(m_entries.count());
+	for (int i = 0; i < members.count(); ++i)
+		members[i] = i;
+	buildLevel(members, true);
+	while (members.count() > 1)
+		buildLevel(members, false);
+	m_root = members.first();
+}
+
+int PageItemIndex::buildLevel(QVector<int>& members, bool leaves)
+{
+	// Sort-Tile-Recursive packing: sort by x into vertical slices,
+	// then by y within each slice, and fill nodes in that order
+	auto boundsOf = [this, leaves](int member) -> const QRectF& {
+		return leaves ? m_entries.at(member).bounds : m_nodes.at(member).bounds;
+	};
+	auto byX = [&boundsOf](int a, int b) { return boundsOf(a).center().x() < boundsOf(b).center().x(); };
+	auto byY = [&boundsOf](int a, int b) { return boundsOf(a).center().y() < boundsOf(b).center().y(); };
+
+	int count = static_cast<int>(members.count());
+	int nodeCount = (count + maxChildren - 1) / maxChildren;
+	int sliceCount = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(nodeCount))));
+	int sliceSize = sliceCount * maxChildren;
+
+	std::sort(members.begin(), members.end(), byX);
+	for (int start = 0; start < count; start += sliceSize)
+		std::sort(members.begin() + start, members.begin() + qMin(count, start + sliceSize), byY);
+
+	QVector<int> parents;
+	parents.reserve(nodeCount);
+	for (int start = 0; start < count; start += maxChildren)
+	{
+		Node node;
+		node.isLeaf = leaves;
+		node.children = members.mid(start, maxChildren);
+		node.bounds = boundsOf(node.children.first());
+		for (int child : std::as_const(node.children))
+			node.bounds = node.bounds.united(boundsOf(child));
+		int nodeIndex = static_cast<int>(m_nodes.count());
+		for (int child : std::as_const(node.children))
+		{
+			if (leaves)
+				m_entries[child].leaf = nodeIndex;
+			else
+				m_nodes[child].parent = nodeIndex;
+		}
+		m_nodes.append(node);
+		parents.append(nodeIndex);
+	}
+	members = parents;
+	return static_cast<int>(members.count());
+}
+
+void PageItemIndex::updateChangedEntries()
+{
+	if (m_changed.isEmpty())
+		return;
+
+	for (const PageItem* item : std::as_const(m_changed))
+	{
+		Entry& entry = m_entries[m_entryIndex.value(item)];
+		entry.bounds = itemBounds(item);
+		// Grow the enclosing nodes, shrinking is left to the next rebuild
+		int nodeIndex = entry.leaf;
+		while ((nodeIndex >= 0) && !m_nodes.at(nodeIndex).bounds.contains(entry.bounds))
+		{
+			Node& node = m_nodes[nodeIndex];
+			node.bounds = node.bounds.united(entry.bounds);
+			nodeIndex = node.parent;
+		}
+	}
+	m_enlargedCount += m_changed.count();
+	m_changed.clear();
+
+	// Enlarged nodes overlap more and more, repack once a good part of the items moved
+	if (m_enlargedCount > qMax(64, static_cast<int>(m_entries.count()) / 4))
+		rebuild();
+}
@@ -0,0 +1,90 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PAGEITEMINDEX_H
+#define PAGEITEMINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QSet>
+#include <QVector>
+
+#include "scribusapi.h"
+
+class PageItem;
+
+/**
+ * R-tree of the bounds of the items of an item list, used to find the items
+ * which may intersect a region without testing every item of the document.
+ *
+ * The index is not told about insertions, deletions or reordering of the
+ * list it mirrors. Instead, it keeps a shallow copy of the list and compares
+ * it with the list being queried; as long as the list is not modified both
+ * share their data and the comparison is immediate. A modified list causes
+ * the tree to be bulk loaded again.
+ *
+ * Moved, resized and rotated items are reported with itemChanged(). Their
+ * entries are updated before the next query by enlarging the affected nodes,
+ * and the tree is rebuilt once too many entries have been moved that way.
+ *
+ * Stored bounds are conservative: they cover the bounding rectangle, the
+ * visual bounding rectangle (line width included) and the clipping path of
+ * an item. Query results are candidates, callers still have to apply their
+ * own exact tests.
+ */
+class SCRIBUS_API PageItemIndex
+{
+public:
+	PageItemIndex() = default;
+
+	/**
+	 * Returns the positions in \a items of the items whose bounds intersect
+	 * \a rect, in ascending order, so that callers keep the stacking order.
+	 */
+	QList<int> intersecting(const QList<PageItem*>& items, const QRectF& rect);
+
+	/// Marks the bounds of \a item as outdated
+	void itemChanged(const PageItem* item);
+	void clear();
+
+	/// Bounds stored for \a item
+	static QRectF itemBounds(const PageItem* item);
+
+private:
+	struct Entry
+	{
+		QRectF bounds;
+		int leaf { -1 };
+	};
+
+	struct Node
+	{
+		QRectF bounds;
+		int parent { -1 };
+		bool isLeaf { true };
+		QVector<int> children; // entry indexes for leaves, node indexes otherwise
+	};
+
+	void sync(const QList<PageItem*>& items);
+	void rebuild();
+	void updateChangedEntries();
+	int buildLevel(QVector<int>& members, bool leaves);
+
+	static const int maxChildren = 16;
+
+	QList<PageItem*> m_items;
+	QVector<Entry> m_entries; // same order as m_items
+	QVector<Node> m_nodes;
+	QHash<const PageItem*, int> m_entryIndex;
+	QSet<const PageItem*> m_changed;
+	int m_root { -1 };
+	int m_enlargedCount { 0 };
+	bool m_valid { false };
+};
+
+#endif // PAGEITEMINDEX_H
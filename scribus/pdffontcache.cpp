@@ -0,0 +1,131 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "pdffontcache.h"
+#include "prefsmanager.h"
+#include "scpaths.h"
+
+namespace
+{
+	const quint32 entryMagic = 0x53435046; // "SCPF"
+	const quint32 entryVersion = 1;
+}
+
+PdfFontCache::PdfFontCache()
+{
+	m_enabled = PrefsManager::instance().appPrefs.imageCachePrefs.cacheEnabled;
+	m_cacheDir = ScPaths::imageCacheDir() + "pdf-fonts/";
+	if (m_enabled)
+		m_enabled = QDir().mkpath(m_cacheDir);
+}
+
+PdfFontCache::~PdfFontCache()
+{
+	if (m_enabled && m_modified)
+		trim();
+}
+
+QString PdfFontCache::entryPath(const QByteArray& key) const
+{
+	QByteArray hexKey = key.toHex();
+	return m_cacheDir + QString::fromLatin1(hexKey.left(2)) + "/" + QString::fromLatin1(hexKey);
+}
+
+bool PdfFontCache::lookup(const QByteArray& key, Entry& entry)
+{
+	if (!m_enabled || key.isEmpty())
+		return false;
+
+	QFile file(entryPath(key));
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	quint32 magic = 0;
+	quint32 version = 0;
+	ds >> magic >> version;
+	if ((magic != entryMagic) || (version != entryVersion))
+		return false;
+
+	Entry cached;
+	ds >> cached.subType >> cached.length1 >> cached.fontData;
+	ds >> cached.glyphs >> cached.glyphMap >> cached.widths;
+	if ((ds.status() != QDataStream::Ok) || cached.fontData.isEmpty() || cached.widths.isEmpty())
+		return false;
+	file.close();
+
+	// Modification time serves as access time when trimming the cache
+	if (file.open(QIODevice::ReadWrite))
+		file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+	entry = cached;
+	return true;
+}
+
+void PdfFontCache::store(const QByteArray& key, const Entry& entry)
+{
+	if (!m_enabled || key.isEmpty())
+		return;
+
+	QString path = entryPath(key);
+	if (!QDir().mkpath(QFileInfo(path).absolutePath()))
+		return;
+
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly))
+		return;
+
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	ds << entryMagic << entryVersion;
+	ds << entry.subType << entry.length1 << entry.fontData;
+	ds << entry.glyphs << entry.glyphMap << entry.widths;
+	if (ds.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return;
+	}
+	if (file.commit())
+		m_modified = true;
+}
+
+void PdfFontCache::trim()
+{
+	QFileInfoList entries;
+	qint64 totalSize = 0;
+	QDirIterator it(m_cacheDir, QDir::Files, QDirIterator::Subdirectories);
+	while (it.hasNext())
+	{
+		it.next();
+		entries.append(it.fileInfo());
+		totalSize += it.fileInfo().size();
+	}
+	if (totalSize <= maxSize)
+		return;
+
+	std::sort(entries.begin(), entries.end(), [](const QFileInfo& a, const QFileInfo& b) {
+		return a.lastModified() < b.lastModified();
+	});
+	for (const QFileInfo& fi : std::as_const(entries))
+	{
+		if (totalSize <= maxSize)
+			break;
+		if (QFile::remove(fi.absoluteFilePath()))
+			totalSize -= fi.size();
+	}
+}
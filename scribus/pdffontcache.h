@@ -0,0 +1,60 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PDFFONTCACHE_H
+#define PDFFONTCACHE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+/**
+ * On-disk cache of subset font programs embedded in PDF files.
+ *
+ * Entries are addressed by a key built by PDFLibCore from the hash of the
+ * font file, the face index, the set of used glyphs, the kind of subset and
+ * the compression setting. A hit gives the compressed font program, the glyph
+ * map of the subset and the widths array of the font, so that exports of the
+ * same fonts with the same glyphs skip subsetting, Flate compression and
+ * glyph metrics lookups.
+ *
+ * Like PdfImageCache, the cache is active only when the application image
+ * cache is enabled and lives in the image cache directory. It is trimmed to
+ * a fixed size, least recently used entries first.
+ */
+class PdfFontCache
+{
+public:
+	struct Entry
+	{
+		QByteArray subType;        //!< /Subtype of the font file stream, empty for TrueType
+		int length1 { 0 };         //!< size of the uncompressed font program
+		QByteArray fontData;       //!< unencrypted font file stream
+		QList<uint> glyphs;        //!< glyphs of the subset, including those added by subsetting
+		QMap<uint, uint> glyphMap; //!< glyph ids of the font to glyph ids of the subset
+		QByteArray widths;         //!< /W array of the CIDFont
+	};
+
+	PdfFontCache();
+	~PdfFontCache();
+
+	bool lookup(const QByteArray& key, Entry& entry);
+	void store(const QByteArray& key, const Entry& entry);
+
+private:
+	QString entryPath(const QByteArray& key) const;
+	void trim();
+
+	static const qint64 maxSize = 64 * 1024 * 1024;
+
+	bool m_enabled { false };
+	bool m_modified { false };
+	QString m_cacheDir;
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include "pdfimagecache.h"
+#include "prefsmanager.h"
+#include "scpaths.h"
+
+namespace
+{
+	const quint32 entryMagic = 0x53435049; // "SCPI"
+	const quint32 entryVersion = 1;
+
+	struct FileHashInfo
+	{
+		qint64 size { -1 };
+		QDateTime lastModified;
+		QByteArray hash;
+	};
+
+	QMutex fileHashMutex;
+	QHash<QString, FileHashInfo> fileHashes;
+}
+
+PdfImageCache::PdfImageCache()
+{
+	const ImageCachePrefs& cachePrefs = PrefsManager::instance().appPrefs.imageCachePrefs;
+	m_enabled = cachePrefs.cacheEnabled;
+	m_maxSize = static_cast<qint64>(cachePrefs.maxCacheSizeMiB) * 1024 * 1024;
+	m_cacheDir = ScPaths::imageCacheDir() + "pdf/";
+	if (m_enabled)
+		m_enabled = QDir().mkpath(m_cacheDir);
+}
+
+PdfImageCache::~PdfImageCache()
+{
+	if (m_enabled && m_modified)
+		trim();
+}
+
+QByteArray PdfImageCache::fileHash(const QString& fileName)
+{
+	QFileInfo fi(fileName);
+	QString filePath = fi.absoluteFilePath();
+	{
+		QMutexLocker locker(&fileHashMutex);
+		auto it = fileHashes.constFind(filePath);
+		if ((it != fileHashes.constEnd()) && (it->size == fi.size()) && (it->lastModified == fi.lastModified()))
+			return it->hash;
+	}
+
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadOnly))
+		return QByteArray();
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	if (!hash.addData(&file))
+		return QByteArray();
+
+	FileHashInfo info;
+	info.size = fi.size();
+	info.lastModified = fi.lastModified();
+	info.hash = hash.result();
+
+	QMutexLocker locker(&fileHashMutex);
+	fileHashes.insert(filePath, info);
+	return info.hash;
+}
+
+QString PdfImageCache::entryPath(const QByteArray& key) const
+{
+	QByteArray hexKey = key.toHex();
+	return m_cacheDir + QString::fromLatin1(hexKey.left(2)) + "/" + QString::fromLatin1(hexKey);
+}
+
+bool PdfImageCache::lookup(const QByteArray& key, Entry& entry)
+{
+	if (!m_enabled || key.isEmpty())
+		return false;
+
+	QFile file(entryPath(key));
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	quint32 magic = 0;
+	quint32 version = 0;
+	ds >> magic >> version;
+	if ((magic != entryMagic) || (version != entryVersion))
+		return false;
+
+	Entry cached;
+	ds >> cached.width >> cached.height;
+	ds >> cached.colorSpace >> cached.outType >> cached.compression;
+	ds >> cached.sxa >> cached.sya;
+	ds >> cached.maskWidth >> cached.maskHeight >> cached.maskCompressed;
+	ds >> cached.maskData >> cached.imageData;
+	if ((ds.status() != QDataStream::Ok) || cached.imageData.isEmpty())
+		return false;
+	file.close();
+
+	// Modification time serves as access time when trimming the cache
+	if (file.open(QIODevice::ReadWrite))
+		file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+	entry = cached;
+	return true;
+}
+
+void PdfImageCache::store(const QByteArray& key, const Entry& entry)
+{
+	if (!m_enabled || key.isEmpty())
+		return;
+
+	QString path = entryPath(key);
+	if (!QDir().mkpath(QFileInfo(path).absolutePath()))
+		return;
+
+	// QSaveFile so that concurrent exports never see partially written entries
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly))
+		return;
+
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	ds << entryMagic << entryVersion;
+	ds << entry.width << entry.height;
+	ds << entry.colorSpace << entry.outType << entry.compression;
+	ds << entry.sxa << entry.sya;
+	ds << entry.maskWidth << entry.maskHeight << entry.maskCompressed;
+	ds << entry.maskData << entry.imageData;
+	if (ds.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return;
+	}
+	if (file.commit())
+		m_modified = true;
+}
+
+void PdfImageCache::trim()
+{
+	QFileInfoList entries;
+	qint64 totalSize = 0;
+	QDirIterator it(m_cacheDir, QDir::Files, QDirIterator::Subdirectories);
+	while (it.hasNext())
+	{
+		it.next();
+		entries.append(it.fileInfo());
+		totalSize += it.fileInfo().size();
+	}
+	if (totalSize <= m_maxSize)
+		return;
+
+	std::sort(entries.begin(), entries.end(), [](const QFileInfo& a, const QFileInfo& b) {
+		return a.lastModified() < b.lastModified();
+	});
+	for (const QFileInfo& fi : std::as_const(entries))
+	{
+		if (totalSize <= m_maxSize)
+			break;
+		if (QFile::remove(fi.absoluteFilePath()))
+			totalSize -= fi.size();
+	}
+}
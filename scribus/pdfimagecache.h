@@ -0,0 +1,70 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PDFIMAGECACHE_H
+#define PDFIMAGECACHE_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * On-disk cache of fully encoded PDF image XObject streams.
+ *
+ * Entries are addressed by a content key built by PDFLibCore from the image
+ * file bytes and every setting that influences decoding, color conversion,
+ * downsampling and compression. A hit lets PDF_Image() write the stored
+ * stream as is instead of loading, converting and encoding the image again,
+ * both for repeated placements within a document and across exports.
+ *
+ * The cache follows the application image cache settings: it is active only
+ * when the image cache is enabled, and its size is bounded by the same limit.
+ */
+class PdfImageCache
+{
+public:
+	struct Entry
+	{
+		int width { 0 };
+		int height { 0 };
+		int colorSpace { 0 };  //!< ColorSpaceEnum of the decoded image
+		int outType { 0 };     //!< ColorSpaceEnum of the written stream
+		int compression { 0 }; //!< PDFOptions::PDFCompression of the written stream
+		double sxa { 0.0 };
+		double sya { 0.0 };
+		int maskWidth { 0 };
+		int maskHeight { 0 };
+		bool maskCompressed { false };
+		QByteArray maskData;   //!< unencrypted alpha mask stream, empty if none
+		QByteArray imageData;  //!< unencrypted image stream
+	};
+
+	PdfImageCache();
+	~PdfImageCache();
+
+	bool isEnabled() const { return m_enabled; }
+
+	/**
+	 * Returns a hash of the content of file \a fileName. Hashes are remembered
+	 * for the lifetime of the process as long as file size and modification
+	 * time do not change. Returns an empty array if the file cannot be read.
+	 */
+	static QByteArray fileHash(const QString& fileName);
+
+	bool lookup(const QByteArray& key, Entry& entry);
+	void store(const QByteArray& key, const Entry& entry);
+
+private:
+	QString entryPath(const QByteArray& key) const;
+	void trim();
+
+	bool m_enabled { false };
+	bool m_modified { false };
+	qint64 m_maxSize { 0 };
+	QString m_cacheDir;
+};
+
+#endif
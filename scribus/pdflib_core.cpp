@@ -57,6 +57,7 @@ for which a new license (GPL+exception) is in place.
 #include <QString>
 #include <QTemporaryFile>
 #include <QTextCodec>
+#include <QtConcurrentRun>
 #include <QUuid>
 
 #include "cmsettings.h"
@@ -953,6 +954,7 @@ int PDFLibCore::WriteFlateImageToStream(const ScImage& image, PdfId ObjNum, Colo
 
 bool PDFLibCore::PDF_Begin_Doc(const QString& fn, BookmarkView* vi)
 {
+	writer.setIncrementalUpdate(Options.incrementalUpdate);
 	if (!writer.open(fn))
 		return false;
 	
@@ -1641,20 +1643,24 @@ PdfFont PDFLibCore::PDF_WriteGlyphsAsXForms(const QByteArray& fontName, const Sc
 }
 
 PdfId PDFLibCore::PDF_EmbedFontObject(const QByteArray& font, const QByteArray& subtype)
+{
+	QByteArray ttf = (Options.Compress? CompressArray(font) : font);
+	//qDebug() << QString("sfnt data: size=%1 compressed=%2").arg(font.length()).arg(ttf.length());
+	return PDF_EmbedFontStream(ttf, font.length(), subtype);
+}
+
+PdfId PDFLibCore::PDF_EmbedFontStream(const QByteArray& stream, int length1, const QByteArray& subtype)
 {
 	PdfId embeddedFontObject = writer.newObject();
 	writer.startObj(embeddedFontObject);
-	int len = font.length();
-	QByteArray ttf = (Options.Compress? CompressArray(font) : font);
-	//qDebug() << QString("sfnt data: size=%1 compressed=%2").arg(len).arg(bb.length());
-	PutDoc("<<\n/Length " + Pdf::toPdf(ttf.length() + 1) + "\n");
-	PutDoc("/Length1 " + Pdf::toPdf(len) + "\n");
+	PutDoc("<<\n/Length " + Pdf::toPdf(stream.length() + 1) + "\n");
+	PutDoc("/Length1 " + Pdf::toPdf(length1) + "\n");
 	if (subtype.size() > 0)
 		PutDoc("/Subtype " + subtype);
 	if (Options.Compress)
 		PutDoc("/Filter /FlateDecode\n");
 	PutDoc(">>\nstream\n");
-	EncodeArrayToStream(ttf, embeddedFontObject);
+	EncodeArrayToStream(stream, embeddedFontObject);
 	PutDoc("\nendstream");
 	writer.endObj(embeddedFontObject);
 	return embeddedFontObject;
@@ -1727,7 +1733,7 @@ PdfId PDFLibCore::PDF_WriteFontDescriptor(const QByteArray& fontName, const ScFa
 	return fontDescriptor;
 }
 
-PdfFont PDFLibCore::PDF_EncodeCidFont(const QByteArray& fontName, ScFace& face, const QByteArray& baseFont, PdfId fontDes, const QMap<uint, QString>& usedGlyphs, const QMap<uint,uint>& glyphmap)
+PdfFont PDFLibCore::PDF_EncodeCidFont(const QByteArray& fontName, ScFace& face, const QByteArray& baseFont, PdfId fontDes, const QMap<uint, QString>& usedGlyphs, const QMap<uint,uint>& glyphmap, QByteArray* widths)
 {
 	PdfFont result;
 	result.name = Pdf::toName(fontName);
@@ -1753,8 +1759,10 @@ PdfFont PDFLibCore::PDF_EncodeCidFont(const QByteArray& fontName, ScFace& face,
 	auto lastIt = std::unique(keys.begin(), keys.end());
 	keys.erase(lastIt, keys.end());
 	bool seenNotDef = false;
-	
-	PutDoc("[ ");
+
+	// Widths of cached subsets are known, glyph metrics are only needed for the ToUnicode map then
+	bool knownWidths = widths && !widths->isEmpty();
+	QByteArray widthArray("[ ");
 	for (auto git = keys.begin(); git != keys.end(); ++git)
 	{
 		uint gid = (result.encoding == Encode_Subset) ? glyphmap.value(*git, 0) : *git;
@@ -1762,7 +1770,8 @@ PdfFont PDFLibCore::PDF_EncodeCidFont(const QByteArray& fontName, ScFace& face,
 			continue;
 		seenNotDef |= (gid == 0);
 
-		PutDoc(Pdf::toPdf(gid) + " [" + Pdf::toPdf(static_cast<int>(face.glyphWidth(*git) * 1000)) + "] ");
+		if (!knownWidths)
+			widthArray += Pdf::toPdf(gid) + " [" + Pdf::toPdf(static_cast<int>(face.glyphWidth(*git) * 1000)) + "] ";
 		QString tmp = QString::asprintf("%04X", gid);
 		QString tmp2;
 
@@ -1788,7 +1797,15 @@ PdfFont PDFLibCore::PDF_EncodeCidFont(const QByteArray& fontName, ScFace& face,
 			toUnicodeMapCounter = 0;
 		}
 	}
-	PutDoc("]");
+	widthArray += "]";
+	if (knownWidths)
+		PutDoc(*widths);
+	else
+	{
+		PutDoc(widthArray);
+		if (widths)
+			*widths = widthArray;
+	}
 	writer.endObj(fontWidths2);
 	if (toUnicodeMapCounter != 0)
 	{
@@ -2082,95 +2099,126 @@ static void dumpCFF(QString name, cff::CFF font)
 
 PdfFont PDFLibCore::PDF_WriteTtfSubsetFont(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs)
 {
-	QByteArray font;
-	face.rawData(font);
-	/*dumpFont(face.psName() + ".ttf", font);*/
 	QList<ScFace::gid_type> glyphs = usedGlyphs.keys();
 	glyphs.removeAll(0);
 	glyphs.prepend(0);
 
-	QMap<uint, uint> glyphMap;
-	QByteArray subset = sfnt::subsetFace(font, glyphs, glyphMap);
+	QByteArray cacheKey = PDF_SubsetFontKey(face, glyphs, "ttf");
+	PdfFontCache::Entry program;
+	if (!fontProgramCache.lookup(cacheKey, program))
+	{
+		QByteArray font;
+		face.rawData(font);
+		/*dumpFont(face.psName() + ".ttf", font);*/
+		// Subsetting adds the components of composite glyphs to the list
+		program.glyphs = glyphs;
+		QByteArray subset = sfnt::subsetFace(font, program.glyphs, program.glyphMap);
+		/*dumpFont(face.psName() + "subs.ttf", subset);*/
+		program.length1 = subset.length();
+		program.fontData = Options.Compress ? CompressArray(subset) : subset;
+	}
 
-	/*dumpFont(face.psName() + "subs.ttf", subset);*/
-	QByteArray baseFont   = sanitizeFontName(face.psName());
-	QByteArray subsetTag  = PDF_GenerateSubsetTag(baseFont, glyphs);
-	QByteArray subsetName = subsetTag + '+' + baseFont;
-	PdfId embeddedFontObj = PDF_EmbedFontObject(subset, QByteArray());
-	PdfId fontDes = PDF_WriteFontDescriptor(subsetName, face, face.format(), embeddedFontObj);
-	
-	PdfFont result = PDF_EncodeCidFont(fontName, face, subsetName, fontDes, usedGlyphs, glyphMap);
-	return result;
+	return PDF_WriteSubsetFontProgram(fontName, face, usedGlyphs, cacheKey, program);
 }
 
 PdfFont PDFLibCore::PDF_WriteCffSubsetFont(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs)
 {
-	QByteArray data;
-	face.rawData(data);
-	QByteArray font = sfnt::getTable(data, "CFF ");
-	/*dumpFont(face.psName() + ".cff", font);*/
-
 	QList<ScFace::gid_type> glyphs = usedGlyphs.keys();
 	glyphs.removeAll(0);
 	glyphs.prepend(0);
 
-	QMap<uint, uint> glyphMap;
-	QByteArray subset = cff::subsetFace(font, glyphs, glyphMap);
-	if (subset.isEmpty())
+	QByteArray cacheKey = PDF_SubsetFontKey(face, glyphs, "cff");
+	PdfFontCache::Entry program;
+	if (!fontProgramCache.lookup(cacheKey, program))
 	{
-		PdfFont result = PDF_WriteType3Font(fontName, face, usedGlyphs);
-		return result;
+		QByteArray data;
+		face.rawData(data);
+		QByteArray font = sfnt::getTable(data, "CFF ");
+		/*dumpFont(face.psName() + ".cff", font);*/
+
+		QByteArray subset = cff::subsetFace(font, glyphs, program.glyphMap);
+		if (subset.isEmpty())
+		{
+			PdfFont result = PDF_WriteType3Font(fontName, face, usedGlyphs);
+			return result;
+		}
+		/*dumpFont(face.psName() + "subs.cff", subset);*/
+		program.subType = "/CIDFontType0C";
+		program.glyphs = glyphs;
+		program.length1 = subset.length();
+		program.fontData = Options.Compress ? CompressArray(subset) : subset;
 	}
 
-	/*dumpFont(face.psName() + "subs.cff", subset);*/
-	QByteArray baseFont   = sanitizeFontName(face.psName());
-	QByteArray subsetTag  = PDF_GenerateSubsetTag(baseFont, glyphs);
-	QByteArray subsetName = subsetTag + '+' + baseFont;
-	PdfId embeddedFontObj = PDF_EmbedFontObject(subset, "/CIDFontType0C");
-	PdfId fontDes = PDF_WriteFontDescriptor(subsetName, face, face.format(), embeddedFontObj);
-	
-	PdfFont result = PDF_EncodeCidFont(fontName, face, subsetName, fontDes, usedGlyphs, glyphMap);
-	return result;
+	return PDF_WriteSubsetFontProgram(fontName, face, usedGlyphs, cacheKey, program);
 }
 
 PdfFont PDFLibCore::PDF_WriteOpenTypeSubsetFont(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs)
 {
-	QByteArray data;
-	face.rawData(data);
 	QList<ScFace::gid_type> glyphs = usedGlyphs.keys();
 	glyphs.removeAll(0);
 	glyphs.prepend(0);
 
-	QMap<uint, uint> glyphMap;
-	QByteArray subset = sfnt::subsetFaceWithHB(data, glyphs, face.faceIndex(), glyphMap);
-	if (subset.isEmpty())
-	{
-		PdfFont result = PDF_WriteType3Font(fontName, face, usedGlyphs);
-		return result;
-	}
-
-	QByteArray subType = "/OpenType";
-	if (!Options.supportsEmbeddedOpenTypeFonts())
+	bool embedOpenType = Options.supportsEmbeddedOpenTypeFonts();
+	QByteArray cacheKey = PDF_SubsetFontKey(face, glyphs, embedOpenType ? "otf" : "otf-cff");
+	PdfFontCache::Entry program;
+	if (!fontProgramCache.lookup(cacheKey, program))
 	{
-		QByteArray cffData = sfnt::getTable(subset, "CFF ");
-		QByteArray cffSubset(cffData.data(), cffData.length());
-		if (cffSubset.isEmpty())
+		QByteArray data;
+		face.rawData(data);
+		QByteArray subset = sfnt::subsetFaceWithHB(data, glyphs, face.faceIndex(), program.glyphMap);
+		if (subset.isEmpty())
 		{
 			PdfFont result = PDF_WriteType3Font(fontName, face, usedGlyphs);
 			return result;
 		}
-		subset = cffSubset;
-		subType = "/CIDFontType0C";
+
+		program.subType = "/OpenType";
+		if (!embedOpenType)
+		{
+			QByteArray cffData = sfnt::getTable(subset, "CFF ");
+			QByteArray cffSubset(cffData.data(), cffData.length());
+			if (cffSubset.isEmpty())
+			{
+				PdfFont result = PDF_WriteType3Font(fontName, face, usedGlyphs);
+				return result;
+			}
+			subset = cffSubset;
+			program.subType = "/CIDFontType0C";
+		}
+		/*dumpFont(face.psName() + "subs.otf", subset);*/
+		program.glyphs = glyphs;
+		program.length1 = subset.length();
+		program.fontData = Options.Compress ? CompressArray(subset) : subset;
 	}
 
-	/*dumpFont(face.psName() + "subs.otf", subset);*/
+	return PDF_WriteSubsetFontProgram(fontName, face, usedGlyphs, cacheKey, program);
+}
+
+QByteArray PDFLibCore::PDF_SubsetFontKey(const ScFace& face, const QList<uint>& glyphs, const QByteArray& subsetType) const
+{
+	QByteArray contentHash = PdfImageCache::fileHash(face.fontFilePath());
+	if (contentHash.isEmpty())
+		return QByteArray();
+
+	QByteArray keyData;
+	QDataStream ks(&keyData, QIODevice::WriteOnly);
+	ks << contentHash << face.faceIndex() << subsetType << Options.Compress << glyphs;
+	return QCryptographicHash::hash(keyData, QCryptographicHash::Sha1);
+}
+
+PdfFont PDFLibCore::PDF_WriteSubsetFontProgram(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs, const QByteArray& cacheKey, PdfFontCache::Entry& program)
+{
 	QByteArray baseFont   = sanitizeFontName(face.psName());
-	QByteArray subsetTag  = PDF_GenerateSubsetTag(baseFont, glyphs);
+	QByteArray subsetTag  = PDF_GenerateSubsetTag(baseFont, program.glyphs);
 	QByteArray subsetName = subsetTag + '+' + baseFont;
-	PdfId embeddedFontObj = PDF_EmbedFontObject(subset, subType);
+	PdfId embeddedFontObj = PDF_EmbedFontStream(program.fontData, program.length1, program.subType);
 	PdfId fontDes = PDF_WriteFontDescriptor(subsetName, face, face.format(), embeddedFontObj);
-	
-	PdfFont result = PDF_EncodeCidFont(fontName, face, subsetName, fontDes, usedGlyphs, glyphMap);
+
+	// Programs from the cache come with their widths, new ones get them here
+	bool isNew = program.widths.isEmpty();
+	PdfFont result = PDF_EncodeCidFont(fontName, face, subsetName, fontDes, usedGlyphs, program.glyphMap, &program.widths);
+	if (isNew)
+		fontProgramCache.store(cacheKey, program);
 	return result;
 }
 
@@ -3496,7 +3544,7 @@ void PDFLibCore::PDF_End_Page()
 			PutPage("Q\n");
 		}
 	}
-	pageData.ObjNum = WritePDFStream(Content);
+	pageData.ObjNum = WritePDFStreamDeferred(Content);
 	int Gobj = 0;
 	if (Options.supportsTransparency())
 	{
@@ -9728,6 +9776,28 @@ PdfId PDFLibCore::WritePDFStream(const QByteArray& cc, PdfId objId)
 	return objId;
 }
 
+PdfId PDFLibCore::WritePDFStreamDeferred(const QByteArray& cc)
+{
+	// Compression and encryption of the stream run on the global thread pool
+	// while the next page is being processed. Pdf::Writer keeps the output
+	// order, so the file is identical to the one written by WritePDFStream().
+	PdfId objId = writer.newObject();
+	bool compress = Options.Compress;
+	QFuture<QByteArray> body = QtConcurrent::run([this, cc, objId, compress]()
+	{
+		QByteArray tmp(cc);
+		if (compress)
+			tmp = CompressArray(tmp);
+		QByteArray result("<< /Length " + Pdf::toPdf(tmp.length()));
+		if (compress)
+			result += "\n/Filter /FlateDecode";
+		result += " >>\nstream\n" + EncStream(tmp, objId) + "\nendstream";
+		return result;
+	});
+	writer.writeDeferredObj(objId, body);
+	return objId;
+}
+
 PdfId PDFLibCore::WritePDFString(const QString& cc)
 {
 	QByteArray tmp;
@@ -10635,14 +10705,33 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 	ImInfo.imageEffects = item->effectsInUse;
 	ImInfo.RequestProps = item->pixm.imgInfo.RequestProps;
 
+	const ShIm* sharedImage = nullptr;
 	auto sharedImageIt = SharedImages.findSuitable(fn, ImInfo);
-	if ((!SharedImages.containsSuitable(fn, ImInfo))
+	if (sharedImageIt != SharedImages.end())
+		sharedImage = &(*sharedImageIt);
+
+	// Bitmap images are also identified by content, so that the same image placed
+	// from different files is written once and encoded streams can be reused
+	// from the image stream cache.
+	QByteArray imageKey;
+	bool cacheableImage = !fromAN && !item->isLatexFrame() && !extensionIndicatesPDF(ext) && !extensionIndicatesEPSorPS(ext);
+	if (!sharedImage && cacheableImage)
+	{
+		imageKey = PDF_ImageCacheKey(item, fn, sx, sy, Profil, Embedded, Intent);
+		auto contentIt = SharedImageContents.constFind(imageKey);
+		if (!imageKey.isEmpty() && (contentIt != SharedImageContents.constEnd()))
+			sharedImage = &(*contentIt);
+	}
+
+	if (!sharedImage
 		|| fromAN
 		|| item->isLatexFrame())
 	{
 		bool imageLoaded = false;
 		bool fatalError  = false;
 		QString pdfFile = fn;
+		PdfImageCache::Entry cachedImage;
+		bool imageFromCache = imageStreamCache.lookup(imageKey, cachedImage);
 		if ((extensionIndicatesPDF(ext) || ((extensionIndicatesEPSorPS(ext)) && (item->pixm.imgInfo.type != ImageType7))) && item->effectsInUse.isEmpty())
 		{
 			if (extensionIndicatesEPSorPS(ext))
@@ -10774,6 +10863,13 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 					ImInfo.sya = sy * (1.0 / ImInfo.reso);
 				}
 			}
+			else if (imageFromCache)
+			{
+				img.imgInfo.colorspace = static_cast<ColorSpaceEnum>(cachedImage.colorSpace);
+				ImInfo.sxa = cachedImage.sxa;
+				ImInfo.sya = cachedImage.sya;
+				ImInfo.reso = 1;
+			}
 			// not PS/PDF
 			else
 			{
@@ -10968,6 +11064,11 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 			img2.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
 			if (item->pixm.imgInfo.type == ImageType7)
 				alphaM = false;
+			else if (imageFromCache)
+			{
+				im2 = cachedImage.maskData;
+				alphaM = !im2.isEmpty();
+			}
 			else
 			{
 				bool gotAlpha = false;
@@ -10985,9 +11086,18 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 				imgE = false;
 			else
 				imgE = !((Options.UseProfiles2) && (img.imgInfo.colorspace != ColorSpaceCMYK));
-			origWidth = img.width();
-			origHeight = img.height();
-			img.applyEffect(item->effectsInUse, item->doc()->PageColors, imgE);
+			if (imageFromCache)
+			{
+				origWidth = cachedImage.maskWidth;
+				origHeight = cachedImage.maskHeight;
+			}
+			else
+			{
+				origWidth = img.width();
+				origHeight = img.height();
+				cachedImage.colorSpace = img.imgInfo.colorspace;
+				img.applyEffect(item->effectsInUse, item->doc()->PageColors, imgE);
+			}
 			if (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / item->imageXScale(), 72.0 / item->imageYScale())))))
 			{
 				ImInfo.sxa = sx * (1.0 / ImInfo.reso);
@@ -11000,7 +11110,9 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 				maskObj = writer.newObject();
 				writer.startObj(maskObj);
 				PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
-				if (Options.CompressMethod != PDFOptions::Compression_None)
+				if (imageFromCache)
+					compAlphaAvail = cachedImage.maskCompressed;
+				else if (Options.CompressMethod != PDFOptions::Compression_None)
 				{
 					QByteArray compAlpha = CompressArray(im2);
 					if (compAlpha.size() > 0)
@@ -11030,14 +11142,18 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 				EncodeArrayToStream(im2, maskObj);
 				PutDoc("\nendstream");
 				writer.endObj(maskObj);
+				cachedImage.maskData = im2;
+				cachedImage.maskCompressed = compAlphaAvail;
 				pageData.ImgObjects[ResNam + "I" + Pdf::toPdf(ResCount)] = maskObj;
 				ResCount++;
 			}
+			int imageWidth = imageFromCache ? cachedImage.width : img.width();
+			int imageHeight = imageFromCache ? cachedImage.height : img.height();
 			PdfId imageObj = writer.newObject();
 			writer.startObj(imageObj);
 			PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
-			PutDoc("/Width " + Pdf::toPdf(img.width()) + "\n");
-			PutDoc("/Height " + Pdf::toPdf(img.height()) + "\n");
+			PutDoc("/Width " + Pdf::toPdf(imageWidth) + "\n");
+			PutDoc("/Height " + Pdf::toPdf(imageHeight) + "\n");
 			enum PDFOptions::PDFCompression compress_method = Options.CompressMethod;
  			enum PDFOptions::PDFCompression cm = Options.CompressMethod;
 			bool exportToCMYK = false;
@@ -11125,6 +11241,11 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 				outType = ColorSpaceMonochrome;
 			else
 				outType = getOutputType(exportToGrayscale, exportToCMYK);
+			if (imageFromCache)
+			{
+				outType = static_cast<ColorSpaceEnum>(cachedImage.outType);
+				cm = static_cast<PDFOptions::PDFCompression>(cachedImage.compression);
+			}
 			if ((outType != ColorSpaceMonochrome) && (doc.HasCMS) && (Options.UseProfiles2) && (!avoidPDFXOutputIntentProf))
 			{
 				PutDoc("/ColorSpace " + ICCProfiles[profInUse].ICCArray + "\n");
@@ -11165,7 +11286,15 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 					PutDoc("/Mask " + Pdf::toPdf(maskObj) + " 0 R\n");
 			}
 			PutDoc(">>\nstream\n");
-			if (cm == PDFOptions::Compression_JPEG) // Fixme: should not do this with monochrome images?
+			bool storeInCache = !imageFromCache && imageStreamCache.isEnabled() && !imageKey.isEmpty();
+			if (storeInCache)
+				writer.startCapture();
+			if (imageFromCache)
+			{
+				if (EncodeArrayToStream(cachedImage.imageData, imageObj))
+					bytesWritten = cachedImage.imageData.size();
+			}
+			else if (cm == PDFOptions::Compression_JPEG) // Fixme: should not do this with monochrome images?
 			{
 				int quality = item->OverrideCompressionQuality ? item->CompressionQualityIndex : Options.Quality;
 				if (item->OverrideCompressionQuality)
@@ -11176,6 +11305,24 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 				bytesWritten = WriteFlateImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
 			else
 				bytesWritten = WriteImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
+			if (storeInCache)
+			{
+				QByteArray imageData = writer.endCapture();
+				if (bytesWritten > 0)
+				{
+					// RC4 is symmetric, encrypting again restores the plain stream
+					cachedImage.imageData = Options.Encrypt ? writer.encryptBytes(imageData, imageObj) : imageData;
+					cachedImage.width = imageWidth;
+					cachedImage.height = imageHeight;
+					cachedImage.outType = outType;
+					cachedImage.compression = cm;
+					cachedImage.sxa = ImInfo.sxa;
+					cachedImage.sya = ImInfo.sya;
+					cachedImage.maskWidth = origWidth;
+					cachedImage.maskHeight = origHeight;
+					imageStreamCache.store(imageKey, cachedImage);
+				}
+			}
 			PutDoc("\nendstream");
 			writer.endObj(imageObj);
 			if (bytesWritten <= 0)
@@ -11188,19 +11335,21 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 			writer.endObj(lengthObj);
 			pageData.ImgObjects[ResNam + "I" + Pdf::toPdf(ResCount)] = imageObj;
 			ImInfo.ResNum = ResCount;
-			ImInfo.Width = img.width();
-			ImInfo.Height = img.height();
+			ImInfo.Width = imageWidth;
+			ImInfo.Height = imageHeight;
 			ImInfo.xa = sx;
 			ImInfo.ya = sy;
 			ImInfo.RequestProps = item->pixm.imgInfo.RequestProps;
 		} // not embedded PDF
 		if (!SharedImages.containsSuitable(fn, ImInfo))
 			SharedImages.insert(fn, ImInfo);
+		if (!imageKey.isEmpty())
+			SharedImageContents.insert(imageKey, ImInfo);
 		ResCount++;
 	}
 	else
 	{
-		ImInfo = *sharedImageIt;
+		ImInfo = *sharedImage;
 		ImInfo.sxa *= sx / ImInfo.xa;
 		ImInfo.sya *= sy / ImInfo.ya;
 	}
@@ -11245,6 +11394,75 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 	return true;
 }
 
+QByteArray PDFLibCore::PDF_ImageCacheKey(const PageItem* item, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent) const
+{
+	QByteArray contentHash = PdfImageCache::fileHash(fn);
+	if (contentHash.isEmpty())
+		return QByteArray();
+
+	QByteArray keyData;
+	QDataStream ks(&keyData, QIODevice::WriteOnly);
+	ks << contentHash;
+	ks << item->pixm.imgInfo.actualPageNumber << static_cast<int>(item->pixm.imgInfo.type) << item->pixm.imgInfo.isRequest;
+	for (auto it = item->pixm.imgInfo.RequestProps.cbegin(); it != item->pixm.imgInfo.RequestProps.cend(); ++it)
+		ks << it.key() << it->visible << it->useMask << it->opacity << it->blend;
+
+	for (const ImageEffect& effect : item->effectsInUse)
+	{
+		ks << effect.effectCode << effect.effectParameters;
+		// Color effects refer to document colors by name on their first lines,
+		// the values of these colors are part of the key so that edits are noticed
+		int colorCount = 0;
+		if (effect.effectCode == ImageEffect::EF_COLORIZE)
+			colorCount = 1;
+		else if (effect.effectCode == ImageEffect::EF_DUOTONE)
+			colorCount = 2;
+		else if (effect.effectCode == ImageEffect::EF_TRITONE)
+			colorCount = 3;
+		else if (effect.effectCode == ImageEffect::EF_QUADTONE)
+			colorCount = 4;
+		const QStringList lines = effect.effectParameters.split('\n');
+		for (int i = 0; i < qMin(colorCount, static_cast<int>(lines.count())); ++i)
+		{
+			const QString& colorName = lines.at(i);
+			if ((colorName == CommonStrings::None) || !doc.PageColors.contains(colorName))
+			{
+				ks << false;
+				continue;
+			}
+			const ScColor color = doc.PageColors.value(colorName);
+			ks << true << static_cast<int>(color.getColorModel()) << color.isSpotColor() << color.isRegistrationColor();
+			double v1 = 0.0, v2 = 0.0, v3 = 0.0, v4 = 0.0;
+			if (color.getColorModel() == colorModelCMYK)
+				color.getCMYK(&v1, &v2, &v3, &v4);
+			else if (color.getColorModel() == colorModelRGB)
+				color.getRGB(&v1, &v2, &v3);
+			else
+				color.getLab(&v1, &v2, &v3);
+			ks << v1 << v2 << v3 << v4;
+		}
+	}
+
+	const CMSData& cms = doc.cmsSettings();
+	ks << doc.HasCMS << Profil << Embedded << static_cast<int>(Intent);
+	ks << cms.DefaultImageRGBProfile << cms.DefaultImageCMYKProfile << cms.BlackPoint;
+	ks << Options.UseRGB << Options.isGrayscale << Options.UseProfiles2 << Options.supportsTransparency();
+	// Input profile selection and the PDF/X-4 output intent check
+	ks << Options.EmbeddedI << Options.ImageProf << Options.PrintProf << static_cast<int>(Options.Version.version());
+	// Printer profile used for the CMYK conversion
+	ks << cms.DefaultPrinterProfile;
+	if (doc.DocPrinterProf)
+		ks << doc.DocPrinterProf.productDescription() << doc.DocPrinterProf.dataHash();
+	ks << static_cast<int>(Options.CompressMethod) << Options.Quality;
+	ks << item->OverrideCompressionMethod << item->CompressionMethodIndex;
+	ks << item->OverrideCompressionQuality << item->CompressionQualityIndex;
+	ks << Options.RecalcPic;
+	if (Options.RecalcPic)
+		ks << Options.PicRes << sx << sy << item->imageXScale() << item->imageYScale();
+
+	return QCryptographicHash::hash(keyData, QCryptographicHash::Sha1);
+}
+
 bool PDFLibCore::PDF_End_Doc(const QString& outputProfilePath)
 {
 	PDF_End_Bookmarks();
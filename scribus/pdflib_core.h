@@ -30,8 +30,9 @@ class PDFOptions;
 class PrefsContext;
 class MultiProgressDialog;
 class ScLayer;
-class ScText;
 
+#include "pdffontcache.h"
+#include "pdfimagecache.h"
 #include "pdfoptions.h"
 #include "pdfstructs.h"
 #include "scribusstructs.h"
@@ -151,11 +152,14 @@ private:
 	PdfFont PDF_WriteTtfSubsetFont(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs);
 	PdfFont PDF_WriteCffSubsetFont(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs);
 	PdfFont PDF_WriteOpenTypeSubsetFont(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs);
+	QByteArray PDF_SubsetFontKey(const ScFace& face, const QList<uint>& glyphs, const QByteArray& subsetType) const;
+	PdfFont PDF_WriteSubsetFontProgram(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs, const QByteArray& cacheKey, PdfFontCache::Entry& program);
 	PdfFont PDF_EncodeSimpleFont(const QByteArray& fontname, ScFace& face,  const QByteArray& baseFont, const QByteArray& subtype, bool isEmbedded, PdfId fontDes, const QMap<uint, QString>& usedGlyphs);
-	PdfFont PDF_EncodeCidFont(const QByteArray& fontname, ScFace& face, const QByteArray& baseFont, PdfId fontDes, const QMap<uint, QString>& usedGlyphs, const QMap<uint, uint>& glyphmap);
+	PdfFont PDF_EncodeCidFont(const QByteArray& fontname, ScFace& face, const QByteArray& baseFont, PdfId fontDes, const QMap<uint, QString>& usedGlyphs, const QMap<uint, uint>& glyphmap, QByteArray* widths = nullptr);
 	PdfFont PDF_EncodeFormFont(const QByteArray& fontname, const ScFace& face,  const QByteArray& baseFont, const QByteArray& subtype, PdfId fontDes);
 	PdfId PDF_EmbedFontObject(const QString& fontName, ScFace &face);
 	PdfId PDF_EmbedFontObject(const QByteArray& font, const QByteArray& subtype);
+	PdfId PDF_EmbedFontStream(const QByteArray& stream, int length1, const QByteArray& subtype);
 	PdfId PDF_EmbedType1AsciiFontObject(const QByteArray& fontData);
 	PdfId PDF_EmbedType1BinaryFontObject(const QByteArray& fontData);
 
@@ -237,6 +241,7 @@ private:
 //	uint       newObject() { return ObjCounter++; }
 	uint       WritePDFStream(const QByteArray& cc);
 	uint       WritePDFStream(const QByteArray& cc, PdfId objId);
+	PdfId      WritePDFStreamDeferred(const QByteArray& cc);
 	uint       WritePDFString(const QString& cc);
 	uint       WritePDFString(const QString& cc, PdfId objId);
 	void       writeXObject(uint objNr, const QByteArray& dictionary, const QByteArray& stream);
@@ -266,6 +271,7 @@ private:
 	void    PDF_xForm(PdfId objNr, double w, double h, const QByteArray& im);
 	bool    PDF_Image(PageItem* c, const QString& fn, double sx, double sy, double x, double y, bool fromAN = false, const QString& Profil = "", bool Embedded = false, eRenderIntent Intent = Intent_Relative_Colorimetric, QByteArray* output = nullptr);
 	bool    PDF_EmbeddedPDF(PageItem* c, const QString& fn, double sx, double sy, double x, double y, ShIm& imgInfo, bool &fatalError);
+	QByteArray PDF_ImageCacheKey(const PageItem* item, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent) const;
 #if HAVE_PODOFO
 	void copyPoDoFoObject(const PoDoFo::PdfObject* obj, PdfId scObjID, QMap<PoDoFo::PdfReference, uint>& importedObjects);
 	void copyPoDoFoDirect(const PoDoFo::PdfObject* obj, QList<PoDoFo::PdfReference>& referencedObjects, QMap<PoDoFo::PdfReference, uint>& importedObjects);
@@ -299,6 +305,9 @@ private:
 	BookmarkView* Bvie { nullptr };
 	//int Dokument;
 	SharedImgRsrc SharedImages;
+	QHash<QByteArray, ShIm> SharedImageContents;
+	PdfImageCache imageStreamCache;
+	PdfFontCache fontProgramCache;
 	QList<PdfDest> NamedDest;
 	QList<PdfId> CalcFields;
 	Pdf::ResourceMap Patterns;
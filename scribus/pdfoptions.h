@@ -131,6 +131,7 @@ public:
 	bool UseSpotColors { true };
 	bool doMultiFile { false };
 	bool openAfterExport { false };
+	bool incrementalUpdate { false };
 	QMap<QString,LPIData> LPISettings;
 	QString SolidProf;
 	int  SComp { 3 };
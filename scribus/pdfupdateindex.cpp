@@ -0,0 +1,93 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "pdfupdateindex.h"
+#include "scpaths.h"
+
+namespace
+{
+	const quint32 indexMagic = 0x53435055; // "SCPU"
+	const quint32 indexVersion = 1;
+	const qint64 tailSize = 1024;
+}
+
+PdfUpdateIndex::PdfUpdateIndex(const QString& pdfFileName)
+	: m_pdfFileName(QFileInfo(pdfFileName).absoluteFilePath())
+{
+}
+
+QString PdfUpdateIndex::indexPath() const
+{
+	QByteArray key = QCryptographicHash::hash(m_pdfFileName.toUtf8(), QCryptographicHash::Sha1).toHex();
+	return ScPaths::applicationDataDir() + "cache/pdf-updates/" + QString::fromLatin1(key);
+}
+
+QByteArray PdfUpdateIndex::fileTail() const
+{
+	QFile file(m_pdfFileName);
+	if (!file.open(QIODevice::ReadOnly))
+		return QByteArray();
+	file.seek(qMax<qint64>(0, file.size() - tailSize));
+	return QCryptographicHash::hash(file.read(tailSize), QCryptographicHash::Sha1);
+}
+
+bool PdfUpdateIndex::load()
+{
+	QFile file(indexPath());
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	quint32 magic = 0;
+	quint32 version = 0;
+	ds >> magic >> version;
+	if ((magic != indexMagic) || (version != indexVersion))
+		return false;
+
+	QByteArray tail;
+	ds >> header >> fileId >> fileSize >> startXRef >> encryptObj >> tail >> objectHashes;
+	if (ds.status() != QDataStream::Ok)
+		return false;
+	if ((QFileInfo(m_pdfFileName).size() != fileSize) || (fileTail() != tail))
+		return false;
+	return !objectHashes.isEmpty() && (startXRef > 0);
+}
+
+bool PdfUpdateIndex::save() const
+{
+	QString path = indexPath();
+	if (!QDir().mkpath(QFileInfo(path).absolutePath()))
+		return false;
+
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	ds << indexMagic << indexVersion;
+	ds << header << fileId << fileSize << startXRef << encryptObj << fileTail() << objectHashes;
+	if (ds.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
+
+void PdfUpdateIndex::remove() const
+{
+	QFile::remove(indexPath());
+}
@@ -0,0 +1,59 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PDFUPDATEINDEX_H
+#define PDFUPDATEINDEX_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+/**
+ * Description of a PDF file as written by the last export, used to append
+ * the next export of the same file as an incremental update.
+ *
+ * The index holds a hash of every indirect object of the file, so that the
+ * next export can tell which objects changed, and what is needed to chain a
+ * new xref section to the file. It is stored in the application data
+ * directory, keyed by the absolute path of the PDF file, together with the
+ * size and a hash of the end of the file: an index is only valid as long as
+ * the file has not been modified or replaced by other means.
+ */
+class PdfUpdateIndex
+{
+public:
+	explicit PdfUpdateIndex(const QString& pdfFileName);
+
+	/**
+	 * Reads the index of the PDF file. Returns false if there is none or if
+	 * the file does not end as it did when the index was saved.
+	 */
+	bool load();
+	bool save() const;
+	/// Removes the stored index, e.g. after the file was written by other means
+	void remove() const;
+
+	/// Bytes before the first object, i.e. the header with the PDF version
+	QByteArray header;
+	/// First element of the file identifier, kept by all updates
+	QByteArray fileId;
+	qint64 fileSize { 0 };
+	/// Offset of the last xref section
+	qint64 startXRef { 0 };
+	/// Object number of the encryption dictionary, 0 if not encrypted
+	uint encryptObj { 0 };
+	/// Hash of each object by object number, empty for free objects
+	QList<QByteArray> objectHashes;
+
+private:
+	QString indexPath() const;
+	QByteArray fileTail() const;
+
+	QString m_pdfFileName;
+};
+
+#endif
@@ -5,7 +5,10 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
+#include <algorithm>
+
 #include <QCryptographicHash>
+#include <QThread>
 
 #include "pdfwriter.h"
 #include "rc4.h"
@@ -457,13 +460,31 @@ namespace Pdf
 		    0x2f, 0x0c, 0xa9, 0xfe, 0x64, 0x53, 0x69, 0x7a };
 		for (int a = 0; a < 32; ++a)
 			m_KeyGen[a] = kg_array[a];
+		m_maxDeferred = qMax(2, QThread::idealThreadCount() * 2);
+	}
+
+	Writer::~Writer()
+	{
+		for (DeferredObj* deferred : std::as_const(m_deferred))
+			deferred->body.waitForFinished();
+		qDeleteAll(m_deferred);
 	}
 	
 	
 	bool Writer::open(const QString& fn)
 	{
-		m_Spool.setFileName(fn);
-		if (!m_Spool.open(QIODevice::WriteOnly))
+		m_fileName = fn;
+		m_previous.reset();
+		if (m_incrementalUpdate)
+		{
+			auto previous = std::make_unique<PdfUpdateIndex>(fn);
+			if (previous->load())
+				m_previous = std::move(previous);
+		}
+		// The previous file stays untouched until the new output is complete,
+		// in incremental mode the output is read back to compare its objects
+		m_Spool.setFileName(m_previous ? fn + ".update" : fn);
+		if (!m_Spool.open(m_incrementalUpdate ? (QIODevice::ReadWrite | QIODevice::Truncate) : QIODevice::WriteOnly))
 			return false;
 		m_outStream.setDevice(&m_Spool);
 		m_ObjCounter = 4;
@@ -482,7 +503,10 @@ namespace Pdf
 	
 	bool Writer::close(bool abortExport)
 	{
+		flushDeferred(true);
 		bool result = (m_Spool.error() == QFile::NoError);
+		if (m_incrementalUpdate && result && !abortExport)
+			return closeIncremental();
 
 		m_Spool.close();
 		if (abortExport || !result)
@@ -496,6 +520,12 @@ namespace Pdf
 	void Writer::setFileId(const QByteArray& id)
 	{
 		m_FileID = QCryptographicHash::hash(id, QCryptographicHash::Md5);
+		// Updates keep the identifier, and so the encryption keys, of the original file
+		if (m_previous && (m_previous->fileId.size() == m_FileID.size()))
+		{
+			m_UpdateID = m_FileID;
+			m_FileID = m_previous->fileId;
+		}
 	}
 	
 	void Writer::setEncryption(bool keyLen16, const QByteArray& PassOwner, const QByteArray& PassUser, int Permissions)
@@ -555,7 +585,7 @@ namespace Pdf
 			data.resize(21);
 		for (int cd = 0; cd < m_KeyLen; ++cd)
 		{
-			data[cd] = m_EncryKey[cd];
+			data[cd] = m_EncryKey.at(cd);
 			dlen++;
 		}
 		data[dlen++] = ObjNum;
@@ -699,6 +729,7 @@ namespace Pdf
 	{
 		QByteArray tmp;
 		uint StX = bytesWritten();
+		m_StartXRef = StX;
 		write("xref\n");
 		write("0 "+Pdf::toPdf(m_ObjCounter)+"\n");
 		//write("0000000000 65535 f \n");
@@ -732,6 +763,151 @@ namespace Pdf
 		write(Pdf::toPdf(StX)+"\n%%EOF\n");
 	}
 	
+	bool Writer::closeIncremental()
+	{
+		// Each object extends up to the next one or to the xref table
+		QList<qint64> starts;
+		for (qint64 offset : std::as_const(m_XRef))
+		{
+			if (offset > 0)
+				starts.append(offset);
+		}
+		starts.append(m_StartXRef);
+		std::sort(starts.begin(), starts.end());
+
+		PdfUpdateIndex index(m_fileName);
+		index.fileId = m_FileID;
+		index.encryptObj = EncryptObj;
+		m_Spool.seek(0);
+		index.header = m_Spool.read(starts.first());
+
+		const QList<QByteArray> noHashes;
+		const QList<QByteArray>& previousHashes = m_previous ? m_previous->objectHashes : noHashes;
+		QList<qint64> ends(m_XRef.count(), 0);
+		QList<PdfId> changed;
+		qint64 changedBytes = 0;
+		PdfId size = qMax(m_XRef.count(), previousHashes.count());
+		for (PdfId id = 0; id < size; ++id)
+		{
+			QByteArray hash;
+			if ((id < static_cast<PdfId>(m_XRef.count())) && (m_XRef[id] > 0))
+			{
+				ends[id] = *std::upper_bound(starts.cbegin(), starts.cend(), m_XRef[id]);
+				hash = hashSpool(m_XRef[id], ends[id]);
+			}
+			index.objectHashes.append(hash);
+			if (hash != previousHashes.value(id))
+			{
+				changed.append(id);
+				changedBytes += ends.value(id) - m_XRef.value(id);
+			}
+		}
+
+		// Replace the file when an update would not be much smaller
+		bool update = m_previous && (index.header == m_previous->header) && (EncryptObj == m_previous->encryptObj) && (changedBytes <= m_StartXRef / 2);
+		if (!update)
+		{
+			bool result = (m_Spool.error() == QFile::NoError);
+			index.fileSize = m_Spool.size();
+			index.startXRef = m_StartXRef;
+			m_Spool.close();
+			if (m_previous)
+				result = result && QFile::remove(m_fileName) && m_Spool.rename(m_fileName);
+			if (result)
+				index.save();
+			else
+			{
+				m_Spool.remove();
+				index.remove();
+			}
+			return result;
+		}
+
+		QFile target(m_fileName);
+		if (!target.open(QIODevice::WriteOnly | QIODevice::Append))
+		{
+			m_Spool.close();
+			m_Spool.remove();
+			return false;
+		}
+		bool result = true;
+		QList<qint64> offsets;
+		for (PdfId id : std::as_const(changed))
+		{
+			offsets.append(ends.value(id) > 0 ? target.pos() : 0);
+			if (ends.value(id) > 0)
+				result = result && copySpool(m_XRef[id], ends[id], target);
+		}
+		qint64 xrefStart = target.pos();
+		QByteArray xref("xref\n");
+		for (int i = 0; i < changed.count(); )
+		{
+			// Subsections of consecutive object numbers
+			int count = 1;
+			while ((i + count < changed.count()) && (changed[i + count] == changed[i] + count))
+				++count;
+			xref += Pdf::toPdf(changed[i]) + " " + Pdf::toPdf(count) + "\n";
+			for (int j = i; j < i + count; ++j)
+			{
+				if (offsets[j] > 0)
+					xref += QByteArray::number(offsets[j]).rightJustified(10, '0') + " 00000 n \n";
+				else
+					xref += "0000000000 65535 f \n";
+			}
+			i += count;
+		}
+		xref += "trailer\n<<\n/Size " + Pdf::toPdf(size) + "\n";
+		xref += "/Root 1 0 R\n/Info 2 0 R\n/ID [" + Pdf::toHexString(m_FileID) + Pdf::toHexString(m_UpdateID.isEmpty() ? m_FileID : m_UpdateID) + "]\n";
+		if (EncryptObj > 0)
+			xref += "/Encrypt " + Pdf::toObjRef(EncryptObj) + "\n";
+		xref += "/Prev " + Pdf::toPdf(m_previous->startXRef) + "\n";
+		xref += ">>\nstartxref\n" + Pdf::toPdf(xrefStart) + "\n%%EOF\n";
+		result = result && (target.write(xref) == xref.size());
+		result = result && (target.error() == QFile::NoError);
+		index.fileSize = target.size();
+		index.startXRef = xrefStart;
+		// Cut a failed update off again, so that the previous export and its index stay valid
+		bool restored = !result && target.resize(m_previous->fileSize);
+		target.close();
+
+		m_Spool.close();
+		m_Spool.remove();
+		// If even that failed the file is in an unknown state, the next export replaces it
+		if (result)
+			index.save();
+		else if (!restored)
+			index.remove();
+		return result;
+	}
+
+	QByteArray Writer::hashSpool(qint64 start, qint64 end)
+	{
+		QCryptographicHash hash(QCryptographicHash::Sha1);
+		m_Spool.seek(start);
+		while (start < end)
+		{
+			QByteArray chunk = m_Spool.read(qMin<qint64>(end - start, 1024 * 1024));
+			if (chunk.isEmpty())
+				break;
+			hash.addData(chunk);
+			start += chunk.size();
+		}
+		return hash.result();
+	}
+
+	bool Writer::copySpool(qint64 start, qint64 end, QIODevice& target)
+	{
+		m_Spool.seek(start);
+		while (start < end)
+		{
+			QByteArray chunk = m_Spool.read(qMin<qint64>(end - start, 1024 * 1024));
+			if (chunk.isEmpty() || (target.write(chunk) != chunk.size()))
+				return false;
+			start += chunk.size();
+		}
+		return true;
+	}
+
 	void Writer::write(const QByteArray& bytes)
 	{
 		m_outStream.writeRawData(bytes, bytes.size());
@@ -792,9 +968,74 @@ namespace Pdf
 		write(">>\n");
 	}
 	
+	void Writer::writeDeferredObj(PdfId id, const QFuture<QByteArray>& body)
+	{
+		assert( m_CurrentObj == 0);
+		flushDeferred(m_deferred.count() >= m_maxDeferred);
+
+		DeferredObj* deferred = new DeferredObj();
+		deferred->id = id;
+		deferred->body = body;
+		deferred->trailing.open(QIODevice::WriteOnly);
+		m_deferred.append(deferred);
+		m_outStream.setDevice(&deferred->trailing);
+	}
+
+	void Writer::flushDeferred(bool wait)
+	{
+		while (!m_deferred.isEmpty())
+		{
+			DeferredObj* deferred = m_deferred.first();
+			if (!wait && !deferred->body.isFinished())
+				break;
+			while (static_cast<uint>(m_XRef.length()) <= deferred->id)
+				m_XRef.append(0);
+			m_XRef[deferred->id] = m_Spool.pos();
+			m_Spool.write(toPdf(deferred->id) + " 0 obj\n");
+			m_Spool.write(deferred->body.result());
+			m_Spool.write("\nendobj\n");
+			qint64 trailingStart = m_Spool.pos();
+			for (const auto& xref : std::as_const(deferred->xrefs))
+				m_XRef[xref.first] = trailingStart + xref.second;
+			m_Spool.write(deferred->trailing.data());
+			m_deferred.removeFirst();
+			if (m_deferred.isEmpty())
+				m_outStream.setDevice(&m_Spool);
+			delete deferred;
+		}
+	}
+
+	void Writer::startCapture()
+	{
+		assert( m_captureDevice == nullptr);
+		m_captureDevice = m_outStream.device();
+		m_capture.setData(QByteArray());
+		m_capture.open(QIODevice::WriteOnly);
+		m_outStream.setDevice(&m_capture);
+	}
+
+	QByteArray Writer::endCapture()
+	{
+		assert( m_captureDevice != nullptr);
+		m_outStream.setDevice(m_captureDevice);
+		m_captureDevice = nullptr;
+		m_capture.close();
+		QByteArray captured = m_capture.data();
+		m_capture.setData(QByteArray());
+		write(captured);
+		return captured;
+	}
+
+	PdfId Writer::objectCounter() const
+	{
+		QMutexLocker locker(&m_ObjCounterMutex);
+		return m_ObjCounter;
+	}
+
 	PdfId Writer::reserveObjects(unsigned int n)
 	{
 		assert( n < (1<<30) ); // should only be triggered by reserveObjects(-1) or similar
+		QMutexLocker locker(&m_ObjCounterMutex);
 		PdfId result = m_ObjCounter;
 		m_ObjCounter += n;
 		return result;
@@ -806,7 +1047,10 @@ namespace Pdf
 		m_CurrentObj = id;
 		while (static_cast<uint>(m_XRef.length()) <= id)
 			m_XRef.append(0);
-		m_XRef[id] = bytesWritten();
+		if (m_deferred.isEmpty())
+			m_XRef[id] = m_Spool.pos();
+		else
+			m_deferred.last()->xrefs.append(qMakePair(id, m_deferred.last()->trailing.pos()));
 		write(toPdf(id));
 		write(" 0 obj\n");
 	}
@@ -9,18 +9,23 @@
 #ifndef Scribus_pdfwriter_h
 #define Scribus_pdfwriter_h
 
+#include <memory>
 #include <type_traits>
 
+#include <QBuffer>
 #include <QByteArray>
 #include <QDataStream>
 #include <QFile>
 #include <QDateTime>
+#include <QFuture>
 #include <QList>
+#include <QMutex>
 #include <QRect>
 #include <QString>
 
 #include "pdfoptions.h"
 #include "pdfstructs.h"
+#include "pdfupdateindex.h"
 #include "pdfversion.h"
 #include "scstreamfilter.h"
 
@@ -148,17 +153,35 @@ namespace Pdf
  * - graphic states
  * - named destinations
  * - form and javascript definitions
+ *
+ * Objects whose content is expensive to produce (e.g. compressed page content
+ * streams) can be handed over as futures with writeDeferredObj(). Everything
+ * written after such an object is buffered in memory until the future is ready,
+ * so the file layout and xref offsets are exactly the same as when writing
+ * synchronously.
+ *
+ * With incremental updates enabled, the objects are compared to those of the
+ * previous export of the same file, see PdfUpdateIndex. If few of them
+ * changed, close() appends only the changed objects to the existing file,
+ * with an xref section and a trailer pointing back to the previous ones.
+ * Otherwise the file is replaced as usual.
  */
 class Writer
 {
 public:
 	Writer();
+	~Writer();
 	
 	// file handling
+	/**
+	 Enables appending changed objects to the file written by the previous export
+	 instead of replacing it. Must be called before open().
+	 */
+	void setIncrementalUpdate(bool incremental) { m_incrementalUpdate = incremental; }
 	bool open (const QString& filename);
 	QDataStream& getOutStream() { return m_outStream; }
 	bool close(bool aborted);
-	qint64 bytesWritten() { return m_Spool.pos(); }
+	qint64 bytesWritten() { flushDeferred(true); return m_Spool.pos(); }
 	
 	// encryption
 	void setFileId(const QByteArray& id);
@@ -173,8 +196,29 @@ public:
 	void write(const QByteArray& bytes);
 	void write(const Pdf::ResourceDictionary& dict);
 
+	/**
+	 Writes indirect object \a id whose body (everything between "obj" and "endobj")
+	 is computed asynchronously, typically by QtConcurrent::run().
+	 */
+	void writeDeferredObj(PdfId id, const QFuture<QByteArray>& body);
+	/**
+	 Writes finished deferred objects and the output buffered behind them to the file.
+	 If \a wait is true, blocks until all pending objects are written.
+	 */
+	void flushDeferred(bool wait);
+	bool hasDeferred() const { return !m_deferred.isEmpty(); }
+
+	/**
+	 Starts recording the bytes written to the output stream, e.g. by stream filters.
+	 */
+	void startCapture();
+	/**
+	 Stops recording, writes the recorded bytes to the output and returns them.
+	 */
+	QByteArray endCapture();
+
 	// objects
-	PdfId objectCounter() const { return m_ObjCounter; }
+	PdfId objectCounter() const;
 	PdfId reserveObjects(unsigned int n);
 	
 	PdfId newObject() { return reserveObjects(1); }
@@ -207,11 +251,24 @@ public:
 	PdfId OpenActionObj { 0 };
 	
 private:
+	struct DeferredObj
+	{
+		PdfId id { 0 };
+		QFuture<QByteArray> body;
+		QBuffer trailing; // output written after this object until the next deferred one
+		QList<QPair<PdfId, qint64> > xrefs; // objects started in trailing, relative offsets
+	};
+
 	PdfId m_ObjCounter { 0 };
 	PdfId m_CurrentObj { 0 };
+	mutable QMutex m_ObjCounterMutex;
 	
 	QFile m_Spool;
 	QDataStream m_outStream;
+	QList<DeferredObj*> m_deferred;
+	int m_maxDeferred { 4 };
+	QBuffer m_capture;
+	QIODevice* m_captureDevice { nullptr };
 	
 	QList<qint64> m_XRef;
 	
@@ -222,6 +279,16 @@ private:
 	QByteArray m_EncryKey;
 	int m_KeyLen { 5 };
 
+	bool m_incrementalUpdate { false };
+	QString m_fileName;
+	std::unique_ptr<PdfUpdateIndex> m_previous; // previous export, if the file can be updated
+	QByteArray m_UpdateID; // second part of the file identifier of an update
+	qint64 m_StartXRef { 0 };
+
+	bool closeIncremental();
+	QByteArray hashSpool(qint64 start, qint64 end);
+	bool copySpool(qint64 start, qint64 end, QIODevice& target);
+
 	void CalcOwnerKey(const QByteArray& Owner, const QByteArray& User);
 	void CalcUserKey(const QByteArray& User, int Permission);
 	QByteArray FitKey(const QByteArray& pass);
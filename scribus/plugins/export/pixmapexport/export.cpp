@@ -22,6 +22,7 @@ for which a new license (GPL+exception) is in place.
 #include "util.h"
 #include "commonstrings.h"
 #include "scpaths.h"
+#include "scpageimageexporter.h"
 
 int scribusexportpixmap_getPluginAPIVersion()
 {
@@ -165,6 +166,8 @@ ExportBitmap::ExportBitmap()
 	exportDir = QDir::currentPath();
 	bitmapType = QString("png");
 	overwrite = false;
+	threads = 0;
+	maxMemory = 0;
 }
 
 QString ExportBitmap::getFileName(ScribusDoc* doc, uint pageNr)
@@ -176,34 +179,30 @@ ExportBitmap::~ExportBitmap()
 {
 }
 
-bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool background, bool single = true)
+void ExportBitmap::setupExporter(ScPageImageExporter& exporter, bool background) const
+{
+	PageToPixmapFlags flags;
+	if (background)
+		flags |= Pixmap_DrawBackground;
+	exporter.setFormat(bitmapType);
+	exporter.setResolution(pageDPI);
+	exporter.setScale(enlargement);
+	exporter.setQuality(quality);
+	exporter.setFlags(flags);
+	exporter.setMaxThreads(threads);
+	if (maxMemory > 0)
+		exporter.setMaxBytesInFlight(static_cast<qint64>(maxMemory) * 1024 * 1024);
+}
+
+bool ExportBitmap::exportPage(ScribusDoc* doc, ScPageImageExporter& exporter, uint pageNr, bool single = true)
 {
 	uint over   = 0;
-	bool saved = false, doFileSave = true;
+	bool doFileSave = true;
 	QString fileName(getFileName(doc, pageNr));
 
 	if (!doc->Pages->at(pageNr))
 		return false;
-	ScPage* page = doc->Pages->at(pageNr);
 
-	/* a little magic here - I need to compute the "maxGr" value...
-	* We need to know the right size of the page for landscape,
-	* portrait and user defined sizes.
-	*/
-	double pixmapSize = (page->height() > page->width()) ? page->height() : page->width();
-	PageToPixmapFlags flags;
-	if (background)
-		flags |= Pixmap_DrawBackground;
-	QImage im(doc->view()->PageToPixmap(pageNr, qRound(pixmapSize * enlargement * (pageDPI / 72.0) / 100.0), flags));
-	if (im.isNull())
-	{
-		ScMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Insufficient memory for this image size."));
-		doc->scMW()->setStatusBarInfoText( tr("Insufficient memory for this image size."));
-		return false;
-	}
-	int dpm = qRound(100.0 / 2.54 * pageDPI);
-	im.setDotsPerMeterY(dpm);
-	im.setDotsPerMeterX(dpm);
 	if (QFile::exists(fileName) && !overwrite)
 	{
 		doFileSave = false;
@@ -222,29 +221,50 @@ bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool background, boo
 		if (over == QMessageBox::YesToAll)
 			overwrite = true;
 	}
-	if (doFileSave)
-		saved = im.save(fileName, bitmapType.toLocal8Bit().constData(), quality);
-	if (!saved && doFileSave)
+	if (!doFileSave)
+		return false;
+	if (!exporter.exportPage(pageNr, fileName))
 	{
-		ScMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Error writing the output file(s)."));
-		doc->scMW()->setStatusBarInfoText( tr("Error writing the output file(s)."));
+		ScMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Insufficient memory for this image size."));
+		doc->scMW()->setStatusBarInfoText( tr("Insufficient memory for this image size."));
+		return false;
 	}
-	return saved;
+	return true;
+}
+
+bool ExportBitmap::waitForExporter(ScribusDoc* doc, ScPageImageExporter& exporter)
+{
+	if (exporter.waitForFinished())
+		return true;
+	ScMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Error writing the output file(s)."));
+	doc->scMW()->setStatusBarInfoText( tr("Error writing the output file(s)."));
+	return false;
 }
 
 bool ExportBitmap::exportCurrent(ScribusDoc* doc,  bool background)
 {
-	return exportPage(doc, doc->currentPageNumber(), background, true);
+	ScPageImageExporter exporter(doc);
+	setupExporter(exporter, background);
+	bool saved = exportPage(doc, exporter, doc->currentPageNumber(), true);
+	return waitForExporter(doc, exporter) && saved;
 }
 
 bool ExportBitmap::exportInterval(ScribusDoc* doc, std::vector<int> &pageNs, bool background)
 {
+	// Pages are rendered here one after the other while the images rendered
+	// before are encoded in the background
+	ScPageImageExporter exporter(doc);
+	setupExporter(exporter, background);
+	bool saved = true;
 	doc->scMW()->mainWindowProgressBar->setMaximum(pageNs.size());
 	for (uint a = 0; a < pageNs.size(); ++a)
 	{
 		doc->scMW()->mainWindowProgressBar->setValue(a);
-		if (!exportPage(doc, pageNs[a]-1, background, false))
-			return false;
+		if (!exportPage(doc, exporter, pageNs[a]-1, false))
+		{
+			saved = false;
+			break;
+		}
 	}
-	return true;
+	return waitForExporter(doc, exporter) && saved;
 }
@@ -13,6 +13,7 @@ for which a new license (GPL+exception) is in place.
 #include <loadsaveplugin.h>
 #include <vector>
 
+class ScPageImageExporter;
 class ScrAction;
 
 class PLUGIN_API PixmapExportPlugin : public ScActionPlugin
@@ -63,6 +64,10 @@ public:
 	bool overwrite;
 	/*! \brief Prefix for filenames */
 	QString filenamePrefix;
+	/*! \brief Number of pages encoded at the same time, 0 for one per processor */
+	int threads;
+	/*! \brief Memory in MB for rendered pages waiting to be encoded, 0 for the default */
+	int maxMemory;
 
 	/*! \brief Exports only the actual page
 	\retval bool true on success */
@@ -74,12 +79,18 @@ public:
 private:
 	/*! \brief create specified filename "docfilename-005.ext" */
 	QString getFileName(ScribusDoc* doc, uint pageNr);
-	/*! \brief export one specified page
+	/*! \brief render one specified page and queue it for writing
+	\param exporter exporter writing the image
 	\param pageNr number of the page
 	\param single bool TRUE if only the one page is exported
 	\retval bool true on success
 	*/
-	bool exportPage(ScribusDoc* doc, uint pageNr, bool background, bool single);
+	bool exportPage(ScribusDoc* doc, ScPageImageExporter& exporter, uint pageNr, bool single);
+	/*! \brief apply the export settings to \a exporter */
+	void setupExporter(ScPageImageExporter& exporter, bool background) const;
+	/*! \brief wait for pages still being written, report errors
+	\retval bool true if all pages were written */
+	bool waitForExporter(ScribusDoc* doc, ScPageImageExporter& exporter);
 };
 
 #endif
@@ -371,6 +371,8 @@ void SVGExPlug::processItemOnPage(double xOffset, double yOffset, PageItem *item
 			break;
 		case PageItem::TextFrame:
 		case PageItem::PathText:
+			if (item->invalid)
+				item->layout();
 			ob = processTextItem(item, trans, fill, stroke);
 			break;
 		case PageItem::Symbol:
@@ -19,7 +19,6 @@ class ScribusDoc;
 class ScribusMainWindow;
 class PageItem;
 class ScPage;
-class ScText;
 
 struct SVGOptions
 {
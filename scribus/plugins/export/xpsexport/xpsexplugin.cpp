@@ -36,6 +36,7 @@ for which a new license (GPL+exception) is in place.
 #include <QUuid>
 
 #include "xpsexplugin.h"
+#include "xpsmasterdictionary.h"
 
 #include "scconfig.h"
 #include "canvas.h"
@@ -230,6 +231,7 @@ bool XPSExPlug::doExport(const QString& fName)
 	imageCounter = 0;
 	fontCounter = 0;
 	xps_fontMap.clear();
+	xps_masterContents.clear();
 	baseDir = dir.path();
 	// Create directory tree
 	QDir outDir(baseDir);
@@ -251,6 +253,7 @@ bool XPSExPlug::doExport(const QString& fName)
 	outDir.cd("Resources");
 	outDir.mkdir("Images");
 	outDir.mkdir("Fonts");
+	outDir.mkdir("MasterPages");
 	outDir.cdUp();
 	writeBaseRel();
 	writeContentType();
@@ -353,6 +356,28 @@ void XPSExPlug::writePages(QDomElement &root)
 
 void XPSExPlug::writePage(QDomElement &doc_root, QDomElement &rel_root, ScPage *Page)
 {
+	int masterIndex = m_Doc->MasterNames[Page->masterPageName()];
+	ScPage *mpage = m_Doc->MasterPages.at(masterIndex);
+	const XPSMasterContent& master = masterContent(masterIndex);
+	if (!master.dictionary.isEmpty())
+	{
+		doc_root.insertBefore(XPSMasterDictionary::pageResources(p_docu, master.dictionary), QDomNode());
+		QDomElement rel = r_docu.createElement("Relationship");
+		rel.setAttribute("Id", QString("rIDm%1").arg(masterIndex));
+		rel.setAttribute("Type", "http://schemas.microsoft.com/xps/2005/06/required-resource");
+		rel.setAttribute("Target", master.dictionary);
+		rel_root.appendChild(rel);
+		// Resources used from a remote dictionary are required resources of the page too
+		for (const XPSResourceInfo& resource : master.resources)
+		{
+			rel = r_docu.createElement("Relationship");
+			rel.setAttribute("Id", resource.id);
+			rel.setAttribute("Type", "http://schemas.microsoft.com/xps/2005/06/required-resource");
+			rel.setAttribute("Target", resource.uri);
+			rel_root.appendChild(rel);
+		}
+		xps_fontRel.unite(master.fonts);
+	}
 	ScLayer ll;
 	ll.isPrintable = false;
 	for (int i = 0; i < m_Doc->Layers.count(); i++)
@@ -360,33 +385,94 @@ void XPSExPlug::writePage(QDomElement &doc_root, QDomElement &rel_root, ScPage *
 		m_Doc->Layers.levelToLayer(ll, i);
 		if (ll.isPrintable)
 		{
-			ScPage *mpage = m_Doc->MasterPages.at(m_Doc->MasterNames[Page->masterPageName()]);
-			writePageLayer(doc_root, rel_root, mpage, ll);
+			writeMasterPageLayer(doc_root, rel_root, mpage, master, ll);
 			writePageLayer(doc_root, rel_root, Page, ll);
 		}
 	}
 }
 
-void XPSExPlug::writePageLayer(QDomElement &doc_root, QDomElement &rel_root, ScPage *page, ScLayer& layer)
+const XPSMasterContent& XPSExPlug::masterContent(int masterIndex)
 {
-	PageItem *item;
-	QList<PageItem*> items;
+	auto it = xps_masterContents.constFind(masterIndex);
+	if (it != xps_masterContents.constEnd())
+		return it.value();
+
+	// Consecutive items other than text frames, which may hold page numbers,
+	// become one visual brush in the resource dictionary of the master page.
+	XPSMasterContent& content = xps_masterContents[masterIndex];
+	ScPage *mpage = m_Doc->MasterPages.at(masterIndex);
 	ScPage* SavedAct = m_Doc->currentPage();
-	if (page->pageNameEmpty())
-		items = m_Doc->DocItems;
-	else
-		items = m_Doc->MasterItems;
-	if (items.count() == 0)
-		return;
-	if (!layer.isPrintable)
-		return;
-	m_Doc->setCurrentPage(page);
-	QDomElement layerGroup = p_docu.createElement("Canvas");
-	if (layer.transparency != 1.0)
-		layerGroup.setAttribute("Opacity", layer.transparency);
-	for (int j = 0; j < items.count(); ++j)
+	m_Doc->setCurrentPage(mpage);
+	QDomElement masterRels = r_docu.createElement("Relationships");
+	QSet<QString> pageFonts;
+	pageFonts.swap(xps_fontRel);
+	QList<QPair<QString, QDomElement> > brushes;
+	ScLayer ll;
+	ll.isPrintable = false;
+	for (int i = 0; i < m_Doc->Layers.count(); i++)
+	{
+		m_Doc->Layers.levelToLayer(ll, i);
+		if (!ll.isPrintable)
+			continue;
+		QList<XPSMasterRun>& runs = content.layers[ll.ID];
+		QDomElement canvas;
+		const QList<PageItem*> items = pageLayerItems(mpage, ll);
+		for (PageItem* item : items)
+		{
+			XPSMasterRun run;
+			if (item->isTextContainer())
+			{
+				run.item = item;
+				runs.append(run);
+				canvas = QDomElement();
+				continue;
+			}
+			if (canvas.isNull())
+			{
+				run.key = QString("mp%1_%2").arg(masterIndex).arg(brushes.count());
+				runs.append(run);
+				canvas = p_docu.createElement("Canvas");
+				brushes.append(qMakePair(run.key, canvas));
+			}
+			writeItemOnPage(item->xPos() - mpage->xOffset(), item->yPos() - mpage->yOffset(), item, canvas, masterRels);
+		}
+	}
+	content.fonts = xps_fontRel;
+	xps_fontRel.swap(pageFonts);
+	m_Doc->setCurrentPage(SavedAct);
+	if (brushes.isEmpty())
+		return content;
+
+	for (QDomElement rel = masterRels.firstChildElement("Relationship"); !rel.isNull(); rel = rel.nextSiblingElement("Relationship"))
+	{
+		XPSResourceInfo resource;
+		resource.id = rel.attribute("Id");
+		resource.uri = rel.attribute("Target");
+		content.resources.append(resource);
+	}
+
+	XPSMasterDictionary dictionary(mpage->width() * conversionFactor, mpage->height() * conversionFactor);
+	for (int i = 0; i < brushes.count(); ++i)
+		dictionary.addBrush(brushes[i].first, brushes[i].second);
+	QString dictName = QString("/Resources/MasterPages/%1.dict").arg(masterIndex);
+	QFile ft(baseDir + dictName);
+	if (ft.open(QIODevice::WriteOnly))
+	{
+		QDataStream s(&ft);
+		QByteArray utf8wr = dictionary.toXml();
+		s.writeRawData(utf8wr.data(), utf8wr.length());
+		ft.close();
+		content.dictionary = dictName;
+	}
+	return content;
+}
+
+QList<PageItem*> XPSExPlug::pageLayerItems(ScPage *page, const ScLayer& layer) const
+{
+	QList<PageItem*> layerItems;
+	const QList<PageItem*>& items = page->pageNameEmpty() ? m_Doc->DocItems : m_Doc->MasterItems;
+	for (PageItem* item : items)
 	{
-		item = items.at(j);
 		if (item->m_layerID != layer.ID)
 			continue;
 		if (!item->printEnabled())
@@ -404,7 +490,51 @@ void XPSExPlug::writePageLayer(QDomElement &doc_root, QDomElement &rel_root, ScP
 			continue;
 		if ((!page->pageNameEmpty()) && (item->OwnPage != static_cast<int>(page->pageNr())) && (item->OwnPage != -1))
 			continue;
+		layerItems.append(item);
+	}
+	return layerItems;
+}
+
+void XPSExPlug::writePageLayer(QDomElement &doc_root, QDomElement &rel_root, ScPage *page, ScLayer& layer)
+{
+	if (!layer.isPrintable)
+		return;
+	const QList<PageItem*> items = pageLayerItems(page, layer);
+	if (items.isEmpty())
+		return;
+	ScPage* SavedAct = m_Doc->currentPage();
+	m_Doc->setCurrentPage(page);
+	QDomElement layerGroup = p_docu.createElement("Canvas");
+	if (layer.transparency != 1.0)
+		layerGroup.setAttribute("Opacity", layer.transparency);
+	for (PageItem* item : items)
 		writeItemOnPage(item->xPos() - page->xOffset(), item->yPos() - page->yOffset(), item, layerGroup, rel_root);
+	doc_root.appendChild(layerGroup);
+	m_Doc->setCurrentPage(SavedAct);
+}
+
+void XPSExPlug::writeMasterPageLayer(QDomElement &doc_root, QDomElement &rel_root, ScPage *mpage, const XPSMasterContent& content, ScLayer& layer)
+{
+	if (!layer.isPrintable)
+		return;
+	const QList<XPSMasterRun> runs = content.layers.value(layer.ID);
+	if (runs.isEmpty())
+		return;
+	ScPage* SavedAct = m_Doc->currentPage();
+	m_Doc->setCurrentPage(mpage);
+	QDomElement layerGroup = p_docu.createElement("Canvas");
+	if (layer.transparency != 1.0)
+		layerGroup.setAttribute("Opacity", layer.transparency);
+	double w = mpage->width() * conversionFactor;
+	double h = mpage->height() * conversionFactor;
+	for (const XPSMasterRun& run : runs)
+	{
+		if (run.item)
+		{
+			writeItemOnPage(run.item->xPos() - mpage->xOffset(), run.item->yPos() - mpage->yOffset(), run.item, layerGroup, rel_root);
+			continue;
+		}
+		layerGroup.appendChild(XPSMasterDictionary::brushPath(p_docu, run.key, w, h));
 	}
 	doc_root.appendChild(layerGroup);
 	m_Doc->setCurrentPage(SavedAct);
@@ -1143,6 +1273,8 @@ void XPSExPlug::processTextItem(double xOffset, double yOffset, PageItem *item,
 		if (grp.hasAttribute("Opacity"))
 			grp2.setAttribute("Opacity", grp.attribute("Opacity"));
 		XPSPainter p(item, grp2, this, xps_fontMap, xps_fontRel, rel_root);
+		if (item->invalid)
+			item->layout();
 		item->textLayout.renderBackground(&p);
 		item->textLayout.render(&p);
 		parentElem.appendChild(grp2);
@@ -16,6 +16,7 @@ for which a new license (GPL+exception) is in place.
 
 #include <QObject>
 #include <QDomElement>
+#include <QList>
 #include <QMap>
 #include <QSet>
 
@@ -30,7 +31,6 @@ class ScribusDoc;
 class ScribusMainWindow;
 class PageItem;
 class ScPage;
-class ScText;
 class ScZipHandler;
 
 struct XPSResourceInfo
@@ -39,6 +39,29 @@ struct XPSResourceInfo
 	QString uri;
 };
 
+/**
+ * Master page item in the drawing order of a layer: either a run of items
+ * shared by all pages, drawn with the brush \a key of the resource dictionary
+ * of the master page, or a text item drawn on each page.
+ */
+struct XPSMasterRun
+{
+	QString key;
+	PageItem* item { nullptr };
+};
+
+/// Content of a master page as written once for all the pages using it
+struct XPSMasterContent
+{
+	/// Part name of the resource dictionary, empty if no item is shared
+	QString dictionary;
+	/// Images and fonts used by the shared items
+	QList<XPSResourceInfo> resources;
+	QSet<QString> fonts;
+	/// Runs of each layer ID
+	QMap<int, QList<XPSMasterRun>> layers;
+};
+
 class PLUGIN_API XPSExportPlugin : public ScActionPlugin
 {
 	Q_OBJECT
@@ -85,6 +108,9 @@ private:
 	void writePages(QDomElement &root);
 	void writePage(QDomElement &doc_root, QDomElement &rel_root, ScPage *Page);
 	void writePageLayer(QDomElement &doc_root, QDomElement &rel_root, ScPage *page, ScLayer& layer);
+	void writeMasterPageLayer(QDomElement &doc_root, QDomElement &rel_root, ScPage *mpage, const XPSMasterContent& content, ScLayer& layer);
+	const XPSMasterContent& masterContent(int masterIndex);
+	QList<PageItem*> pageLayerItems(ScPage *page, const ScLayer& layer) const;
 	void writeItemOnPage(double xOffset, double yOffset, PageItem *Item, QDomElement &parentElem, QDomElement &rel_root);
 	void handleImageFallBack(PageItem *Item, QDomElement &parentElem, QDomElement &rel_root);
 	void processPolyItem(double xOffset, double yOffset, PageItem *Item, QDomElement &parentElem, QDomElement &rel_root);
@@ -128,6 +154,7 @@ private:
 	int fontCounter { 0 };
 	QMap<QString, XPSResourceInfo> xps_fontMap;
 	QSet<QString> xps_fontRel;
+	QMap<int, XPSMasterContent> xps_masterContents;
 	struct txtRunItem
 	{
 		QChar chr;
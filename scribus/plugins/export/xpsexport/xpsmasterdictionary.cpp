@@ -0,0 +1,58 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "xpsmasterdictionary.h"
+
+XPSMasterDictionary::XPSMasterDictionary(double width, double height)
+	: m_docu("xpsdict")
+{
+	m_pageBox = QString("0, 0, %1, %2").arg(width).arg(height);
+	m_docu.setContent(QString("<ResourceDictionary></ResourceDictionary>"));
+	QDomElement droot = m_docu.documentElement();
+	droot.setAttribute("xmlns", "http://schemas.microsoft.com/xps/2005/06");
+	droot.setAttribute("xmlns:x", "http://schemas.microsoft.com/xps/2005/06/resourcedictionary-key");
+}
+
+void XPSMasterDictionary::addBrush(const QString& key, const QDomElement& canvas)
+{
+	QDomElement brush = m_docu.createElement("VisualBrush");
+	brush.setAttribute("x:Key", key);
+	brush.setAttribute("TileMode", "None");
+	brush.setAttribute("ViewboxUnits", "Absolute");
+	brush.setAttribute("ViewportUnits", "Absolute");
+	brush.setAttribute("Viewbox", m_pageBox);
+	brush.setAttribute("Viewport", m_pageBox);
+	QDomElement visual = m_docu.createElement("VisualBrush.Visual");
+	visual.appendChild(m_docu.importNode(canvas, true));
+	brush.appendChild(visual);
+	m_docu.documentElement().appendChild(brush);
+	++m_brushCount;
+}
+
+QByteArray XPSMasterDictionary::toXml() const
+{
+	QString vo = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+	vo += m_docu.toString();
+	return vo.toUtf8();
+}
+
+QDomElement XPSMasterDictionary::pageResources(QDomDocument& doc, const QString& source)
+{
+	QDomElement resources = doc.createElement("FixedPage.Resources");
+	QDomElement dictionary = doc.createElement("ResourceDictionary");
+	dictionary.setAttribute("Source", source);
+	resources.appendChild(dictionary);
+	return resources;
+}
+
+QDomElement XPSMasterDictionary::brushPath(QDomDocument& doc, const QString& key, double width, double height)
+{
+	QDomElement ob = doc.createElement("Path");
+	ob.setAttribute("Data", QString("M 0,0 L %1,0 L %1,%2 L 0,%2 Z").arg(QString::number(width), QString::number(height)));
+	ob.setAttribute("Fill", "{StaticResource " + key + "}");
+	return ob;
+}
@@ -0,0 +1,46 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef XPSMASTERDICTIONARY_H
+#define XPSMASTERDICTIONARY_H
+
+#include <QByteArray>
+#include <QDomDocument>
+#include <QDomElement>
+#include <QString>
+
+/**
+ * Remote resource dictionary holding the content a master page shares
+ * between all pages using it.
+ *
+ * Each run of master page items is stored as a VisualBrush covering the
+ * whole page. Pages refer to the dictionary with pageResources() and paint
+ * the runs in their drawing order with brushPath().
+ */
+class XPSMasterDictionary
+{
+public:
+	/// \a width and \a height are the size of the master page in XPS units
+	XPSMasterDictionary(double width, double height);
+
+	bool isEmpty() const { return m_brushCount == 0; }
+	/// Adds a copy of \a canvas as the brush \a key
+	void addBrush(const QString& key, const QDomElement& canvas);
+	/// Returns the content of the dictionary part
+	QByteArray toXml() const;
+
+	/// Returns the FixedPage.Resources element of \a doc referring to the dictionary part \a source
+	static QDomElement pageResources(QDomDocument& doc, const QString& source);
+	/// Returns a path of \a doc painting a \a width by \a height page with the brush \a key
+	static QDomElement brushPath(QDomDocument& doc, const QString& key, double width, double height);
+
+private:
+	QString m_pageBox;
+	QDomDocument m_docu;
+	int m_brushCount { 0 };
+};
+
+#endif // XPSMASTERDICTIONARY_H
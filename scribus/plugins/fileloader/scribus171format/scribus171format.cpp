@@ -17,8 +17,10 @@ for which a new license (GPL+exception) is in place.
 #include <QFileInfo>
 #include <QList>
 #include <QRegularExpression>
+#include <QScopeGuard>
 #include <QScopedPointer>
 #include <QStringView>
+#include <QTemporaryFile>
 
 #include "../../formatidlist.h"
 #include "commonstrings.h"
@@ -40,6 +42,9 @@ for which a new license (GPL+exception) is in place.
 #include "prefsmanager.h"
 #include "qtiocompressor.h"
 #include "scclocale.h"
+#include "scdocumentpackage.h"
+#include "scimagecachemanager.h"
+#include "scimageprefetcher.h"
 #include "scconfig.h"
 #include "sccolorengine.h"
 #include "scpattern.h"
@@ -72,6 +77,7 @@ Scribus171Format::Scribus171Format()
 
 Scribus171Format::~Scribus171Format()
 {
+	closePackage();
 	unregisterAll();
 }
 
@@ -79,7 +85,7 @@ void Scribus171Format::languageChange()
 {
 	FileFormat* fmt = getFormatByID(FORMATID_SLA171IMPORT);
 	fmt->trName = tr("Scribus 1.7.1+ Document");
-	fmt->filter = fmt->trName + " (*.sla *.SLA *.sla.gz *.SLA.GZ *.scd *.SCD *.scd.gz *.SCD.GZ)";
+	fmt->filter = fmt->trName + " (*.sla *.SLA *.sla.gz *.SLA.GZ *.slaz *.SLAZ *.scd *.SCD *.scd.gz *.SCD.GZ)";
 }
 
 QString Scribus171Format::fullTrName() const
@@ -117,10 +123,10 @@ void Scribus171Format::registerFormats()
 	fmt.load = true;
 	fmt.save = true;
 	fmt.colorReading = true;
-	fmt.filter = fmt.trName + " (*.sla *.SLA *.sla.gz *.SLA.GZ *.scd *.SCD *.scd.gz *.SCD.GZ)";
+	fmt.filter = fmt.trName + " (*.sla *.SLA *.sla.gz *.SLA.GZ *.slaz *.SLAZ *.scd *.SCD *.scd.gz *.SCD.GZ)";
 	fmt.mimeTypes = QStringList();
 	fmt.mimeTypes.append("application/x-scribus");
-	fmt.fileExtensions = QStringList() << "sla" << "sla.gz" << "scd" << "scd.gz";
+	fmt.fileExtensions = QStringList() << "sla" << "sla.gz" << "slaz" << "scd" << "scd.gz";
 	fmt.priority = 64;
 	fmt.nativeScribus = true;
 	registerFormat(fmt);
@@ -128,6 +134,13 @@ void Scribus171Format::registerFormats()
 
 bool Scribus171Format::fileSupported(QIODevice* /* file */, const QString & fileName) const
 {
+	// Packages are only written by 1.7.1+, the document itself is checked when read
+	if (isPackage(fileName))
+	{
+		ScDocumentPackage package;
+		return package.open(fileName) && package.contains(ScDocumentPackage::documentEntry);
+	}
+
 	QByteArray docBytes;
 	if (fileName.right(2) == "gz")
 	{
@@ -145,7 +158,11 @@ bool Scribus171Format::fileSupported(QIODevice* /* file */, const QString & file
 		// Not gzip encoded, just load it
 		loadRawBytes(fileName, docBytes, 1024);
 	}
+	return isSupportedDocument(docBytes);
+}
 
+bool Scribus171Format::isSupportedDocument(const QByteArray& docBytes)
+{
 	int startElemPos = docBytes.left(512).indexOf("<SCRIBUSUTF8NEW ");
 	if (startElemPos < 0)
 		return false;
@@ -193,6 +210,8 @@ bool Scribus171Format::storySupported(const QByteArray& storyData) const
 
 QIODevice* Scribus171Format::slaReader(const QString & fileName)
 {
+	if (isPackage(fileName))
+		return packageReader(fileName);
 	if (!fileSupported(nullptr, fileName))
 		return nullptr;
 
@@ -221,6 +240,92 @@ QIODevice* Scribus171Format::slaReader(const QString & fileName)
 	return ioDevice;
 }
 
+void Scribus171Format::prefetchImages(const QString& fileName, int gsRes, bool useImageCache, ScImagePrefetcher& prefetcher)
+{
+	QString baseDir = QFileInfo(fileName).absolutePath();
+	QFile file(fileName);
+	QtIOCompressor compressor(&file);
+	compressor.setStreamFormat(QtIOCompressor::GzipFormat);
+	QScopedPointer<QIODevice> package(isPackage(fileName) ? packageReader(fileName) : nullptr);
+	if (isPackage(fileName) && !package)
+		return;
+	QIODevice* ioDevice = package ? package.data() : ((fileName.right(2) == "gz") ? static_cast<QIODevice*>(&compressor) : &file);
+	if (!ioDevice->isOpen() && !ioDevice->open(QIODevice::ReadOnly))
+		return;
+
+	// Only attributes are looked at, in the order loadFile() will load the images
+	ScXmlStreamReader reader(ioDevice);
+	while (!reader.atEnd() && !reader.hasError() && !prefetcher.isStopping())
+	{
+		if (reader.readNext() != QXmlStreamReader::StartElement)
+			continue;
+		ScXmlStreamAttributes attrs = reader.scAttributes();
+		int itemType = attrs.hasAttribute("PTYPE") ? attrs.valueAsInt("PTYPE") : attrs.valueAsInt("ItemType", -1);
+		if (itemType != PageItem::ImageFrame)
+			continue;
+		bool inlineImage = attrs.hasAttribute("isInlineImage") ? attrs.valueAsBool("isInlineImage", false) : attrs.valueAsBool("IsInlineImage", false);
+		if (inlineImage)
+			continue;
+		// Low resolution previews are looked up in the image cache first, decoding them here would be wasted
+		if (useImageCache && (attrs.valueAsInt("ImageRes", 1) != 0))
+			continue;
+		QString imageFile = attrs.hasAttribute("PFILE") ? attrs.valueAsString("PFILE") : attrs.valueAsString("ImageFileName");
+		if (imageFile.isEmpty())
+			continue;
+		int page = attrs.hasAttribute("Pagenumber") ? attrs.valueAsInt("Pagenumber", 0) : attrs.valueAsInt("ImagePageNumber", 0);
+		prefetcher.prefetch(QDir::fromNativeSeparators(Relative2Path(imageFile, baseDir)), page, gsRes);
+	}
+}
+
+bool Scribus171Format::isPackage(const QString& fileName)
+{
+	return ScDocumentPackage::isPackage(fileName);
+}
+
+QIODevice* Scribus171Format::packageReader(const QString& fileName)
+{
+	ScDocumentPackage package;
+	if (!package.open(fileName))
+		return nullptr;
+	QScopedPointer<QIODevice> document(package.readDocument());
+	if (!document || !isSupportedDocument(document->peek(1024)))
+		return nullptr;
+	return document.take();
+}
+
+void Scribus171Format::openPackage(const QString& fileName)
+{
+	closePackage();
+	m_package = new ScDocumentPackage();
+	if (!m_package->open(fileName))
+		closePackage();
+}
+
+void Scribus171Format::closePackage()
+{
+	delete m_package;
+	m_package = nullptr;
+}
+
+bool Scribus171Format::readInlineImageEntry(PageItem* item, const QString& entryName, const QString& ext)
+{
+	if (!m_package || !m_package->contains(entryName))
+		return false;
+
+	// The image is streamed from the package to the file the item loads,
+	// without going through the document XML
+	QTemporaryFile tempFile(QDir::tempPath() + "/scribus_temp_XXXXXX." + ext);
+	if (!tempFile.open() || !m_package->readEntry(entryName, &tempFile))
+		return false;
+	tempFile.setAutoRemove(false);
+	tempFile.close();
+
+	item->isInlineImage = true;
+	item->isTempFile = true;
+	item->Pfile = getLongPathName(tempFile.fileName());
+	return true;
+}
+
 QIODevice* Scribus171Format::paletteReader(const QString & fileName)
 {
 	if (!paletteSupported(nullptr, fileName))
@@ -1656,13 +1761,27 @@ bool Scribus171Format::loadFile(const QString & fileName, const FileFormat & /*
 		setFileReadError();
 		return false;
 	}
+	if (isPackage(fileName))
+		openPackage(fileName);
+	auto packageGuard = qScopeGuard([this] { closePackage(); });
 	QString fileDir = QFileInfo(fileName).absolutePath();
 	int firstPage = 0;
 	int layerToSetActive = 0;
-	
+
+	// Decode linked images in the background while the document is parsed
+	int gsRes = PrefsManager::instance().gsResolution();
+	bool useImageCache = ScImageCacheManager::instance().enabled();
+	ScImagePrefetcher::instance().startBatch([fileName, gsRes, useImageCache](ScImagePrefetcher& prefetcher) {
+		prefetchImages(fileName, gsRes, useImageCache, prefetcher);
+	});
+	auto prefetchGuard = qScopeGuard([] { ScImagePrefetcher::instance().finishBatch(); });
+
+	// The document is decompressed and parsed in a single pass, progress is
+	// measured on the file itself as a gzip stream does not know its size
+	QIODevice* fileDevice = ioDevice->isSequential() ? &aFile : ioDevice.data();
 	if (m_mwProgressBar != nullptr)
 	{
-		m_mwProgressBar->setMaximum(ioDevice->size());
+		m_mwProgressBar->setMaximum(fileDevice->size());
 		m_mwProgressBar->setValue(0);
 	}
 	// Stop autosave timer,it will be restarted only if doc has autosave feature is enabled
@@ -1710,11 +1829,14 @@ bool Scribus171Format::loadFile(const QString & fileName, const FileFormat & /*
 
 		if (m_mwProgressBar != nullptr)
 		{
-			int newProgress = qRound(ioDevice->pos() / (double) ioDevice->size() * 100);
+			int newProgress = qRound(fileDevice->pos() / (double) fileDevice->size() * 100);
 			if (newProgress != progress)
 			{
-				m_mwProgressBar->setValue(reader.characterOffset());
+				m_mwProgressBar->setValue(fileDevice->pos());
 				progress = newProgress;
+				// Only the progress bar is painted, running the event loop
+				// here could let other events act on the half-loaded document
+				m_mwProgressBar->repaint();
 			}
 		}
 
@@ -2434,7 +2556,7 @@ bool Scribus171Format::loadFile(const QString & fileName, const FileFormat & /*
 //	m_Doc->autoSaveTimer->start(m_Doc->autoSaveTime());
 
 	if (m_mwProgressBar != nullptr)
-		m_mwProgressBar->setValue(reader.characterOffset());
+		m_mwProgressBar->setValue(fileDevice->size());
 	return true;
 }
 
@@ -4240,6 +4362,7 @@ bool Scribus171Format::readPDFOptions(ScribusDoc* doc, ScXmlStreamReader& reader
 	doc->pdfOptions().hideToolBar = attrs.valueAsBool("hideToolBar", false);
 	doc->pdfOptions().fitWindow = attrs.valueAsBool("fitWindow", false);
 	doc->pdfOptions().openAfterExport = attrs.valueAsBool("openAfterExport", false);
+	doc->pdfOptions().incrementalUpdate = attrs.valueAsBool("incrementalUpdate", false);
 	doc->pdfOptions().PageLayout = attrs.valueAsInt("PageLayout", 0);
 	doc->pdfOptions().openAction = attrs.valueAsString("openAction", "");
 
@@ -6227,8 +6350,11 @@ PageItem* Scribus171Format::pasteItem(ScribusDoc *doc, const ScXmlStreamAttribut
 				inlineF = attrs.valueAsBool("isInlineImage", false);
 			else
 				inlineF = attrs.valueAsBool("IsInlineImage", false);
-			QString dat = attrs.valueAsString("ImageData", "");
-			QByteArray inlineImageData(dat.toUtf8());
+			// Base64 is plain ASCII, convert straight from the attribute instead of
+			// holding a UTF-16 copy of what may be several megabytes of image data
+			QByteArray inlineImageData(attrs.value(QLatin1String("ImageData")).toLatin1());
+			// Packages store inline images as separate entries
+			QString inlineImageEntry(attrs.valueAsString("ImageDataEntry", ""));
 			QString inlineImageExt;
 			//Remove lowercase in 1.8
 			if (attrs.hasAttribute("inlineImageExt"))
@@ -6237,7 +6363,9 @@ PageItem* Scribus171Format::pasteItem(ScribusDoc *doc, const ScXmlStreamAttribut
 				inlineImageExt = attrs.valueAsString("InlineImageExt", "");
 			if (inlineF)
 			{
-				if (inlineImageData.size() > 0)
+				if (!inlineImageEntry.isEmpty())
+					readInlineImageEntry(currItem, inlineImageEntry, inlineImageExt);
+				else if (inlineImageData.size() > 0)
 					currItem->setInlineData(inlineImageData, inlineImageExt);
 			}
 			else
@@ -8160,6 +8288,9 @@ bool Scribus171Format::loadPage(const QString & fileName, int pageNumber, bool M
 		setFileReadError();
 		return false;
 	}
+	if (isPackage(fileName))
+		openPackage(fileName);
+	auto packageGuard = qScopeGuard([this] { closePackage(); });
 
 	QString fileDir = QFileInfo(fileName).absolutePath();
 	
@@ -25,6 +25,9 @@ class QIODevice;
 class  ColorList;
 class  MultiLine;
 class  PageItem_NoteFrame;
+class  ScDocumentPackage;
+class  ScDocumentSaveJob;
+class  ScImagePrefetcher;
 class  ScLayer;
 class  ScribusDoc;
 //struct ScribusDoc::BookMa;
@@ -55,6 +58,7 @@ class PLUGIN_API Scribus171Format : public LoadSavePlugin
 
 		bool loadFile(const QString & fileName, const FileFormat & fmt, int flags, int index = 0) override;
 		bool saveFile(const QString & fileName, const FileFormat & fmt) override;
+		ScDocumentSaveJob* saveFileInBackground(const QString & fileName, const FileFormat & fmt) override;
 		
 		bool loadPalette(const QString & fileName) override;
 		bool savePalette(const QString & fileName) override;
@@ -120,6 +124,22 @@ class PLUGIN_API Scribus171Format : public LoadSavePlugin
 		QIODevice* slaReader(const QString & fileName);
 		QIODevice* paletteReader(const QString & fileName);
 
+		/// Packages are zip files holding the document and its inline images as separate entries
+		static bool isPackage(const QString& fileName);
+		static bool isSupportedDocument(const QByteArray& docBytes);
+		/// Reads the document entry of package \a fileName, returns nullptr if it is not a 1.7.1+ document
+		static QIODevice* packageReader(const QString& fileName);
+		void openPackage(const QString& fileName);
+		void closePackage();
+		/// Extracts the inline image \a entryName of the package being loaded to a temporary file of \a item
+		bool readInlineImageEntry(PageItem* item, const QString& entryName, const QString& ext);
+
+		/**
+		 * Queues the images linked from document \a fileName in \a prefetcher, runs in a background thread.
+		 * Low resolution previews are skipped if \a useImageCache is set, they are looked up in the image cache.
+		 */
+		static void prefetchImages(const QString& fileName, int gsRes, bool useImageCache, ScImagePrefetcher& prefetcher);
+
 		void getStyle(ParagraphStyle& style, ScXmlStreamReader& reader, StyleSet<ParagraphStyle> *docParagraphStyles, ScribusDoc* doc, bool equiv);
 		void getStyle(CharStyle& style, ScXmlStreamReader& reader, StyleSet<CharStyle> *docCharStyles, ScribusDoc* doc, bool equiv);
 
@@ -188,6 +208,10 @@ class PLUGIN_API Scribus171Format : public LoadSavePlugin
 
 		PageItem* pasteItem(ScribusDoc *doc, const ScXmlStreamAttributes& attrs, const QString& baseDir, PageItem::ItemKind itemKind, int pageNr = -2 /* currentPage*/);
 
+		static QString documentDir(const QString& fileName);
+		void serializeDocument(ScDocumentSaveJob* saveJob, const QString& fileDir);
+		bool savePackage(const QString& fileName);
+		void writeDocument(ScXmlStreamWriter& docu, const QString& fileDir);
 		void writeCheckerProfiles(ScXmlStreamWriter& docu) const;
 		void writeLineStyles(ScXmlStreamWriter& docu) const;
 		void writeLineStyles(ScXmlStreamWriter& docu, const QStringList& styleNames) const;
@@ -235,6 +259,7 @@ class PLUGIN_API Scribus171Format : public LoadSavePlugin
 		void WritePages(ScribusDoc *doc, ScXmlStreamWriter& docu, QProgressBar *dia2, uint maxC, bool master) const;
 		void WriteObjects(ScribusDoc *doc, ScXmlStreamWriter& docu, const QString& baseDir, QProgressBar *dia2, uint maxC, ItemSelection master, QList<PageItem*> *items = 0) const;
 		void SetItemProps(ScXmlStreamWriter& docu, PageItem* item, const QString& baseDir) const;
+		void writeInlineImageData(ScXmlStreamWriter& docu, const PageItem* item) const;
 		
 		QMap<QString, QString> charStyleMap;
 		QMap<QString, QString> parStyleMap;
@@ -251,6 +276,8 @@ class PLUGIN_API Scribus171Format : public LoadSavePlugin
 
 		QFile aFile;
 		QString clipPath;
+		QString m_packageDir; ///< Directory collecting the package entries while saving a package
+		ScDocumentPackage* m_package {nullptr}; ///< Package being loaded
 		bool isNewFormat {false};
 		bool layerFound {false};
 		double GrX {0.0};
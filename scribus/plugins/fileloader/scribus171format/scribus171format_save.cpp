@@ -7,15 +7,16 @@ for which a new license (GPL+exception) is in place.
 #include "scribus171format.h"
 #include "scribus171formatimpl.h"
 
-#include <ctime>
 #include <memory>
 #include <utility>
 
 #include <QCursor>
+#include <QDir>
 #include <QFileInfo>
 #include <QList>
 #include <QDataStream>
 #include <QScopedPointer>
+#include <QTemporaryDir>
 
 #include "../../formatidlist.h"
 
@@ -34,9 +35,10 @@ for which a new license (GPL+exception) is in place.
 #include "pageitem_table.h"
 #include "pagesize.h"
 #include "prefsmanager.h"
-#include "qtiocompressor.h"
 #include "resourcecollection.h"
 #include "scconfig.h"
+#include "scdocumentpackage.h"
+#include "scdocumentsavejob.h"
 #include "scpaths.h"
 #include "scpattern.h"
 #include "scribusdoc.h"
@@ -277,10 +279,36 @@ bool Scribus171Format::savePalette(const QString & fileName)
 	return writeSucceed;
 }
 
-bool Scribus171Format::saveFile(const QString & fileName, const FileFormat & /* fmt */)
+bool Scribus171Format::saveFile(const QString & fileName, const FileFormat & fmt)
 {
 	m_lastSavedFile = "";
+	if (isPackage(fileName))
+		return savePackage(fileName);
 
+	std::unique_ptr<ScDocumentSaveJob> saveJob(saveFileInBackground(fileName, fmt));
+	if (!saveJob)
+		return false;
+	bool writeSucceed = saveJob->waitForFinished();
+	m_lastSavedFile = saveJob->savedFileName();
+	return writeSucceed;
+}
+
+ScDocumentSaveJob* Scribus171Format::saveFileInBackground(const QString & fileName, const FileFormat & /* fmt */)
+{
+	// Packages can only be zipped once all their entries are written
+	if (isPackage(fileName))
+		return nullptr;
+
+	auto* saveJob = new ScDocumentSaveJob(fileName, fileName.toLower().right(2) == "gz");
+#ifdef Q_OS_UNIX
+	saveJob->setPermissions(m_Doc->filePermissions());
+#endif
+	serializeDocument(saveJob, documentDir(fileName));
+	return saveJob;
+}
+
+QString Scribus171Format::documentDir(const QString& fileName)
+{
 	// #11279: Image links get corrupted when symlinks involved
 	// We have to proceed in tow steps here as QFileInfo::canonicalPath()
 	// may not return correct result if fileName does not exists
@@ -288,38 +316,49 @@ bool Scribus171Format::saveFile(const QString & fileName, const FileFormat & /*
 	QString canonicalPath = QFileInfo(fileDir).canonicalFilePath();
 	if (!canonicalPath.isEmpty())
 		fileDir = canonicalPath;
+	return fileDir;
+}
 
-	// Create a random temporary file name
-	srand(time(nullptr)); // initialize random sequence each time
-	long randt = 0;
-	long randn = 1 + (int) (((double) rand() / ((double) RAND_MAX + 1)) * 10000);
-	QString  tmpFileName  = QString("%1.%2").arg(fileName).arg(randn);
-	while (QFile::exists(tmpFileName) && (randt < 100))
-	{
-		randn = 1 + (int) (((double) rand() / ((double) RAND_MAX + 1)) * 10000);
-		tmpFileName = QString("%1.%2").arg(fileName).arg(randn);
-		++randt;
-	}
-	if (QFile::exists(tmpFileName))
-		return false;
+void Scribus171Format::serializeDocument(ScDocumentSaveJob* saveJob, const QString& fileDir)
+{
+	// The document is serialized here, compression and writing to disk
+	// are done by the job while serialization goes on
+	saveJob->start();
 
-	QScopedPointer<QIODevice> outputFile;
-	if (fileName.toLower().right(2) == "gz")
-	{
-		aFile.setFileName(tmpFileName);
-		QtIOCompressor *compressor = new QtIOCompressor(&aFile);
-		compressor->setStreamFormat(QtIOCompressor::GzipFormat);
-		outputFile.reset(compressor);
-	}
-	else
-		outputFile.reset( new QFile(tmpFileName) );
+	ScXmlStreamWriter docu;
+	docu.setAutoFormatting(true);
+	docu.setDevice(saveJob->device());
+	writeDocument(docu, fileDir);
+	saveJob->endSnapshot(!docu.hasError());
+}
 
-	if (!outputFile->open(QIODevice::WriteOnly))
+bool Scribus171Format::savePackage(const QString& fileName)
+{
+	// Entries are collected in a directory which is zipped once complete
+	QTemporaryDir packageDir(ScPaths::tempFileDir() + "/scribus_package_XXXXXX");
+	if (!packageDir.isValid())
 		return false;
 
-	ScXmlStreamWriter docu;
-	docu.setAutoFormatting(true);
-	docu.setDevice(outputFile.data());
+	m_packageDir = packageDir.path();
+	ScDocumentSaveJob saveJob(packageDir.filePath(ScDocumentPackage::documentEntry), false);
+	serializeDocument(&saveJob, documentDir(fileName));
+	bool writeSucceed = saveJob.waitForFinished();
+	m_packageDir.clear();
+	if (!writeSucceed)
+		return false;
+
+	writeSucceed = ScDocumentPackage::write(packageDir.path(), fileName);
+	if (writeSucceed)
+		m_lastSavedFile = fileName;
+#ifdef Q_OS_UNIX
+	if (writeSucceed)
+		QFile::setPermissions(fileName, m_Doc->filePermissions());
+#endif
+	return writeSucceed;
+}
+
+void Scribus171Format::writeDocument(ScXmlStreamWriter & docu, const QString& fileDir)
+{
 	docu.writeStartDocument();
 	docu.writeStartElement("SCRIBUSUTF8NEW");
 	docu.writeAttribute("Version", ScribusAPI::getVersion());
@@ -550,31 +589,6 @@ bool Scribus171Format::saveFile(const QString & fileName, const FileFormat & /*
 
 	docu.writeEndElement();
 	docu.writeEndDocument();
-
-	bool  writeSucceed = false;
-	const QFile* qFile = qobject_cast<QFile*>(outputFile.data());
-	if (qFile)
-		writeSucceed = (qFile->error() == QFile::NoError);
-	else
-		writeSucceed = true;
-	outputFile->close();
-	if (writeSucceed)
-	{
-		if (QFile::exists(fileName))
-			writeSucceed = QFile::remove(fileName) ? QFile::rename(tmpFileName, fileName) : false;
-		else
-			writeSucceed = QFile::rename(tmpFileName, fileName);
-		m_lastSavedFile = writeSucceed ? fileName : tmpFileName;
-	}
-	else if (QFile::exists(tmpFileName))
-		QFile::remove(tmpFileName);
-	if (writeSucceed)
-		QFile::remove(tmpFileName);
-#ifdef Q_OS_UNIX
-	if (writeSucceed)
-		QFile::setPermissions(fileName, m_Doc->filePermissions());
-#endif
-	return writeSucceed;
 }
 
 void Scribus171Format::writeCheckerProfiles(ScXmlStreamWriter & docu) const
@@ -1374,6 +1388,7 @@ void Scribus171Format::writePdfOptions(ScXmlStreamWriter & docu) const
 	docu.writeAttribute("hideToolBar", static_cast<int>(m_Doc->pdfOptions().hideToolBar));
 	docu.writeAttribute("fitWindow", static_cast<int>(m_Doc->pdfOptions().fitWindow));
 	docu.writeAttribute("openAfterExport", static_cast<int>(m_Doc->pdfOptions().openAfterExport));
+	docu.writeAttribute("incrementalUpdate", static_cast<int>(m_Doc->pdfOptions().incrementalUpdate));
 	docu.writeAttribute("PageLayout", m_Doc->pdfOptions().PageLayout);
 	docu.writeAttribute("openAction", m_Doc->pdfOptions().openAction);
 
@@ -2699,6 +2714,30 @@ void Scribus171Format::WriteObjects(ScribusDoc *doc, ScXmlStreamWriter& docu, co
 	}
 }
 
+void Scribus171Format::writeInlineImageData(ScXmlStreamWriter& docu, const PageItem* item) const
+{
+	QFileInfo inlFi(item->Pfile);
+	docu.writeAttribute("InlineImageExt", inlFi.suffix());
+	if (!m_packageDir.isEmpty())
+	{
+		// Packages store the image file as is, the document only references it.
+		// If the file can't be added to the package, it is embedded as usual.
+		QString entryName = ScDocumentPackage::addImageEntry(m_packageDir, item->Pfile);
+		if (!entryName.isEmpty())
+		{
+			docu.writeAttribute("ImageDataEntry", entryName);
+			return;
+		}
+	}
+	QFile inFil(item->Pfile);
+	if (inFil.open(QIODevice::ReadOnly))
+	{
+		QByteArray ba = qCompress(inFil.readAll()).toBase64();
+		docu.writeAttribute("ImageData", QString(ba));
+		inFil.close();
+	}
+}
+
 void Scribus171Format::SetItemProps(ScXmlStreamWriter& docu, PageItem* item, const QString& baseDir) const
 {
 	docu.writeAttribute("OwnPage", item->OwnPage);
@@ -2874,15 +2913,7 @@ void Scribus171Format::SetItemProps(ScXmlStreamWriter& docu, PageItem* item, con
 		{
 			docu.writeAttribute("ImageFileName", "");
 			docu.writeAttribute("IsInlineImage", static_cast<int>(item->isInlineImage));
-			QFileInfo inlFi(item->Pfile);
-			docu.writeAttribute("InlineImageExt", inlFi.suffix());
-			QFile inFil(item->Pfile);
-			if (inFil.open(QIODevice::ReadOnly))
-			{
-				QByteArray ba = qCompress(inFil.readAll()).toBase64();
-				docu.writeAttribute("ImageData", QString(ba));
-				inFil.close();
-			}
+			writeInlineImageData(docu, item);
 		}
 		else
 			docu.writeAttribute("ImageFileName", Path2Relative(item->Pfile, baseDir));
@@ -2894,15 +2925,7 @@ void Scribus171Format::SetItemProps(ScXmlStreamWriter& docu, PageItem* item, con
 		{
 			docu.writeAttribute("ImageFileName", "");
 			docu.writeAttribute("IsInlineImage", static_cast<int>(item->isInlineImage));
-			QFileInfo inlFi(item->Pfile);
-			docu.writeAttribute("InlineImageExt", inlFi.suffix());
-			QFile inFil(item->Pfile);
-			if (inFil.open(QIODevice::ReadOnly))
-			{
-				QByteArray ba = qCompress(inFil.readAll()).toBase64();
-				docu.writeAttribute("ImageData", QString(ba));
-				inFil.close();
-			}
+			writeInlineImageData(docu, item);
 			PageItem_OSGFrame *osgframe = item->asOSGFrame();
 			docu.writeAttribute("ModelFile", Path2Relative(osgframe->modelFile, baseDir));
 			docu.writeAttribute("CurrentViewName", osgframe->currentView);
@@ -6,6 +6,7 @@ for which a new license (GPL+exception) is in place.
 */
 #include "objimageexport.h"
 
+#include <QDir>
 #include <QImageWriter>
 #include <structmember.h>
 #include <QFileInfo>
@@ -14,9 +15,11 @@ for which a new license (GPL+exception) is in place.
 #include "cmdutil.h"
 #include "pyesstring.h"
 #include "scpage.h"
+#include "scpageimageexporter.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
+#include "util.h"
 
 struct ImageExport
 {
@@ -28,6 +31,8 @@ struct ImageExport
 	int scale; // how is bitmap scaled 100 = 100%
 	int quality; // quality/compression <1; 100>
 	int transparentBkgnd; // background transparency
+	int threads; // number of pages encoded at the same time, 0 = one per processor
+	int maxMemory; // MB of rendered pages waiting to be encoded, 0 = default
 };
 
 static void ImageExport_dealloc(ImageExport* self)
@@ -53,6 +58,8 @@ static PyObject * ImageExport_new(PyTypeObject *type, PyObject * /*args*/, PyObj
 		self->scale = 100;
 		self->quality = 100;
 		self->transparentBkgnd = 0;
+		self->threads = 0;
+		self->maxMemory = 0;
 	}
 	return (PyObject *) self;
 }
@@ -67,6 +74,8 @@ static PyMemberDef ImageExport_members[] = {
 	{ "scale", T_INT, offsetof(ImageExport, scale), 0, imgexp_scale__doc__ },
 	{ "quality", T_INT, offsetof(ImageExport, quality), 0, imgexp_quality__doc__ },
 	{ "transparentBkgnd", T_INT, offsetof(ImageExport, transparentBkgnd), 0, imgexp_transparentBkgnd__doc__ },
+	{ "threads", T_INT, offsetof(ImageExport, threads), 0, imgexp_threads__doc__ },
+	{ "maxMemory", T_INT, offsetof(ImageExport, maxMemory), 0, imgexp_maxMemory__doc__ },
 	{ nullptr, 0, 0, 0, nullptr } // sentinel
 };
 
@@ -142,30 +151,30 @@ static PyGetSetDef ImageExport_getseters [] = {
 	{ nullptr, nullptr, nullptr, nullptr, nullptr }  // sentinel
 };
 
-static PyObject *ImageExport_save(ImageExport *self)
+static void ImageExport_setupExporter(ImageExport *self, ScPageImageExporter& exporter)
 {
-	if (!checkHaveDocument())
-		return nullptr;
-
-	ScribusDoc*  doc = ScCore->primaryMainWindow()->doc;
-	ScribusView*view = ScCore->primaryMainWindow()->view;
-	ScPage* page = doc->currentPage();
-
-	/* a little magic here - I need to compute the "maxGr" value...
-	* We need to know the right size of the page for landscape,
-	* portrait and user defined sizes.
-	*/
-	double pixmapSize = (page->height() > page->width()) ? page->height() : page->width();
 	PageToPixmapFlags flags = Pixmap_DrawBackground;
 	if (self->transparentBkgnd)
 		flags &= ~Pixmap_DrawBackground;
-	QImage im = view->PageToPixmap(page->pageNr(), qRound(pixmapSize * self->scale * (self->dpi / 72.0) / 100.0), flags);
-	int dpi = qRound(100.0 / 2.54 * self->dpi);
-	im.setDotsPerMeterY(dpi);
-	im.setDotsPerMeterX(dpi);
+	exporter.setFormat(QString::fromUtf8(PyUnicode_AsUTF8(self->type)));
+	exporter.setResolution(self->dpi);
+	exporter.setScale(self->scale);
+	exporter.setQuality(self->quality);
+	exporter.setFlags(flags);
+	exporter.setMaxThreads(self->threads);
+	if (self->maxMemory > 0)
+		exporter.setMaxBytesInFlight(static_cast<qint64>(self->maxMemory) * 1024 * 1024);
+}
 
-	QString imgFileName = PyUnicode_asQString(self->name);
-	if (!im.save(imgFileName, PyUnicode_AsUTF8(self->type), self->quality))
+static PyObject *ImageExport_saveCurrentPage(ImageExport *self, const QString& fileName)
+{
+	ScribusDoc*  doc = ScCore->primaryMainWindow()->doc;
+	ScPage* page = doc->currentPage();
+
+	ScPageImageExporter exporter(doc);
+	ImageExport_setupExporter(self, exporter);
+	bool rendered = exporter.exportPage(page->pageNr(), fileName);
+	if (!exporter.waitForFinished() || !rendered)
 	{
 		PyErr_SetString(ScribusException, QObject::tr("Failed to export image", "python error").toUtf8().constData());
 		return nullptr;
@@ -173,6 +182,14 @@ static PyObject *ImageExport_save(ImageExport *self)
 	return PyBool_FromLong(static_cast<long>(true));
 }
 
+static PyObject *ImageExport_save(ImageExport *self)
+{
+	if (!checkHaveDocument())
+		return nullptr;
+
+	return ImageExport_saveCurrentPage(self, PyUnicode_asQString(self->name));
+}
+
 static PyObject *ImageExport_saveAs(ImageExport *self, PyObject *args)
 {
 	PyESString value;
@@ -181,25 +198,62 @@ static PyObject *ImageExport_saveAs(ImageExport *self, PyObject *args)
 	if (!PyArg_ParseTuple(args, "es", "utf-8", value.ptr()))
 		return nullptr;
 
-	ScribusDoc*  doc = ScCore->primaryMainWindow()->doc;
-	ScribusView*view = ScCore->primaryMainWindow()->view;
-	ScPage* page = doc->currentPage();
+	return ImageExport_saveCurrentPage(self, QString::fromUtf8(value.c_str()));
+}
 
-	/* a little magic here - I need to compute the "maxGr" value...
-	* We need to know the right size of the page for landscape,
-	* portrait and user defined sizes.
-	*/
-	double pixmapSize = (page->height() > page->width()) ? page->height() : page->width();
-	PageToPixmapFlags flags = Pixmap_DrawBackground;
-	if (self->transparentBkgnd)
-		flags &= ~Pixmap_DrawBackground;
-	QImage im = view->PageToPixmap(page->pageNr(), qRound(pixmapSize * self->scale * (self->dpi / 72.0) / 100.0), flags);
-	int dpi = qRound(100.0 / 2.54 * self->dpi);
-	im.setDotsPerMeterY(dpi);
-	im.setDotsPerMeterX(dpi);
+static PyObject *ImageExport_savePages(ImageExport *self, PyObject *args)
+{
+	PyObject *pages = nullptr;
+	PyESString directory;
+	PyESString prefix;
+	if (!checkHaveDocument())
+		return nullptr;
+	if (!PyArg_ParseTuple(args, "Oes|es", &pages, "utf-8", directory.ptr(), "utf-8", prefix.ptr()))
+		return nullptr;
+	if (!PyList_Check(pages))
+	{
+		PyErr_SetString(PyExc_TypeError, QObject::tr("The page list must be a list of integers.", "python error").toUtf8().constData());
+		return nullptr;
+	}
 
-	QString outputFileName = QString::fromUtf8(value.c_str());
-	if (!im.save(outputFileName, PyUnicode_AsUTF8(self->type), self->quality))
+	ScribusDoc* doc = ScCore->primaryMainWindow()->doc;
+	std::vector<int> pageNs;
+	Py_ssize_t len = PyList_Size(pages);
+	for (Py_ssize_t i = 0; i < len; i++)
+	{
+		PyObject *tmp = PyList_GetItem(pages, i);
+		if (!PyLong_Check(tmp))
+		{
+			PyErr_SetString(PyExc_TypeError, QObject::tr("The page list must be a list of integers.", "python error").toUtf8().constData());
+			return nullptr;
+		}
+		long pageNr = PyLong_AsLong(tmp);
+		if ((pageNr < 1) || (pageNr > static_cast<long>(doc->Pages->count())))
+		{
+			PyErr_SetString(PyExc_ValueError, QObject::tr("Page number out of range.", "python error").toUtf8().constData());
+			return nullptr;
+		}
+		pageNs.push_back(static_cast<int>(pageNr));
+	}
+
+	// Pages are rendered one after the other while the images rendered
+	// before are encoded in the background
+	QString type = QString::fromUtf8(PyUnicode_AsUTF8(self->type)).toLower();
+	QString dir = QString::fromUtf8(directory.c_str());
+	QString filePrefix = QString::fromUtf8(prefix.c_str());
+	ScPageImageExporter exporter(doc);
+	ImageExport_setupExporter(self, exporter);
+	bool rendered = true;
+	for (int pageNr : pageNs)
+	{
+		QString fileName = QDir::cleanPath(dir + "/" + getFileNameByPage(doc, pageNr - 1, type, filePrefix));
+		if (!exporter.exportPage(pageNr - 1, fileName))
+		{
+			rendered = false;
+			break;
+		}
+	}
+	if (!exporter.waitForFinished() || !rendered)
 	{
 		PyErr_SetString(ScribusException, QObject::tr("Failed to export image", "python error").toUtf8().constData());
 		return nullptr;
@@ -210,6 +264,7 @@ static PyObject *ImageExport_saveAs(ImageExport *self, PyObject *args)
 static PyMethodDef ImageExport_methods[] = {
 	{ "save", (PyCFunction) ImageExport_save, METH_NOARGS, imgexp_save__doc__ },
 	{ "saveAs", (PyCFunction) ImageExport_saveAs, METH_VARARGS, imgexp_saveas__doc__ },
+	{ "savePages", (PyCFunction) ImageExport_savePages, METH_VARARGS, imgexp_savepages__doc__ },
 	{ nullptr, (PyCFunction)(nullptr), 0, nullptr } // sentinel
 };
 
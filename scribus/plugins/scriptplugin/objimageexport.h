@@ -34,10 +34,15 @@ PyDoc_STRVAR(imgexp_filename__doc__, "Filename of the image. With or without pat
 PyDoc_STRVAR(imgexp_quality__doc__, "Quality/compression: minimum 1 (poor), maximum 100 (quality). Read/write integer.");
 PyDoc_STRVAR(imgexp_scale__doc__, "This is the scaling of the image. 100 = 100% etc. Read/write integer.");
 PyDoc_STRVAR(imgexp_transparentBkgnd__doc__, "Enable or disable transparent background.");
+PyDoc_STRVAR(imgexp_threads__doc__, "Number of pages encoded at the same time by savePages(), 0 for one per processor. Read/write integer.");
+PyDoc_STRVAR(imgexp_maxMemory__doc__, "Memory in MB for rendered pages waiting to be encoded by savePages(), 0 for the default. Read/write integer.");
 PyDoc_STRVAR(imgexp_type__doc__, "Bitmap type. See allTypes list for more info. Read/write string.");
 
 PyDoc_STRVAR(imgexp_save__doc__, "save() -> boolean\n\nSaves image under previously set 'name'.");
 PyDoc_STRVAR(imgexp_saveas__doc__, "saveAs('filename') -> boolean\n\nSaves image as 'filename'.");
+PyDoc_STRVAR(imgexp_savepages__doc__, "savePages([pages], 'directory'[, 'prefix']) -> boolean\n\n\
+Saves the pages numbered in list 'pages' into 'directory', named as in\n\
+Export/Save as Image. Pages are encoded in parallel, see 'threads'.");
 
 // Nest items are not needed but are here for me to exercise
 // writing complete python objects
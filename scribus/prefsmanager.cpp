@@ -468,6 +468,8 @@ void PrefsManager::initDefaults()
 	appPrefs.fontPrefs.askBeforeSubstitute = true;
 	appPrefs.miscPrefs.haveStylePreview = true;
 	appPrefs.miscPrefs.saveEmergencyFile = true;
+	appPrefs.miscPrefs.persistShapingCache = false;
+	appPrefs.miscPrefs.lazyTextLayout = false;
 	// lorem ipsum defaults
 	appPrefs.miscPrefs.useStandardLI = false;
 	appPrefs.miscPrefs.paragraphsLI = 1;
@@ -536,6 +538,7 @@ void PrefsManager::initDefaults()
 	appPrefs.pdfPrefs.hideToolBar = false;
 	appPrefs.pdfPrefs.fitWindow = false;
 	appPrefs.pdfPrefs.openAfterExport = false;
+	appPrefs.pdfPrefs.incrementalUpdate = false;
 	appPrefs.pdfPrefs.PageLayout = PDFOptions::SinglePage;
 	appPrefs.pdfPrefs.openAction = "";
 	appPrefs.imageCachePrefs.cacheEnabled = false;
@@ -1467,6 +1470,8 @@ bool PrefsManager::writePref(const QString& filePath)
 	deMiscellaneous.setAttribute("LoremIpsumUseStandard", static_cast<int>(appPrefs.miscPrefs.useStandardLI));
 	deMiscellaneous.setAttribute("LoremIpsumParagraphs", appPrefs.miscPrefs.paragraphsLI);
 	deMiscellaneous.setAttribute("saveEmergencyFile", static_cast<int>(appPrefs.miscPrefs.saveEmergencyFile));
+	deMiscellaneous.setAttribute("PersistShapingCache", static_cast<int>(appPrefs.miscPrefs.persistShapingCache));
+	deMiscellaneous.setAttribute("LazyTextLayout", static_cast<int>(appPrefs.miscPrefs.lazyTextLayout));
 	elem.appendChild(deMiscellaneous);
 
 	QDomElement deSE = docu.createElement("StoryEditor");
@@ -1894,6 +1899,7 @@ bool PrefsManager::writePref(const QString& filePath)
 	pdf.setAttribute("hideToolBar", static_cast<int>(appPrefs.pdfPrefs.hideToolBar));
 	pdf.setAttribute("fitWindow", static_cast<int>(appPrefs.pdfPrefs.fitWindow));
 	pdf.setAttribute("openAfterExport", static_cast<int>(appPrefs.pdfPrefs.openAfterExport));
+	pdf.setAttribute("incrementalUpdate", static_cast<int>(appPrefs.pdfPrefs.incrementalUpdate));
 	pdf.setAttribute("PageLayout", appPrefs.pdfPrefs.PageLayout);
 	pdf.setAttribute("OpenAction", appPrefs.pdfPrefs.openAction);
 	for (auto itlp = appPrefs.pdfPrefs.LPISettings.cbegin(); itlp != appPrefs.pdfPrefs.LPISettings.cend(); ++itlp)
@@ -2131,6 +2137,8 @@ bool PrefsManager::readPref(const QString& filePath)
 			appPrefs.miscPrefs.useStandardLI = static_cast<bool>(dc.attribute("LoremIpsumUseStandard", "0").toInt());
 			appPrefs.miscPrefs.paragraphsLI = dc.attribute("LoremIpsumParagraphs", "1").toInt();
 			appPrefs.miscPrefs.saveEmergencyFile = static_cast<bool>(dc.attribute("saveEmergencyFile", "1").toInt());
+			appPrefs.miscPrefs.persistShapingCache = static_cast<bool>(dc.attribute("PersistShapingCache", "0").toInt());
+			appPrefs.miscPrefs.lazyTextLayout = static_cast<bool>(dc.attribute("LazyTextLayout", "0").toInt());
 		}
 
 		if (dc.tagName() == "Display")
@@ -2748,6 +2756,7 @@ bool PrefsManager::readPref(const QString& filePath)
 			appPrefs.pdfPrefs.hideToolBar = static_cast<bool>(dc.attribute("hideToolBar", "0").toInt());
 			appPrefs.pdfPrefs.fitWindow = static_cast<bool>(dc.attribute("fitWindow", "0").toInt());
 			appPrefs.pdfPrefs.openAfterExport = static_cast<bool>(dc.attribute("openAfterExport", "0").toInt());
+			appPrefs.pdfPrefs.incrementalUpdate = static_cast<bool>(dc.attribute("incrementalUpdate", "0").toInt());
 			appPrefs.pdfPrefs.PageLayout = dc.attribute("PageLayout", "0").toInt();
 			appPrefs.pdfPrefs.openAction = dc.attribute("OpenAction", "");
 			QDomNode pfoNode = domNode.firstChild();
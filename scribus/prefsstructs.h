@@ -417,6 +417,8 @@ struct MiscellaneousPrefs
 {
 	bool haveStylePreview; //! Show previews in the Style setup areas like Style Manager
 	bool saveEmergencyFile; //! true = try to save emergency files when crashing
+	bool persistShapingCache; //! true = keep text shaping results in a file next to the document
+	bool lazyTextLayout; //! true = lay out text frames of loaded documents only when they are first needed
 
 	// lorem ipsum
 	bool useStandardLI; //! Use the standard Lorem Ipsum text
@@ -413,6 +413,17 @@ void ScColor::setSpotColor(bool s)
 	m_Spot = s;
 }
 
+size_t qHash(const ScColor& color, size_t seed)
+{
+	double v[4] { 0.0, 0.0, 0.0, 0.0 };
+	colorModel model = color.getColorModel();
+	if (model == colorModelRGB)
+		color.getRGB(&v[0], &v[1], &v[2]);
+	else if (model == colorModelCMYK)
+		color.getCMYK(&v[0], &v[1], &v[2], &v[3]);
+	return qHashMulti(seed, static_cast<int>(model), color.isSpotColor(), color.isRegistrationColor(), v[0], v[1], v[2], v[3]);
+}
+
 ColorList::ColorList(ScribusDoc* doc, bool retainDoc)
 	     : m_doc(doc),
 	       m_retainDoc(retainDoc)
@@ -559,18 +570,128 @@ QString ColorList::tryAddColor(QString name, const ScColor& col)
 {
 	if (contains(name))
 		return name;
-	bool found = false;
-	QString ret = name;
-	for (auto it = begin(); it != end(); ++it)
+
+	// Among several colors of the same value, the first one by name is returned
+	updateIndex();
+	QString ret;
+	for (auto it = m_valueIndex.constFind(col); (it != m_valueIndex.constEnd()) && (it.key() == col); ++it)
+	{
+		// Colors may have been modified in place through iterators since they were indexed
+		auto colorIt = constFind(it.value());
+		if ((colorIt == constEnd()) || !(colorIt.value() == col))
+			continue;
+		if (ret.isEmpty() || (it.value() < ret))
+			ret = it.value();
+	}
+	if (!ret.isEmpty())
+		return ret;
+
+	insert(name, col);
+	return name;
+}
+
+ColorList::iterator ColorList::insert(const QString& name, const ScColor& col)
+{
+	if (m_indexValid)
+	{
+		unindexColor(name);
+		indexColor(name, col);
+	}
+	return QMap<QString, ScColor>::insert(name, col);
+}
+
+ColorList::iterator ColorList::insert(const_iterator pos, const QString& name, const ScColor& col)
+{
+	if (m_indexValid)
+	{
+		unindexColor(name);
+		indexColor(name, col);
+	}
+	return QMap<QString, ScColor>::insert(pos, name, col);
+}
+
+void ColorList::insert(const QMap<QString, ScColor>& colors)
+{
+	for (auto it = colors.constBegin(); it != colors.constEnd(); ++it)
+		insert(it.key(), it.value());
+}
+
+qsizetype ColorList::remove(const QString& name)
+{
+	if (m_indexValid)
+		unindexColor(name);
+	return QMap<QString, ScColor>::remove(name);
+}
+
+ScColor ColorList::take(const QString& name)
+{
+	if (m_indexValid)
+		unindexColor(name);
+	return QMap<QString, ScColor>::take(name);
+}
+
+void ColorList::clear()
+{
+	m_valueIndex.clear();
+	m_indexedColors.clear();
+	m_touchedColors.clear();
+	m_indexValid = true;
+	QMap<QString, ScColor>::clear();
+}
+
+ScColor& ColorList::operator[](const QString& name)
+{
+	if (m_indexValid)
+		m_touchedColors.insert(name);
+	return QMap<QString, ScColor>::operator[](name);
+}
+
+ColorList::iterator ColorList::find(const QString& name)
+{
+	if (m_indexValid)
+		m_touchedColors.insert(name);
+	return QMap<QString, ScColor>::find(name);
+}
+
+void ColorList::indexColor(const QString& name, const ScColor& col)
+{
+	m_indexedColors.insert(name, col);
+	if (col.getColorModel() != colorModelLab)
+		m_valueIndex.insert(col, name);
+}
+
+void ColorList::unindexColor(const QString& name)
+{
+	auto it = m_indexedColors.find(name);
+	if (it == m_indexedColors.end())
+		return;
+	if (it->getColorModel() != colorModelLab)
+		m_valueIndex.remove(*it, name);
+	m_indexedColors.erase(it);
+}
+
+void ColorList::updateIndex()
+{
+	if (m_indexValid)
 	{
-		if (it.value() == col)
+		for (const QString& name : std::as_const(m_touchedColors))
 		{
-			ret = it.key();
-			found = true;
-			break;
+			unindexColor(name);
+			auto it = constFind(name);
+			if (it != constEnd())
+				indexColor(name, it.value());
 		}
+		m_touchedColors.clear();
+		if (m_indexedColors.count() == count())
+			return;
 	}
-	if (!found)
-		insert(name, col);
-	return ret;
+
+	m_valueIndex.clear();
+	m_indexedColors.clear();
+	m_touchedColors.clear();
+	m_valueIndex.reserve(count());
+	m_indexedColors.reserve(count());
+	for (auto it = constBegin(); it != constEnd(); ++it)
+		indexColor(it.key(), it.value());
+	m_indexValid = true;
 }
@@ -25,8 +25,10 @@ for which a new license (GPL+exception) is in place.
 #define SCCOLOR_H
 
 #include <QColor>
+#include <QHash>
 #include <QMap>
 #include <QPointer>
+#include <QSet>
 #include <QString>
 
 #include "scribusapi.h"
@@ -165,6 +167,9 @@ private:
 	colorModel m_Model {colorModelRGB};
 };
 
+/** \brief Hash consistent with ScColor::operator==, Lab colors which never compare equal all share one value */
+SCRIBUS_API size_t qHash(const ScColor& color, size_t seed = 0);
+
 class SCRIBUS_API ColorList : public QMap<QString, ScColor>
 {
 public:
@@ -193,10 +198,47 @@ public:
 	/** \brief Try to add ScColor col to the list, if col already exists either by name or by value the existing color name is returned. */
 	QString tryAddColor(QString name, const ScColor& col);
 
+	/**
+	 * Modifiers of QMap, reimplemented to keep the value index used by tryAddColor() up to date.
+	 * Colors modified through non-const iterators, or through the QMap interface, are only taken
+	 * into account once the number of colors changes. The using declarations keep the overloads
+	 * of QMap which are not reimplemented visible.
+	 */
+	using QMap<QString, ScColor>::insert;
+	using QMap<QString, ScColor>::remove;
+	using QMap<QString, ScColor>::take;
+	using QMap<QString, ScColor>::clear;
+	using QMap<QString, ScColor>::operator[];
+	using QMap<QString, ScColor>::find;
+
+	iterator insert(const QString& name, const ScColor& col);
+	iterator insert(const_iterator pos, const QString& name, const ScColor& col);
+	void insert(const QMap<QString, ScColor>& colors);
+	void insert(QMap<QString, ScColor>&& colors) { insert(std::as_const(colors)); }
+	qsizetype remove(const QString& name);
+	ScColor take(const QString& name);
+	void clear();
+	ScColor& operator[](const QString& name);
+	ScColor operator[](const QString& name) const { return QMap<QString, ScColor>::operator[](name); }
+	iterator find(const QString& name);
+	const_iterator find(const QString& name) const { return QMap<QString, ScColor>::find(name); }
+
 protected:
 	QPointer<ScribusDoc> m_doc;
 	bool m_retainDoc { false };
 
+	/// Names of the colors by value, Lab colors are not indexed as they never compare equal
+	QMultiHash<ScColor, QString> m_valueIndex;
+	/// Values of the colors as indexed
+	QHash<QString, ScColor> m_indexedColors;
+	/// Colors which may have been modified through references since they were indexed
+	QSet<QString> m_touchedColors;
+	bool m_indexValid { false };
+
+	void indexColor(const QString& name, const ScColor& col);
+	void unindexColor(const QString& name);
+	void updateIndex();
+
 	/** \brief Ensure availability of black color. */
 	void ensureBlack();
 
@@ -0,0 +1,54 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QMutexLocker>
+
+#include "sccolorconversioncache.h"
+
+bool ScColorConversionCache::Key::operator==(const Key& other) const
+{
+	return (conversion == other.conversion) && (model == other.model) && (flags == other.flags) &&
+	       (level == other.level) &&
+	       (values[0] == other.values[0]) && (values[1] == other.values[1]) &&
+	       (values[2] == other.values[2]) && (values[3] == other.values[3]);
+}
+
+size_t qHash(const ScColorConversionCache::Key& key, size_t seed)
+{
+	return qHashMulti(seed, key.conversion, key.model, key.flags, key.level,
+	                  key.values[0], key.values[1], key.values[2], key.values[3]);
+}
+
+bool ScColorConversionCache::find(const Key& key, QColor& color) const
+{
+	QMutexLocker locker(&m_mutex);
+	auto it = m_colors.constFind(key);
+	if (it == m_colors.constEnd())
+		return false;
+	color = it.value();
+	return true;
+}
+
+void ScColorConversionCache::insert(const Key& key, const QColor& color)
+{
+	QMutexLocker locker(&m_mutex);
+	if (m_colors.count() >= maxCount)
+		m_colors.clear();
+	m_colors.insert(key, color);
+}
+
+void ScColorConversionCache::clear()
+{
+	QMutexLocker locker(&m_mutex);
+	m_colors.clear();
+}
+
+int ScColorConversionCache::count() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_colors.count();
+}
@@ -0,0 +1,67 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCCOLORCONVERSIONCACHE_H
+#define SCCOLORCONVERSIONCACHE_H
+
+#include <QColor>
+#include <QHash>
+#include <QMutex>
+
+#include "scribusapi.h"
+
+/**
+ * Results of ScColorEngine conversions of document colors to QColors.
+ *
+ * Repaints and exports convert the same few named colors and shades over and
+ * over. Each document keeps the results, keyed by the color values, the shade,
+ * the kind of conversion and the color management flags of the document at
+ * the time of the conversion, so that modified colors simply get new entries.
+ * The color transforms of the document are not part of the key: the document
+ * clears its cache whenever it replaces them.
+ */
+class SCRIBUS_API ScColorConversionCache
+{
+public:
+	enum Conversion
+	{
+		ToRGB,
+		ToDisplay,
+		ToDisplayShade,
+		ToProof,
+		ToShade,
+		ToShadeProof
+	};
+
+	struct Key
+	{
+		double values[4] { 0.0, 0.0, 0.0, 0.0 };
+		double level { 100.0 };
+		quint8 conversion { 0 };
+		quint8 model { 0 };
+		/// Spot and registration flags of the color, color management state of the document
+		quint8 flags { 0 };
+
+		bool operator==(const Key& other) const;
+	};
+
+	bool find(const Key& key, QColor& color) const;
+	void insert(const Key& key, const QColor& color);
+	void clear();
+	int count() const;
+
+private:
+	/// Conversions are cheap to redo, the cache is simply emptied when it gets this large
+	static const int maxCount = 16384;
+
+	mutable QMutex m_mutex;
+	QHash<Key, QColor> m_colors;
+};
+
+size_t qHash(const ScColorConversionCache::Key& key, size_t seed = 0);
+
+#endif // SCCOLORCONVERSIONCACHE_H
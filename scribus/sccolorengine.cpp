@@ -21,6 +21,7 @@ for which a new license (GPL+exception) is in place.
  *                                                                         *
  ***************************************************************************/
 
+#include <algorithm>
 #include <cmath>
 
 #include "sccolorengine.h"
@@ -28,11 +29,62 @@ for which a new license (GPL+exception) is in place.
 #include "scribusdoc.h"
 #include "colormgmt/sccolormgmtengine.h"
 
+/** Input of a conversion to a proofed QColor, see getShadeColorProof() */
+struct ScColorEngine::ProofConversion
+{
+	enum Input
+	{
+		None,
+		RGB16,
+		CMYK16,
+		LabDbl
+	};
+
+	Input input { None };
+	ScColorTransform transform;
+	quint16 inC[4] { 0, 0, 0, 0 };
+	double inLab[3] { 0.0, 0.0, 0.0 };
+	/// The result, computed without transform if input is None
+	QColor result;
+};
+
+ScColorConversionCache::Key ScColorEngine::conversionKey(ScColorConversionCache::Conversion conversion, const ScColor& color, const ScribusDoc* doc, double level, bool option)
+{
+	ScColorConversionCache::Key key;
+	key.conversion = conversion;
+	key.model = color.m_Model;
+	key.level = level;
+	if (color.m_Model == colorModelLab)
+	{
+		key.values[0] = color.m_L_val;
+		key.values[1] = color.m_a_val;
+		key.values[2] = color.m_b_val;
+	}
+	else
+	{
+		int count = (color.m_Model == colorModelCMYK) ? 4 : 3;
+		for (int i = 0; i < count; ++i)
+			key.values[i] = color.m_values[i];
+	}
+	key.flags = (color.m_Spot ? 0x01 : 0) | (color.m_Regist ? 0x02 : 0) | (option ? 0x04 : 0) |
+	            (ScCore->haveCMS() ? 0x08 : 0);
+	if (doc)
+		key.flags |= (doc->HasCMS ? 0x10 : 0) | (doc->SoftProofing ? 0x20 : 0) | (doc->Gamut ? 0x40 : 0);
+	return key;
+}
+
 QColor ScColorEngine::getRGBColor(const ScColor& color, const ScribusDoc* doc)
 {
+	ScColorConversionCache::Key key = conversionKey(ScColorConversionCache::ToRGB, color, doc, 100.0);
+	QColor tmp;
+	if (doc && doc->colorConversionCache().find(key, tmp))
+		return tmp;
 	RGBColor rgb;
 	getRGBValues(color, doc, rgb);
-	return QColor(rgb.r, rgb.g, rgb.b);
+	tmp = QColor(rgb.r, rgb.g, rgb.b);
+	if (doc)
+		doc->colorConversionCache().insert(key, tmp);
+	return tmp;
 }
 
 ScColor ScColorEngine::convertToModel(const ScColor& color, const ScribusDoc* doc, colorModel model)
@@ -606,7 +658,10 @@ void ScColorEngine::getShadeColorRGB(const ScColor& color, const ScribusDoc* doc
 
 QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* doc)
 {
+	ScColorConversionCache::Key key = conversionKey(ScColorConversionCache::ToDisplay, color, doc, 100.0);
 	QColor tmp;
+	if (doc && doc->colorConversionCache().find(key, tmp))
+		return tmp;
 	if (color.getColorModel() == colorModelRGB)
 	{
 		RGBColorF rgb;
@@ -683,12 +738,17 @@ QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* do
 			tmp.setRgbF(var_R, var_G, var_B);
 		}
 	}
+	if (doc)
+		doc->colorConversionCache().insert(key, tmp);
 	return tmp;
 }
 
 QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* doc, double level)
 {
+	ScColorConversionCache::Key key = conversionKey(ScColorConversionCache::ToDisplayShade, color, doc, level);
 	QColor tmp;
+	if (doc && doc->colorConversionCache().find(key, tmp))
+		return tmp;
 	if (color.getColorModel() == colorModelRGB)
 	{
 		RGBColorF rgb;
@@ -719,6 +779,8 @@ QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* do
 		trans.apply(inC, outC, 1);
 		tmp = QColor(outC[0] / 257, outC[1] / 257, outC[2] / 257);
 	}
+	if (doc)
+		doc->colorConversionCache().insert(key, tmp);
 	return tmp;
 }
 
@@ -741,7 +803,10 @@ QColor ScColorEngine::getDisplayColorGC(const ScColor& color, const ScribusDoc*
 
 QColor ScColorEngine::getColorProof(const ScColor& color, const ScribusDoc* doc, bool gamutCheck)
 {
+	ScColorConversionCache::Key key = conversionKey(ScColorConversionCache::ToProof, color, doc, 100.0, gamutCheck);
 	QColor tmp;
+	if (doc && doc->colorConversionCache().find(key, tmp))
+		return tmp;
 	bool gamutChkEnabled = doc ? doc->Gamut : false;
 	bool spot = color.isSpotColor();
 	if (color.getColorModel() == colorModelRGB)
@@ -764,22 +829,74 @@ QColor ScColorEngine::getColorProof(const ScColor& color, const ScribusDoc* doc,
 		cmyk.k = qRound(color.m_values[3] * 255.0);
 		tmp = getColorProof(cmyk, doc, spot, gamutCheck && gamutChkEnabled);
 	}
+	if (doc)
+		doc->colorConversionCache().insert(key, tmp);
 	return tmp;
 }
 
 QColor ScColorEngine::getShadeColor(const ScColor& color, const ScribusDoc* doc, double level)
 {
+	ScColorConversionCache::Key key = conversionKey(ScColorConversionCache::ToShade, color, doc, level);
+	QColor tmp;
+	if (doc && doc->colorConversionCache().find(key, tmp))
+		return tmp;
 	RGBColor rgb;
 	rgb.r = qRound(color.m_values[0] * 255.0);
 	rgb.g = qRound(color.m_values[1] * 255.0);
 	rgb.b = qRound(color.m_values[2] * 255.0);
 	getShadeColorRGB(color, doc, rgb, level);
-	return QColor(rgb.r, rgb.g, rgb.b);
+	tmp = QColor(rgb.r, rgb.g, rgb.b);
+	if (doc)
+		doc->colorConversionCache().insert(key, tmp);
+	return tmp;
 }
 
 QColor ScColorEngine::getShadeColorProof(const ScColor& color, const ScribusDoc* doc, double level)
 {
+	ScColorConversionCache::Key key = conversionKey(ScColorConversionCache::ToShadeProof, color, doc, level);
 	QColor tmp;
+	if (doc && doc->colorConversionCache().find(key, tmp))
+		return tmp;
+
+	QList<ProofConversion> conversions(1);
+	prepareShadeColorProof(color, doc, level, conversions[0]);
+	applyProofConversions(conversions);
+	tmp = conversions[0].result;
+	if (doc)
+		doc->colorConversionCache().insert(key, tmp);
+	return tmp;
+}
+
+QList<QColor> ScColorEngine::getShadeColorsProof(const QList<ScColor>& colors, const QList<double>& levels, const ScribusDoc* doc)
+{
+	Q_ASSERT(colors.count() == levels.count());
+	QList<QColor> results(colors.count());
+	QList<ScColorConversionCache::Key> keys;
+	QList<int> missing;
+	QList<ProofConversion> conversions;
+	for (int i = 0; i < colors.count(); ++i)
+	{
+		ScColorConversionCache::Key key = conversionKey(ScColorConversionCache::ToShadeProof, colors.at(i), doc, levels.at(i));
+		if (doc && doc->colorConversionCache().find(key, results[i]))
+			continue;
+		conversions.append(ProofConversion());
+		prepareShadeColorProof(colors.at(i), doc, levels.at(i), conversions.last());
+		keys.append(key);
+		missing.append(i);
+	}
+
+	applyProofConversions(conversions);
+	for (int i = 0; i < missing.count(); ++i)
+	{
+		results[missing.at(i)] = conversions.at(i).result;
+		if (doc)
+			doc->colorConversionCache().insert(keys.at(i), conversions.at(i).result);
+	}
+	return results;
+}
+
+void ScColorEngine::prepareShadeColorProof(const ScColor& color, const ScribusDoc* doc, double level, ProofConversion& conversion)
+{
 	bool doGC = doc ? doc->Gamut : false;
 	bool cmsUse = doc ? doc->HasCMS : false;
 	bool softProof = doc ? doc->SoftProofing : false;
@@ -799,10 +916,10 @@ QColor ScColorEngine::getShadeColorProof(const ScColor& color, const ScribusDoc*
 			CMYKColorF cmyk;
 			cmyk.c = cmyk.m = cmyk.y = 0;
 			cmyk.k = 1.0 - rgb.g;
-			tmp = getColorProof(cmyk, doc, color.isSpotColor(), doGC);
+			prepareColorProof(cmyk, doc, color.isSpotColor(), doGC, conversion);
 		}
 		else
-			tmp = getColorProof(rgb, doc, color.isSpotColor(), doGC);
+			prepareColorProof(rgb, doc, color.isSpotColor(), doGC, conversion);
 	}
 	else if (color.getColorModel() == colorModelCMYK)
 	{
@@ -812,32 +929,120 @@ QColor ScColorEngine::getShadeColorProof(const ScColor& color, const ScribusDoc*
 		cmyk.y = color.m_values[2];
 		cmyk.k = color.m_values[3];
 		getShadeColorCMYK(color, doc, cmyk, level);
-		tmp = getColorProof(cmyk, doc, color.isSpotColor(), doGC);
+		prepareColorProof(cmyk, doc, color.isSpotColor(), doGC, conversion);
 	}
 	else if (color.getColorModel() == colorModelLab)
 	{
-		double inC[3];
-		inC[0] = 100 - (100 - color.m_L_val) * (level / 100.0);
-		inC[1] = color.m_a_val * (level / 100.0);
-		inC[2] = color.m_b_val * (level / 100.0);
-		quint16 outC[3];
+		conversion.input = ProofConversion::LabDbl;
+		conversion.inLab[0] = 100 - (100 - color.m_L_val) * (level / 100.0);
+		conversion.inLab[1] = color.m_a_val * (level / 100.0);
+		conversion.inLab[2] = color.m_b_val * (level / 100.0);
 		ScColorTransform trans  = doc ? doc->stdLabToScreenTrans : ScCore->defaultLabToRGBTrans;
 		ScColorTransform transProof   = doc ? doc->stdProofLab   : ScCore->defaultLabToRGBTrans;
 		ScColorTransform transProofGC = doc ? doc->stdProofLabGC : ScCore->defaultLabToRGBTrans;
 		if (cmsUse && doc && doc->SoftProofing)
+			conversion.transform = doGC ? transProofGC : transProof;
+		else
+			conversion.transform = trans;
+	}
+}
+
+void ScColorEngine::prepareColorProof(const RGBColorF& rgb, const ScribusDoc* doc, bool spot, bool gamutCheck, ProofConversion& conversion)
+{
+	ScColorTransform transRGBMon  = doc ? doc->stdTransRGBMon : ScCore->defaultRGBToScreenSolidTrans;
+	ScColorTransform transProof   = doc ? doc->stdProof   : ScCore->defaultRGBToScreenSolidTrans;
+	ScColorTransform transProofGC = doc ? doc->stdProofGC : ScCore->defaultRGBToScreenSolidTrans;
+	bool cmsUse   = doc ? doc->HasCMS : false;
+	bool cmsTrans = (transRGBMon && transProof && transProofGC);
+	if (ScCore->haveCMS() && cmsTrans)
+	{
+		conversion.input = ProofConversion::RGB16;
+		conversion.inC[0] = rgb.r * 65535.0;
+		conversion.inC[1] = rgb.g * 65535.0;
+		conversion.inC[2] = rgb.b * 65535.0;
+		if (cmsUse && !spot && doc->SoftProofing)
+			conversion.transform = gamutCheck ? transProofGC : transProof;
+		else
+			conversion.transform = transRGBMon;
+	}
+	else
+		conversion.result = QColor(qRound(rgb.r * 255.0), qRound(rgb.g * 255.0), qRound(rgb.b * 255.0));
+}
+
+void ScColorEngine::prepareColorProof(const CMYKColorF& cmyk, const ScribusDoc* doc, bool spot, bool gamutCheck, ProofConversion& conversion)
+{
+	ScColorTransform transCMYKMon     = doc ? doc->stdTransCMYKMon : ScCore->defaultCMYKToRGBTrans;
+	ScColorTransform transProofCMYK   = doc ? doc->stdProofCMYK   : ScCore->defaultCMYKToRGBTrans;
+	ScColorTransform transProofCMYKGC = doc ? doc->stdProofCMYKGC : ScCore->defaultCMYKToRGBTrans;
+	bool cmsUse   = doc ? doc->HasCMS : false;
+	bool cmsTrans = (transCMYKMon && transProofCMYK && transProofCMYKGC);
+	if (ScCore->haveCMS() && cmsTrans)
+	{
+		conversion.input = ProofConversion::CMYK16;
+		conversion.inC[0] = cmyk.c * 65535.0;
+		conversion.inC[1] = cmyk.m * 65535.0;
+		conversion.inC[2] = cmyk.y * 65535.0;
+		conversion.inC[3] = cmyk.k * 65535.0;
+		if (cmsUse && !spot && doc->SoftProofing)
+			conversion.transform = gamutCheck ? transProofCMYKGC : transProofCMYK;
+		else
+			conversion.transform = transCMYKMon;
+	}
+	else
+	{
+		int r = 255 - qMin(255, qRound((cmyk.c + cmyk.k) * 255.0));
+		int g = 255 - qMin(255, qRound((cmyk.m + cmyk.k) * 255.0));
+		int b = 255 - qMin(255, qRound((cmyk.y + cmyk.k) * 255.0));
+		conversion.result = QColor(r, g, b);
+	}
+}
+
+void ScColorEngine::applyProofConversions(QList<ProofConversion>& conversions)
+{
+	// Conversions sharing input format and transform are done with a single call
+	// to the color management engine, in the order of their first occurrence
+	QList<bool> done(conversions.count(), false);
+	for (int first = 0; first < conversions.count(); ++first)
+	{
+		const ProofConversion& group = conversions.at(first);
+		if (done.at(first) || (group.input == ProofConversion::None))
+			continue;
+		if (group.transform.isNull())
 		{
-			ScColorTransform xform = doGC ? transProofGC : transProof;
-			xform.apply(inC, outC, 1);
-			tmp = QColor(outC[0] / 257, outC[1] / 257, outC[2] / 257);
+			done[first] = true;
+			conversions[first].result = QColor(0, 0, 0);
+			continue;
+		}
+
+		QList<int> members;
+		for (int i = first; i < conversions.count(); ++i)
+		{
+			if (done.at(i) || (conversions.at(i).input != group.input) || !(conversions.at(i).transform == group.transform))
+				continue;
+			members.append(i);
+			done[i] = true;
+		}
+
+		int channels = (group.input == ProofConversion::CMYK16) ? 4 : 3;
+		QList<quint16> outC(members.count() * 3);
+		ScColorTransform transform = group.transform;
+		if (group.input == ProofConversion::LabDbl)
+		{
+			QList<double> inC(members.count() * 3);
+			for (int i = 0; i < members.count(); ++i)
+				std::copy_n(conversions.at(members.at(i)).inLab, 3, inC.begin() + i * 3);
+			transform.apply(inC.data(), outC.data(), members.count());
 		}
 		else
 		{
-			trans.apply(inC, outC, 1);
-			tmp = QColor(outC[0] / 257, outC[1] / 257, outC[2] / 257);
+			QList<quint16> inC(members.count() * channels);
+			for (int i = 0; i < members.count(); ++i)
+				std::copy_n(conversions.at(members.at(i)).inC, channels, inC.begin() + i * channels);
+			transform.apply(inC.data(), outC.data(), members.count());
 		}
+		for (int i = 0; i < members.count(); ++i)
+			conversions[members.at(i)].result = QColor(outC.at(i * 3) / 257, outC.at(i * 3 + 1) / 257, outC.at(i * 3 + 2) / 257);
 	}
-	
-	return tmp;
 }
 
 QColor ScColorEngine::getColorProof(const RGBColor& rgb, const ScribusDoc* doc, bool spot, bool gamutCkeck)
@@ -24,8 +24,11 @@ for which a new license (GPL+exception) is in place.
 #ifndef SCCOLORENGINE_H
 #define SCCOLORENGINE_H
 
+#include <QList>
+
 #include "scribusapi.h"
 #include "sccolor.h"
+#include "sccolorconversioncache.h"
 #include "sccolorstructs.h"
 class ScribusDoc;
 
@@ -85,6 +88,11 @@ public:
 	* If color management is enabled, returned value use the monitor color space. */
 	static QColor getShadeColorProof(const ScColor& color, const ScribusDoc* doc, double level);
 
+	/** \brief Return proofed QColors of \a colors with the shades in \a levels, same as getShadeColorProof().
+	* Conversions which are not cached yet are done with one call to the color management engine
+	* for all colors using the same color transform. */
+	static QList<QColor> getShadeColorsProof(const QList<ScColor>& colors, const QList<double>& levels, const ScribusDoc* doc);
+
 	/** \brief Return a proofed QColor from a rgb color.
 	* If color management is enabled, returned value use the monitor color space. */
 	static QColor getColorProof(const RGBColor& rgb, const ScribusDoc* doc, bool spot, bool gamutCkeck);
@@ -122,6 +130,15 @@ public:
 
 	/** \brief Apply Gray-Component-Removal to an ScColor */
 	static void applyGCR(ScColor& color, const ScribusDoc* doc);
+
+private:
+	struct ProofConversion;
+
+	static ScColorConversionCache::Key conversionKey(ScColorConversionCache::Conversion conversion, const ScColor& color, const ScribusDoc* doc, double level, bool option = false);
+	static void prepareShadeColorProof(const ScColor& color, const ScribusDoc* doc, double level, ProofConversion& conversion);
+	static void prepareColorProof(const RGBColorF& rgb, const ScribusDoc* doc, bool spot, bool gamutCheck, ProofConversion& conversion);
+	static void prepareColorProof(const CMYKColorF& cmyk, const ScribusDoc* doc, bool spot, bool gamutCheck, ProofConversion& conversion);
+	static void applyProofConversions(QList<ProofConversion>& conversions);
 };
 
 #endif
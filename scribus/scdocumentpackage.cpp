@@ -0,0 +1,100 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QScopedPointer>
+
+#include "scdocumentpackage.h"
+#include "third_party/zip/scribus_zip.h"
+
+const QString ScDocumentPackage::documentEntry("document.sla");
+
+ScDocumentPackage::ScDocumentPackage()
+{
+}
+
+ScDocumentPackage::~ScDocumentPackage()
+{
+	close();
+}
+
+bool ScDocumentPackage::isPackage(const QString& fileName)
+{
+	return fileName.endsWith(".slaz", Qt::CaseInsensitive);
+}
+
+QString ScDocumentPackage::addImageEntry(const QString& packageDir, const QString& imageFile)
+{
+	QDir dir(packageDir);
+	if (!dir.exists("images") && !dir.mkdir("images"))
+		return QString();
+	// Inline images each have their own temporary file, so its name is unique
+	QString entryName = "images/" + QFileInfo(imageFile).fileName();
+	QString entryPath = dir.filePath(entryName);
+	if (QFile::exists(entryPath) || QFile::copy(imageFile, entryPath))
+		return entryName;
+	return QString();
+}
+
+bool ScDocumentPackage::write(const QString& packageDir, const QString& fileName)
+{
+	QSaveFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	ScZipHandler zip(true);
+	bool writeSucceed = zip.open(&file) && zip.write(packageDir);
+	writeSucceed = zip.close() && writeSucceed;
+	writeSucceed = writeSucceed && (file.error() == QFile::NoError);
+	if (!writeSucceed)
+	{
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
+
+bool ScDocumentPackage::open(const QString& fileName)
+{
+	close();
+	m_zip = new ScZipHandler();
+	if (m_zip->open(fileName))
+		return true;
+	close();
+	return false;
+}
+
+void ScDocumentPackage::close()
+{
+	delete m_zip;
+	m_zip = nullptr;
+}
+
+bool ScDocumentPackage::contains(const QString& entryName) const
+{
+	return m_zip && m_zip->contains(entryName);
+}
+
+bool ScDocumentPackage::readEntry(const QString& entryName, QIODevice* device)
+{
+	return contains(entryName) && m_zip->read(entryName, device);
+}
+
+QIODevice* ScDocumentPackage::readDocument()
+{
+	QScopedPointer<QBuffer> buffer(new QBuffer());
+	buffer->open(QIODevice::WriteOnly);
+	if (!readEntry(documentEntry, buffer.data()))
+		return nullptr;
+	buffer->close();
+	if (!buffer->open(QIODevice::ReadOnly))
+		return nullptr;
+	return buffer.take();
+}
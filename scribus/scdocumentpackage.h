@@ -0,0 +1,60 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCDOCUMENTPACKAGE_H
+#define SCDOCUMENTPACKAGE_H
+
+#include <QString>
+
+#include "scribusapi.h"
+
+class QIODevice;
+class ScZipHandler;
+
+/**
+ * Zip package holding a document and the files it embeds as separate entries.
+ *
+ * A package is written by collecting its entries in a directory, the
+ * document as documentEntry and inline images with addImageEntry(), and
+ * zipping that directory with write(). When loading, the document is read
+ * with readDocument() and the other entries with readEntry().
+ */
+class SCRIBUS_API ScDocumentPackage
+{
+public:
+	ScDocumentPackage();
+	~ScDocumentPackage();
+	ScDocumentPackage(const ScDocumentPackage&) = delete;
+	ScDocumentPackage& operator=(const ScDocumentPackage&) = delete;
+
+	/// Name of the document entry
+	static const QString documentEntry;
+
+	/// Returns true if \a fileName names a package
+	static bool isPackage(const QString& fileName);
+	/**
+	 * Copies \a imageFile into the package directory \a packageDir.
+	 * Returns the name of its entry, an empty string if it could not be copied.
+	 */
+	static QString addImageEntry(const QString& packageDir, const QString& imageFile);
+	/// Zips \a packageDir to \a fileName, which is only replaced once the package is complete
+	static bool write(const QString& packageDir, const QString& fileName);
+
+	bool open(const QString& fileName);
+	void close();
+	bool isOpen() const { return m_zip != nullptr; }
+	bool contains(const QString& entryName) const;
+	/// Writes entry \a entryName to \a device
+	bool readEntry(const QString& entryName, QIODevice* device);
+	/// Returns the document entry in a buffer open for reading, nullptr if it can not be read
+	QIODevice* readDocument();
+
+private:
+	ScZipHandler* m_zip { nullptr };
+};
+
+#endif // SCDOCUMENTPACKAGE_H
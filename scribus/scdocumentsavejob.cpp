@@ -0,0 +1,232 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QFile>
+#include <QIODevice>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QScopedPointer>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "qtiocompressor.h"
+#include "scdocumentsavejob.h"
+
+namespace
+{
+	QThreadPool* saveThreadPool()
+	{
+		static QThreadPool* pool = nullptr;
+		if (!pool)
+		{
+			pool = new QThreadPool();
+			pool->setMaxThreadCount(1);
+		}
+		return pool;
+	}
+}
+
+class ScDocumentSaveJob::SnapshotDevice : public QIODevice
+{
+public:
+	explicit SnapshotDevice(ScDocumentSaveJob* job) : m_job(job) {}
+
+	QByteArray takeBuffer()
+	{
+		QByteArray chunk;
+		chunk.swap(m_buffer);
+		return chunk;
+	}
+
+protected:
+	qint64 readData(char* /*data*/, qint64 /*maxSize*/) override { return -1; }
+
+	qint64 writeData(const char* data, qint64 len) override
+	{
+		// Stop the serialization as soon as the job has failed
+		if (m_job->isCanceled())
+			return -1;
+		if (m_buffer.isEmpty())
+			m_buffer.reserve(chunkSize + qMin(len, chunkSize));
+		m_buffer.append(data, len);
+		if (m_buffer.size() >= chunkSize)
+			m_job->queueChunk(takeBuffer());
+		return len;
+	}
+
+private:
+	ScDocumentSaveJob* m_job;
+	QByteArray m_buffer;
+};
+
+ScDocumentSaveJob::ScDocumentSaveJob(const QString& fileName, bool compress, QObject* parent)
+	: QObject(parent),
+	  m_fileName(fileName),
+	  m_compress(compress)
+{
+	m_device = new SnapshotDevice(this);
+	m_device->open(QIODevice::WriteOnly);
+}
+
+ScDocumentSaveJob::~ScDocumentSaveJob()
+{
+	if (!isFinished())
+		cancel();
+	if (m_result.isStarted())
+		m_result.waitForFinished();
+	delete m_device;
+}
+
+void ScDocumentSaveJob::setPermissions(QFileDevice::Permissions permissions)
+{
+	m_permissions = permissions;
+	m_hasPermissions = true;
+}
+
+QIODevice* ScDocumentSaveJob::device()
+{
+	return m_device;
+}
+
+void ScDocumentSaveJob::start()
+{
+	if (m_result.isStarted())
+		return;
+	m_result = QtConcurrent::run(saveThreadPool(), [this]() {
+		bool success = run();
+		QMetaObject::invokeMethod(this, [this, success]() { emit finished(success); }, Qt::QueuedConnection);
+		return success;
+	});
+}
+
+void ScDocumentSaveJob::endSnapshot(bool complete)
+{
+	if (!complete)
+	{
+		cancel();
+		return;
+	}
+	QByteArray chunk = m_device->takeBuffer();
+	m_device->close();
+	// The last chunk is queued along with the total size, so that its progress is complete
+	QMutexLocker locker(&m_mutex);
+	if (!chunk.isEmpty() && !isCanceled())
+	{
+		m_chunks.append(chunk);
+		m_bytesQueued += chunk.size();
+		m_bytesPending += chunk.size();
+	}
+	m_snapshotComplete = true;
+	m_chunkQueued.wakeAll();
+}
+
+void ScDocumentSaveJob::cancel()
+{
+	m_canceled.storeRelaxed(1);
+	QMutexLocker locker(&m_mutex);
+	m_chunks.clear();
+	m_bytesPending = 0;
+	m_chunkQueued.wakeAll();
+	m_chunkTaken.wakeAll();
+}
+
+bool ScDocumentSaveJob::waitForFinished()
+{
+	if (!m_result.isStarted())
+		return false;
+	m_result.waitForFinished();
+	return m_result.result();
+}
+
+bool ScDocumentSaveJob::isFinished() const
+{
+	return m_result.isStarted() && m_result.isFinished();
+}
+
+void ScDocumentSaveJob::queueChunk(const QByteArray& chunk)
+{
+	QMutexLocker locker(&m_mutex);
+	// Until the worker runs, which may be after other jobs, there is nothing to wait for
+	while (m_running && (m_bytesPending > maxQueuedBytes) && !isCanceled())
+		m_chunkTaken.wait(&m_mutex);
+	if (isCanceled())
+		return;
+	m_chunks.append(chunk);
+	m_bytesQueued += chunk.size();
+	m_bytesPending += chunk.size();
+	m_chunkQueued.wakeAll();
+}
+
+bool ScDocumentSaveJob::takeChunk(QByteArray& chunk, qint64& bytesTotal)
+{
+	QMutexLocker locker(&m_mutex);
+	while (m_chunks.isEmpty() && !m_snapshotComplete && !isCanceled())
+		m_chunkQueued.wait(&m_mutex);
+	bytesTotal = m_snapshotComplete ? m_bytesQueued : -1;
+	if (isCanceled() || m_chunks.isEmpty())
+		return false;
+	chunk = m_chunks.takeFirst();
+	m_bytesPending -= chunk.size();
+	m_chunkTaken.wakeAll();
+	return true;
+}
+
+bool ScDocumentSaveJob::run()
+{
+	{
+		QMutexLocker locker(&m_mutex);
+		m_running = true;
+	}
+
+	QSaveFile file(m_fileName);
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		cancel();
+		return false;
+	}
+	QScopedPointer<QtIOCompressor> compressor;
+	QIODevice* output = &file;
+	if (m_compress)
+	{
+		compressor.reset(new QtIOCompressor(&file));
+		compressor->setStreamFormat(QtIOCompressor::GzipFormat);
+		compressor->open(QIODevice::WriteOnly);
+		output = compressor.data();
+	}
+
+	bool writeSucceed = true;
+	qint64 bytesWritten = 0;
+	qint64 bytesTotal = -1;
+	QByteArray chunk;
+	while (takeChunk(chunk, bytesTotal))
+	{
+		if (output->write(chunk) != chunk.size())
+		{
+			writeSucceed = false;
+			cancel();
+			break;
+		}
+		bytesWritten += chunk.size();
+		emit progress(bytesWritten, bytesTotal);
+	}
+	if (compressor)
+		compressor->close();
+	writeSucceed = writeSucceed && !isCanceled() && (file.error() == QFile::NoError);
+	if (!writeSucceed)
+	{
+		file.cancelWriting();
+		return false;
+	}
+	writeSucceed = file.commit();
+	if (writeSucceed)
+		m_savedFileName = m_fileName;
+#ifdef Q_OS_UNIX
+	if (writeSucceed && m_hasPermissions)
+		QFile::setPermissions(m_fileName, m_permissions);
+#endif
+	return writeSucceed;
+}
@@ -0,0 +1,107 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCDOCUMENTSAVEJOB_H
+#define SCDOCUMENTSAVEJOB_H
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QFileDevice>
+#include <QFuture>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QWaitCondition>
+
+#include "scribusapi.h"
+
+class QIODevice;
+
+/**
+ * Writes a document file on a worker thread.
+ *
+ * The file format plugin serializes the document on the GUI thread into
+ * device(), which only keeps the data in memory. Chunks of data are handed
+ * over to the worker as they fill up; the worker compresses them if needed
+ * and writes them through a QSaveFile, so that the document file is only
+ * replaced once the new one is complete. Compression and disk writes thus
+ * overlap with the serialization, and once endSnapshot() has been called the
+ * document may change again while the file is being written. Once the worker
+ * is running, writes to device() block while more than maxQueuedBytes wait
+ * for it, so that a slow disk does not make the whole document pile up in
+ * memory.
+ *
+ * Jobs run one after the other, in the order they were started. Until the
+ * jobs started before it are done, writes to device() never block.
+ */
+class SCRIBUS_API ScDocumentSaveJob : public QObject
+{
+	Q_OBJECT
+
+public:
+	ScDocumentSaveJob(const QString& fileName, bool compress, QObject* parent = nullptr);
+	~ScDocumentSaveJob() override;
+
+	const QString& fileName() const { return m_fileName; }
+	/// Permissions given to the file once written, otherwise those of a new file
+	void setPermissions(QFileDevice::Permissions permissions);
+
+	/// Device receiving the serialized document, writable until endSnapshot()
+	QIODevice* device();
+	/// Queues the worker, data written to device() before and after is written to the file
+	void start();
+	/// Marks the end of the serialized document, cancels the job if \a complete is false
+	void endSnapshot(bool complete = true);
+	/// Stops the worker, the document file is left untouched
+	void cancel();
+	bool isCanceled() const { return m_canceled.loadRelaxed() != 0; }
+
+	/// Waits for the worker, returns true if the file has been written
+	bool waitForFinished();
+	bool isFinished() const;
+	/// Name of the file written by the job, empty if it failed. Only valid once the job is finished.
+	const QString& savedFileName() const { return m_savedFileName; }
+
+signals:
+	/// Emitted by the worker, \a bytesTotal is -1 until the snapshot is complete
+	void progress(qint64 bytesWritten, qint64 bytesTotal);
+	/// Emitted on the thread of the job once the worker is done
+	void finished(bool success);
+
+private:
+	class SnapshotDevice;
+
+	void queueChunk(const QByteArray& chunk);
+	bool takeChunk(QByteArray& chunk, qint64& bytesTotal);
+	bool run();
+
+	static constexpr qint64 chunkSize = 1024 * 1024;
+	static constexpr qint64 maxQueuedBytes = 32 * 1024 * 1024;
+
+	QString m_fileName;
+	QString m_savedFileName;
+	bool m_compress { false };
+	bool m_hasPermissions { false };
+	QFileDevice::Permissions m_permissions;
+	SnapshotDevice* m_device { nullptr };
+
+	QMutex m_mutex;
+	QWaitCondition m_chunkQueued;
+	QWaitCondition m_chunkTaken;
+	QList<QByteArray> m_chunks;
+	/// Bytes queued in total and those not yet taken by the worker
+	qint64 m_bytesQueued { 0 };
+	qint64 m_bytesPending { 0 };
+	/// Set once the worker takes chunks, only then do writes wait for it
+	bool m_running { false };
+	bool m_snapshotComplete { false };
+	QAtomicInt m_canceled { 0 };
+	QFuture<bool> m_result;
+};
+
+#endif // SCDOCUMENTSAVEJOB_H
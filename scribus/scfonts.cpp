@@ -17,7 +17,6 @@ for which a new license (GPL+exception) is in place.
 
 #include <QApplication>
 #include <QDir>
-#include <QDomDocument>
 #include <QFile>
 #include <QFileInfo>
 #include <QFont>
@@ -650,13 +649,6 @@ static QString getFtError(int code)
 bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, const QString& DocName)
 {
 	static bool firstRun;
-	bool Subset = false;
-	char buf[128];
-	QString glyName;
-	ScFace::FontFormat format;
-	ScFace::FontType   type;
-	FT_Face         face = nullptr;
-	struct testCache foCache;
 	QFileInfo fic(filename);
 	QDateTime lastMod = fic.lastModified();
 	QTime lastModTime = lastMod.time();
@@ -665,24 +657,72 @@ bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, cons
 		lastModTime.setHMS(lastModTime.hour(), lastModTime.minute(), lastModTime.second());
 		lastMod.setTime(lastModTime);
 	}
-	foCache.isOK = false;
-	foCache.isChecked = true;
-	foCache.lastMod = lastMod;
-	if (m_checkedFonts.count() == 0)
+
+	ScFontIndex::Entry entry;
+	bool known = findFontEntry(filename, entry);
+	if (!known || (entry.lastMod != lastMod) || (entry.size != fic.size()))
+	{
+		if (m_checkedFonts.isEmpty() && (!m_fontIndex || (m_fontIndex->count() == 0)))
+		{
+			firstRun = true;
+			ScCore->setSplashStatus( QObject::tr("Creating Font Cache") );
+		}
+		else if (known)
+			ScCore->setSplashStatus( QObject::tr("Modified Font found, checking...") );
+		else if (!firstRun)
+			ScCore->setSplashStatus( QObject::tr("New Font found, checking...") );
+		entry = checkFontFile(filename, library);
+		entry.lastMod = lastMod;
+		entry.size = fic.size();
+	}
+	m_checkedFonts.insert(filename, entry);
+	m_otherFonts.remove(filename);
+	if (!entry.isOK || entry.faces.isEmpty())
+		return true;
+
+	addFontFaces(filename, entry, DocName);
+	return false;
+}
+
+bool SCFonts::findFontEntry(const QString& filename, ScFontIndex::Entry& entry) const
+{
+	auto it = m_checkedFonts.constFind(filename);
+	if (it != m_checkedFonts.constEnd())
+	{
+		entry = *it;
+		return true;
+	}
+	if (m_fontIndex && m_fontIndex->find(filename, entry))
+		return true;
+	it = m_otherFonts.constFind(filename);
+	if (it != m_otherFonts.constEnd())
 	{
-		firstRun = true;
-		ScCore->setSplashStatus( QObject::tr("Creating Font Cache") );
+		entry = *it;
+		return true;
 	}
+	return false;
+}
+
+// Open all faces of a font file with FreeType and check their glyphs
+ScFontIndex::Entry SCFonts::checkFontFile(const QString& filename, FT_Library &library)
+{
+	bool Subset = false;
+	char buf[128];
+	QString glyName;
+	ScFace::FontFormat format;
+	ScFace::FontType   type;
+	FT_Face         face = nullptr;
+	ScFontIndex::Entry entry;
+
 	FT_Error error = FT_New_Face( library, QFile::encodeName(filename), 0, &face );
 	if (error || (face == nullptr))
 	{
 		if (face != nullptr)
 			FT_Done_Face(face);
-		m_checkedFonts.insert(filename, foCache);
 		addRejectedFont(filename, QObject::tr("Font is broken: \"%1\"").arg(getFtError(error)));
 		if (m_showFontInfo)
 			sDebug(QObject::tr("Font %1 is broken, discarding it. Error message: \"%2\"").arg(filename, getFtError(error)));
-		return true;
+		return entry;
 	}
 	if (face->family_name == nullptr)
 	{
@@ -690,8 +730,7 @@ bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, cons
 		if (m_showFontInfo)
 			sDebug(QObject::tr("Failed to load font %1 - font family unspecified").arg(filename));
 		FT_Done_Face(face);
-		m_checkedFonts.insert(filename, foCache);
-		return true;
+		return entry;
 	}
 	getFontFormat(face, format, type);
 	if (format == ScFace::UNKNOWN_FORMAT) 
@@ -700,8 +739,7 @@ bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, cons
 		if (m_showFontInfo)
 			sDebug(QObject::tr("Failed to load font %1 - font type unknown").arg(filename));
 		FT_Done_Face(face);
-		m_checkedFonts.insert(filename, foCache);
-		return true;
+		return entry;
 	}
 	// Some fonts such as Noto ColorEmoji are in fact bitmap fonts
 	// and do not provide a valid value for units_per_EM
@@ -711,105 +749,48 @@ bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, cons
 		if (m_showFontInfo)
 			sDebug(QObject::tr("Failed to load font %1 - font is not scalable").arg(filename));
 		FT_Done_Face(face);
-		m_checkedFonts.insert(filename, foCache);
-		return true;
+		return entry;
 	}
 	bool HasNames = FT_HAS_GLYPH_NAMES(face);
 
-	if (!m_checkedFonts.contains(filename))
-	{
-		if (!firstRun)
-			ScCore->setSplashStatus( QObject::tr("New Font found, checking...") );
-		FT_UInt gindex = 0;
-		FT_ULong charcode = FT_Get_First_Char( face, &gindex );
-		while ( gindex != 0 )
-		{
-			error = FT_Load_Glyph(face, gindex, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP);
-			if (error)
-			{
-				auto errorMessage = QObject::tr("Font %1 has broken glyph %2 (charcode U+%3). Error message: \"%4\"")
-							   .arg(filename)
-							   .arg(gindex)
-							   .arg(charcode, 4, 16, QChar('0'))
-							   .arg(getFtError(error));
-				addRejectedFont(filename, errorMessage);
-				if (m_showFontInfo)
-					sDebug(errorMessage);
-				FT_Done_Face(face);
-				m_checkedFonts.insert(filename, foCache);
-				return true;
-			}
-			FT_Get_Glyph_Name(face, gindex, buf, 128);
-			QString newName(buf);
-			if (newName == glyName)
-			{
-				HasNames = false;
-				Subset = true;
-			}
-			glyName = newName;
-			charcode = FT_Get_Next_Char( face, charcode, &gindex );
-		}
-		foCache.isOK = true;
-		m_checkedFonts.insert(filename, foCache);
-	}
-	else
+	FT_UInt gindex = 0;
+	FT_ULong charcode = FT_Get_First_Char( face, &gindex );
+	while ( gindex != 0 )
 	{
-		auto& checkedFont = m_checkedFonts[filename];
-		if (!checkedFont.isOK)
+		error = FT_Load_Glyph(face, gindex, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP);
+		if (error)
 		{
-			checkedFont.isChecked = true;
+			auto errorMessage = QObject::tr("Font %1 has broken glyph %2 (charcode U+%3). Error message: \"%4\"")
+						   .arg(filename)
+						   .arg(gindex)
+						   .arg(charcode, 4, 16, QChar('0'))
+						   .arg(getFtError(error));
+			addRejectedFont(filename, errorMessage);
+			if (m_showFontInfo)
+				sDebug(errorMessage);
 			FT_Done_Face(face);
-			return true;
+			return entry;
 		}
-		if (checkedFont.lastMod != foCache.lastMod)
-		{
-			ScCore->setSplashStatus( QObject::tr("Modified Font found, checking...") );
-			FT_UInt gindex = 0;
-			FT_ULong charcode = FT_Get_First_Char( face, &gindex );
-			while ( gindex != 0 )
-			{
-				error = FT_Load_Glyph(face, gindex, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP);
-				if (error)
-				{
-					auto errorMessage = QObject::tr("Font %1 has broken glyph %2 (charcode U+%3). Error message: \"%4\"")
-								   .arg(filename)
-								   .arg(gindex)
-								   .arg(charcode, 4, 16, QChar('0'))
-								   .arg(getFtError(error));
-					addRejectedFont(filename, errorMessage);
-					if (m_showFontInfo)
-						sDebug(errorMessage);
-					FT_Done_Face(face);
-					m_checkedFonts.insert(filename, foCache);
-					return true;
-				}
-				FT_Get_Glyph_Name(face, gindex, buf, 128);
-				QString newName(buf);
-				if (newName == glyName)
-				{
-					HasNames = false;
-					Subset = true;
-				}
-				glyName = newName;
-				charcode = FT_Get_Next_Char( face, charcode, &gindex );
-			}
-			foCache.isOK = true;
-			checkedFont = foCache;
-		}
-		else
+		FT_Get_Glyph_Name(face, gindex, buf, 128);
+		QString newName(buf);
+		if (newName == glyName)
 		{
-			checkedFont.isOK = true;
-			checkedFont.isChecked = true;
+			HasNames = false;
+			Subset = true;
 		}
+		glyName = newName;
+		charcode = FT_Get_Next_Char( face, charcode, &gindex );
 	}
+	entry.isOK = true;
 
 	// Warning: code below is also present in loadScalableFont, so if you do
 	// any modification here, think also about modifying code in loadScalableFont
 	int faceIndex = 0;
 	while (!error)
 	{
-		QString fam(getFamilyName(face));
-		QStringList features(getFontFeatures(face));
+		ScFontIndex::Face faceInfo;
+		faceInfo.family = getFamilyName(face);
+		faceInfo.features = getFontFeatures(face);
 		QString sty(face->style_name);
 		if ((sty == "Regular" && face->style_flags != 0) || sty.isEmpty())
 		{
@@ -831,22 +812,49 @@ bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, cons
 					break;
 			}
 		}
-		QString fullName(fam);
-		if (!sty.isEmpty())
-			fullName += " " + sty;
+		faceInfo.style = sty;
 		const char* psName = FT_Get_Postscript_Name(face);
-		QString qpsName;
 		if (psName)
-			qpsName = QString(psName);
+			faceInfo.psName = QString(psName);
 		else
-			qpsName = fullName;
+			faceInfo.psName = sty.isEmpty() ? faceInfo.family : faceInfo.family + " " + sty;
+		faceInfo.faceIndex = faceIndex;
+		faceInfo.format = format;
+		ScFace::FontType faceType = (format == ScFace::TTCF) ? ScFace::TTF : ScFace::UNKNOWN_TYPE;
+		getSubFontType(face, faceType);
+		faceInfo.type = faceType;
+		faceInfo.hasGlyphNames = HasNames;
+		faceInfo.subset = Subset || (face->num_glyphs > 2048);
+		entry.faces.append(faceInfo);
+
+		if ((++faceIndex) >= face->num_faces)
+			break;
+		FT_Done_Face(face);
+		face = nullptr;
+		error = FT_New_Face(library, QFile::encodeName(filename), faceIndex, &face);
+	} //while
+	
+	if (face != nullptr)
+		FT_Done_Face(face);
+	return entry;
+}
+
+// Create the faces of a checked font file, FreeType opens them when they are first used
+void SCFonts::addFontFaces(const QString& filename, const ScFontIndex::Entry& entry, const QString& DocName)
+{
+	for (const ScFontIndex::Face& faceInfo : entry.faces)
+	{
+		QString sty(faceInfo.style);
+		QString fullName(faceInfo.family);
+		if (!sty.isEmpty())
+			fullName += " " + sty;
 		ScFace t;
 		if (contains(fullName))
 		{
 			t = (*this)[fullName];
-			if (t.psName() != qpsName)
+			if (t.psName() != faceInfo.psName)
 			{
-				QString alt = " (" + qpsName + ")";
+				QString alt = " (" + faceInfo.psName + ")";
 				fullName += alt;
 				sty += alt;
 			}
@@ -854,79 +862,48 @@ bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, cons
 		t = (*this)[fullName];
 		if (t.isNone())
 		{
-			switch (format) 
+			switch (faceInfo.format) 
 			{
 				case ScFace::PFA:
-					t = ScFace(new ScFace_PFA(fam, sty, "", fullName, qpsName, filename, faceIndex, features));
-					t.subset(Subset);
+					t = ScFace(new ScFace_PFA(faceInfo.family, sty, "", fullName, faceInfo.psName, filename, faceInfo.faceIndex, faceInfo.features));
 					break;
 				case ScFace::PFB:
-					t = ScFace(new ScFace_PFB(fam, sty, "", fullName, qpsName, filename, faceIndex, features));
-					t.subset(Subset);
+					t = ScFace(new ScFace_PFB(faceInfo.family, sty, "", fullName, faceInfo.psName, filename, faceInfo.faceIndex, faceInfo.features));
 					break;
 				case ScFace::SFNT:
-					t = ScFace(new ScFace_ttf(fam, sty, "", fullName, qpsName, filename, faceIndex, features));
-					getSubFontType(face, t.m_m->typeCode);
-					t.subset(Subset);
-					break;
 				case ScFace::TTCF:
-					t = ScFace(new ScFace_ttf(fam, sty, "", fullName, qpsName, filename, faceIndex, features));
-					t.m_m->formatCode = ScFace::TTCF;
-					t.m_m->typeCode = ScFace::TTF;
-					getSubFontType(face, t.m_m->typeCode);
-					t.subset(Subset);
-					break;
 				case ScFace::TYPE42:
-					t = ScFace(new ScFace_ttf(fam, sty, "", fullName, qpsName, filename, faceIndex, features));
-					getSubFontType(face, t.m_m->typeCode);
-					t.subset(Subset);
+					t = ScFace(new ScFace_ttf(faceInfo.family, sty, "", fullName, faceInfo.psName, filename, faceInfo.faceIndex, faceInfo.features));
+					if (faceInfo.format == ScFace::TTCF)
+						t.m_m->formatCode = ScFace::TTCF;
+					t.m_m->typeCode = static_cast<ScFace::FontType>(faceInfo.type);
 					break;
 				default:
 				/* catching any types not handled above to silence compiler */
 					break;
 			}
+			if (t.isNone())
+				continue;
 			insert(fullName, t);
-			t.m_m->hasGlyphNames = HasNames;
+			t.subset(faceInfo.subset);
+			t.m_m->hasGlyphNames = faceInfo.hasGlyphNames;
 			t.embedPs(true);
 			t.usable(true);
 			t.m_m->status = ScFace::UNKNOWN;
-			if (face->num_glyphs > 2048)
-				t.subset(true);
 			t.m_m->forDocument = DocName;
-			//setBestEncoding(face); //AV
 			if (m_showFontInfo)
-				sDebug(QObject::tr("Font %1 loaded from %2(%3)").arg(t.psName(), filename).arg(faceIndex + 1));
-
-/*
-//debug
-			QByteArray bb;
-			t->rawData(bb);
-			QFile dump(QString("/tmp/fonts/%1-%2").arg(fullName, psName));
-			dump.open(IO_WriteOnly);
-			QDataStream os(&dump);
-			os.writeRawBytes(bb.data(), bb.size());
-			dump.close();
-*/
+				sDebug(QObject::tr("Font %1 loaded from %2(%3)").arg(t.psName(), filename).arg(faceInfo.faceIndex + 1));
 		}
 		else 
 		{
 			if (m_showFontInfo)
-				sDebug(QObject::tr("Font %1(%2) is duplicate of %3").arg(filename).arg(faceIndex + 1).arg(t.fontPath()));
+				sDebug(QObject::tr("Font %1(%2) is duplicate of %3").arg(filename).arg(faceInfo.faceIndex + 1).arg(t.fontPath()));
 			// this is needed since eg. AppleSymbols will happily return a face for *any* face_index
-			if (faceIndex > 0) {
+			if (faceInfo.faceIndex > 0) {
 				break;
 			}
 		}
-		if ((++faceIndex) >= face->num_faces)
-			break;
-		FT_Done_Face(face);
-		face = nullptr;
-		error = FT_New_Face(library, QFile::encodeName(filename), faceIndex, &face);
-	} //while
-	
-	if (face != nullptr)
-		FT_Done_Face(face);
-	return error && faceIndex == 0;
+	}
 }
 
 void SCFonts::removeFont(const QString& name)
@@ -1214,59 +1191,17 @@ void SCFonts::addUserPath(const QString& pf)
 		addPath(extraDirs->get(i, 0));
 }
 
-void SCFonts::readFontCache(const QString& pf)
+void SCFonts::readFontCache(const QString& pf, ScFontIndex& fontIndex)
 {
 	QFile fr(pf + "/cfonts.xml");
 	QFileInfo fir(fr);
 	if (fir.exists())
 		fr.remove();
 	m_checkedFonts.clear();
-	struct testCache foCache;
+	m_otherFonts.clear();
 
-	QDomDocument docu("fontcacherc");
-	QFile f(pf + "/checkfonts172.xml");
-	if (!f.open(QIODevice::ReadOnly))
-		return;
 	ScCore->setSplashStatus( QObject::tr("Reading Font Cache") );
-
-	QTextStream ts(&f);
-	ts.setEncoding(QStringConverter::Utf8);
-
-#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
-	QDomDocument::ParseResult parseResult = docu.setContent(ts.readAll());
-	if (!parseResult)
-	{
-		f.close();
-		return;
-	}
-#else
-	QString errorMsg;
-	int errorLine = 0, errorColumn = 0;
-	if ( !docu.setContent(ts.readAll(), &errorMsg, &errorLine, &errorColumn) )
-	{
-		f.close();
-		return;
-	}
-#endif
-	f.close();
-
-	QDomElement elem = docu.documentElement();
-	if (elem.tagName() != "CachedFonts")
-		return;
-
-	QDomNode DOC = elem.firstChild();
-	while (!DOC.isNull())
-	{
-		QDomElement dc = DOC.toElement();
-		if (dc.tagName()=="Font")
-		{
-			foCache.isChecked = false;
-			foCache.isOK = static_cast<bool>(dc.attribute("Status", "1").toInt());
-			foCache.lastMod = QDateTime::fromString(dc.attribute("Modified"), Qt::ISODate);
-			m_checkedFonts.insert(dc.attribute("File"), foCache);
-		}
-		DOC = DOC.nextSibling();
-	}
+	fontIndex.open(pf + "/fontindex172.dat");
 }
 
 void SCFonts::writeFontCache() const
@@ -1277,44 +1212,20 @@ void SCFonts::writeFontCache() const
 
 void SCFonts::writeFontCache(const QString& pf) const
 {
-	QDomDocument docu("fontcacherc");
-	QString st="<CachedFonts></CachedFonts>";
-
-	docu.setContent(st);
-	QDomElement elem = docu.documentElement();
-	for (auto it = m_checkedFonts.cbegin(); it != m_checkedFonts.cend(); ++it)
-	{
-		const auto& checkedFont = it.value();
-
-		bool saveItem = checkedFont.isChecked;
-		if (!checkedFont.isChecked) // Font might be located in another local Scribus font folder
-			saveItem = QFile::exists(it.key());
-		if (!saveItem)
-			continue;
-
-		QDomElement fosu = docu.createElement("Font");
-		fosu.setAttribute("File", it.key());
-		fosu.setAttribute("Status", static_cast<int>(checkedFont.isOK));
-		fosu.setAttribute("Modified", checkedFont.lastMod.toString(Qt::ISODate));
-		elem.appendChild(fosu);
-	}
+	QMap<QString, ScFontIndex::Entry> entries(m_otherFonts);
+	entries.insert(m_checkedFonts);
 
 	ScCore->setSplashStatus( QObject::tr("Writing updated Font Cache") );
-
-	QFile file(pf + "/checkfonts172.xml");
-	if (!file.open(QIODevice::WriteOnly))
-		return;
-	QTextStream s(&file);
-	s.setEncoding(QStringConverter::Utf8);
-	s << docu.toString();
-	file.close();
+	ScFontIndex::write(pf + "/fontindex172.dat", entries);
 }
 
 void SCFonts::getFonts(const QString& pf, bool showFontInfo)
 {
 	m_showFontInfo = showFontInfo;
 	m_fontPaths.clear();
-	readFontCache(pf);
+	ScFontIndex fontIndex;
+	readFontCache(pf, fontIndex);
+	m_fontIndex = &fontIndex;
 	ScCore->setSplashStatus( QObject::tr("Searching for Fonts") );
 	addUserPath(pf);
 
@@ -1351,6 +1262,16 @@ void SCFonts::getFonts(const QString& pf, bool showFontInfo)
 	for (fpi = m_fontPaths.begin() ; fpi != fpend; ++fpi) 
 		addScalableFonts(*fpi);
 #endif
+	// Font files of the index which were not found again may be in the font folder of a document
+	const QStringList indexedFiles = fontIndex.paths();
+	for (const QString& filename : indexedFiles)
+	{
+		ScFontIndex::Entry entry;
+		if (!m_checkedFonts.contains(filename) && QFile::exists(filename) && fontIndex.find(filename, entry))
+			m_otherFonts.insert(filename, entry);
+	}
+	m_fontIndex = nullptr;
+
 	updateFontMap();
 	writeFontCache(pf);
 }
@@ -18,6 +18,7 @@ for which a new license (GPL+exception) is in place.
 #include <QStringList>
 
 #include "fonts/scface.h"
+#include "fonts/scfontindex.h"
 #include "fpointarray.h"
 #include "scconfig.h"
 #include "scribusapi.h"
@@ -62,7 +63,7 @@ class SCRIBUS_API SCFonts : public QMap<QString,ScFace>
 		/// Changes replacement fonts to point to new real fonts. For all keys 'nam' in 'substitutes', findFont(name).isReplacement() must be true
 		void setSubstitutions(const QMap<QString,QString>& substitutes, ScribusDoc* doc = nullptr);
 		void removeFont(const QString& name);
-		/// Write checked fonts file
+		/// Write the index of checked font files
 		void writeFontCache() const;
 
 		/// maps family name to face variants
@@ -78,10 +79,13 @@ class SCRIBUS_API SCFonts : public QMap<QString,ScFace>
 		QString getItalicStyle(const QString& family);
 
 	private:
-		void readFontCache(const QString& pf);
+		void readFontCache(const QString& pf, ScFontIndex& fontIndex);
 		void writeFontCache(const QString& pf) const;
 		void addPath(QString p);
 		bool addScalableFont(const QString& filename, FT_Library &library, const QString& DocName);
+		bool findFontEntry(const QString& filename, ScFontIndex::Entry& entry) const;
+		ScFontIndex::Entry checkFontFile(const QString& filename, FT_Library &library);
+		void addFontFaces(const QString& filename, const ScFontIndex::Entry& entry, const QString& DocName);
 		void addRejectedFont(const QString& fontPath, const QString& message);
 		void addUserPath(const QString& pf);
 #ifdef HAVE_FONTCONFIG
@@ -92,13 +96,12 @@ class SCRIBUS_API SCFonts : public QMap<QString,ScFace>
 #endif
 		QStringList m_fontPaths;
 
-		struct testCache
-		{
-			bool isOK;
-			bool isChecked;
-			QDateTime lastMod;
-		};
-		QMap<QString, testCache> m_checkedFonts;
+		/// Index of the previous run, only set while getFonts() searches for fonts
+		const ScFontIndex* m_fontIndex { nullptr };
+		/// Font files found by this run
+		QMap<QString, ScFontIndex::Entry> m_checkedFonts;
+		/// Font files of the previous index not found by this run, e.g. in the font folder of a document
+		QMap<QString, ScFontIndex::Entry> m_otherFonts;
 
 	protected:
 		bool m_showFontInfo { false };
@@ -0,0 +1,131 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QDebug>
+#include <QFile>
+#include <QMutexLocker>
+#include <QTextCodec>
+
+#include "langmgr.h"
+#include "schyphenationcache.h"
+
+ScHyphenationCache::ScHyphenationCache(int maxWords)
+	: m_words(maxWords)
+{
+}
+
+ScHyphenationCache::~ScHyphenationCache()
+{
+	for (Dictionary* dictionary : std::as_const(m_dictionaries))
+	{
+		if (dictionary)
+			hnj_hyphen_free(dictionary->dict);
+		delete dictionary;
+	}
+}
+
+ScHyphenationCache& ScHyphenationCache::instance()
+{
+	static ScHyphenationCache cache;
+	return cache;
+}
+
+bool ScHyphenationCache::hasDictionary(const QString& language)
+{
+	return dictionary(language) != nullptr;
+}
+
+bool ScHyphenationCache::loadDictionary(const QString& language, const QString& fileName)
+{
+	QMutexLocker locker(&m_dictMutex);
+	// A dictionary may be in use by hyphenate(), so it is never replaced
+	if (m_dictionaries.contains(language))
+		return false;
+	Dictionary* dictionary = loadDictionaryFile(fileName);
+	if (!dictionary)
+		return false;
+	m_dictionaries.insert(language, dictionary);
+	return true;
+}
+
+bool ScHyphenationCache::isCached(const QString& language, const QString& word)
+{
+	QMutexLocker locker(&m_wordMutex);
+	return m_words.contains(language + QChar(0) + word);
+}
+
+const ScHyphenationCache::Dictionary* ScHyphenationCache::dictionary(const QString& language)
+{
+	QMutexLocker locker(&m_dictMutex);
+	auto it = m_dictionaries.constFind(language);
+	if (it != m_dictionaries.constEnd())
+		return *it;
+
+	// Languages without a usable dictionary are remembered too
+	Dictionary* dictionary = loadDictionaryFile(LanguageManager::instance()->getHyphFilename(language));
+	m_dictionaries.insert(language, dictionary);
+	return dictionary;
+}
+
+ScHyphenationCache::Dictionary* ScHyphenationCache::loadDictionaryFile(const QString& fileName)
+{
+	QFile file(fileName);
+	if (fileName.isEmpty() || !file.open(QIODevice::ReadOnly))
+		return nullptr;
+	QTextCodec* codec = QTextCodec::codecForName(file.readLine());
+	file.close();
+	if (!codec)
+	{
+		qDebug()<<"Unable to load lines from Hyphenator file";
+		return nullptr;
+	}
+	HyphenDict* dict = hnj_hyphen_load(file.fileName().toLocal8Bit().data());
+	if (!dict)
+		return nullptr;
+	auto* dictionary = new Dictionary;
+	dictionary->dict = dict;
+	dictionary->codec = codec;
+	return dictionary;
+}
+
+QByteArray ScHyphenationCache::hyphenate(const QString& language, const QString& word)
+{
+	QString key = language + QChar(0) + word;
+	{
+		QMutexLocker locker(&m_wordMutex);
+		if (const QByteArray* hyphens = m_words.object(key))
+			return *hyphens;
+	}
+
+	const Dictionary* dictionary = this->dictionary(language);
+	if (!dictionary)
+		return QByteArray();
+
+	// Dictionaries are only read while hyphenating, so no lock is needed here
+	QByteArray te = dictionary->codec->fromUnicode(word);
+	QByteArray hyphens(qMax(te.length(), word.length()) + 5, 0);
+	char **rep = nullptr;
+	int *pos = nullptr;
+	int *cut = nullptr;
+	// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
+	if (hnj_hyphen_hyphenate2(dictionary->dict, te.data(), te.length(), hyphens.data(), nullptr, &rep, &pos, &cut))
+		hyphens.clear();
+	else
+		hyphens[te.length()] = '\0';
+	if (rep)
+	{
+		for (int i = 0; i < te.length() - 1; ++i)
+			free(rep[i]);
+	}
+	free(rep);
+	free(pos);
+	free(cut);
+
+	QMutexLocker locker(&m_wordMutex);
+	m_words.insert(key, new QByteArray(hyphens));
+	return hyphens;
+}
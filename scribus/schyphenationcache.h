@@ -0,0 +1,86 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCHYPHENATIONCACHE_H
+#define SCHYPHENATIONCACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include "scribusapi.h"
+#include "third_party/hyphen/hyphen.h"
+
+class QTextCodec;
+
+/**
+ * Hyphenation dictionaries and the hyphenation points of the words
+ * hyphenated with them.
+ *
+ * A dictionary is loaded the first time its language is asked for and stays
+ * resident. The hyphenation points of the most recently hyphenated words are
+ * kept, so that the words a story repeats are only run through the
+ * dictionary once. hyphenate() may be called from several threads at once,
+ * Hyphenator uses this to hyphenate the paragraphs of a story in parallel.
+ */
+class SCRIBUS_API ScHyphenationCache
+{
+public:
+	/// Creates a cache keeping the points of \a maxWords words, the application shares instance()
+	explicit ScHyphenationCache(int maxWords = maxCachedWords);
+	~ScHyphenationCache();
+	ScHyphenationCache(const ScHyphenationCache&) = delete;
+	ScHyphenationCache& operator=(const ScHyphenationCache&) = delete;
+
+	static ScHyphenationCache& instance();
+
+	/// Returns true if a hyphenation dictionary is available for \a language
+	bool hasDictionary(const QString& language);
+	/**
+	 * Uses the dictionary \a fileName for \a language instead of the one
+	 * LanguageManager knows of. Returns false if it can not be loaded or the
+	 * dictionary of \a language has already been asked for.
+	 */
+	bool loadDictionary(const QString& language, const QString& fileName);
+	/// Returns true if the hyphenation points of \a word in \a language are kept
+	bool isCached(const QString& language, const QString& word);
+
+	/**
+	 * Returns the hyphenation points of the lower case \a word in \a language,
+	 * an empty array if there is no dictionary for \a language or the
+	 * dictionary failed to hyphenate it.
+	 * Bytes are set to an odd value after the characters where the word may
+	 * be broken, as expected by StoryText::hyphenateWord(). The array holds
+	 * at least one byte per character of \a word.
+	 */
+	QByteArray hyphenate(const QString& language, const QString& word);
+
+private:
+	struct Dictionary
+	{
+		HyphenDict* dict { nullptr };
+		QTextCodec* codec { nullptr };
+	};
+
+	static constexpr int maxCachedWords = 65536;
+
+	/// Returns the dictionary of \a language, loading it if needed, nullptr if there is none
+	const Dictionary* dictionary(const QString& language);
+	/// Loads the dictionary file \a fileName, returns nullptr if it is not usable
+	static Dictionary* loadDictionaryFile(const QString& fileName);
+
+	QMutex m_dictMutex;
+	/// Loaded dictionaries, nullptr for languages without a usable dictionary
+	QHash<QString, Dictionary*> m_dictionaries;
+
+	QMutex m_wordMutex;
+	QCache<QString, QByteArray> m_words;
+};
+
+#endif // SCHYPHENATIONCACHE_H
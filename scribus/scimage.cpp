@@ -17,6 +17,7 @@ for which a new license (GPL+exception) is in place.
 #include <QMessageBox>
 #include <QList>
 #include <QScopedPointer>
+#include <QSharedPointer>
 
 #include "cmsettings.h"
 #include "commonstrings.h"
@@ -25,6 +26,8 @@ for which a new license (GPL+exception) is in place.
 #include "rawimage.h"
 #include "sccolorengine.h"
 #include "scimagecacheproxy.h"
+#include "scimagekernels.h"
+#include "scimageprefetcher.h"
 #include "scstreamfilter.h"
 #include "scimage.h"
 #include "scpaths.h"
@@ -375,315 +378,49 @@ void ScImage::blur(int radius)
 	}
 
 	QRgb *pix = (QRgb*) bits();
-	int w   = width();
-	int h   = height();
-	int wm  = w - 1;
-	int hm  = h - 1;
-	int wh  = w * h;
-	int div = radius + radius + 1;
-
-	int *r = new int[wh];
-	int *g = new int[wh];
-	int *b = new int[wh];
-	int *a = new int[wh];
-	int rsum, gsum, bsum, asum, x, y, i, yp, yi, yw;
-	QRgb p;
-	int *vmin = new int[qMax(w, h)];
-
-	int divsum = (div + 1) >> 1;
-	divsum *= divsum;
-	int *dv = new int[256*divsum];
-	for (i = 0; i < 256 * divsum; ++i) {
-		dv[i] = (i / divsum);
-	}
-
-	yw = yi = 0;
-
-	int **stack = new int*[div];
-	for (int i = 0; i < div; ++i) {
-		stack[i] = new int[4];
-	}
-
-	int stackpointer;
-	int stackstart;
-	int *sir;
-	int rbs;
-	int r1 = radius + 1;
-	int routsum, goutsum, boutsum, aoutsum;
-	int rinsum, ginsum, binsum, ainsum;
-
-	for (y = 0; y < h; ++y)
-	{
-		rinsum = ginsum = binsum = ainsum
-			= routsum = goutsum = boutsum = aoutsum
-			= rsum = gsum = bsum = asum = 0;
-		for (i = -radius; i <= radius; ++i)
-		{
-			p = pix[yi + qMin(wm, qMax(i, 0))];
-			sir = stack[i + radius];
-			sir[0] = qRed(p);
-			sir[1] = qGreen(p);
-			sir[2] = qBlue(p);
-			sir[3] = qAlpha(p);
-
-			rbs = r1 - abs(i);
-			rsum += sir[0] * rbs;
-			gsum += sir[1] * rbs;
-			bsum += sir[2] * rbs;
-			asum += sir[3] * rbs;
-
-			if (i > 0)
-			{
-				rinsum += sir[0];
-				ginsum += sir[1];
-				binsum += sir[2];
-				ainsum += sir[3];
-			}
-			else
-			{
-				routsum += sir[0];
-				goutsum += sir[1];
-				boutsum += sir[2];
-				aoutsum += sir[3];
-			}
-		}
-		stackpointer = radius;
-
-		for (x=0; x < w; ++x)
-		{
-			r[yi] = dv[rsum];
-			g[yi] = dv[gsum];
-			b[yi] = dv[bsum];
-			a[yi] = dv[asum];
-
-			rsum -= routsum;
-			gsum -= goutsum;
-			bsum -= boutsum;
-			asum -= aoutsum;
-
-			stackstart = stackpointer - radius + div;
-			sir = stack[stackstart % div];
-
-			routsum -= sir[0];
-			goutsum -= sir[1];
-			boutsum -= sir[2];
-			aoutsum -= sir[3];
-
-			if (y == 0)
-			{
-				vmin[x] = qMin(x + radius + 1, wm);
-			}
-			p = pix[yw + vmin[x]];
-
-			sir[0] = qRed(p);
-			sir[1] = qGreen(p);
-			sir[2] = qBlue(p);
-			sir[3] = qAlpha(p);
-
-			rinsum += sir[0];
-			ginsum += sir[1];
-			binsum += sir[2];
-			ainsum += sir[3];
-
-			rsum += rinsum;
-			gsum += ginsum;
-			bsum += binsum;
-			asum += ainsum;
-
-			stackpointer = (stackpointer+1)%div;
-			sir = stack[(stackpointer)%div];
-
-			routsum += sir[0];
-			goutsum += sir[1];
-			boutsum += sir[2];
-			aoutsum += sir[3];
-
-			rinsum -= sir[0];
-			ginsum -= sir[1];
-			binsum -= sir[2];
-			ainsum -= sir[3];
-
-			++yi;
-		}
-		yw += w;
-	}
-	for (x=0; x < w; ++x)
-	{
-		rinsum = ginsum = binsum = ainsum
-			= routsum = goutsum = boutsum = aoutsum
-			= rsum = gsum = bsum = asum = 0;
-
-		yp =- radius * w;
-
-		for (i=-radius; i <= radius; ++i)
-		{
-			yi = qMax(0, yp) + x;
-
-			sir = stack[i + radius];
-
-			sir[0] = r[yi];
-			sir[1] = g[yi];
-			sir[2] = b[yi];
-			sir[3] = a[yi];
-
-			rbs = r1 - abs(i);
-
-			rsum += r[yi]*rbs;
-			gsum += g[yi]*rbs;
-			bsum += b[yi]*rbs;
-			asum += a[yi]*rbs;
-
-			if (i > 0)
-			{
-				rinsum += sir[0];
-				ginsum += sir[1];
-				binsum += sir[2];
-				ainsum += sir[3];
-			}
-			else
-			{
-				routsum += sir[0];
-				goutsum += sir[1];
-				boutsum += sir[2];
-				aoutsum += sir[3];
-			}
-
-			if (i < hm)
-			{
-				yp += w;
-			}
-		}
-
-		yi = x;
-		stackpointer = radius;
-
-		for (y=0; y < h; ++y)
-		{
-			pix[yi] = qRgba(dv[rsum], dv[gsum], dv[bsum], dv[asum]);
-
-			rsum -= routsum;
-			gsum -= goutsum;
-			bsum -= boutsum;
-			asum -= aoutsum;
-
-			stackstart = stackpointer-radius+div;
-			sir = stack[stackstart%div];
-
-			routsum -= sir[0];
-			goutsum -= sir[1];
-			boutsum -= sir[2];
-			aoutsum -= sir[3];
-
-			if (x==0)
-			{
-				vmin[y] = qMin(y + r1,hm)*w;
-			}
-			p = x + vmin[y];
-
-			sir[0] = r[p];
-			sir[1] = g[p];
-			sir[2] = b[p];
-			sir[3] = a[p];
-
-			rinsum += sir[0];
-			ginsum += sir[1];
-			binsum += sir[2];
-			ainsum += sir[3];
-
-			rsum += rinsum;
-			gsum += ginsum;
-			bsum += binsum;
-			asum += ainsum;
-
-			stackpointer = (stackpointer + 1) % div;
-			sir = stack[stackpointer];
-
-			routsum += sir[0];
-			goutsum += sir[1];
-			boutsum += sir[2];
-			aoutsum += sir[3];
-
-			rinsum -= sir[0];
-			ginsum -= sir[1];
-			binsum -= sir[2];
-			ainsum -= sir[3];
-
-			yi += w;
-		}
-	}
-	delete [] r;
-	delete [] g;
-	delete [] b;
-	delete [] a;
-	delete [] vmin;
-	delete [] dv;
-
-	for (int i = 0; i < div; ++i)
-	{
-		delete [] stack[i];
-	}
-	delete [] stack;
+	int w = width();
+	int h = height();
+	qsizetype stride = bytesPerLine() / sizeof(QRgb);
+
+	int divsum = (radius + 1) * (radius + 1);
+	QVector<uchar> dv(256 * divsum);
+	for (int i = 0; i < dv.size(); ++i)
+		dv[i] = i / divsum;
+	QVector<QRgb> stack(2 * radius + 1);
+
+	// Rows, then columns, each blurred in place
+	for (int y = 0; y < h; ++y)
+		ScImageKernels::blurLine(pix + y * stride, w, 1, radius, dv.constData(), stack.data());
+	for (int x = 0; x < w; ++x)
+		ScImageKernels::blurLine(pix + x, h, stride, radius, dv.constData(), stack.data());
 }
 
 bool ScImage::convolveImage(QImage *dest, const unsigned int order, const double *kernel)
 {
-	double red, green, blue, alpha;
-	const double *k;
-	unsigned int *q;
-	int x, y, mx, my, sx, sy;
-	long i;
-	int mcx, mcy;
-	long widthk = order;
+	int widthk = order;
 	if ((widthk % 2) == 0)
 		return false;
-	double *normal_kernel = (double *)malloc(widthk*widthk*sizeof(double));
-	if (!normal_kernel)
-		return false;
-	*dest = QImage(width(), height(), QImage::Format_ARGB32);
+	QVector<double> normal_kernel(widthk * widthk);
 	double normalize = 0.0;
-	for (i=0; i < (widthk * widthk); i++)
+	for (int i = 0; i < (widthk * widthk); i++)
 		normalize += kernel[i];
 	if (fabs(normalize) <= 1.0e-12)
 		normalize = 1.0;
 	normalize = 1.0 / normalize;
-	for (i = 0; i < (widthk * widthk); i++)
-		normal_kernel[i] = normalize*kernel[i];
-	for (y = 0; y < dest->height(); ++y)
+	for (int i = 0; i < (widthk * widthk); i++)
+		normal_kernel[i] = normalize * kernel[i];
+
+	int h = height();
+	int w = width();
+	*dest = QImage(w, h, QImage::Format_ARGB32);
+	QVector<const QRgb*> rows(widthk);
+	for (int y = 0; y < h; ++y)
 	{
-		sy = y - (widthk / 2);
-		q = (unsigned int *) dest->scanLine(y);
-		for (x = 0; x < dest->width(); ++x)
-		{
-			k = normal_kernel;
-			red = green = blue = alpha = 0;
-			sy = y - (widthk / 2);
-			for (mcy = 0; mcy < widthk; ++mcy, ++sy)
-			{
-				my = sy < 0 ? 0 : sy > height() - 1 ? height() - 1 : sy;
-				sx = x + (-widthk / 2);
-				for (mcx=0; mcx < widthk; ++mcx, ++sx)
-				{
-					mx = sx < 0 ? 0 : sx > width()-1 ? width()-1 : sx;
-					int px = pixel(mx, my);
-					red += (*k)*(qRed(px) * 257);
-					green += (*k)*(qGreen(px) * 257);
-					blue += (*k)*(qBlue(px) * 257);
-					alpha += (*k)*(qAlpha(px) * 257);
-					++k;
-				}
-			}
-			red = red < 0 ? 0 : red > 65535 ? 65535 : red + 0.5;
-			green = green < 0 ? 0 : green > 65535 ? 65535 : green + 0.5;
-			blue = blue < 0 ? 0 : blue > 65535 ? 65535 : blue + 0.5;
-			alpha = alpha < 0 ? 0 : alpha > 65535 ? 65535 : alpha + 0.5;
-			*q++ = qRgba((unsigned char)(red / 257UL),
-			             (unsigned char)(green / 257UL),
-			             (unsigned char)(blue / 257UL),
-			             (unsigned char)(alpha / 257UL));
-		}
+		for (int ky = 0; ky < widthk; ++ky)
+			rows[ky] = (const QRgb*) constScanLine(qBound(0, y + ky - widthk / 2, h - 1));
+		ScImageKernels::convolveRow(rows.constData(), w, normal_kernel.constData(), widthk, (QRgb*) dest->scanLine(y));
 	}
-	free(normal_kernel);
-	return(true);
+	return true;
 }
 
 int ScImage::getOptimalKernelWidth(double radius, double sigma)
@@ -738,20 +475,13 @@ void ScImage::sharpen(double radius, double sigma)
 	kernel[i / 2] = (-2.0) * normalize;
 
 	QImage dest;
-	convolveImage(&dest, widthk, kernel);
+	bool convolved = convolveImage(&dest, widthk, kernel);
 	free(kernel);
+	if (!convolved)
+		return;
 
 	for (int yi = 0; yi < dest.height(); ++yi)
-	{
-		QRgb *s = (QRgb*) dest.scanLine(yi);
-		QRgb *d = (QRgb*) scanLine(yi);
-		for (int xi = 0; xi < dest.width(); ++xi)
-		{
-			(*d) = (*s);
-			s++;
-			d++;
-		}
-	}
+		memcpy(scanLine(yi), dest.constScanLine(yi), dest.width() * sizeof(QRgb));
 }
 
 void ScImage::contrast(int contrastValue, bool cmyk)
@@ -794,34 +524,21 @@ void ScImage::applyCurve(const QVector<int>& curveTable, bool cmyk)
 {
 	int h = height();
 	int w = width();
-	QRgb *s;
-	QRgb r;
-	int c, m, y, k;
-	unsigned char *p;
-	for (int yi=0; yi < h; ++yi)
+	uchar table[256];
+	for (int i = 0; i < 256; ++i)
 	{
-		s = (QRgb*)(scanLine( yi ));
-		for (int xi=0; xi < w; ++xi)
-		{
-			r = *s;
-			if (cmyk)
-			{
-				p = (unsigned char *) s;
-				p[0] = 255 - curveTable[255 - p[0]];
-				p[1] = 255 - curveTable[255 - p[1]];
-				p[2] = 255 - curveTable[255 - p[2]];
-				p[3] = 255 - curveTable[255 - p[3]];
-			}
-			else
-			{
-				c = curveTable[qRed(r)];
-				m = curveTable[qGreen(r)];
-				y = curveTable[qBlue(r)];
-				k = qAlpha(r);
-				*s = qRgba(c, m, y, k);
-			}
-			s++;
-		}
+		// CMYK values are ink amounts, the curve applies to the lightness
+		if (cmyk)
+			table[i] = 255 - curveTable[255 - i];
+		else
+			table[i] = curveTable[i];
+	}
+	for (int yi = 0; yi < h; ++yi)
+	{
+		if (cmyk)
+			ScImageKernels::applyTable(scanLine(yi), 4 * w, table);
+		else
+			ScImageKernels::applyTableRGB((QRgb*) scanLine(yi), w, table);
 	}
 }
 
@@ -831,48 +548,36 @@ void ScImage::colorize(ScribusDoc* doc, ScColor color, int shade, bool cmyk)
 	int w = width();
 	int cc, cm, cy, ck;
 	int hu, sa, v;
-	ScColor tmp2;
 	QColor tmpR;
-	QRgb *s;
-	QRgb r;
-	double k;
-	int cc2, cm2, cy2, k2;
+	int cc2, cm2, cy2;
+	QRgb inkTable[256];
 	if (cmyk)
 	{
 		CMYKColor cmykCol;
 		ScColorEngine::getShadeColorCMYK(color, doc, cmykCol, shade);
 		cmykCol.getValues(cc, cm, cy, ck);
+		for (int i = 0; i < 256; ++i)
+		{
+			double k = i / 255.0;
+			inkTable[i] = qRgba(qMin(qRound(cc * k), 255), qMin(qRound(cm * k), 255), qMin(qRound(cy * k), 255), qMin(qRound(ck * k), 255));
+		}
 	}
 	else
 	{
-		ck = 0;
 		RGBColor rgbCol;
 		ScColorEngine::getShadeColorRGB(color, doc, rgbCol, shade);
 		rgbCol.getValues(cc, cm, cy);
-	}
-	for (int yi = 0; yi < h; ++yi)
-	{
-		s = (QRgb*)(scanLine( yi ));
-		for (int xi = 0; xi < w; ++xi)
+		tmpR.setRgb(cc, cm, cy);
+		tmpR.getHsv(&hu, &sa, &v);
+		for (int k2 = 0; k2 < 256; ++k2)
 		{
-			r = *s;
-			if (cmyk)
-			{
-				k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255) / 255.0;
-				*s = qRgba(qMin(qRound(cc*k), 255), qMin(qRound(cm*k), 255), qMin(qRound(cy*k), 255), qMin(qRound(ck*k), 255));
-			}
-			else
-			{
-				k2 = 255 - qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-				tmpR.setRgb(cc, cm, cy);
-				tmpR.getHsv(&hu, &sa, &v);
-				tmpR.setHsv(hu, sa * k2 / 255, 255 - ((255 - v) * k2 / 255));
-				tmpR.getRgb(&cc2, &cm2, &cy2);
-				*s = qRgba(cc2, cm2, cy2, qAlpha(r));
-			}
-			s++;
+			tmpR.setHsv(hu, sa * k2 / 255, 255 - ((255 - v) * k2 / 255));
+			tmpR.getRgb(&cc2, &cm2, &cy2);
+			inkTable[k2] = qRgba(cc2, cm2, cy2, 0);
 		}
 	}
+	for (int yi = 0; yi < h; ++yi)
+		ScImageKernels::applyInkTable((QRgb*) scanLine(yi), w, inkTable, cmyk);
 }
 
 void ScImage::duotone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray curve1, bool lin1, ScColor color2, int shade2, FPointArray curve2, bool lin2, bool cmyk)
@@ -881,9 +586,9 @@ void ScImage::duotone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray c
 	int w = width();
 	int c, c1, m, m1, y, y1, k, k1;
 	int cn, c1n, mn, m1n, yn, y1n, kn, k1n;
-	uchar cb;
 	QVector<int> curveTable1;
 	QVector<int> curveTable2;
+	QRgb inkTable[256];
 	CMYKColor cmykCol;
 	ScColorEngine::getShadeColorCMYK(color1, doc, cmykCol, shade1);
 	cmykCol.getValues(c, m, y, k);
@@ -899,36 +604,29 @@ void ScImage::duotone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray c
 	{
 		curveTable2[x] = qMin(255, qMax(0, qRound(getCurveYValue(curve2, x / 255.0, lin2) * 255)));
 	}
-	for (int yi=0; yi < h; ++yi)
-	{
-		QRgb * s = (QRgb*)(scanLine( yi ));
-		for (int xi=0; xi < w; ++xi)
+	// The resulting color only depends on the ink level of the pixel
+	for (int cb = 0; cb < 256; ++cb)
+	{
+		cn = qMin((c * curveTable1[cb]) >> 8, 255);
+		mn = qMin((m * curveTable1[cb]) >> 8, 255);
+		yn = qMin((y * curveTable1[cb]) >> 8, 255);
+		kn = qMin((k * curveTable1[cb]) >> 8, 255);
+		c1n = qMin((c1 * curveTable1[cb]) >> 8, 255);
+		m1n = qMin((m1 * curveTable2[cb]) >> 8, 255);
+		y1n = qMin((y1 * curveTable2[cb]) >> 8, 255);
+		k1n = qMin((k1 * curveTable2[cb]) >> 8, 255);
+		ScColor col = ScColor(qMin(cn + c1n, 255), qMin(mn + m1n, 255), qMin(yn + y1n, 255), qMin(kn + k1n, 255));
+		if (cmyk)
+			col.getCMYK(&cn, &mn, &yn, &kn);
+		else
 		{
-			QRgb r = *s;
-			if (cmyk)
-				cb = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
-			else
-				cb = 255 - qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-			cn = qMin((c * curveTable1[(int)cb]) >> 8, 255);
-			mn = qMin((m * curveTable1[(int)cb]) >> 8, 255);
-			yn = qMin((y * curveTable1[(int)cb]) >> 8, 255);
-			kn = qMin((k * curveTable1[(int)cb]) >> 8, 255);
-			c1n = qMin((c1 * curveTable1[(int)cb]) >> 8, 255);
-			m1n = qMin((m1 * curveTable2[(int)cb]) >> 8, 255);
-			y1n = qMin((y1 * curveTable2[(int)cb]) >> 8, 255);
-			k1n = qMin((k1 * curveTable2[(int)cb]) >> 8, 255);
-			ScColor col = ScColor(qMin(cn + c1n, 255), qMin(mn + m1n, 255), qMin(yn + y1n, 255), qMin(kn + k1n, 255));
-			if (cmyk)
-				col.getCMYK(&cn, &mn, &yn, &kn);
-			else
-			{
-				col.getRawRGBColor(&cn, &mn, &yn);
-				kn = qAlpha(r);
-			}
-			*s = qRgba(cn, mn, yn, kn);
-			s++;
+			col.getRawRGBColor(&cn, &mn, &yn);
+			kn = 0;
 		}
+		inkTable[cb] = qRgba(cn, mn, yn, kn);
 	}
+	for (int yi = 0; yi < h; ++yi)
+		ScImageKernels::applyInkTable((QRgb*) scanLine(yi), w, inkTable, cmyk);
 }
 
 void ScImage::tritone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray curve1, bool lin1, ScColor color2, int shade2, FPointArray curve2, bool lin2, ScColor color3, int shade3, const FPointArray& curve3, bool lin3, bool cmyk)
@@ -937,11 +635,11 @@ void ScImage::tritone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray c
 	int w = width();
 	int c, c1, c2, m, m1, m2, y, y1, y2, k, k1, k2;
 	int cn, c1n, c2n, mn, m1n, m2n, yn, y1n, y2n, kn, k1n, k2n;
-	uchar cb;
 	CMYKColor cmykCol;
 	QVector<int> curveTable1;
 	QVector<int> curveTable2;
 	QVector<int> curveTable3;
+	QRgb inkTable[256];
 	ScColorEngine::getShadeColorCMYK(color1, doc, cmykCol, shade1);
 	cmykCol.getValues(c, m, y, k);
 	ScColorEngine::getShadeColorCMYK(color2, doc, cmykCol, shade2);
@@ -963,40 +661,33 @@ void ScImage::tritone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray c
 	{
 		curveTable3[x] = qMin(255, qMax(0, qRound(getCurveYValue(curve2, x / 255.0, lin3) * 255)));
 	}
-	for (int yi = 0; yi < h; ++yi)
-	{
-		QRgb * s = (QRgb*)(scanLine( yi ));
-		for (int xi = 0; xi < w; ++xi)
+	// The resulting color only depends on the ink level of the pixel
+	for (int cb = 0; cb < 256; ++cb)
+	{
+		cn = qMin((c * curveTable1[cb]) >> 8, 255);
+		mn = qMin((m * curveTable1[cb]) >> 8, 255);
+		yn = qMin((y * curveTable1[cb]) >> 8, 255);
+		kn = qMin((k * curveTable1[cb]) >> 8, 255);
+		c1n = qMin((c1 * curveTable2[cb]) >> 8, 255);
+		m1n = qMin((m1 * curveTable2[cb]) >> 8, 255);
+		y1n = qMin((y1 * curveTable2[cb]) >> 8, 255);
+		k1n = qMin((k1 * curveTable2[cb]) >> 8, 255);
+		c2n = qMin((c2 * curveTable3[cb]) >> 8, 255);
+		m2n = qMin((m2 * curveTable3[cb]) >> 8, 255);
+		y2n = qMin((y2 * curveTable3[cb]) >> 8, 255);
+		k2n = qMin((k2 * curveTable3[cb]) >> 8, 255);
+		ScColor col = ScColor(qMin(cn+c1n+c2n, 255), qMin(mn+m1n+m2n, 255), qMin(yn+y1n+y2n, 255), qMin(kn+k1n+k2n, 255));
+		if (cmyk)
+			col.getCMYK(&cn, &mn, &yn, &kn);
+		else
 		{
-			QRgb r = *s;
-			if (cmyk)
-				cb = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
-			else
-				cb = 255 - qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-			cn = qMin((c * curveTable1[(int)cb]) >> 8, 255);
-			mn = qMin((m * curveTable1[(int)cb]) >> 8, 255);
-			yn = qMin((y * curveTable1[(int)cb]) >> 8, 255);
-			kn = qMin((k * curveTable1[(int)cb]) >> 8, 255);
-			c1n = qMin((c1 * curveTable2[(int)cb]) >> 8, 255);
-			m1n = qMin((m1 * curveTable2[(int)cb]) >> 8, 255);
-			y1n = qMin((y1 * curveTable2[(int)cb]) >> 8, 255);
-			k1n = qMin((k1 * curveTable2[(int)cb]) >> 8, 255);
-			c2n = qMin((c2 * curveTable3[(int)cb]) >> 8, 255);
-			m2n = qMin((m2 * curveTable3[(int)cb]) >> 8, 255);
-			y2n = qMin((y2 * curveTable3[(int)cb]) >> 8, 255);
-			k2n = qMin((k2 * curveTable3[(int)cb]) >> 8, 255);
-			ScColor col = ScColor(qMin(cn+c1n+c2n, 255), qMin(mn+m1n+m2n, 255), qMin(yn+y1n+y2n, 255), qMin(kn+k1n+k2n, 255));
-			if (cmyk)
-				col.getCMYK(&cn, &mn, &yn, &kn);
-			else
-			{
-				col.getRawRGBColor(&cn, &mn, &yn);
-				kn = qAlpha(r);
-			}
-			*s = qRgba(cn, mn, yn, kn);
-			s++;
+			col.getRawRGBColor(&cn, &mn, &yn);
+			kn = 0;
 		}
+		inkTable[cb] = qRgba(cn, mn, yn, kn);
 	}
+	for (int yi = 0; yi < h; ++yi)
+		ScImageKernels::applyInkTable((QRgb*) scanLine(yi), w, inkTable, cmyk);
 }
 
 void ScImage::quadtone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray curve1, bool lin1, ScColor color2, int shade2, FPointArray curve2, bool lin2, ScColor color3, int shade3, FPointArray curve3, bool lin3, ScColor color4, int shade4, FPointArray curve4, bool lin4, bool cmyk)
@@ -1005,12 +696,12 @@ void ScImage::quadtone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray
 	int w = width();
 	int c, c1, c2, c3, m, m1, m2, m3, y, y1, y2, y3, k, k1, k2, k3;
 	int cn, c1n, c2n, c3n, mn, m1n, m2n, m3n, yn, y1n, y2n, y3n, kn, k1n, k2n, k3n;
-	uchar cb;
 	CMYKColor cmykCol;
 	QVector<int> curveTable1;
 	QVector<int> curveTable2;
 	QVector<int> curveTable3;
 	QVector<int> curveTable4;
+	QRgb inkTable[256];
 	ScColorEngine::getShadeColorCMYK(color1, doc, cmykCol, shade1);
 	cmykCol.getValues(c, m, y, k);
 	ScColorEngine::getShadeColorCMYK(color2, doc, cmykCol, shade2);
@@ -1039,123 +730,61 @@ void ScImage::quadtone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray
 	{
 		curveTable4[x] = qMin(255, qMax(0, qRound(getCurveYValue(curve4, x / 255.0, lin4) * 255)));
 	}
-	for (int yi=0; yi < h; ++yi)
-	{
-		QRgb * s = (QRgb*)(scanLine( yi ));
-		for (int xi = 0; xi < w; ++xi)
+	// The resulting color only depends on the ink level of the pixel
+	for (int cb = 0; cb < 256; ++cb)
+	{
+		cn = qMin((c * curveTable1[cb]) >> 8, 255);
+		mn = qMin((m * curveTable1[cb]) >> 8, 255);
+		yn = qMin((y * curveTable1[cb]) >> 8, 255);
+		kn = qMin((k * curveTable1[cb]) >> 8, 255);
+		c1n = qMin((c1 * curveTable2[cb]) >> 8, 255);
+		m1n = qMin((m1 * curveTable2[cb]) >> 8, 255);
+		y1n = qMin((y1 * curveTable2[cb]) >> 8, 255);
+		k1n = qMin((k1 * curveTable2[cb]) >> 8, 255);
+		c2n = qMin((c2 * curveTable3[cb]) >> 8, 255);
+		m2n = qMin((m2 * curveTable3[cb]) >> 8, 255);
+		y2n = qMin((y2 * curveTable3[cb]) >> 8, 255);
+		k2n = qMin((k2 * curveTable3[cb]) >> 8, 255);
+		c3n = qMin((c3 * curveTable4[cb]) >> 8, 255);
+		m3n = qMin((m3 * curveTable4[cb]) >> 8, 255);
+		y3n = qMin((y3 * curveTable4[cb]) >> 8, 255);
+		k3n = qMin((k3 * curveTable4[cb]) >> 8, 255);
+		ScColor col = ScColor(qMin(cn+c1n+c2n+c3n, 255), qMin(mn+m1n+m2n+m3n, 255), qMin(yn+y1n+y2n+y3n, 255), qMin(kn+k1n+k2n+k3n, 255));
+		if (cmyk)
+			col.getCMYK(&cn, &mn, &yn, &kn);
+		else
 		{
-			QRgb r = *s;
-			if (cmyk)
-				cb = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
-			else
-				cb = 255 - qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-			cn = qMin((c * curveTable1[(int)cb]) >> 8, 255);
-			mn = qMin((m * curveTable1[(int)cb]) >> 8, 255);
-			yn = qMin((y * curveTable1[(int)cb]) >> 8, 255);
-			kn = qMin((k * curveTable1[(int)cb]) >> 8, 255);
-			c1n = qMin((c1 * curveTable2[(int)cb]) >> 8, 255);
-			m1n = qMin((m1 * curveTable2[(int)cb]) >> 8, 255);
-			y1n = qMin((y1 * curveTable2[(int)cb]) >> 8, 255);
-			k1n = qMin((k1 * curveTable2[(int)cb]) >> 8, 255);
-			c2n = qMin((c2 * curveTable3[(int)cb]) >> 8, 255);
-			m2n = qMin((m2 * curveTable3[(int)cb]) >> 8, 255);
-			y2n = qMin((y2 * curveTable3[(int)cb]) >> 8, 255);
-			k2n = qMin((k2 * curveTable3[(int)cb]) >> 8, 255);
-			c3n = qMin((c3 * curveTable4[(int)cb]) >> 8, 255);
-			m3n = qMin((m3 * curveTable4[(int)cb]) >> 8, 255);
-			y3n = qMin((y3 * curveTable4[(int)cb]) >> 8, 255);
-			k3n = qMin((k3 * curveTable4[(int)cb]) >> 8, 255);
-			ScColor col = ScColor(qMin(cn+c1n+c2n+c3n, 255), qMin(mn+m1n+m2n+m3n, 255), qMin(yn+y1n+y2n+y3n, 255), qMin(kn+k1n+k2n+k3n, 255));
-			if (cmyk)
-				col.getCMYK(&cn, &mn, &yn, &kn);
-			else
-			{
-				col.getRawRGBColor(&cn, &mn, &yn);
-				kn = qAlpha(r);
-			}
-			*s = qRgba(cn, mn, yn, kn);
-			s++;
+			col.getRawRGBColor(&cn, &mn, &yn);
+			kn = 0;
 		}
+		inkTable[cb] = qRgba(cn, mn, yn, kn);
 	}
+	for (int yi = 0; yi < h; ++yi)
+		ScImageKernels::applyInkTable((QRgb*) scanLine(yi), w, inkTable, cmyk);
 }
 
 void ScImage::invert(bool cmyk)
 {
 	int h = height();
 	int w = width();
-	unsigned char *p;
-	QRgb * s;
-	unsigned char c, m, y, k;
 	for (int yi = 0; yi < h; ++yi)
-	{
-		s = (QRgb*)(scanLine( yi ));
-		for (int xi = 0; xi < w; ++xi)
-		{
-			if (cmyk)
-			{
-				p = (unsigned char *) s;
-				c = 255 - qMin(255, p[0] + p[3]);
-				m = 255 - qMin(255, p[1] + p[3]);
-				y = 255 - qMin(255, p[2] + p[3]);
-				k = qMin(qMin(c, m), y);
-				p[0] = c - k;
-				p[1] = m - k;
-				p[2] = y - k;
-				p[3] = k;
-			}
-			else
-				*s ^= 0x00ffffff;
-			s++;
-		}
-	}
+		ScImageKernels::invert((QRgb*) scanLine(yi), w, cmyk);
 }
 
 void ScImage::toGrayscale(bool cmyk)
 {
 	int h = height();
 	int w = width();
-	int k;
-	QRgb * s;
-	QRgb r;
 	for (int yi = 0; yi < h; ++yi)
-	{
-		s = (QRgb*)(scanLine( yi ));
-		for (int xi = 0; xi < w; ++xi)
-		{
-			r = *s;
-			if (cmyk)
-			{
-				k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
-				*s = qRgba(0, 0, 0, k);
-			}
-			else
-			{
-				k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-				*s = qRgba(k, k, k, qAlpha(r));
-			}
-			s++;
-		}
-	}
+		ScImageKernels::toGrayscale((QRgb*) scanLine(yi), w, cmyk);
 }
 
 void ScImage::swapRGBA()
 {
-	unsigned int *ptr;
-	unsigned char *p;
-	unsigned char r, b;
-	for (int i = 0; i < height(); ++i)
-	{
-		ptr = (unsigned int *) scanLine(i);
-		for (int j = 0; j < width(); ++j)
-		{
-			p = (unsigned char *) ptr;
-			r = p[0];
-			b = p[2];
-			p[2] = r;
-			p[0] = b;
-			ptr++;
-		}
-	}
+	int h = height();
+	int w = width();
+	for (int yi = 0; yi < h; ++yi)
+		ScImageKernels::swapRedBlue((QRgb*) scanLine(yi), w);
 }
 
 bool ScImage::createLowRes(double scale)
@@ -1204,53 +833,33 @@ bool ScImage::convert2JPG(const QString& fn, int Quality, bool isCMYK, bool isGr
 
 QByteArray ScImage::ImageToArray() const
 {
-	int i = 0;
 	int h = height();
 	int w = width();
-	unsigned char u;
-	const QRgb *rgb;
-	QByteArray imgArray(3 * h * w, ' ');
+	qsizetype scanLineSize = 3 * qsizetype(w);
+	QByteArray imgArray(scanLineSize * h, ' ');
 	if (imgArray.isNull())
 		return imgArray;
+	uchar* data = (uchar*) imgArray.data();
 	for (int yi = 0; yi < h; ++yi)
-	{
-		rgb = (QRgb*) this->constScanLine(yi);
-		for (int xi = 0; xi < w; ++xi)
-		{
-			u = qRed(*rgb);
-			imgArray[i++] = u;
-			u = qGreen(*rgb);
-			imgArray[i++] = u;
-			u = qBlue(*rgb);
-			imgArray[i++] = u;
-			++rgb;
-		}
-	}
+		ScImageKernels::packRGB((const QRgb*) constScanLine(yi), w, data + yi * scanLineSize);
 	return imgArray;
 }
 
 void ScImage::convertToGray()
 {
-	int k;
 	int h = height();
 	int w = width();
-	QRgb *s, r;
+	QRgb *s;
 	for (int yi = 0; yi < h; ++yi)
 	{
 		s = (QRgb*)(scanLine( yi ));
 		for (int xi = 0; xi < w; ++xi)
-		{
-			r = *s;
-			k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-			*s++ = qRgba(k, 0, 0, 0);
-		}
+			s[xi] = qRgba(ScImageKernels::luminance(s[xi]), 0, 0, 0);
 	}
 }
 
 bool ScImage::writeRGBDataToFilter(ScStreamFilter* filter) const
 {
-	QRgb r;
-	const QRgb *s;
 	QByteArray buffer;
 	bool success = true;
 	int  h = height();
@@ -1261,16 +870,11 @@ bool ScImage::writeRGBDataToFilter(ScStreamFilter* filter) const
 	buffer.resize(bufferSize + 16);
 	if (buffer.isNull()) // Memory allocation failure
 		return false;
+	uchar* data = (uchar*) buffer.data();
 	for (int yi = 0; yi < h; ++yi)
 	{
-		s = (const QRgb*) constScanLine(yi);
-		for (int xi = 0; xi < w; ++xi)
-		{
-			r = *s++;
-			buffer[pending++] = static_cast<unsigned char>(qRed(r));
-			buffer[pending++] = static_cast<unsigned char>(qGreen(r));
-			buffer[pending++] = static_cast<unsigned char>(qBlue(r));
-		}
+		ScImageKernels::packRGB((const QRgb*) constScanLine(yi), w, data + pending);
+		pending += scanLineSize;
 		if (pending >= bufferSize)
 		{
 			success &= filter->writeData(buffer.constData(), pending);
@@ -1284,41 +888,25 @@ bool ScImage::writeRGBDataToFilter(ScStreamFilter* filter) const
 
 bool ScImage::writeGrayDataToFilter(ScStreamFilter* filter, bool precal) const
 {
-	QRgb r;
-	const QRgb *s;
 	QByteArray buffer;
 	bool success = true;
 	int  h = height();
 	int  w = width();
-	int  pending = 0, k;
+	int  pending = 0;
 	int  scanLineSize = w;
 	int  bufferSize   = qMax(scanLineSize, (65536 - 65536 % scanLineSize));
 	buffer.resize(bufferSize + 16);
 	if (buffer.isNull()) // Memory allocation failure
 		return false;
+	uchar* data = (uchar*) buffer.data();
 	for (int yi = 0; yi < h; ++yi)
 	{
-		s = (const QRgb*) constScanLine(yi);
+		const QRgb* s = (const QRgb*) constScanLine(yi);
 		if (precal) // image data is already grayscale, no need for weighted conversion
-		{
-			for (int xi = 0; xi < w; ++xi)
-			{
-				r = *s;
-				k = qRed(r);
-				buffer[pending++] = k;
-				s++;
-			}
-		}
+			ScImageKernels::packRed(s, w, data + pending);
 		else
-		{
-			for (int xi = 0; xi < w; ++xi)
-			{
-				r = *s;
-				k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-				buffer[pending++] = k;
-				s++;
-			}
-		}
+			ScImageKernels::packGray(s, w, data + pending);
+		pending += scanLineSize;
 		if (pending >= bufferSize)
 		{
 			success &= filter->writeData(buffer.constData(), pending);
@@ -1377,8 +965,6 @@ bool ScImage::writeMonochromeDataToFilter(ScStreamFilter* filter, bool fromCmyk)
 
 bool ScImage::writeCMYKDataToFilter(ScStreamFilter* filter) const
 {
-	QRgb r;
-	const QRgb *s;
 	QByteArray buffer;
 	bool success = true;
 	int  h = height();
@@ -1389,17 +975,11 @@ bool ScImage::writeCMYKDataToFilter(ScStreamFilter* filter) const
 	buffer.resize(bufferSize + 16);
 	if (buffer.isNull()) // Memory allocation failure
 		return false;
+	uchar* data = (uchar*) buffer.data();
 	for (int yi = 0; yi < h; ++yi)
 	{
-		s = (const QRgb*) constScanLine(yi);
-		for (int xi = 0; xi < w; ++xi)
-		{
-			r = *s++;
-			buffer[pending++] = static_cast<unsigned char> (qRed(r));
-			buffer[pending++] = static_cast<unsigned char> (qGreen(r));
-			buffer[pending++] = static_cast<unsigned char> (qBlue(r));
-			buffer[pending++] = static_cast<unsigned char> (qAlpha(r));
-		}
+		ScImageKernels::packCMYK((const QRgb*) constScanLine(yi), w, data + pending);
+		pending += scanLineSize;
 		if (pending >= bufferSize)
 		{
 			success &= filter->writeData(buffer.constData(), pending);
@@ -2274,8 +1854,17 @@ bool ScImage::loadPicture(const QString & fn, int page, const CMSettings& cmSett
 	if (ext.isEmpty() || (!ext2.isEmpty() && (ext2 != ext)))
 		ext = ext2;
 
-	QScopedPointer<ScImgDataLoader> pDataLoader;
-	if (extensionIndicatesPDF(ext))
+	// Images linked from a document being loaded may already have been decoded in the background
+	bool loaded = false;
+	QSharedPointer<ScImgDataLoader> pDataLoader;
+	if ((requestType != Thumbnail) && !imgInfo.isRequest)
+		pDataLoader = ScImagePrefetcher::instance().take(fn, page, gsRes, loaded);
+
+	if (!pDataLoader.isNull())
+	{
+		// Decoded by ScImagePrefetcher
+	}
+	else if (extensionIndicatesPDF(ext))
 		pDataLoader.reset( new ScImgDataLoader_PDF() );
 	else if (extensionIndicatesEPSorPS(ext))
 		pDataLoader.reset( new ScImgDataLoader_PS() );
@@ -2325,7 +1914,9 @@ bool ScImage::loadPicture(const QString & fn, int page, const CMSettings& cmSett
 		pDataLoader.reset( new ScImgDataLoader_QT() );
 #endif
 
-	if (pDataLoader->loadPicture(fn, page, gsRes, (requestType == Thumbnail)))
+	if (!loaded)
+		loaded = pDataLoader->loadPicture(fn, page, gsRes, (requestType == Thumbnail));
+	if (loaded)
 	{
 		QImage::operator=(pDataLoader->image());
 		imgInfo = pDataLoader->imageInfoRecord();
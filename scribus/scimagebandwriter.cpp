@@ -0,0 +1,270 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <csetjmp>
+#include <memory>
+
+#include <QDataStream>
+#include <QFile>
+#include <QImage>
+#include <QtConcurrent>
+
+#include <png.h>
+#include <tiffio.h>
+
+#include "scimagebandwriter.h"
+#include "scstreamfilter_jpeg.h"
+
+struct ScImageBandWriterData
+{
+	QFile file;
+	QDataStream stream;
+	png_structp png { nullptr };
+	png_infop pngInfo { nullptr };
+	std::unique_ptr<ScJpegEncodeFilter> jpeg;
+	TIFF* tiff { nullptr };
+};
+
+static void ScImageBandWriter_png_write_fn(png_structp pngPtr, png_bytep data, png_size_t length)
+{
+	QFile* file = (QFile*) png_get_io_ptr(pngPtr);
+	if (file->write((const char*) data, length) != static_cast<qint64>(length))
+		png_error(pngPtr, "Write Error");
+}
+
+static void ScImageBandWriter_png_flush_fn(png_structp /*pngPtr*/)
+{
+}
+
+ScImageBandWriter::ScImageBandWriter(const QString& fileName, const QString& format)
+	: m_fileName(fileName),
+	  m_format(formatFromName(format))
+{
+}
+
+ScImageBandWriter::~ScImageBandWriter()
+{
+	waitForQueuedBand();
+	freeData();
+}
+
+ScImageBandWriter::Format ScImageBandWriter::formatFromName(const QString& format)
+{
+	QString ext = format.toLower();
+	if (ext == "png")
+		return PNG;
+	if ((ext == "jpg") || (ext == "jpeg"))
+		return JPEG;
+	if ((ext == "tif") || (ext == "tiff"))
+		return TIFF;
+	return Unsupported;
+}
+
+bool ScImageBandWriter::canWriteBands(const QString& format)
+{
+	return formatFromName(format) != Unsupported;
+}
+
+bool ScImageBandWriter::open(int width, int height)
+{
+	waitForQueuedBand();
+	freeData();
+	if ((m_format == Unsupported) || (width <= 0) || (height <= 0))
+		return false;
+	m_width = width;
+	m_height = height;
+	m_rowsWritten = 0;
+	m_data = new ScImageBandWriterData();
+
+	bool opened = false;
+	if (m_format == PNG)
+		opened = openPNG();
+	else if (m_format == JPEG)
+		opened = openJPEG();
+	else if (m_format == TIFF)
+		opened = openTIFF();
+	if (!opened)
+	{
+		freeData();
+		QFile::remove(m_fileName);
+	}
+	return opened;
+}
+
+bool ScImageBandWriter::openPNG()
+{
+	m_data->file.setFileName(m_fileName);
+	if (!m_data->file.open(QIODevice::WriteOnly))
+		return false;
+	m_data->png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+	if (!m_data->png)
+		return false;
+	m_data->pngInfo = png_create_info_struct(m_data->png);
+	if (!m_data->pngInfo)
+		return false;
+	if (setjmp(png_jmpbuf(m_data->png)))
+		return false;
+
+	png_set_write_fn(m_data->png, &m_data->file, ScImageBandWriter_png_write_fn, ScImageBandWriter_png_flush_fn);
+	png_set_IHDR(m_data->png, m_data->pngInfo, m_width, m_height, 8, PNG_COLOR_TYPE_RGB_ALPHA,
+				 PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	if (m_dpi > 0)
+	{
+		png_uint_32 dpm = qRound(m_dpi / 0.0254);
+		png_set_pHYs(m_data->png, m_data->pngInfo, dpm, dpm, PNG_RESOLUTION_METER);
+	}
+	// Same mapping of quality to compression as Qt's PNG writer
+	if (m_quality >= 0)
+		png_set_compression_level(m_data->png, qBound(0, (100 - m_quality) * 9 / 91, 9));
+	png_write_info(m_data->png, m_data->pngInfo);
+	return true;
+}
+
+bool ScImageBandWriter::openJPEG()
+{
+	m_data->file.setFileName(m_fileName);
+	if (!m_data->file.open(QIODevice::WriteOnly))
+		return false;
+	m_data->stream.setDevice(&m_data->file);
+	m_data->jpeg = std::make_unique<ScJpegEncodeFilter>(&m_data->stream, m_width, m_height, ScJpegEncodeFilter::RGB);
+	if (m_quality >= 0)
+		m_data->jpeg->setQuality(m_quality);
+	m_data->jpeg->setResolution(m_dpi);
+	return m_data->jpeg->openFilter();
+}
+
+bool ScImageBandWriter::openTIFF()
+{
+	// Classic TIFF files are limited to 4 GB
+	qint64 imageBytes = static_cast<qint64>(m_width) * m_height * 4;
+	const char* mode = (imageBytes > Q_INT64_C(0xE0000000)) ? "w8" : "w";
+	m_data->tiff = TIFFOpen(QFile::encodeName(m_fileName).constData(), mode);
+	if (!m_data->tiff)
+		return false;
+	uint16_t extraSamples[] = { EXTRASAMPLE_UNASSALPHA };
+	TIFFSetField(m_data->tiff, TIFFTAG_IMAGEWIDTH, m_width);
+	TIFFSetField(m_data->tiff, TIFFTAG_IMAGELENGTH, m_height);
+	TIFFSetField(m_data->tiff, TIFFTAG_BITSPERSAMPLE, 8);
+	TIFFSetField(m_data->tiff, TIFFTAG_SAMPLESPERPIXEL, 4);
+	TIFFSetField(m_data->tiff, TIFFTAG_EXTRASAMPLES, 1, extraSamples);
+	TIFFSetField(m_data->tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+	TIFFSetField(m_data->tiff, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+	TIFFSetField(m_data->tiff, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+	TIFFSetField(m_data->tiff, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(m_data->tiff, 0));
+	if (m_dpi > 0)
+	{
+		TIFFSetField(m_data->tiff, TIFFTAG_RESOLUTIONUNIT, RESUNIT_INCH);
+		TIFFSetField(m_data->tiff, TIFFTAG_XRESOLUTION, static_cast<float>(m_dpi));
+		TIFFSetField(m_data->tiff, TIFFTAG_YRESOLUTION, static_cast<float>(m_dpi));
+	}
+	return true;
+}
+
+bool ScImageBandWriter::writeBand(const QImage& band)
+{
+	if (!m_data || (band.width() != m_width))
+		return false;
+	int rows = qMin(band.height(), m_height - m_rowsWritten);
+	if (rows <= 0)
+		return band.isNull();
+
+	QImage converted = band.convertToFormat((m_format == JPEG) ? QImage::Format_RGB888 : QImage::Format_RGBA8888);
+	if (converted.isNull())
+		return false;
+	for (int y = 0; y < rows; ++y)
+	{
+		if (!writeRow(converted.constScanLine(y)))
+		{
+			freeData();
+			return false;
+		}
+		++m_rowsWritten;
+	}
+	return true;
+}
+
+bool ScImageBandWriter::queueBand(const QImage& band)
+{
+	if (!waitForQueuedBand() || !m_data)
+		return false;
+	m_queuedBand = QtConcurrent::run([this, band]() { return writeBand(band); });
+	return true;
+}
+
+bool ScImageBandWriter::waitForQueuedBand()
+{
+	if (m_queuedBand.isCanceled())
+		return true;
+	bool result = m_queuedBand.result();
+	m_queuedBand = QFuture<bool>();
+	return result;
+}
+
+bool ScImageBandWriter::writeRow(const uchar* row)
+{
+	if (m_format == PNG)
+	{
+		if (setjmp(png_jmpbuf(m_data->png)))
+			return false;
+		png_write_row(m_data->png, const_cast<png_bytep>(row));
+		return true;
+	}
+	if (m_format == JPEG)
+		return m_data->jpeg->writeData(reinterpret_cast<const char*>(row), m_width * 3);
+	if (m_format == TIFF)
+		return TIFFWriteScanline(m_data->tiff, const_cast<uchar*>(row), m_rowsWritten, 0) == 1;
+	return false;
+}
+
+bool ScImageBandWriter::close()
+{
+	waitForQueuedBand();
+	if (!m_data)
+	{
+		QFile::remove(m_fileName);
+		return false;
+	}
+
+	bool success = (m_rowsWritten == m_height);
+	if (success && (m_format == PNG))
+	{
+		if (setjmp(png_jmpbuf(m_data->png)))
+			success = false;
+		else
+			png_write_end(m_data->png, m_data->pngInfo);
+	}
+	else if (success && (m_format == JPEG))
+		success = m_data->jpeg->closeFilter();
+	else if (m_format == TIFF)
+	{
+		TIFFClose(m_data->tiff);
+		m_data->tiff = nullptr;
+	}
+	if (m_data->file.isOpen())
+	{
+		m_data->file.close();
+		success = success && (m_data->file.error() == QFileDevice::NoError);
+	}
+	freeData();
+
+	if (!success)
+		QFile::remove(m_fileName);
+	return success;
+}
+
+void ScImageBandWriter::freeData()
+{
+	if (!m_data)
+		return;
+	if (m_data->png)
+		png_destroy_write_struct(&m_data->png, &m_data->pngInfo);
+	m_data->jpeg.reset();
+	if (m_data->tiff)
+		TIFFClose(m_data->tiff);
+	delete m_data;
+	m_data = nullptr;
+}
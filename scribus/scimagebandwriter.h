@@ -0,0 +1,83 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCIMAGEBANDWRITER_H
+#define SCIMAGEBANDWRITER_H
+
+#include <QFuture>
+#include <QString>
+
+#include "scribusapi.h"
+
+class QImage;
+struct ScImageBandWriterData;
+
+/**
+ * Writes a PNG, JPEG or TIFF image from horizontal bands of rows, top to
+ * bottom, so that the whole image never has to be in memory. Bands are
+ * QImages as wide as the image, in any format QImage can convert from;
+ * premultiplied alpha is written unpremultiplied.
+ *
+ * queueBand() encodes on a worker thread so that the next band can be
+ * rendered meanwhile; at most one band is encoded at a time and bands are
+ * always written in the order they were queued.
+ */
+class SCRIBUS_API ScImageBandWriter
+{
+public:
+	ScImageBandWriter(const QString& fileName, const QString& format);
+	~ScImageBandWriter();
+
+	/// Returns true if images of \a format, e.g. "png" or "tif", can be written band by band
+	static bool canWriteBands(const QString& format);
+
+	/// Quality <0; 100> as for QImage::save(), -1 for the default
+	void setQuality(int quality) { m_quality = quality; }
+	void setResolution(int dpi) { m_dpi = dpi; }
+
+	bool open(int width, int height);
+	/// Appends the rows of \a band below the rows already written
+	bool writeBand(const QImage& band);
+	/// Like writeBand() but returns before the band is encoded, waiting for the previous band first
+	bool queueBand(const QImage& band);
+	/// Finishes the file, fails if fewer rows than the image height were written
+	bool close();
+
+	int width() const { return m_width; }
+	int height() const { return m_height; }
+	int rowsWritten() const { return m_rowsWritten; }
+
+private:
+	enum Format
+	{
+		Unsupported,
+		PNG,
+		JPEG,
+		TIFF
+	};
+
+	static Format formatFromName(const QString& format);
+
+	bool openPNG();
+	bool openJPEG();
+	bool openTIFF();
+	bool waitForQueuedBand();
+	bool writeRow(const uchar* row);
+	void freeData();
+
+	QString m_fileName;
+	Format m_format { Unsupported };
+	int m_quality { -1 };
+	int m_dpi { 72 };
+	int m_width { 0 };
+	int m_height { 0 };
+	int m_rowsWritten { 0 };
+	ScImageBandWriterData* m_data { nullptr };
+	QFuture<bool> m_queuedBand;
+};
+
+#endif
@@ -0,0 +1,294 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifdef __SSE2__
+	#include <emmintrin.h>
+#endif
+
+#include "scimagekernels.h"
+
+namespace
+{
+	inline int channel(QRgb p, int c)
+	{
+		return (p >> (8 * c)) & 0xff;
+	}
+
+	/// Fills the blur stack with the pixels around the first one and sums its window
+	void initBlurWindow(const QRgb* line, int count, qsizetype step, int radius, QRgb* stack, int* sum, int* inSum, int* outSum)
+	{
+		for (int c = 0; c < 4; ++c)
+			sum[c] = inSum[c] = outSum[c] = 0;
+		for (int i = -radius; i <= radius; ++i)
+		{
+			QRgb p = line[qMin(count - 1, qMax(i, 0)) * step];
+			stack[i + radius] = p;
+			int weight = radius + 1 - qAbs(i);
+			for (int c = 0; c < 4; ++c)
+			{
+				sum[c] += channel(p, c) * weight;
+				if (i > 0)
+					inSum[c] += channel(p, c);
+				else
+					outSum[c] += channel(p, c);
+			}
+		}
+	}
+
+	/// Packs the channels of a convolved pixel, scaled to 16 bit
+	inline QRgb convolvedPixel(const double* sum)
+	{
+		QRgb p = 0;
+		for (int c = 0; c < 4; ++c)
+		{
+			double v = (sum[c] < 0) ? 0 : (sum[c] > 65535) ? 65535 : sum[c] + 0.5;
+			p |= QRgb(static_cast<uchar>(v / 257)) << (8 * c);
+		}
+		return p;
+	}
+
+#ifdef __SSE2__
+	/// Channels of a pixel as 32 bit integers, blue first
+	inline __m128i unpackPixel(QRgb p)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(p)), zero), zero);
+	}
+#endif
+}
+
+void ScImageKernels::applyTable(uchar* __restrict data, int count, const uchar* __restrict table)
+{
+	for (int i = 0; i < count; ++i)
+		data[i] = table[data[i]];
+}
+
+void ScImageKernels::applyTableRGB(QRgb* __restrict row, int width, const uchar* __restrict table)
+{
+	for (int x = 0; x < width; ++x)
+	{
+		QRgb c = row[x];
+		row[x] = (c & 0xff000000) | (table[qRed(c)] << 16) | (table[qGreen(c)] << 8) | table[qBlue(c)];
+	}
+}
+
+void ScImageKernels::applyInkTable(QRgb* __restrict row, int width, const QRgb* __restrict table, bool cmyk)
+{
+	if (cmyk)
+	{
+		for (int x = 0; x < width; ++x)
+			row[x] = table[inkLevel(row[x], true)];
+	}
+	else
+	{
+		for (int x = 0; x < width; ++x)
+			row[x] = table[inkLevel(row[x], false)] | (row[x] & 0xff000000);
+	}
+}
+
+void ScImageKernels::invert(QRgb* row, int width, bool cmyk)
+{
+	if (!cmyk)
+	{
+		for (int x = 0; x < width; ++x)
+			row[x] ^= 0x00ffffff;
+		return;
+	}
+	for (int x = 0; x < width; ++x)
+	{
+		QRgb p = row[x];
+		int k = qAlpha(p);
+		int c = 255 - qMin(255, qRed(p) + k);
+		int m = 255 - qMin(255, qGreen(p) + k);
+		int y = 255 - qMin(255, qBlue(p) + k);
+		int kn = qMin(qMin(c, m), y);
+		row[x] = qRgba(c - kn, m - kn, y - kn, kn);
+	}
+}
+
+void ScImageKernels::toGrayscale(QRgb* row, int width, bool cmyk)
+{
+	if (cmyk)
+	{
+		for (int x = 0; x < width; ++x)
+			row[x] = qRgba(0, 0, 0, inkLevel(row[x], true));
+	}
+	else
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			int k = luminance(row[x]);
+			row[x] = qRgba(k, k, k, qAlpha(row[x]));
+		}
+	}
+}
+
+void ScImageKernels::swapRedBlue(QRgb* row, int width)
+{
+	for (int x = 0; x < width; ++x)
+	{
+		QRgb c = row[x];
+		row[x] = (c & 0xff00ff00) | ((c & 0x00ff0000) >> 16) | ((c & 0x000000ff) << 16);
+	}
+}
+
+void ScImageKernels::blurLine(QRgb* line, int count, qsizetype step, int radius, const uchar* divTable, QRgb* stack)
+{
+#ifdef __SSE2__
+	const int div = 2 * radius + 1;
+	const int last = count - 1;
+	int s[4], in[4], out[4];
+	initBlurWindow(line, count, step, radius, stack, s, in, out);
+	__m128i sum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+	__m128i inSum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+	__m128i outSum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(out));
+	int stackPointer = radius;
+	for (int x = 0; x < count; ++x)
+	{
+		// Read ahead before writing, the pixels entering the window are still the original ones
+		QRgb incoming = line[qMin(x + radius + 1, last) * step];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(s), sum);
+		line[x * step] = divTable[s[0]] | (divTable[s[1]] << 8) | (divTable[s[2]] << 16) | (QRgb(divTable[s[3]]) << 24);
+
+		int stackStart = (stackPointer + radius + 1) % div;
+		__m128i leaving = unpackPixel(stack[stackStart]);
+		__m128i entering = unpackPixel(incoming);
+		stack[stackStart] = incoming;
+		stackPointer = (stackPointer + 1) % div;
+		__m128i centre = unpackPixel(stack[stackPointer]);
+
+		sum = _mm_sub_epi32(sum, outSum);
+		outSum = _mm_sub_epi32(outSum, leaving);
+		inSum = _mm_add_epi32(inSum, entering);
+		sum = _mm_add_epi32(sum, inSum);
+		outSum = _mm_add_epi32(outSum, centre);
+		inSum = _mm_sub_epi32(inSum, centre);
+	}
+#else
+	blurLineScalar(line, count, step, radius, divTable, stack);
+#endif
+}
+
+void ScImageKernels::blurLineScalar(QRgb* line, int count, qsizetype step, int radius, const uchar* divTable, QRgb* stack)
+{
+	const int div = 2 * radius + 1;
+	const int last = count - 1;
+	int sum[4], inSum[4], outSum[4];
+	initBlurWindow(line, count, step, radius, stack, sum, inSum, outSum);
+	int stackPointer = radius;
+	for (int x = 0; x < count; ++x)
+	{
+		// Read ahead before writing, the pixels entering the window are still the original ones
+		QRgb incoming = line[qMin(x + radius + 1, last) * step];
+		line[x * step] = divTable[sum[0]] | (divTable[sum[1]] << 8) | (divTable[sum[2]] << 16) | (QRgb(divTable[sum[3]]) << 24);
+
+		int stackStart = (stackPointer + radius + 1) % div;
+		QRgb leaving = stack[stackStart];
+		stack[stackStart] = incoming;
+		stackPointer = (stackPointer + 1) % div;
+		QRgb centre = stack[stackPointer];
+		for (int c = 0; c < 4; ++c)
+		{
+			sum[c] -= outSum[c];
+			outSum[c] -= channel(leaving, c);
+			inSum[c] += channel(incoming, c);
+			sum[c] += inSum[c];
+			outSum[c] += channel(centre, c);
+			inSum[c] -= channel(centre, c);
+		}
+	}
+}
+
+void ScImageKernels::convolveRow(const QRgb* const* rows, int width, const double* kernel, int order, QRgb* __restrict out)
+{
+#ifdef __SSE2__
+	const int half = order / 2;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i scale = _mm_set1_epi16(257);
+	double s[4];
+	for (int x = 0; x < width; ++x)
+	{
+		// Blue and green in the low sum, red and alpha in the high one
+		__m128d sumLow = _mm_setzero_pd();
+		__m128d sumHigh = _mm_setzero_pd();
+		const double* k = kernel;
+		for (int ky = 0; ky < order; ++ky)
+		{
+			const QRgb* row = rows[ky];
+			for (int kx = 0; kx < order; ++kx, ++k)
+			{
+				QRgb p = row[qBound(0, x + kx - half, width - 1)];
+				// Channels scaled to 16 bit fit unsigned 16 bit lanes
+				__m128i c16 = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(p)), zero), scale);
+				__m128i c32 = _mm_unpacklo_epi16(c16, zero);
+				__m128d weight = _mm_set1_pd(*k);
+				sumLow = _mm_add_pd(sumLow, _mm_mul_pd(weight, _mm_cvtepi32_pd(c32)));
+				sumHigh = _mm_add_pd(sumHigh, _mm_mul_pd(weight, _mm_cvtepi32_pd(_mm_srli_si128(c32, 8))));
+			}
+		}
+		_mm_storeu_pd(s, sumLow);
+		_mm_storeu_pd(s + 2, sumHigh);
+		out[x] = convolvedPixel(s);
+	}
+#else
+	convolveRowScalar(rows, width, kernel, order, out);
+#endif
+}
+
+void ScImageKernels::convolveRowScalar(const QRgb* const* rows, int width, const double* kernel, int order, QRgb* __restrict out)
+{
+	const int half = order / 2;
+	for (int x = 0; x < width; ++x)
+	{
+		double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+		const double* k = kernel;
+		for (int ky = 0; ky < order; ++ky)
+		{
+			const QRgb* row = rows[ky];
+			for (int kx = 0; kx < order; ++kx, ++k)
+			{
+				QRgb p = row[qBound(0, x + kx - half, width - 1)];
+				for (int c = 0; c < 4; ++c)
+					sum[c] += (*k) * (channel(p, c) * 257);
+			}
+		}
+		out[x] = convolvedPixel(sum);
+	}
+}
+
+void ScImageKernels::packRGB(const QRgb* __restrict row, int width, uchar* __restrict out)
+{
+	for (int x = 0; x < width; ++x)
+	{
+		out[3 * x] = qRed(row[x]);
+		out[3 * x + 1] = qGreen(row[x]);
+		out[3 * x + 2] = qBlue(row[x]);
+	}
+}
+
+void ScImageKernels::packCMYK(const QRgb* __restrict row, int width, uchar* __restrict out)
+{
+	for (int x = 0; x < width; ++x)
+	{
+		out[4 * x] = qRed(row[x]);
+		out[4 * x + 1] = qGreen(row[x]);
+		out[4 * x + 2] = qBlue(row[x]);
+		out[4 * x + 3] = qAlpha(row[x]);
+	}
+}
+
+void ScImageKernels::packGray(const QRgb* __restrict row, int width, uchar* __restrict out)
+{
+	for (int x = 0; x < width; ++x)
+		out[x] = luminance(row[x]);
+}
+
+void ScImageKernels::packRed(const QRgb* __restrict row, int width, uchar* __restrict out)
+{
+	for (int x = 0; x < width; ++x)
+		out[x] = qRed(row[x]);
+}
@@ -0,0 +1,84 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCIMAGEKERNELS_H
+#define SCIMAGEKERNELS_H
+
+#include <QRgb>
+
+#include "scribusapi.h"
+
+/**
+ * Scanline kernels for the effects of ScImage and for packing its pixels into
+ * the byte layouts written to stream filters.
+ *
+ * Every kernel processes one contiguous row of ARGB32 pixels with integer
+ * arithmetic and lookup tables only, without branches depending on the pixel
+ * values, so that the compiler can vectorize the loops for the instruction
+ * set of the target. CMYK images store cyan, magenta, yellow and black in the
+ * red, green, blue and alpha channels of their pixels.
+ *
+ * Blur and convolution carry sums along the row, they process the four
+ * channels of a pixel at once with SSE2 where available. Their scalar
+ * versions give the same results and are used everywhere else.
+ */
+class SCRIBUS_API ScImageKernels
+{
+public:
+	/// Weighted gray value <0; 255> of the red, green and blue channels
+	static inline int luminance(QRgb c)
+	{
+		return (30 * qRed(c) + 59 * qGreen(c) + 11 * qBlue(c) + 50) / 100;
+	}
+
+	/// Amount of ink <0; 255> of a pixel, 0 being white, as used by colorize and multitone effects
+	static inline int inkLevel(QRgb c, bool cmyk)
+	{
+		return cmyk ? qMin(luminance(c) + qAlpha(c), 255) : 255 - luminance(c);
+	}
+
+	/// Replaces each of the \a count bytes of \a data by its entry in the 256 bytes of \a table
+	static void applyTable(uchar* __restrict data, int count, const uchar* __restrict table);
+	/// Replaces red, green and blue of the pixels by their entry in \a table, alpha is kept
+	static void applyTableRGB(QRgb* __restrict row, int width, const uchar* __restrict table);
+	/**
+	 * Replaces the pixels by the entry of the 256 colors of \a table for their
+	 * inkLevel(). RGB pixels keep their alpha, table entries must have none.
+	 */
+	static void applyInkTable(QRgb* __restrict row, int width, const QRgb* __restrict table, bool cmyk);
+	static void invert(QRgb* row, int width, bool cmyk);
+	static void toGrayscale(QRgb* row, int width, bool cmyk);
+	static void swapRedBlue(QRgb* row, int width);
+
+	/**
+	 * Stack blur of the \a count pixels of \a line, which are \a step pixels
+	 * apart so that columns can be blurred in place as well. \a divTable maps
+	 * the weighted sums of the window to channel values, it holds i / (radius + 1)²
+	 * for i < 256 * (radius + 1)². \a stack has room for 2 * radius + 1 pixels.
+	 */
+	static void blurLine(QRgb* line, int count, qsizetype step, int radius, const uchar* divTable, QRgb* stack);
+	static void blurLineScalar(QRgb* line, int count, qsizetype step, int radius, const uchar* divTable, QRgb* stack);
+	/**
+	 * Convolves a row of \a width pixels with the \a order x \a order weights
+	 * of \a kernel, applied to the channels scaled to 16 bit. \a rows are the
+	 * \a order source rows centered on the row, repeating the first or last
+	 * row of the image beyond its borders.
+	 */
+	static void convolveRow(const QRgb* const* rows, int width, const double* kernel, int order, QRgb* __restrict out);
+	static void convolveRowScalar(const QRgb* const* rows, int width, const double* kernel, int order, QRgb* __restrict out);
+
+	/// Writes 3 bytes per pixel: red, green and blue
+	static void packRGB(const QRgb* __restrict row, int width, uchar* __restrict out);
+	/// Writes 4 bytes per pixel: cyan, magenta, yellow and black
+	static void packCMYK(const QRgb* __restrict row, int width, uchar* __restrict out);
+	/// Writes the luminance() of each pixel
+	static void packGray(const QRgb* __restrict row, int width, uchar* __restrict out);
+	/// Writes the red channel of each pixel, for images already converted to gray
+	static void packRed(const QRgb* __restrict row, int width, uchar* __restrict out);
+};
+
+#endif // SCIMAGEKERNELS_H
@@ -0,0 +1,164 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtConcurrent>
+
+#include "scimageprefetcher.h"
+#include "util_formats.h"
+#include "imagedataloaders/scimgdataloader_jpeg.h"
+#include "imagedataloaders/scimgdataloader_png.h"
+#include "imagedataloaders/scimgdataloader_psd.h"
+#include "imagedataloaders/scimgdataloader_tiff.h"
+
+namespace
+{
+	// Decoded images may be several hundred megabytes each, keep only a few
+	// more waiting than there are threads decoding them
+	int maxWaitingImages()
+	{
+		return 2 * qMax(1, QThread::idealThreadCount());
+	}
+
+	QString imageType(const QString& fileName)
+	{
+		QString ext = QFileInfo(fileName).suffix().toLower();
+		QString ext2 = getImageType(fileName);
+		if (ext.isEmpty() || (!ext2.isEmpty() && (ext2 != ext)))
+			ext = ext2;
+		return ext;
+	}
+}
+
+ScImagePrefetcher& ScImagePrefetcher::instance()
+{
+	static ScImagePrefetcher prefetcher;
+	return prefetcher;
+}
+
+ScImagePrefetcher::ScImagePrefetcher()
+	: m_freeSlots(maxWaitingImages())
+{
+	// One thread is taken by the scanner
+	m_threadPool.setMaxThreadCount(qMax(2, QThread::idealThreadCount() + 1));
+}
+
+bool ScImagePrefetcher::canPrefetch(const QString& fileName)
+{
+	QString ext = imageType(fileName);
+	return extensionIndicatesTIFF(ext) || extensionIndicatesPSD(ext) || extensionIndicatesJPEG(ext) || extensionIndicatesPNG(ext);
+}
+
+ScImgDataLoader* ScImagePrefetcher::createLoader(const QString& fileName)
+{
+	// Same choice of loader as ScImage::loadPicture()
+	QString ext = imageType(fileName);
+	if (extensionIndicatesJPEG(ext))
+		return new ScImgDataLoader_JPEG();
+	if (extensionIndicatesPNG(ext))
+		return new ScImgDataLoader_PNG();
+	if (extensionIndicatesPSD(ext))
+		return new ScImgDataLoader_PSD();
+	if (extensionIndicatesTIFF(ext))
+		return new ScImgDataLoader_TIFF();
+	return nullptr;
+}
+
+void ScImagePrefetcher::startBatch(const std::function<void(ScImagePrefetcher&)>& scanner)
+{
+	finishBatch();
+	m_batchRunning = true;
+	m_scanner = QtConcurrent::run(&m_threadPool, [this, scanner]() { scanner(*this); });
+}
+
+void ScImagePrefetcher::finishBatch()
+{
+	if (!m_batchRunning)
+		return;
+	m_stopping.storeRelaxed(1);
+	m_scanner.waitForFinished();
+
+	QMutexLocker locker(&m_mutex);
+	QList<Job> jobs;
+	jobs.swap(m_jobs);
+	locker.unlock();
+	dropJobs(jobs);
+
+	m_stopping.storeRelaxed(0);
+	m_batchRunning = false;
+}
+
+bool ScImagePrefetcher::isStopping() const
+{
+	return (m_stopping.loadRelaxed() != 0);
+}
+
+void ScImagePrefetcher::prefetch(const QString& fileName, int page, int gsRes)
+{
+	if (!canPrefetch(fileName))
+		return;
+	while (!m_freeSlots.tryAcquire(1, 100))
+	{
+		if (isStopping())
+			return;
+	}
+
+	Job job;
+	job.fileName = fileName;
+	job.page = page;
+	job.gsRes = gsRes;
+	job.loader.reset(createLoader(fileName));
+	QSharedPointer<ScImgDataLoader> loader = job.loader;
+	job.result = QtConcurrent::run(&m_threadPool, [loader, fileName, page, gsRes]() {
+		return loader->loadPicture(fileName, page, gsRes, false);
+	});
+
+	QMutexLocker locker(&m_mutex);
+	m_jobs.append(job);
+}
+
+QSharedPointer<ScImgDataLoader> ScImagePrefetcher::take(const QString& fileName, int page, int gsRes, bool& loaded)
+{
+	loaded = false;
+	QMutexLocker locker(&m_mutex);
+	int index = -1;
+	for (int i = 0; i < m_jobs.count(); ++i)
+	{
+		const Job& job = m_jobs.at(i);
+		if ((job.fileName == fileName) && (job.page == page) && (job.gsRes == gsRes))
+		{
+			index = i;
+			break;
+		}
+	}
+	if (index < 0)
+		return QSharedPointer<ScImgDataLoader>();
+
+	QList<Job> skipped = m_jobs.mid(0, index);
+	Job job = m_jobs.at(index);
+	m_jobs.remove(0, index + 1);
+	locker.unlock();
+
+	dropJobs(skipped);
+	loaded = job.result.result();
+	m_freeSlots.release();
+	return job.loader;
+}
+
+void ScImagePrefetcher::dropJobs(const QList<Job>& jobs)
+{
+	// Jobs not started yet are never run, running ones are left to finish on
+	// their own, the decoded data is freed with the last copy of the loader
+	for (const Job& job : jobs)
+	{
+		QFuture<bool> result = job.result;
+		result.cancel();
+		m_freeSlots.release();
+	}
+}
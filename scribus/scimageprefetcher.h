@@ -0,0 +1,98 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCIMAGEPREFETCHER_H
+#define SCIMAGEPREFETCHER_H
+
+#include <functional>
+
+#include <QAtomicInt>
+#include <QFuture>
+#include <QList>
+#include <QMutex>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+
+#include "scribusapi.h"
+
+class ScImgDataLoader;
+
+/**
+ * Decodes image files on a thread pool ahead of ScImage::loadPicture().
+ *
+ * While a document is loaded, a scanner running in the background walks the
+ * document file and calls prefetch() for every linked image it references, in
+ * document order. Decoding, by far the most expensive part of loading a TIFF
+ * or PSD, then proceeds in parallel while the document is parsed.
+ * ScImage::loadPicture() takes the decoded data with take() and performs the
+ * color management, effects and low resolution preview on the GUI thread as
+ * before, so that the result and the ScImageCacheManager entries it writes
+ * are unchanged.
+ *
+ * Only formats whose loaders need nothing from the document or from external
+ * programs are prefetched, and the scanner skips images which are expected to
+ * come from ScImageCacheManager. The number of decoded images waiting to be taken is
+ * bounded, prefetch() blocks the scanner until one of them has been taken.
+ */
+class SCRIBUS_API ScImagePrefetcher
+{
+public:
+	static ScImagePrefetcher& instance();
+
+	/// Returns true if file \a fileName is of a format decoded by prefetch()
+	static bool canPrefetch(const QString& fileName);
+
+	/**
+	 * Starts a batch of prefetches, \a scanner is run in the background and
+	 * is expected to call prefetch() for the images to be decoded.
+	 * A batch which is still running is finished first.
+	 */
+	void startBatch(const std::function<void(ScImagePrefetcher&)>& scanner);
+	/// Stops the scanner and drops the images which have not been taken, without waiting for their decoding
+	void finishBatch();
+	/// Returns true if the scanner should give up, e.g. because loading finished
+	bool isStopping() const;
+
+	/// Queues decoding of page \a page of \a fileName at ghostscript resolution \a gsRes
+	void prefetch(const QString& fileName, int page, int gsRes);
+
+	/**
+	 * Returns the loader which decoded page \a page of \a fileName, waiting
+	 * for it if necessary, or a null pointer if this image was not prefetched.
+	 * \a loaded receives the result of ScImgDataLoader::loadPicture().
+	 * Images queued before this one are assumed to be skipped by the document
+	 * loader and are dropped.
+	 */
+	QSharedPointer<ScImgDataLoader> take(const QString& fileName, int page, int gsRes, bool& loaded);
+
+private:
+	ScImagePrefetcher();
+
+	struct Job
+	{
+		QString fileName;
+		int page { 0 };
+		int gsRes { 0 };
+		QSharedPointer<ScImgDataLoader> loader;
+		QFuture<bool> result;
+	};
+
+	static ScImgDataLoader* createLoader(const QString& fileName);
+	void dropJobs(const QList<Job>& jobs);
+
+	QThreadPool m_threadPool;
+	QSemaphore m_freeSlots;
+	QMutex m_mutex;
+	QList<Job> m_jobs;
+	QFuture<void> m_scanner;
+	QAtomicInt m_stopping { 0 };
+	bool m_batchRunning { false };
+};
+
+#endif // SCIMAGEPREFETCHER_H
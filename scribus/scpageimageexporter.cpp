@@ -0,0 +1,140 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <limits>
+
+#include <QImage>
+#include <QMutexLocker>
+#include <QThread>
+
+#include "scimagebandwriter.h"
+#include "scpage.h"
+#include "scpageimageexporter.h"
+#include "scribusdoc.h"
+#include "scribusview.h"
+
+ScPageImageExporter::ScPageImageExporter(ScribusDoc* doc)
+	: m_doc(doc)
+{
+	setMaxThreads(0);
+}
+
+ScPageImageExporter::~ScPageImageExporter()
+{
+	m_threadPool.waitForDone();
+}
+
+void ScPageImageExporter::setMaxThreads(int threads)
+{
+	if (threads <= 0)
+		threads = QThread::idealThreadCount();
+	m_threadPool.setMaxThreadCount(qMax(1, threads));
+}
+
+int ScPageImageExporter::maxGr(int pageNr) const
+{
+	/* a little magic here - I need to compute the "maxGr" value...
+	* We need to know the right size of the page for landscape,
+	* portrait and user defined sizes.
+	*/
+	const ScPage* page = m_doc->Pages->at(pageNr);
+	double pixmapSize = (page->height() > page->width()) ? page->height() : page->width();
+	return qRound(pixmapSize * m_scale * (m_dpi / 72.0) / 100.0);
+}
+
+QSize ScPageImageExporter::imageSize(int pageNr) const
+{
+	return ScribusView::pageToPixmapSize(m_doc->Pages->at(pageNr), maxGr(pageNr));
+}
+
+int ScPageImageExporter::bandHeight(int imageWidth)
+{
+	// Keep a band, and the one being encoded meanwhile, around 64 MB
+	const qint64 bandBytes = 64 * 1024 * 1024;
+	qint64 rowBytes = qMax<qint64>(1, static_cast<qint64>(imageWidth) * 4);
+	return static_cast<int>(qBound<qint64>(16, bandBytes / rowBytes, std::numeric_limits<int>::max()));
+}
+
+bool ScPageImageExporter::exportPage(int pageNr, const QString& fileName)
+{
+	if ((pageNr < 0) || (pageNr >= m_doc->Pages->count()) || !m_doc->Pages->at(pageNr))
+		return false;
+
+	QSize size = imageSize(pageNr);
+	if (ScImageBandWriter::canWriteBands(m_format) && (size.height() > bandHeight(size.width())))
+	{
+		if (exportPageBands(pageNr, size, fileName))
+			return true;
+		QMutexLocker locker(&m_mutex);
+		m_failedFiles.append(fileName);
+		return true;
+	}
+
+	qint64 bytes = static_cast<qint64>(size.width()) * size.height() * 4;
+	reserveBytes(bytes);
+	QImage im = m_doc->view()->PageToPixmap(pageNr, maxGr(pageNr), m_flags);
+	if (im.isNull())
+	{
+		QMutexLocker locker(&m_mutex);
+		m_bytesInFlight -= bytes;
+		m_bytesReleased.wakeAll();
+		return false;
+	}
+	int dpm = qRound(100.0 / 2.54 * m_dpi);
+	im.setDotsPerMeterY(dpm);
+	im.setDotsPerMeterX(dpm);
+	m_threadPool.start([this, im, fileName, bytes]() { encode(im, fileName, bytes); });
+	return true;
+}
+
+bool ScPageImageExporter::exportPageBands(int pageNr, const QSize& size, const QString& fileName)
+{
+	ScImageBandWriter writer(fileName, m_format);
+	writer.setQuality(m_quality);
+	writer.setResolution(m_dpi);
+	if (!writer.open(size.width(), size.height()))
+		return false;
+
+	// The previous band is encoded while the next one is rendered
+	bool rendered = m_doc->view()->PageToBands(pageNr, maxGr(pageNr), bandHeight(size.width()), [&writer](const QImage& band, int) {
+		return writer.queueBand(band);
+	}, m_flags);
+	bool closed = writer.close();
+	return rendered && closed;
+}
+
+void ScPageImageExporter::reserveBytes(qint64 bytes)
+{
+	QMutexLocker locker(&m_mutex);
+	while ((m_bytesInFlight > 0) && (m_bytesInFlight + bytes > m_maxBytesInFlight))
+		m_bytesReleased.wait(&m_mutex);
+	m_bytesInFlight += bytes;
+}
+
+void ScPageImageExporter::encode(const QImage& image, const QString& fileName, qint64 bytes)
+{
+	bool saved = image.save(fileName, m_format.toLocal8Bit().constData(), m_quality);
+
+	QMutexLocker locker(&m_mutex);
+	if (!saved)
+		m_failedFiles.append(fileName);
+	m_bytesInFlight -= bytes;
+	m_bytesReleased.wakeAll();
+}
+
+bool ScPageImageExporter::waitForFinished()
+{
+	m_threadPool.waitForDone();
+	QMutexLocker locker(&m_mutex);
+	return m_failedFiles.isEmpty();
+}
+
+QStringList ScPageImageExporter::failedFiles() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_failedFiles;
+}
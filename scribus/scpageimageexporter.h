@@ -0,0 +1,92 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCPAGEIMAGEEXPORTER_H
+#define SCPAGEIMAGEEXPORTER_H
+
+#include <QMutex>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include "scribusapi.h"
+#include "scribusstructs.h"
+
+class QImage;
+class ScribusDoc;
+
+/**
+ * Exports pages of a document as bitmap images.
+ *
+ * Pages are rendered one by one on the calling thread, which must be the GUI
+ * thread as page items cannot be drawn from anywhere else, while the images
+ * already rendered are encoded and written on a thread pool. The memory taken
+ * by rendered images waiting for or being in encoding is bounded:
+ * exportPage() waits for encoders to finish before rendering a page which
+ * would exceed the limit. Pages too large to be rendered in one piece are
+ * rendered in bands and streamed to the file instead, see ScImageBandWriter.
+ */
+class SCRIBUS_API ScPageImageExporter
+{
+public:
+	explicit ScPageImageExporter(ScribusDoc* doc);
+	/// Waits for pages still being encoded
+	~ScPageImageExporter();
+
+	/// Image format, e.g. "png" or "jpg", as for QImage::save()
+	void setFormat(const QString& format) { m_format = format; }
+	void setResolution(int dpi) { m_dpi = dpi; }
+	/// Enlargement of the image in percent
+	void setScale(double scale) { m_scale = scale; }
+	/// Quality <0; 100> as for QImage::save(), -1 for the default
+	void setQuality(int quality) { m_quality = quality; }
+	void setFlags(PageToPixmapFlags flags) { m_flags = flags; }
+	/// Number of images encoded at the same time, 0 for one per processor
+	void setMaxThreads(int threads);
+	/// Bytes of rendered images allowed to wait for or be in encoding, one image is always allowed
+	void setMaxBytesInFlight(qint64 bytes) { m_maxBytesInFlight = bytes; }
+
+	/// Size of the image of page \a pageNr
+	QSize imageSize(int pageNr) const;
+	/// Number of rows rendered at once for pages rendered in bands
+	static int bandHeight(int imageWidth);
+
+	/**
+	 * Renders page \a pageNr and queues it for being written to \a fileName.
+	 * Returns false if the document has no page \a pageNr or it could not be rendered, errors while writing
+	 * are reported by waitForFinished().
+	 */
+	bool exportPage(int pageNr, const QString& fileName);
+	/// Waits for all queued pages, returns false if any of them could not be written
+	bool waitForFinished();
+	/// Files which could not be written
+	QStringList failedFiles() const;
+
+private:
+	int maxGr(int pageNr) const;
+	bool exportPageBands(int pageNr, const QSize& size, const QString& fileName);
+	void reserveBytes(qint64 bytes);
+	void encode(const QImage& image, const QString& fileName, qint64 bytes);
+
+	ScribusDoc* m_doc { nullptr };
+	QString m_format { "png" };
+	int m_dpi { 72 };
+	double m_scale { 100.0 };
+	int m_quality { -1 };
+	PageToPixmapFlags m_flags { Pixmap_DrawBackground };
+	qint64 m_maxBytesInFlight { 256 * 1024 * 1024 };
+
+	QThreadPool m_threadPool;
+	mutable QMutex m_mutex;
+	QWaitCondition m_bytesReleased;
+	qint64 m_bytesInFlight { 0 };
+	QStringList m_failedFiles;
+};
+
+#endif // SCPAGEIMAGEEXPORTER_H
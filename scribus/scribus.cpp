@@ -3697,11 +3697,18 @@ bool ScribusMainWindow::loadDoc(const QString& fileName)
 		t.start();*/
 		doc->flag_Renumber = false;
 		doc->updateNumbers(true);
+		// In lazy mode frames stay invalid until they are drawn, exported or
+		// queried, except for stories with marks, as notes frames and
+		// references are only set up by layout
+		bool lazyTextLayout = m_prefsManager.appPrefs.miscPrefs.lazyTextLayout;
 		for (auto iti = doc->Items->begin(); iti != doc->Items->end(); ++iti)
 		{
 			PageItem* ite = *iti;
 			if ((ite->nextInChain() == nullptr) && !ite->isNoteFrame())  //do not layout notes frames
-				ite->layout();
+			{
+				if (!lazyTextLayout || ite->itemText.hasTextMarks())
+					ite->layout();
+			}
 		}
 		if (!doc->marksList().isEmpty())
 		{
@@ -4145,7 +4152,7 @@ bool ScribusMainWindow::slotFileSaveAs()
 	{
 		docContext->set("save_as", fn.left(fn.lastIndexOf("/")));
 		fileName = fn;
-		if (!((fn.endsWith(".sla")) || (fn.endsWith(".sla.gz"))))
+		if (!((fn.endsWith(".sla")) || (fn.endsWith(".sla.gz")) || (fn.endsWith(".slaz"))))
 			fileName = fn+".sla";
 		if (overwrite(this, fileName))
 		{
@@ -8708,7 +8715,7 @@ void ScribusMainWindow::dragEnterEvent ( QDragEnterEvent* e)
 		for (int i = 0; i < fileUrls.count(); ++i)
 		{
 			fileUrl = fileUrls[i].toLocalFile().toLower();
-			if (fileUrl.endsWith(".sla") || fileUrl.endsWith(".sla.gz") || fileUrl.endsWith(".shape") || fileUrl.endsWith(".sce"))
+			if (fileUrl.endsWith(".sla") || fileUrl.endsWith(".sla.gz") || fileUrl.endsWith(".slaz") || fileUrl.endsWith(".shape") || fileUrl.endsWith(".sce"))
 			{
 				accepted = true;
 				break;
@@ -8744,7 +8751,7 @@ void ScribusMainWindow::dropEvent ( QDropEvent * e)
 		for (int i = 0; i < fileUrls.count(); ++i)
 		{
 			fileUrl = fileUrls[i].toLocalFile().toLower();
-			if (fileUrl.endsWith(".sla") || fileUrl.endsWith(".sla.gz"))
+			if (fileUrl.endsWith(".sla") || fileUrl.endsWith(".sla.gz") || fileUrl.endsWith(".slaz"))
 			{
 				QUrl url( fileUrls[i] );
 				QFileInfo fi(url.toLocalFile());
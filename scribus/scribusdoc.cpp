@@ -85,6 +85,7 @@ for which a new license (GPL+exception) is in place.
 #include "prefsmanager.h"
 #include "resourcecollection.h"
 #include "sccolorengine.h"
+#include "scdocumentsavejob.h"
 #include "scpage.h"
 #include "scraction.h"
 #include "scribusXml.h"
@@ -95,7 +96,10 @@ for which a new license (GPL+exception) is in place.
 #include "serializer.h"
 #include "tableborder.h"
 #include "textnote.h"
+#include "text/shapedruncache.h"
 #include "text/textlayoutpainter.h"
+#include "text/textlayoutscheduler.h"
+#include "text/textshaper.h"
 #include "ui/guidemanager.h"
 #include "ui/inserttablecolumnsdialog.h"
 #include "ui/inserttablerowsdialog.h"
@@ -622,6 +626,8 @@ ScribusDoc::~ScribusDoc()
 	delete m_serializer;
 	delete m_tserializer;
 	delete m_docUpdater;
+	// Deleting the job cancels an autosave still being written
+	delete m_autoSaveJob;
 	if (!m_docPrefsData.docSetupPrefs.AutoSaveKeep)
 	{
 		if (autoSaveFiles.count() != 0)
@@ -813,6 +819,7 @@ void ScribusDoc::CloseCMSProfiles()
 
 void ScribusDoc::SetDefaultCMSParams()
 {
+	m_colorConversionCache.clear();
 	BlackPoint     = true;
 	SoftProofing   = false;
 	Gamut          = false;
@@ -844,6 +851,7 @@ void ScribusDoc::SetDefaultCMSParams()
 
 bool ScribusDoc::OpenCMSProfiles(ScProfileInfoMap InPo, ScProfileInfoMap InPoCMYK, ScProfileInfoMap  /*MoPo*/, ScProfileInfoMap PrPo)
 {
+	m_colorConversionCache.clear();
 	HasCMS = false;
 	colorEngine = ScColorMgmtEngineFactory::createDefaultEngine();
 
@@ -4382,6 +4390,14 @@ void ScribusDoc::getUsedFonts(QMap<QString, QMap<uint, QString> > & Really)
 	QList<PageItem*>* itemLists[] = { &MasterItems, &DocItems };
 	PageItem* it = nullptr;
 
+	// Lay out independent text chains up front so they get shaped concurrently
+	bool wasMasterPageMode = m_masterPageMode;
+	setMasterPageMode(false);
+	TextLayoutScheduler layoutScheduler;
+	layoutScheduler.addItems(DocItems);
+	layoutScheduler.run();
+	setMasterPageMode(wasMasterPageMode);
+
 	for (int i = 0; i < 2; ++i)
 	{
 		allItems = *(itemLists[i]);
@@ -5012,6 +5028,8 @@ bool ScribusDoc::save(const QString& fileName, QString* savedFile, uint formatID
 	bool ret = fl.saveFile(fileName, this, savedFile, formatID);
 	if (!ret)
 		return false;
+	if (PrefsManager::instance().appPrefs.miscPrefs.persistShapingCache)
+		ShapedRunCache::instance().save(ShapedRunCache::cacheFileName(fileName), shapedRunKeys());
 	setDocumentFileName(fileName);
 	setModified(false);
 	hasName = true;
@@ -5081,6 +5099,36 @@ bool ScribusDoc::changePageProperties(double initialTop, double initialBottom, d
 	return true;
 }
 
+/// Converts the colors of all stops of \a gradient in one batch
+static void recalculateGradientStopColors(const ScribusDoc* doc, const VGradient& gradient)
+{
+	QList<VColorStop*> stops;
+	QList<ScColor> colors;
+	QList<double> levels;
+	for (VColorStop* stop : gradient.colorStops())
+	{
+		if (stop->name == CommonStrings::None)
+			continue;
+		stops.append(stop);
+		colors.append(doc->PageColors[stop->name]);
+		levels.append(stop->shade);
+	}
+	if (stops.isEmpty())
+		return;
+
+	QList<QColor> results = ScColorEngine::getShadeColorsProof(colors, levels, doc);
+	for (int i = 0; i < stops.count(); ++i)
+	{
+		QColor tmp = results.at(i);
+		if (doc->viewAsPreview)
+		{
+			VisionDefectColor defect;
+			tmp = defect.convertDefect(tmp, doc->previewVisual);
+		}
+		stops.at(i)->color = tmp;
+	}
+}
+
 void ScribusDoc::recalculateColorsList(const QList<PageItem*> *itemList)
 {
 	QList<PageItem*> allItems;
@@ -5113,15 +5161,9 @@ void ScribusDoc::recalculateColorsList(const QList<PageItem*> *itemList)
 				ite->setMeshPointColor(grow, 3, patch.BR.colorName, patch.BR.shade, patch.BR.transparency, true);
 				ite->setMeshPointColor(grow, 4, patch.BL.colorName, patch.BL.shade, patch.BL.transparency, true);
 			}
-			QList<VColorStop*> cstops = ite->fill_gradient.colorStops();
-			for (int cst = 0; cst < ite->fill_gradient.stops(); ++cst)
-				ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
-			cstops = ite->stroke_gradient.colorStops();
-			for (int cst = 0; cst < ite->stroke_gradient.stops(); ++cst)
-				ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
-			cstops = ite->mask_gradient.colorStops();
-			for (int cst = 0; cst < ite->mask_gradient.stops(); ++cst)
-				ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
+			recalculateGradientStopColors(this, ite->fill_gradient);
+			recalculateGradientStopColors(this, ite->stroke_gradient);
+			recalculateGradientStopColors(this, ite->mask_gradient);
 			if (ite->GrType == Gradient_Conical)
 				ite->createConicalMesh();
 		}
@@ -5158,15 +5200,9 @@ void ScribusDoc::recalculateColorItem(PageItem *item)
 			ite->setMeshPointColor(grow, 3, patch.BR.colorName, patch.BR.shade, patch.BR.transparency, true);
 			ite->setMeshPointColor(grow, 4, patch.BL.colorName, patch.BL.shade, patch.BL.transparency, true);
 		}
-		QList<VColorStop*> cstops = ite->fill_gradient.colorStops();
-		for (int cst = 0; cst < ite->fill_gradient.stops(); ++cst)
-			ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
-		cstops = ite->stroke_gradient.colorStops();
-		for (int cst = 0; cst < ite->stroke_gradient.stops(); ++cst)
-			ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
-		cstops = ite->mask_gradient.colorStops();
-		for (int cst = 0; cst < ite->mask_gradient.stops(); ++cst)
-			ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
+		recalculateGradientStopColors(ite->doc(), ite->fill_gradient);
+		recalculateGradientStopColors(ite->doc(), ite->stroke_gradient);
+		recalculateGradientStopColors(ite->doc(), ite->mask_gradient);
 		if (ite->GrType == Gradient_Conical)
 			ite->createConicalMesh();
 	}
@@ -5180,23 +5216,7 @@ void ScribusDoc::recalculateColors()
 
 	//Adjust Items of the 3 types to the colors
 	for (auto itGrad = docGradients.begin(); itGrad != docGradients.end(); ++itGrad)
-	{
-		QList<VColorStop*> cstops = itGrad.value().colorStops();
-		for (int cst = 0; cst < itGrad.value().stops(); ++cst)
-		{
-			if (cstops.at(cst)->name != CommonStrings::None)
-			{
-				const ScColor& col = PageColors[cstops.at(cst)->name];
-				QColor tmp = ScColorEngine::getShadeColorProof(col, this, cstops.at(cst)->shade);
-				if (viewAsPreview)
-				{
-					VisionDefectColor defect;
-					tmp = defect.convertDefect(tmp, previewVisual);
-				}
-				cstops.at(cst)->color = tmp;
-			}
-		}
-	}
+		recalculateGradientStopColors(this, itGrad.value());
 
 	recalculateColorsList(&DocItems);
 	recalculateColorsList(&MasterItems);
@@ -5232,15 +5252,9 @@ void ScribusDoc::recalculateColors()
 				ite->setMeshPointColor(grow, 3, patch.BR.colorName, patch.BR.shade, patch.BR.transparency, true);
 				ite->setMeshPointColor(grow, 4, patch.BL.colorName, patch.BL.shade, patch.BL.transparency, true);
 			}
-			QList<VColorStop*> cstops = ite->fill_gradient.colorStops();
-			for (int cst = 0; cst < ite->fill_gradient.stops(); ++cst)
-				ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
-			cstops = ite->stroke_gradient.colorStops();
-			for (int cst = 0; cst < ite->stroke_gradient.stops(); ++cst)
-				ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
-			cstops = ite->mask_gradient.colorStops();
-			for (int cst = 0; cst < ite->mask_gradient.stops(); ++cst)
-				ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
+			recalculateGradientStopColors(this, ite->fill_gradient);
+			recalculateGradientStopColors(this, ite->stroke_gradient);
+			recalculateGradientStopColors(this, ite->mask_gradient);
 			if (ite->GrType == Gradient_Conical)
 				ite->createConicalMesh();
 		}
@@ -5282,15 +5296,9 @@ void ScribusDoc::recalculateColors()
 					ite->setMeshPointColor(grow, 3, patch.BR.colorName, patch.BR.shade, patch.BR.transparency, true);
 					ite->setMeshPointColor(grow, 4, patch.BL.colorName, patch.BL.shade, patch.BL.transparency, true);
 				}
-				QList<VColorStop*> cstops = ite->fill_gradient.colorStops();
-				for (int cst = 0; cst < ite->fill_gradient.stops(); ++cst)
-					ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
-				cstops = ite->stroke_gradient.colorStops();
-				for (int cst = 0; cst < ite->stroke_gradient.stops(); ++cst)
-					ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
-				cstops = ite->mask_gradient.colorStops();
-				for (int cst = 0; cst < ite->mask_gradient.stops(); ++cst)
-					ite->SetQColor(&cstops.at(cst)->color, cstops.at(cst)->name, cstops.at(cst)->shade);
+				recalculateGradientStopColors(this, ite->fill_gradient);
+				recalculateGradientStopColors(this, ite->stroke_gradient);
+				recalculateGradientStopColors(this, ite->mask_gradient);
 				if (ite->isImageFrame())
 					loadPict(ite->Pfile, ite, true, false);
 				if (ite->GrType == Gradient_Conical)
@@ -5373,12 +5381,21 @@ bool ScribusDoc::copyPageToMasterPage(int pageNumber, int leftPage, int maxLeftP
 					}
 					if (tempSelection.count() != 0)
 					{
-						ScriXmlDoc ss;
+						const QList<PageItem*> itemsToCopy = tempSelection.items();
 						setMasterPageMode(true);
-						setCurrentPage(pageMaster); // Needed for writeElem to write proper page relative coordinates
-						QString dataS = ScriXmlDoc::writeElem(this, &tempSelection);
-						setCurrentPage(targetPage);
-						ss.readElemToLayer(dataS, this, targetPage->xOffset(), targetPage->yOffset(), false, true, it->ID);
+						if (canCloneItems(itemsToCopy))
+						{
+							setCurrentPage(targetPage);
+							cloneItems(itemsToCopy, targetPage->xOffset() - pageMaster->xOffset(), targetPage->yOffset() - pageMaster->yOffset(), it->ID);
+						}
+						else
+						{
+							ScriXmlDoc ss;
+							setCurrentPage(pageMaster); // Needed for writeElem to write proper page relative coordinates
+							QString dataS = ScriXmlDoc::writeElem(this, &tempSelection);
+							setCurrentPage(targetPage);
+							ss.readElemToLayer(dataS, this, targetPage->xOffset(), targetPage->yOffset(), false, true, it->ID);
+						}
 						setMasterPageMode(false);
 						setCurrentPage(oldCurrentPage);
 					}
@@ -5403,12 +5420,22 @@ bool ScribusDoc::copyPageToMasterPage(int pageNumber, int leftPage, int maxLeftP
 			}
 			if (tempSelection.count() != 0)
 			{
-				ScriXmlDoc ss;
-				setCurrentPage(sourcePage); // Needed for writeElem to write proper page relative coordinates
-				QString dataS = ScriXmlDoc::writeElem(this, &tempSelection);
-				setMasterPageMode(true);
-				setCurrentPage(targetPage);
-				ss.readElemToLayer(dataS, this, targetPage->xOffset(), targetPage->yOffset(), false, true, it->ID);
+				const QList<PageItem*> itemsToCopy = tempSelection.items();
+				if (canCloneItems(itemsToCopy))
+				{
+					setMasterPageMode(true);
+					setCurrentPage(targetPage);
+					cloneItems(itemsToCopy, targetPage->xOffset() - sourcePage->xOffset(), targetPage->yOffset() - sourcePage->yOffset(), it->ID);
+				}
+				else
+				{
+					ScriXmlDoc ss;
+					setCurrentPage(sourcePage); // Needed for writeElem to write proper page relative coordinates
+					QString dataS = ScriXmlDoc::writeElem(this, &tempSelection);
+					setMasterPageMode(true);
+					setCurrentPage(targetPage);
+					ss.readElemToLayer(dataS, this, targetPage->xOffset(), targetPage->yOffset(), false, true, it->ID);
+				}
 				setMasterPageMode(false);
 				setCurrentPage(oldCurrentPage);
 			}
@@ -5515,6 +5542,186 @@ PageItem* ScribusDoc::createPageItem(const PageItem::ItemType itemType, const Pa
 	return newItem;
 }
 
+bool ScribusDoc::canCloneItems(const QList<PageItem*>& items) const
+{
+	QSet<const PageItem*> checkedStories;
+	for (const PageItem* item : items)
+	{
+		if (!canCloneItem(item, checkedStories))
+			return false;
+	}
+	return true;
+}
+
+bool ScribusDoc::canCloneItem(const PageItem* item, QSet<const PageItem*>& checkedStories) const
+{
+	switch (item->itemType())
+	{
+		case PageItem::ImageFrame:
+		case PageItem::TextFrame:
+		case PageItem::Line:
+		case PageItem::Polygon:
+		case PageItem::PolyLine:
+		case PageItem::PathText:
+		case PageItem::Symbol:
+		case PageItem::Group:
+		case PageItem::RegularPolygon:
+		case PageItem::Arc:
+		case PageItem::Spiral:
+			break;
+		default:
+			return false;
+	}
+	if (item->isTableItem || item->isWelded())
+		return false;
+
+	if (item->isTextFrame() || item->isPathText())
+	{
+		// Inline frames and marks are document objects referenced from the text,
+		// the text of a chain is shared and only has to be checked once
+		const PageItem* firstInChain = item;
+		while (firstInChain->prevInChain() != nullptr)
+			firstInChain = firstInChain->prevInChain();
+		if (!checkedStories.contains(firstInChain))
+		{
+			checkedStories.insert(firstInChain);
+			const StoryText& story = item->itemText;
+			for (int i = 0; i < story.length(); ++i)
+			{
+				if (story.text(i) == SpecialChars::OBJECT)
+					return false;
+			}
+		}
+	}
+
+	for (const PageItem* child : item->groupItemList)
+	{
+		if (!canCloneItem(child, checkedStories))
+			return false;
+	}
+	return true;
+}
+
+QList<PageItem*> ScribusDoc::cloneItems(const QList<PageItem*>& items, double dx, double dy, int toLayer)
+{
+	QList<PageItem*> copies;
+	if (!canCloneItems(items))
+		return copies;
+
+	QSet<const PageItem*> sources;
+	for (const PageItem* item : items)
+	{
+		sources.insert(item);
+		const QList<PageItem*> children = item->getAllChildren();
+		for (const PageItem* child : children)
+			sources.insert(child);
+	}
+
+	QHash<const PageItem*, PageItem*> clones;
+	clones.reserve(sources.count());
+	copies.reserve(items.count());
+	for (const PageItem* item : items)
+	{
+		PageItem* clone = cloneItem(item, dx, dy, toLayer, sources, clones);
+		clone->setMasterPage(OnPage(clone), m_currentPage->pageName());
+		Items->append(clone);
+		copies.append(clone);
+	}
+
+	// Relink the copies of chained frames, their stories were only copied for the first frame
+	for (auto it = clones.cbegin(); it != clones.cend(); ++it)
+	{
+		const PageItem* prev = it.key()->prevInChain();
+		if ((prev != nullptr) && clones.contains(prev))
+			clones.value(prev)->link(it.value());
+	}
+
+	if (UndoManager::undoEnabled())
+	{
+		for (PageItem* clone : std::as_const(copies))
+		{
+			auto *is = new ScItemState<PageItem*>("Create PageItem");
+			is->set("CREATE_ITEM");
+			is->setItem(clone);
+			UndoObject *target = Pages->at(0);
+			if (clone->OwnPage > -1)
+				target = Pages->at(clone->OwnPage);
+			m_undoManager->action(target, is);
+		}
+	}
+	return copies;
+}
+
+PageItem* ScribusDoc::cloneItem(const PageItem* item, double dx, double dy, int toLayer, const QSet<const PageItem*>& sources, QHash<const PageItem*, PageItem*>& clones)
+{
+	PageItem* clone = nullptr;
+	switch (item->itemType())
+	{
+		case PageItem::ImageFrame:
+			clone = new PageItem_ImageFrame(*item);
+			break;
+		case PageItem::TextFrame:
+			clone = new PageItem_TextFrame(*item);
+			break;
+		case PageItem::Line:
+			clone = new PageItem_Line(*item);
+			break;
+		case PageItem::Polygon:
+			clone = new PageItem_Polygon(*item);
+			break;
+		case PageItem::PolyLine:
+			clone = new PageItem_PolyLine(*item);
+			break;
+		case PageItem::PathText:
+			clone = new PageItem_PathText(*item);
+			break;
+		case PageItem::Symbol:
+			clone = new PageItem_Symbol(*item);
+			break;
+		case PageItem::Group:
+			clone = new PageItem_Group(*item);
+			break;
+		case PageItem::RegularPolygon:
+			clone = new PageItem_RegularPolygon(*item);
+			break;
+		case PageItem::Arc:
+			clone = new PageItem_Arc(*item);
+			break;
+		case PageItem::Spiral:
+			clone = new PageItem_Spiral(*item);
+			break;
+		default:
+			assert(false);
+			return nullptr;
+	}
+	clone->renewUId();
+	clone->setSelected(false);
+
+	// The copy constructor shares the story with the original
+	if ((item->prevInChain() != nullptr) && sources.contains(item->prevInChain()))
+		clone->itemText = StoryText(this);
+	else
+		clone->itemText = item->itemText.copy();
+	clone->invalidateLayout();
+
+	clone->m_layerID = toLayer;
+	clone->setXYPos(item->xPos() + dx, item->yPos() + dy, true);
+	clone->setRedrawBounding();
+	if (clone->isAutoText)
+		LastAuto = clone;
+
+	clone->groupItemList.clear();
+	for (const PageItem* child : item->groupItemList)
+	{
+		PageItem* childClone = cloneItem(child, dx, dy, toLayer, sources, clones);
+		childClone->Parent = clone;
+		clone->groupItemList.append(childClone);
+	}
+
+	clones.insert(item, clone);
+	return clone;
+}
+
 int ScribusDoc::itemAdd(const PageItem::ItemType itemType, const PageItem::ItemFrameType frameType, double x, double y, double b, double h, double w, const QString& fill, const QString& outline, PageItem::ItemKind itemKind)
 {
 	UndoTransaction activeTransaction;
@@ -7397,35 +7604,26 @@ void ScribusDoc::copyPage(int pageNumberToCopy, int existingPage, int whereToIns
 	setCurrentPage(from);
 
 	int oldItems = Items->count();
-	QList<QString> itemBuffer;
+	QHash<int, QList<PageItem*> > layerItems;
+	for (int ite = 0; ite < oldItems; ++ite)
+	{
+		PageItem *itemToCopy = Items->at(ite);
+		if (itemToCopy->OwnPage == from->pageNr())
+			layerItems[itemToCopy->m_layerID].append(itemToCopy);
+	}
+	// Items which cannot be cloned are copied through XML, one fragment per layer
+	QHash<int, QString> itemBuffer;
 	Selection tempSelection(this, false);
 	m_Selection->clear();
 	tempSelection.delaySignalsOn();
-	if (oldItems > 0)
+	for (auto it = layerItems.cbegin(); it != layerItems.cend(); ++it)
 	{
-		if (Layers.count() != 0)
-		{
-			int currActiveLayer = activeLayer();
-			for (ScLayers::iterator it = Layers.begin(); it != Layers.end(); ++it)
-			{
-				setActiveLayer(it->ID);
-				for (int ite = 0; ite < oldItems; ++ite)
-				{
-					PageItem *itemToCopy = Items->at(ite);
-					if ((itemToCopy->OwnPage == from->pageNr()) && (it->ID == itemToCopy->m_layerID))
-						tempSelection.addItem(itemToCopy);
-				}
-				if (tempSelection.count() != 0)
-				{
-					QString dataS = ScriXmlDoc::writeElem(this, &tempSelection);
-					itemBuffer.append(dataS);
-				}
-				else
-					itemBuffer.append(QString());
-				tempSelection.clear();
-			}
-			setActiveLayer(currActiveLayer);
-		}
+		if (canCloneItems(it.value()))
+			continue;
+		for (PageItem* itemToCopy : it.value())
+			tempSelection.addItem(itemToCopy);
+		itemBuffer.insert(it.key(), ScriXmlDoc::writeElem(this, &tempSelection));
+		tempSelection.clear();
 	}
 	tempSelection.delaySignalsOff();
 
@@ -7482,9 +7680,8 @@ void ScribusDoc::copyPage(int pageNumberToCopy, int existingPage, int whereToIns
 		// FIXME: stop using m_View
 		if (m_View)
 			m_View->reformPagesView();
-		if (itemBuffer.count() > 0)
+		if (layerItems.count() > 0)
 		{
-			int lcount = 0;
 			if (Layers.count() != 0)
 			{
 				int currActiveLayer = activeLayer();
@@ -7496,13 +7693,15 @@ void ScribusDoc::copyPage(int pageNumberToCopy, int existingPage, int whereToIns
 				this->SnapItems = false;
 				for (auto it = Layers.begin(); it != Layers.end(); ++it)
 				{
-					if ((lcount < itemBuffer.count()) && !itemBuffer[lcount].isEmpty())
+					if (!layerItems.contains(it->ID))
+						continue;
+					if (itemBuffer.contains(it->ID))
 					{
 						ScriXmlDoc ss;
-						QString fragment = itemBuffer[lcount];
-						ss.readElemToLayer(fragment, this, destination->xOffset(), destination->yOffset(), false, true, it->ID);
+						ss.readElemToLayer(itemBuffer.value(it->ID), this, destination->xOffset(), destination->yOffset(), false, true, it->ID);
 					}
-					lcount++;
+					else
+						cloneItems(layerItems.value(it->ID), destination->xOffset() - from->xOffset(), destination->yOffset() - from->yOffset(), it->ID);
 				}
 				this->SnapGrid   = savedAlignGrid;
 				this->SnapGuides = savedAlignGuides;
@@ -14315,14 +14514,20 @@ void ScribusDoc::itemSelection_MultipleDuplicate(const ItemMultipleDuplicateData
 				dV2 += selection.height();
 		}
 		ScriXmlDoc ss;
-		QString BufferS = ScriXmlDoc::writeElem(this, &selection);
+		bool cloneItemsInMemory = canCloneItems(selectedItems);
+		QString BufferS;
+		if (!cloneItemsInMemory)
+			BufferS = ScriXmlDoc::writeElem(this, &selection);
 		//FIXME: stop using m_View
 		Selection tempSelection(nullptr, false);
 		m_View->deselectItems(true);
 		for (int i = 0; i < mdData.copyCount; ++i)
 		{
 			int oldItemCount = Items->count();
-			ss.readElem(BufferS, this, m_currentPage->xOffset(), m_currentPage->yOffset(), false, true);
+			if (cloneItemsInMemory)
+				cloneItems(selectedItems, 0.0, 0.0, activeLayer());
+			else
+				ss.readElem(BufferS, this, m_currentPage->xOffset(), m_currentPage->yOffset(), false, true);
 			tempSelection.delaySignalsOn();
 			for (int j = oldItemCount; j < Items->count(); ++j)
 			{
@@ -14368,7 +14573,10 @@ void ScribusDoc::itemSelection_MultipleDuplicate(const ItemMultipleDuplicateData
 		double dX = mdData.gridGapH / m_docUnitRatio + selection.width();
 		double dY = mdData.gridGapV / m_docUnitRatio + selection.height();
 		ScriXmlDoc ss;
-		QString BufferS = ScriXmlDoc::writeElem(this, &selection);
+		bool cloneItemsInMemory = canCloneItems(selectedItems);
+		QString BufferS;
+		if (!cloneItemsInMemory)
+			BufferS = ScriXmlDoc::writeElem(this, &selection);
 		for (int i = 0; i < mdData.gridRows; ++i) //skip 0, the item is the one we are copying
 		{
 			for (int j = 0; j < mdData.gridCols; ++j) //skip 0, the item is the one we are copying
@@ -14377,7 +14585,10 @@ void ScribusDoc::itemSelection_MultipleDuplicate(const ItemMultipleDuplicateData
 				if (i == 0 && j == 0)
 					continue;
 				uint ac = Items->count();
-				ss.readElem(BufferS, this, m_currentPage->xOffset(), m_currentPage->yOffset(), false, true);
+				if (cloneItemsInMemory)
+					cloneItems(selectedItems, 0.0, 0.0, activeLayer());
+				else
+					ss.readElem(BufferS, this, m_currentPage->xOffset(), m_currentPage->yOffset(), false, true);
 				for (int as = ac; as < Items->count(); ++as)
 				{
 					PageItem* bItem = Items->at(as);
@@ -14490,7 +14701,11 @@ void ScribusDoc::multipleDuplicateByPage(const ItemMultipleDuplicateData& dialog
 
 	ScPage* oldCurrentPage = currentPage();
 	ScriXmlDoc xmlStream;
-	QString buffer = ScriXmlDoc::writeElem(this, &selection);
+	const QList<PageItem*> selectedItems = selection.items();
+	bool cloneItemsInMemory = canCloneItems(selectedItems);
+	QString buffer;
+	if (!cloneItemsInMemory)
+		buffer = ScriXmlDoc::writeElem(this, &selection);
 	for (const auto page: pages)
 	{
 		if (currPageNumber == page - 1)
@@ -14498,7 +14713,10 @@ void ScribusDoc::multipleDuplicateByPage(const ItemMultipleDuplicateData& dialog
 		ScPage* targetPage = Pages->at(page - 1);
 		setCurrentPage(targetPage);
 		int countBeforeInsert = Items->count();
-		xmlStream.readElem(buffer, this, currentPage()->xOffset(), currentPage()->yOffset(), false, true);
+		if (cloneItemsInMemory)
+			cloneItems(selectedItems, targetPage->xOffset() - oldCurrentPage->xOffset(), targetPage->yOffset() - oldCurrentPage->yOffset(), activeLayer());
+		else
+			xmlStream.readElem(buffer, this, currentPage()->xOffset(), currentPage()->yOffset(), false, true);
 		if (!lastInChain)
 			continue;
 		for (int i = countBeforeInsert; i < Items->count(); ++i)
@@ -17605,6 +17823,19 @@ void ScribusDoc::itemResizeToMargin(PageItem* item, int direction)
 	changedPagePreview();
 }
 
+QList<int> ScribusDoc::itemsIntersecting(const QRectF& rect)
+{
+	if (Items == &MasterItems)
+		return m_masterItemIndex.intersecting(MasterItems, rect);
+	return m_docItemIndex.intersecting(*Items, rect);
+}
+
+void ScribusDoc::itemBoundsChanged(const PageItem* item)
+{
+	m_docItemIndex.itemChanged(item);
+	m_masterItemIndex.itemChanged(item);
+}
+
 void ScribusDoc::restartAutoSaveTimer()
 {
 	autoSaveTimer->stop();
@@ -17618,6 +17849,13 @@ void ScribusDoc::slotAutoSave()
 	if (!isModified())
 		return;
 	autoSaveTimer->stop();
+	// Previous autosave is still being written, try again later
+	if (m_autoSaveJob)
+	{
+		if (m_docPrefsData.docSetupPrefs.AutoSave)
+			autoSaveTimer->start(m_docPrefsData.docSetupPrefs.AutoSaveTime);
+		return;
+	}
 	QString base = tr("Document");
 	QString path = m_docPrefsData.pathPrefs.documents;
 	QString fileName;
@@ -17632,21 +17870,35 @@ void ScribusDoc::slotAutoSave()
 		path = m_docPrefsData.docSetupPrefs.AutoSaveDir;
 	fileName = QDir::cleanPath(path + "/" + base + QString("_autosave_%1.sla").arg(dat.toString("dd_MM_yyyy_hh_mm")));
 	FileLoader fl(fileName);
-	if (fl.saveFile(fileName, this, nullptr))
-	{
-		scMW()->statusBar()->showMessage( tr("File %1 autosaved").arg(base), 5000);
-		if (autoSaveFiles.count() >= m_docPrefsData.docSetupPrefs.AutoSaveCount)
-		{
-			QFile f(autoSaveFiles.first());
-			f.remove();
-			autoSaveFiles.removeFirst();
-		}
-		autoSaveFiles.append(fileName);
-	}
+	// The document is serialized now, the file is written in the background
+	m_autoSaveJob = fl.saveFileInBackground(fileName, this);
+	if (m_autoSaveJob)
+	{
+		connect(m_autoSaveJob, &ScDocumentSaveJob::finished, this, [this, base, fileName](bool success) {
+			if (success)
+				autoSaveFinished(base, fileName);
+			m_autoSaveJob->deleteLater();
+			m_autoSaveJob = nullptr;
+		});
+	}
+	else if (fl.saveFile(fileName, this, nullptr))
+		autoSaveFinished(base, fileName);
 	if (m_docPrefsData.docSetupPrefs.AutoSave)
 		autoSaveTimer->start(m_docPrefsData.docSetupPrefs.AutoSaveTime);
 }
 
+void ScribusDoc::autoSaveFinished(const QString& base, const QString& fileName)
+{
+	scMW()->statusBar()->showMessage( tr("File %1 autosaved").arg(base), 5000);
+	if (autoSaveFiles.count() >= m_docPrefsData.docSetupPrefs.AutoSaveCount)
+	{
+		QFile f(autoSaveFiles.first());
+		f.remove();
+		autoSaveFiles.removeFirst();
+	}
+	autoSaveFiles.append(fileName);
+}
+
 void ScribusDoc::setupNumerations()
 {
 	QList<NumStruct*> numList = numerations.values();
@@ -19304,3 +19556,24 @@ void ScribusDoc::syncAllTableConditionalStyles()
 	sync(MasterItems);
 	refreshTableItems();
 }
+
+QList<QByteArray> ScribusDoc::shapedRunKeys()
+{
+	QList<QByteArray> keys;
+	const QList<PageItem*> items = getAllItems(MasterItems) + getAllItems(DocItems);
+	for (PageItem* item : items)
+	{
+		if (!item->isTextFrame() || (item->prevInChain() != nullptr))
+			continue;
+		// Blocks are the same TextLayoutScheduler and ShapedTextFeed use
+		StoryText& story = item->itemText;
+		TextShaper shaper(item, story, 0);
+		for (int fromPos = 0; fromPos < story.length(); )
+		{
+			int toPos = story.nextBlockStart(fromPos);
+			keys += shaper.runKeys(fromPos, toPos);
+			fromPos = toPos;
+		}
+	}
+	return keys;
+}
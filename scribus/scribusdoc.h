@@ -36,6 +36,7 @@ for which a new license (GPL+exception) is in place.
 #include <QObject>
 #include <QPixmap>
 #include <QRectF>
+#include <QSet>
 #include <QStringList>
 #include <QTimer>
 #include <QUuid>
@@ -56,8 +57,10 @@ for which a new license (GPL+exception) is in place.
 #include "pageitem_group.h"
 #include "pageitem_latexframe.h"
 #include "pageitem_textframe.h"
+#include "pageitemindex.h"
 #include "pagestructs.h"
 #include "prefsstructs.h"
+#include "sccolorconversioncache.h"
 #include "scguardedptr.h"
 #include "scpage.h"
 #include "sclayer.h"
@@ -71,6 +74,7 @@ for which a new license (GPL+exception) is in place.
 #include "usertaskstructs.h"
 
 class DocUpdater;
+class ScDocumentSaveJob;
 class FPoint;
 class UndoManager;
 // class UndoState;
@@ -568,6 +572,11 @@ class SCRIBUS_API ScribusDoc : public QObject, public UndoObject, public Observa
 		 * @param enable bool, if true Colormanagement is switched on, else off
 		 */
 		void enableCMS(bool enable);
+		/**
+		 * @brief Results of ScColorEngine conversions of colors of this document,
+		 * cleared whenever the color transforms of the document are replaced
+		 */
+		ScColorConversionCache& colorConversionCache() const { return m_colorConversionCache; }
 
 		const ParagraphStyle& paragraphStyle(const QString& name) const { return m_docParagraphStyles.get(name); }
 		const StyleSet<ParagraphStyle>& paragraphStyles()  const { return m_docParagraphStyles; }
@@ -887,6 +896,26 @@ class SCRIBUS_API ScribusDoc : public QObject, public UndoObject, public Observa
 		 */
 		PageItem* createPageItem(const PageItem::ItemType itemType, const PageItem::ItemFrameType frameType, double x, double y, double b, double h, double w, const QString& fill, const QString& outline);
 
+		/**
+		 * @brief Check if cloneItems() can copy these items and their group children
+		 * Tables, render frames, note frames, welded items and stories containing inline
+		 * frames or marks have to be copied through ScriXmlDoc instead.
+		 */
+		bool canCloneItems(const QList<PageItem*>& items) const;
+
+		/**
+		 * @brief Copy items in memory and append the copies to the current item list
+		 * Group children, stories and loaded images are copied along. Text chains between
+		 * copied frames are kept, a frame whose chain starts outside \a items gets a copy
+		 * of the whole story, as with pasting. A creation undo action is recorded for each copy.
+		 * @param items items to copy, in stacking order and without group children
+		 * @param dx horizontal displacement of the copies
+		 * @param dy vertical displacement of the copies
+		 * @param toLayer layer of the copies
+		 * @return the copies in the order of \a items, empty if canCloneItems() fails
+		 */
+		QList<PageItem*> cloneItems(const QList<PageItem*>& items, double dx, double dy, int toLayer);
+
 		/**
 		 * @brief Add an Item to the document.
 		 * A simple function to create an item of a defined type and add it to the document
@@ -1546,7 +1575,16 @@ class SCRIBUS_API ScribusDoc : public QObject, public UndoObject, public Observa
 		Hyphenator* docHyphenator {nullptr};
 		void itemResizeToMargin(PageItem* item, int direction); //direction reflect enum numbers from Canvas::FrameHandle
 
+		/**
+		 * \brief Positions in Items of the items whose bounds intersect \a rect, in stacking order.
+		 * The result may contain items that do not intersect, callers must still do their exact test.
+		 */
+		QList<int> itemsIntersecting(const QRectF& rect);
+		/** \brief Called by items when their position, size, rotation, line width or clip changes */
+		void itemBoundsChanged(const PageItem* item);
+
 	private:
+		mutable ScColorConversionCache m_colorConversionCache;
 		UndoTransaction m_itemCreationTransaction;
 		UndoTransaction m_alignTransaction;
 
@@ -1555,7 +1593,10 @@ class SCRIBUS_API ScribusDoc : public QObject, public UndoObject, public Observa
 		MassObservable<PageItem*> m_itemsChanged;
 		MassObservable<ScPage*> m_pagesChanged;
 		MassObservable<QRectF> m_regionsChanged;
+		PageItemIndex m_docItemIndex;
+		PageItemIndex m_masterItemIndex;
 		DocUpdater* m_docUpdater {nullptr};
+		ScDocumentSaveJob* m_autoSaveJob {nullptr};
 
 	signals:
 		//Lets make our doc talk to our GUI rather than confusing all our normal stuff
@@ -1847,6 +1888,8 @@ class SCRIBUS_API ScribusDoc : public QObject, public UndoObject, public Observa
 		bool m_flag_notesChanged {false};
 
 		void multipleDuplicateByPage(const ItemMultipleDuplicateData& mdData, Selection& selection, QString& tooltip);
+		bool canCloneItem(const PageItem* item, QSet<const PageItem*>& checkedStories) const;
+		PageItem* cloneItem(const PageItem* item, double dx, double dy, int toLayer, const QSet<const PageItem*>& sources, QHash<const PageItem*, PageItem*>& clones);
 
 
 	public:
@@ -1976,6 +2019,12 @@ class SCRIBUS_API ScribusDoc : public QObject, public UndoObject, public Observa
 	protected slots:
 		void slotAutoSave();
 
+	private:
+		/// Updates the list of autosave files once \a fileName has been written
+		void autoSaveFinished(const QString& base, const QString& fileName);
+		/// Returns the ShapedRunCache keys of the text of all stories in the document
+		QList<QByteArray> shapedRunKeys();
+
 		//auto-numerations
 	public:
 		QMap<QString, NumStruct*> numerations;
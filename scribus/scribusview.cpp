@@ -361,10 +361,11 @@ void ScribusView::changed(QRectF re, bool)
 		widget()->resize(newCanvasWidth, newCanvasHeight);
 		m_oldCanvasSize = newCanvasSize;
 	}
+	// Drop cached tiles even if nothing is redrawn now
+	m_canvas->invalidate(re);
 	if (!m_doc->isLoading() && !m_ScMW->scriptIsRunning())
 	{
 // 		qDebug() << "ScribusView-changed(): changed region:" << re;
-		m_canvas->setForcedRedraw(true);
 		updateCanvas(re);
 	}
 }
@@ -2523,6 +2524,53 @@ QMap<int, QImage> ScribusView::PagesToPixmap(int maxGr, int Nr, PageToPixmapFlag
 	if (m_doc->DocPages.isEmpty())
 		return m_previews;
 
+	renderWithPixmapSettings(flags, [&]() {
+		// Draw all pages
+		if (Nr == -1)
+		{
+			for (const ScPage * page : std::as_const(m_doc->DocPages))
+			{
+				QImage im = drawPageToPixmap(maxGr, page, flags);
+				m_previews.insert(page->pageNr(), im);
+			}
+		}
+		// Draw single page by number
+		else
+		{
+			if (inRange(0, Nr, m_doc->DocPages.count() - 1))
+			{
+				const ScPage *page = m_doc->DocPages.at(Nr);
+				QImage im = drawPageToPixmap(maxGr, page, flags);
+				m_previews.insert(page->pageNr(), im);
+			}
+		}
+	});
+
+	return m_previews;
+}
+
+bool ScribusView::PageToBands(int Nr, int maxGr, int bandHeight, const std::function<bool(const QImage&, int)>& consumer, PageToPixmapFlags flags)
+{
+	if (m_doc == nullptr || maxGr <= 0 || bandHeight <= 0)
+		return false;
+	if (!inRange(0, Nr, m_doc->DocPages.count() - 1))
+		return false;
+
+	bool result = false;
+	renderWithPixmapSettings(flags, [&]() {
+		result = drawPageToBands(maxGr, m_doc->DocPages.at(Nr), bandHeight, consumer, flags);
+	});
+	return result;
+}
+
+QSize ScribusView::pageToPixmapSize(const ScPage* page, int maxGr)
+{
+	double sc = maxGr / page->height();
+	return QSize(qRound(page->width() * sc), qRound(page->height() * sc));
+}
+
+void ScribusView::renderWithPixmapSettings(PageToPixmapFlags flags, const std::function<void()>& render)
+{
 	// Preserve old settings
 
 	int oldAppMode = m_doc->appMode;
@@ -2558,25 +2606,7 @@ QMap<int, QImage> ScribusView::PagesToPixmap(int maxGr, int Nr, PageToPixmapFlag
 //	QElapsedTimer timer;
 //	timer.start();
 
-	// Draw all pages
-	if (Nr == -1)
-	{
-		for (const ScPage * page : std::as_const(m_doc->DocPages))
-		{
-			QImage im = drawPageToPixmap(maxGr, page, flags);
-			m_previews.insert(page->pageNr(), im);
-		}
-	}
-	// Draw single page by number
-	else
-	{
-		if (inRange(0, Nr, m_doc->DocPages.count() - 1))
-		{
-			const ScPage *page = m_doc->DocPages.at(Nr);
-			QImage im = drawPageToPixmap(maxGr, page, flags);
-			m_previews.insert(page->pageNr(), im);
-		}
-	}
+	render();
 
 //	qDebug() << Q_FUNC_INFO << "- draw preview in" << timer.elapsed() << "milliseconds";
 
@@ -2598,8 +2628,6 @@ QMap<int, QImage> ScribusView::PagesToPixmap(int maxGr, int Nr, PageToPixmapFlag
 	m_doc->minCanvasCoordinate = FPoint(cx, cy);
 	if (!flags.testFlag(Pixmap_NoCanvasModeChange))
 		requestMode(oldAppMode);
-
-	return m_previews;
 }
 
 QImage ScribusView::drawPageToPixmap(int maxGr, const ScPage *page, PageToPixmapFlags flags)
@@ -2618,6 +2646,53 @@ QImage ScribusView::drawPageToPixmap(int maxGr, const ScPage *page, PageToPixmap
 	im = QImage(clipw, cliph, QImage::Format_ARGB32_Premultiplied);
 	if (im.isNull())
 		return im;
+
+	QRect pageClip(clipx, clipy, clipw, cliph);
+	QList<QPair<PageItem*, int> > changedList = loadFullResolutionImages(page, pageClip, flags);
+	drawPageRect(im, page, pageClip, 0, flags);
+	restoreImageResolutions(changedList);
+
+	return im;
+}
+
+bool ScribusView::drawPageToBands(int maxGr, const ScPage *page, int bandHeight, const std::function<bool(const QImage&, int)>& consumer, PageToPixmapFlags flags)
+{
+	double sc = maxGr / page->height();
+	int clipx = static_cast<int>(page->xOffset() * sc);
+	int clipy = static_cast<int>(page->yOffset() * sc);
+	int clipw = qRound(page->width() * sc);
+	int cliph = qRound(page->height() * sc);
+
+	m_canvas->setScale(sc);
+
+	if ((clipw <=0) || (cliph <= 0))
+		return false;
+
+	QRect pageClip(clipx, clipy, clipw, cliph);
+	QList<QPair<PageItem*, int> > changedList = loadFullResolutionImages(page, pageClip, flags);
+	bool result = true;
+	for (int top = 0; result && (top < cliph); top += bandHeight)
+	{
+		QImage band(clipw, qMin(bandHeight, cliph - top), QImage::Format_ARGB32_Premultiplied);
+		if (band.isNull())
+		{
+			result = false;
+			break;
+		}
+		drawPageRect(band, page, pageClip, top, flags);
+		result = consumer(band, top);
+	}
+	restoreImageResolutions(changedList);
+
+	return result;
+}
+
+void ScribusView::drawPageRect(QImage& im, const ScPage *page, const QRect& pageClip, int top, PageToPixmapFlags flags)
+{
+	int clipx = pageClip.x();
+	int clipy = pageClip.y();
+	QRect clip(clipx, clipy + top, im.width(), im.height());
+
 	im.fill( qRgba(0, 0, 0, 0) );
 
 	auto painter = std::make_unique<ScPainter>(&im, im.width(), im.height(), 1.0, 0);
@@ -2625,20 +2700,39 @@ QImage ScribusView::drawPageToPixmap(int maxGr, const ScPage *page, PageToPixmap
 		painter->clear(m_doc->paperColor());
 	else if (flags & Pixmap_DrawWhiteBackground)
 		painter->clear(QColor(255, 255, 255));
-	painter->translate(-clipx, -clipy);
+	painter->translate(-clip.x(), -clip.y());
 	painter->setFillMode(ScPainter::Solid);
 	if (flags & Pixmap_DrawFrame)
 	{
 		painter->setPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
 		painter->setBrush(m_doc->paperColor());
-		painter->drawRect(clipx, clipy, clipw, cliph);
+		painter->drawRect(clipx, clipy, pageClip.width(), pageClip.height());
 	}
 	painter->beginLayer(1.0, 0);
 	painter->setZoomFactor(m_canvas->scale());
 
+	ScLayer layer;
+	layer.isViewable = false;
+	int layerCount = m_doc->layerCount();
+	for (int layerLevel = 0; layerLevel < layerCount; ++layerLevel)
+	{
+		m_doc->Layers.levelToLayer(layer, layerLevel);
+		m_canvas->DrawMasterItems(painter.get(), page, layer, clip);
+		m_canvas->DrawPageItems(painter.get(), layer, clip, false);
+		m_canvas->DrawPageItems(painter.get(), layer, clip, true);
+	}
+	painter->endLayer();
+	painter->end();
+}
+
+QList<QPair<PageItem*, int> > ScribusView::loadFullResolutionImages(const ScPage *page, const QRect& pageClip, PageToPixmapFlags flags)
+{
 	QList<QPair<PageItem*, int> > changedList;
+	if (flags.testFlag(Pixmap_DontReloadImages))
+		return changedList;
+
 	PageItem* currItem;
-	if (!page->FromMaster.isEmpty() && !flags.testFlag(Pixmap_DontReloadImages))
+	if (!page->FromMaster.isEmpty())
 	{
 		QList<PageItem*> itemList = page->FromMaster;
 		while (!itemList.isEmpty())
@@ -2666,10 +2760,11 @@ QImage ScribusView::drawPageToPixmap(int maxGr, const ScPage *page, PageToPixmap
 			currItem->setImageYOffset(imgY);
 		}
 	}
-	if (!m_doc->Items->isEmpty() && !flags.testFlag(Pixmap_DontReloadImages))
+	if (!m_doc->Items->isEmpty())
 	{
-		FPoint orig = m_canvas->localToCanvas(QPoint(clipx, clipy));
-		QRectF cullingArea(orig.x(), orig.y(), qRound(clipw / sc + 0.5), qRound(cliph / sc + 0.5));
+		double sc = m_canvas->scale();
+		FPoint orig = m_canvas->localToCanvas(pageClip.topLeft());
+		QRectF cullingArea(orig.x(), orig.y(), qRound(pageClip.width() / sc + 0.5), qRound(pageClip.height() / sc + 0.5));
 		QList<PageItem*> itemList = *(m_doc->Items);
 		while (!itemList.isEmpty())
 		{
@@ -2703,42 +2798,26 @@ QImage ScribusView::drawPageToPixmap(int maxGr, const ScPage *page, PageToPixmap
 			currItem->setImageYOffset(imgY);
 		}
 	}
+	return changedList;
+}
 
-	ScLayer layer;
-	layer.isViewable = false;
-	int layerCount = m_doc->layerCount();
-	for (int layerLevel = 0; layerLevel < layerCount; ++layerLevel)
-	{
-		m_doc->Layers.levelToLayer(layer, layerLevel);
-		m_canvas->DrawMasterItems(painter.get(), page, layer, QRect(clipx, clipy, clipw, cliph));
-		m_canvas->DrawPageItems(painter.get(), layer, QRect(clipx, clipy, clipw, cliph), false);
-		m_canvas->DrawPageItems(painter.get(), layer, QRect(clipx, clipy, clipw, cliph), true);
-	}
-	painter->endLayer();
-	painter->end();
-	painter.reset();
-
-	if (!changedList.isEmpty())
+void ScribusView::restoreImageResolutions(const QList<QPair<PageItem*, int> >& changedList)
+{
+	for (int it = 0; it < changedList.count(); it++)
 	{
-		QPair<PageItem*, int> itemPair;
-		for (int it = 0; it < changedList.count(); it++)
-		{
-			itemPair = changedList.at(it);
-			currItem = itemPair.first;
-			currItem->pixm.imgInfo.lowResType = itemPair.second;
-			int fho = currItem->imageFlippedH();
-			int fvo = currItem->imageFlippedV();
-			double imgX = currItem->imageXOffset();
-			double imgY = currItem->imageYOffset();
-			m_doc->loadPict(currItem->Pfile, currItem, true);
-			currItem->setImageFlippedH(fho);
-			currItem->setImageFlippedV(fvo);
-			currItem->setImageXOffset(imgX);
-			currItem->setImageYOffset(imgY);
-		}
+		const QPair<PageItem*, int>& itemPair = changedList.at(it);
+		PageItem* currItem = itemPair.first;
+		currItem->pixm.imgInfo.lowResType = itemPair.second;
+		int fho = currItem->imageFlippedH();
+		int fvo = currItem->imageFlippedV();
+		double imgX = currItem->imageXOffset();
+		double imgY = currItem->imageYOffset();
+		m_doc->loadPict(currItem->Pfile, currItem, true);
+		currItem->setImageFlippedH(fho);
+		currItem->setImageFlippedV(fvo);
+		currItem->setImageXOffset(imgX);
+		currItem->setImageYOffset(imgY);
 	}
-
-	return im;
 }
 
 void ScribusView::setNewRulerOrigin(QMouseEvent *m)
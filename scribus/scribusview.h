@@ -24,6 +24,7 @@ for which a new license (GPL+exception) is in place.
 #ifndef SCRIBUSVIEW_H
 #define SCRIBUSVIEW_H
 
+#include <functional>
 #include <vector>
 // include files for QT
 #include <QDragLeaveEvent>
@@ -175,6 +176,16 @@ public:
 	QImage PageToPixmap(int Nr, int maxGr, PageToPixmapFlags flags = Pixmap_DrawFrame | Pixmap_DrawBackground);
 	QImage MPageToPixmap(const QString& name, int maxGr, bool drawFrame = true);
 	QImage drawPageToPixmap(int maxGr, const ScPage *page, PageToPixmapFlags flags = Pixmap_DrawFrame | Pixmap_DrawBackground);
+	/**
+	 * Renders page \a Nr at the size PageToPixmap() would use, in horizontal bands of
+	 * \a bandHeight rows from top to bottom, so that large renderings never need a
+	 * whole page image. \a consumer gets each band and the row of its top edge and
+	 * returns false to stop rendering.
+	 * @return true if all bands were rendered and consumed
+	 */
+	bool PageToBands(int Nr, int maxGr, int bandHeight, const std::function<bool(const QImage&, int)>& consumer, PageToPixmapFlags flags = Pixmap_DrawFrame | Pixmap_DrawBackground);
+	/// Size of the image PageToPixmap() and PageToBands() render for \a page
+	static QSize pageToPixmapSize(const ScPage* page, int maxGr);
 
 	/**
 	 * Called when the ruler origin is dragged
@@ -298,6 +309,13 @@ private:
 	bool ImageAfterDraw { false };
 	QStack<ViewState> m_viewStates;
 
+	void renderWithPixmapSettings(PageToPixmapFlags flags, const std::function<void()>& render);
+	bool drawPageToBands(int maxGr, const ScPage *page, int bandHeight, const std::function<bool(const QImage&, int)>& consumer, PageToPixmapFlags flags);
+	/// Draws the rows of the page rendering at \a pageClip starting at row \a top into \a im
+	void drawPageRect(QImage& im, const ScPage *page, const QRect& pageClip, int top, PageToPixmapFlags flags);
+	QList<QPair<PageItem*, int> > loadFullResolutionImages(const ScPage *page, const QRect& pageClip, PageToPixmapFlags flags);
+	void restoreImageResolutions(const QList<QPair<PageItem*, int> >& changedList);
+
 private slots:
 	void setZoom();
 	/**
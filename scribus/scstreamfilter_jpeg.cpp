@@ -191,6 +191,12 @@ bool ScJpegEncodeFilter::openFilter ()
 		}
 		jpeg_set_defaults  (&m_filterData->cinfo);
 		jpeg_set_quality   (&m_filterData->cinfo, m_quality, true);
+		if (m_dpi > 0)
+		{
+			m_filterData->cinfo.density_unit = 1; // dots per inch
+			m_filterData->cinfo.X_density = static_cast<UINT16>(qMin(m_dpi, 65535));
+			m_filterData->cinfo.Y_density = static_cast<UINT16>(qMin(m_dpi, 65535));
+		}
 		jpeg_start_compress(&m_filterData->cinfo, true);
 		success = true;
 	}
@@ -40,6 +40,8 @@ public:
 	bool writeData(const char* data, int dataLen) override;
 
 	void setQuality(int quality) { m_quality = qMin(qMax(0, quality), 100); }
+	/// Resolution stored in the JFIF header, 0 for none
+	void setResolution(int dpi) { m_dpi = qMax(0, dpi); }
 
 protected:
 	bool  m_openedFilter { false };
@@ -50,6 +52,7 @@ protected:
 	unsigned int m_width { 0 };
 	unsigned int m_height { 0 };
 	int          m_quality { 75 };
+	int          m_dpi { 0 };
 	Color        m_color;
 };
 
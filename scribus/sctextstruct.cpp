@@ -17,53 +17,3 @@ PageItem* InlineFrame::getPageItem(const ScribusDoc* doc) const
 		return doc->FrameItems[m_object_id];
 	return nullptr;
 }
-
-
-ScText::~ScText() 
-{
-	delete parstyle;
-	parstyle = nullptr;
-	mark = nullptr;
-}
-
-bool ScText::hasObject(const ScribusDoc *doc) const
-{
-	if (this->ch == SpecialChars::OBJECT)
-		return ((embedded > 0) && (doc->FrameItems.contains(embedded)));
-	return false;
-}
-
-bool ScText::hasMark(const Mark* mrk) const
-{
-	if (this->ch != SpecialChars::OBJECT)
-		return false;
-	if (mrk == nullptr)
-		return mark != nullptr;
-	return mark == mrk;
-}
-
-QList<PageItem*> ScText::getGroupedItems(const ScribusDoc *doc) const
-{
-	QList<PageItem*> result;
-	if ((embedded > 0) && (doc->FrameItems.contains(embedded)))
-	{
-		PageItem* dItem = doc->FrameItems[embedded];
-		result.append(dItem);
-		if (dItem->isGroup())
-			result = dItem->getAllChildren();
-	}
-	return result;
-}
-
-PageItem* ScText::getItem(const ScribusDoc *doc) const
-{
-	if ((embedded > 0) && (doc->FrameItems.contains(embedded)))
-		return doc->FrameItems[embedded];
-	return nullptr;
-}
-
-void ScText::setNewMark(Mark *mrk)
-{
-	if (!mrk->isUnique())
-		mark = mrk;
-}
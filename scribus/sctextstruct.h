@@ -130,40 +130,6 @@ struct SCRIBUS_API GlyphLayout
 	uint glyph { 0 };
 };
 
-class SCRIBUS_API ScText : public CharStyle
-{
-public:
-	ScText() : CharStyle() {}
-
-	ScText(const ScText& other) :
-		CharStyle(other),
-		embedded(other.embedded),
-		ch(other.ch)
-	{
-		if (other.parstyle)
-			parstyle = new ParagraphStyle(*other.parstyle);
-		if (other.mark)
-			setNewMark(other.mark);
-	}
-
-	~ScText() override;
-
-	ParagraphStyle* parstyle { nullptr }; // only for parseps
-	int embedded { 0 };
-	Mark* mark { nullptr };
-	QChar ch;
-
-	bool hasObject(const ScribusDoc *doc) const;
-	//returns true if given MRK is found, if MRK is nullptr then any mark returns true
-	bool hasMark(const Mark * mrk = nullptr) const;
-	QList<PageItem*> getGroupedItems(const ScribusDoc *doc) const;
-	PageItem* getItem(const ScribusDoc *doc) const;
-
-private:
-	void setNewMark(Mark* mrk);
-};
-
-
 /** @brief First Line Offset Policy
  * Set whether the first line offset is based on max glyph height
  * or some of predefined height.
@@ -32,6 +32,10 @@
  *  Before any attribute is queried, you have to call validate(), which checks
  *  the stored m_contextversion against the StyleContext's version and updates all
  *  attributes if they are different.
+ *  Each style keeps the flattened values of its inheritance chain. A new context
+ *  version only copies the inherited values again if this style, its parent
+ *  style or the parent's own chain changed since the last update, which is
+ *  tracked with revision numbers.
  */
 class SCRIBUS_API BaseStyle : public SaxIO
 {
@@ -42,6 +46,22 @@ protected:
 	int m_contextversion { -1 };
 	QString m_parent;
 	QString m_shortcut;
+	quint64 m_revision { newRevision() };
+	const BaseStyle* m_inheritedFrom { nullptr };
+	quint64 m_inheritedRevision { 0 };
+
+	static quint64 newRevision();
+	/// Call this before a style which may belong to a style set changes its name
+	void renamed(const QString& newName);
+
+	/// Call this when the attributes of this style were changed directly
+	void modified() { m_contextversion = -1; m_revision = newRevision(); }
+
+	/**
+		Returns the revision of the styles this style inherits from,
+		\a parent has already been validated.
+	 */
+	virtual quint64 inheritedRevision(const BaseStyle* parent) const;
 
 public:
 	BaseStyle() = default;
@@ -51,16 +71,18 @@ public:
 	BaseStyle& operator=(const BaseStyle& o)
 	{ //assert(typeinfo() == o.typeinfo()); 
 		m_isDefaultStyle = o.m_isDefaultStyle;
+		renamed(o.m_name);
 		m_name = o.m_name;
 //		m_context = o.m_context; 
-		m_contextversion = -1; 
+		modified();
 		m_parent = o.m_parent;
 		m_shortcut = o.m_shortcut;
 		return *this;
 	}
 	
 	BaseStyle(const BaseStyle& o) : SaxIO(), m_isDefaultStyle(o.m_isDefaultStyle),m_name(o.m_name),
-		m_context(o.m_context), m_contextversion(o.m_contextversion), m_parent(o.m_parent), m_shortcut(o.m_shortcut) {} 
+		m_context(o.m_context), m_contextversion(o.m_contextversion), m_parent(o.m_parent), m_shortcut(o.m_shortcut),
+		m_inheritedFrom(o.m_inheritedFrom), m_inheritedRevision(o.m_inheritedRevision) {}
 	
 	virtual ~BaseStyle() {}
 
@@ -78,8 +100,10 @@ public:
 	bool isDefaultStyle() const      { return m_isDefaultStyle; }
 	
 	QString name() const             { return m_name; }
-	void setName(const QString& n)   { m_name = n.isEmpty() ? "" : n; }
+	void setName(const QString& n)   { renamed(n); m_name = n.isEmpty() ? "" : n; }
 	bool hasName() const             { return ! m_name.isEmpty(); }
+	/// Changes whenever a style belonging to a context is renamed, so that style sets can index styles by name
+	static quint64 renameRevision();
 
 	QString baseName() const;
 
@@ -107,12 +131,23 @@ public:
 		Checks if this BaseStyle needs an update
 	 */
 	inline void validate() const {
-		if (m_context && m_contextversion != m_context->version()) {
-			const_cast<BaseStyle*>(this)->update(m_context);
-			assert( m_context->checkConsistency() );
-		}
+		if (m_context && m_contextversion != m_context->version())
+			revalidate();
 	}
 
+	/**
+		Like validate(), but checks the inheritance chain even if the
+		StyleContext's version did not change. Only calls update() if
+		this style or a style it inherits from changed.
+	 */
+	void revalidate() const;
+
+	/**
+		Changes whenever the attributes of this style may have changed,
+		revisions are unique among all styles.
+	 */
+	quint64 revision() const { return m_revision; }
+
 	QString shortcut() const { return m_shortcut; }
 	void setShortcut(const QString &shortcut) { m_shortcut = shortcut; }
 
@@ -141,7 +176,7 @@ public:
 	void applyStyle(const BaseStyle& other) {
 		if (other.hasParent())
 			setParent( other.parent() == INHERIT_PARENT? "" :other.parent());
-		m_contextversion = -1;
+		modified();
 	}
 	/** 
 		if other has the same parent, remove this parent 
@@ -149,7 +184,7 @@ public:
 	void eraseStyle(const BaseStyle& other) {
 		if (other.parent() == parent())
 			setParent("");
-		m_contextversion = -1;
+		modified();
 	}
 };
 
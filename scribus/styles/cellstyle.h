@@ -116,7 +116,7 @@ public:
 	 * @param v value of the attribute.
 	 */
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT) \
-	void set##attr_NAME(attr_TYPE v) { m_##attr_NAME = v; inh_##attr_NAME = false; }
+	void set##attr_NAME(attr_TYPE v) { m_##attr_NAME = v; inh_##attr_NAME = false; modified(); }
 #include "cellstyle.attrdefs.cxx"
 #undef ATTRDEF
 	
@@ -125,7 +125,7 @@ public:
 	 * inherited.
 	 */
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT) \
-	void reset##attr_NAME() { m_##attr_NAME = attr_DEFAULT; inh_##attr_NAME = true; }
+	void reset##attr_NAME() { m_##attr_NAME = attr_DEFAULT; inh_##attr_NAME = true; modified(); }
 #include "cellstyle.attrdefs.cxx"
 #undef ATTRDEF
 	
@@ -176,7 +176,7 @@ inline CellStyle& CellStyle::operator=(const CellStyle& other)
 	inh_##attr_NAME = other.inh_##attr_NAME;
 #include "cellstyle.attrdefs.cxx"
 #undef ATTRDEF
-	m_contextversion = -1;
+	modified();
 	return *this;
 }
 
@@ -187,7 +187,7 @@ inline CellStyle::CellStyle(const CellStyle& other) : BaseStyle(other), cellStyl
 	inh_##attr_NAME = other.inh_##attr_NAME;
 #include "cellstyle.attrdefs.cxx"
 #undef ATTRDEF
-	m_contextversion = -1;
+	modified();
 }
 
 #endif // CELLSTYLE_H
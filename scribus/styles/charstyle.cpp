@@ -395,7 +395,7 @@ void CharStyle::setStyle(const CharStyle& other)
 {
 	other.validate();
 	setParent(other.parent());
-	m_contextversion = -1; 
+	modified();
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT, attr_BREAKSHAPING) \
 	inh_##attr_NAME = other.inh_##attr_NAME; \
 	m_##attr_NAME = other.m_##attr_NAME;
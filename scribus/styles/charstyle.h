@@ -164,14 +164,14 @@ public:
 	/** setter: sets the attribute's value and clears inherited flag */
 	
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT, attr_BREAKSHAPING) \
-	void set##attr_NAME(attr_TYPE v) { m_##attr_NAME = v; inh_##attr_NAME = false; }
+	void set##attr_NAME(attr_TYPE v) { m_##attr_NAME = v; inh_##attr_NAME = false; modified(); }
 #include "charstyle.attrdefs.cxx"
 #undef ATTRDEF
 	
 	/** setter: resets the attribute's value and sets inherited flag */
 	
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT, attr_BREAKSHAPING) \
-	void reset##attr_NAME() { m_##attr_NAME = attr_DEFAULT; inh_##attr_NAME = true; }
+	void reset##attr_NAME() { m_##attr_NAME = attr_DEFAULT; inh_##attr_NAME = true; modified(); }
 #include "charstyle.attrdefs.cxx"
 #undef ATTRDEF
 	
@@ -216,7 +216,7 @@ inline CharStyle & CharStyle::operator=(const CharStyle & other)
 #include "charstyle.attrdefs.cxx"
 #undef ATTRDEF
 	m_Effects = other.m_Effects;
-	m_contextversion = -1;
+	modified();
 	return *this;
 }
 
@@ -228,7 +228,7 @@ inline CharStyle::CharStyle(const CharStyle & other) : BaseStyle(other)
 #include "charstyle.attrdefs.cxx"
 #undef ATTRDEF
 	m_Effects = other.m_Effects;
-	m_contextversion = -1;
+	modified();
 }
 
 #endif
@@ -80,15 +80,15 @@ public:
 	/** setter: sets the attribute's value and clears inherited flag */
 	
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT) \
-	void set##attr_NAME(attr_TYPE v) { m_##attr_NAME = v; inh_##attr_NAME = false; }
+	void set##attr_NAME(attr_TYPE v) { m_##attr_NAME = v; inh_##attr_NAME = false; modified(); }
 #include "linestyle.attrdefs.cxx"
 #undef ATTRDEF
-	void appendSubline(const LineStyle& subline) { validate(); m_Sublines.append(subline); inh_Sublines = false; }
+	void appendSubline(const LineStyle& subline) { validate(); m_Sublines.append(subline); inh_Sublines = false; modified(); }
 	
 	/** setter: resets the attribute's value and sets inherited flag */
 	
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT) \
-	void reset##attr_NAME() { m_##attr_NAME = attr_DEFAULT; inh_##attr_NAME = true; }
+	void reset##attr_NAME() { m_##attr_NAME = attr_DEFAULT; inh_##attr_NAME = true; modified(); }
 #include "linestyle.attrdefs.cxx"
 #undef ATTRDEF
 	
@@ -134,7 +134,7 @@ inline LineStyle & LineStyle::operator=(const LineStyle & other)
 	inh_##attr_NAME = other.inh_##attr_NAME;
 #include "linestyle.attrdefs.cxx"
 #undef ATTRDEF
-	m_contextversion = -1;
+	modified();
 	return *this;
 }
 
@@ -145,7 +145,7 @@ inline LineStyle::LineStyle(const LineStyle & other) : BaseStyle(other), lineSty
 	inh_##attr_NAME = other.inh_##attr_NAME;
 #include "linestyle.attrdefs.cxx"
 #undef ATTRDEF
-	m_contextversion = -1;
+	modified();
 }
 
 #endif
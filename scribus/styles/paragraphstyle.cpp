@@ -140,6 +140,12 @@ void ParagraphStyle::breakImplicitCharStyleInheritance(bool val)
 	repairImplicitCharStyleInheritance();
 }
 
+quint64 ParagraphStyle::inheritedRevision(const BaseStyle* parent) const
+{
+	m_cstyle.revalidate();
+	return qMax(BaseStyle::inheritedRevision(parent), m_cstyle.revision());
+}
+
 void ParagraphStyle::update(const StyleContext* context)
 {
 	BaseStyle::update(context);
@@ -198,7 +204,7 @@ void ParagraphStyle::setStyle(const ParagraphStyle & other)
 {
 	other.validate();
 	setParent(other.parent());
-	m_contextversion = -1;
+	modified();
 	m_cstyle.setStyle(other.charStyle());
 	m_cstyleContext.invalidate();
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT) \
@@ -138,16 +138,16 @@ public:
 	/** setter: sets the attribute's value and clears inherited flag */
 	
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT) \
-	void set##attr_NAME(attr_TYPE v) { m_##attr_NAME = v; inh_##attr_NAME = false; }
+	void set##attr_NAME(attr_TYPE v) { m_##attr_NAME = v; inh_##attr_NAME = false; modified(); }
 #include "paragraphstyle.attrdefs.cxx"
 #undef ATTRDEF
-	void appendTabValue(const TabRecord& tab) { validate(); m_TabValues.append(tab); inh_TabValues = false; }
+	void appendTabValue(const TabRecord& tab) { validate(); m_TabValues.append(tab); inh_TabValues = false; modified(); }
 	
 	
 	/** setter: resets the attribute's value and sets inherited flag */
 	
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT) \
-	void reset##attr_NAME() { m_##attr_NAME = attr_DEFAULT; inh_##attr_NAME = true; }
+	void reset##attr_NAME() { m_##attr_NAME = attr_DEFAULT; inh_##attr_NAME = true; modified(); }
 #include "paragraphstyle.attrdefs.cxx"
 #undef ATTRDEF
 	
@@ -169,6 +169,10 @@ public:
 #undef ATTRDEF
 	
 	
+protected:
+	/// The character style is part of what a paragraph style inherits
+	quint64 inheritedRevision(const BaseStyle* parent) const override;
+
 private:
 		
 	// member declarations:
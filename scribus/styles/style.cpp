@@ -13,6 +13,7 @@
 *                                                                         *
 ***************************************************************************/
 
+#include <QAtomicInteger>
 #include <QDebug>
 #include <QRegularExpression>
 
@@ -23,11 +24,18 @@
 
 const QString BaseStyle::INHERIT_PARENT = "\n";
 
+namespace
+{
+	// Parent loops in broken documents must not recurse forever
+	thread_local int revalidateDepth = 0;
+	const int maxInheritanceDepth = 64;
+}
+
 void BaseStyle::setContext(const StyleContext* context)
 { 
 	if (m_context != context) {
 		m_context = context;
-		m_contextversion = -1;
+		modified();
 		assert( !m_context || m_context->checkConsistency() );
 	}
 	//qDebug() << QString("setContext of %2 context %1").arg(reinterpret_cast<uint>(m_context),16).arg(reinterpret_cast<uint>(this),16);
@@ -48,7 +56,7 @@ void BaseStyle::setParent(const QString& p)
 		return;
 	}
 	if (m_parent != p) 
-		m_contextversion = -1; 
+		modified();
 	m_parent = p.isEmpty()? "" : p;
 }
 
@@ -60,6 +68,61 @@ void BaseStyle::update(const StyleContext* b)
 		m_contextversion = m_context->version(); 
 }
 
+quint64 BaseStyle::newRevision()
+{
+	static QAtomicInteger<quint64> lastRevision;
+	return ++lastRevision;
+}
+
+namespace
+{
+	QAtomicInteger<quint64> lastRename;
+}
+
+void BaseStyle::renamed(const QString& newName)
+{
+	// Styles without context are not in a style set yet
+	if (m_context && (newName != m_name))
+		++lastRename;
+}
+
+quint64 BaseStyle::renameRevision()
+{
+	return lastRename.loadRelaxed();
+}
+
+quint64 BaseStyle::inheritedRevision(const BaseStyle* parent) const
+{
+	return parent ? parent->revision() : 0;
+}
+
+void BaseStyle::revalidate() const
+{
+	if (!m_context)
+		return;
+	auto* self = const_cast<BaseStyle*>(this);
+
+	const BaseStyle* parent = parentStyle();
+	if (parent && (revalidateDepth < maxInheritanceDepth))
+	{
+		++revalidateDepth;
+		parent->revalidate();
+		--revalidateDepth;
+	}
+	if ((m_contextversion >= 0) && (parent == m_inheritedFrom) && (inheritedRevision(parent) == m_inheritedRevision))
+	{
+		// Nothing this style inherits from has changed, the flattened values are still valid
+		self->m_contextversion = m_context->version();
+		return;
+	}
+
+	self->update(m_context);
+	assert( m_context->checkConsistency() );
+	self->m_inheritedFrom = parent;
+	self->m_inheritedRevision = inheritedRevision(parent);
+	self->m_revision = newRevision();
+}
+
 QString BaseStyle::baseName() const
 {
 	if (m_name.isEmpty())
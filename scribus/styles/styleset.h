@@ -3,6 +3,7 @@
 #ifndef STYLESET_H
 #define STYLESET_H
 
+#include <QHash>
 #include <QList>
 #include <QRegularExpression>
 
@@ -58,6 +59,9 @@ public:
 	{ 
 		styles.append(style); 
 		style->setContext(this); 
+		// The first of several styles with the same name wins
+		if (m_indexVersion == m_version && !m_index.contains(style->name()))
+			m_index.insert(style->name(), styles.count() - 1);
 		return style; 
 	}
 	
@@ -104,6 +108,7 @@ public:
 			delete styles.front(); 
 			styles.pop_front(); 
 		}
+		m_indexVersion = -1;
 		if (invalid)
 			invalidate();
 	}
@@ -129,8 +134,44 @@ private:
 	QList<STYLE*> styles;
 	const StyleContext* m_context;
 	STYLE* m_default;
+
+	/**
+	 * Index of the styles by name. Appended styles are added to it, it is
+	 * rebuilt once styles have been removed, the set has been invalidated or
+	 * any style has been renamed.
+	 */
+	mutable QHash<QString, int> m_index;
+	mutable int m_indexVersion { -1 };
+	mutable quint64 m_indexRenameRevision { 0 };
+
+	inline int indexOf(const QString& name) const;
+	static bool isSameDefinition(const STYLE& style, const STYLE& other);
 };
 
+template<class STYLE>
+inline int StyleSet<STYLE>::indexOf(const QString& name) const
+{
+	if ((m_indexVersion != m_version) || (m_indexRenameRevision != BaseStyle::renameRevision()))
+	{
+		m_index.clear();
+		m_index.reserve(styles.count());
+		// The first of several styles with the same name wins
+		for (int i = styles.count() - 1; i >= 0; --i)
+			m_index[styles[i]->name()] = i;
+		m_indexVersion = m_version;
+		m_indexRenameRevision = BaseStyle::renameRevision();
+	}
+	return m_index.value(name, -1);
+}
+
+template<class STYLE>
+bool StyleSet<STYLE>::isSameDefinition(const STYLE& style, const STYLE& other)
+{
+	return (style == other)
+		&& (style.shortcut() == other.shortcut())
+		&& (style.isDefaultStyle() == other.isDefaultStyle());
+}
+
 template<class STYLE>
 inline void StyleSet<STYLE>::remove(int index)
 {
@@ -138,24 +179,19 @@ inline void StyleSet<STYLE>::remove(int index)
 	if (styles.at(index) == m_default)
 		return;
 	styles.removeAt(index);
+	m_indexVersion = -1;
 }
 
 template<class STYLE>
 inline bool StyleSet<STYLE>::contains(const QString& name) const
 {
-	for (int i = 0; i < styles.count(); ++i)
-		if (styles[i]->name() == name)
-			return true;
-	return false;
+	return indexOf(name) >= 0;
 }
 
 template<class STYLE>
 inline int StyleSet<STYLE>::find(const QString& name) const
 {
-	for (int i = 0; i < styles.count(); ++i)
-		if (styles[i]->name() == name)
-			return i;
-	return -1;
+	return indexOf(name);
 }
 
 template<class STYLE>
@@ -174,11 +210,9 @@ inline const BaseStyle* StyleSet<STYLE>::resolve(const QString& name) const
 {
 	if (name.isEmpty())
 		return m_default;
-	for (int i = 0; i < styles.count(); ++i)
-	{
-		if (styles[i]->name() == name)
-			return styles[i];
-	}
+	int index = indexOf(name);
+	if (index >= 0)
+		return styles[index];
 	return m_context ? m_context->resolve(name) : NULL;
 }
 
@@ -230,8 +264,12 @@ inline void StyleSet<STYLE>::redefine(const StyleSet<STYLE>& defs, bool removeUn
 			if (styles[i]->name() == defs[j].name()) 
 			{
 				found = true;
-				(*styles[i]) = defs[j];
-				(*styles[i]).setContext(this);
+				// Keep unchanged styles so that they and the styles inheriting from them are not updated
+				if (!isSameDefinition(*styles[i], defs[j]))
+				{
+					(*styles[i]) = defs[j];
+					(*styles[i]).setContext(this);
+				}
 				if (defs.m_default == defs.styles[j])
 					makeDefault(styles[i]);
 				break;
@@ -118,7 +118,7 @@ public:
 	 * @param v value of the attribute.
 	 */
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT) \
-	void set##attr_NAME(attr_TYPE v) { m_##attr_NAME = v; inh_##attr_NAME = false; }
+	void set##attr_NAME(attr_TYPE v) { m_##attr_NAME = v; inh_##attr_NAME = false; modified(); }
 #include "tablestyle.attrdefs.cxx"
 #undef ATTRDEF
 
@@ -127,7 +127,7 @@ public:
 	 * inherited.
 	 */
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT) \
-	void reset##attr_NAME() { m_##attr_NAME = attr_DEFAULT; inh_##attr_NAME = true; }
+	void reset##attr_NAME() { m_##attr_NAME = attr_DEFAULT; inh_##attr_NAME = true; modified(); }
 #include "tablestyle.attrdefs.cxx"
 #undef ATTRDEF
 
@@ -217,7 +217,7 @@ inline TableStyle& TableStyle::operator=(const TableStyle& other)
 #include "tablestyle.attrdefs.cxx"
 #undef ATTRDEF
 	m_conditionalStyles = other.m_conditionalStyles;
-	m_contextversion = -1;
+	modified();
 	return *this;
 }
 
@@ -229,7 +229,7 @@ inline TableStyle::TableStyle(const TableStyle& other) : BaseStyle(other), table
 #include "tablestyle.attrdefs.cxx"
 #undef ATTRDEF
 	m_conditionalStyles = other.m_conditionalStyles;
-	m_contextversion = -1;
+	modified();
 }
 
 #endif // TABLESTYLE_H
\ No newline at end of file
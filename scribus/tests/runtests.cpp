@@ -2,14 +2,24 @@
 #include <QTest>
 //#include "testGlyphStore.h"
 //#include "testIndex.h"
+#include "testColorList.h"
+#include "testDocumentPackage.h"
+#include "testHyphenationCache.h"
+#include "testShapedRunCache.h"
 #include "testStoryText.h"
+#include "testStyles.h"
 #include "runtests.h"
 
 int RunTests::runTests(int argc, char ** argv)
 { 
 	QList<QObject *> testObjects;
 //	testObjects << new TestGlyphStore();
+	testObjects << new TestColorList();
+	testObjects << new TestDocumentPackage();
+	testObjects << new TestHyphenationCache();
+	testObjects << new TestShapedRunCache();
 	testObjects << new TestStoryText();
+	testObjects << new TestStyles();
 //	testObjects << new TestIndex();
 	int failed = 0;
 	for (int i = 0; i < testObjects.count(); ++i)
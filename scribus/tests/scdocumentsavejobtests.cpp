@@ -0,0 +1,171 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#include <QFile>
+#include <QSignalSpy>
+#include <QtTest/QtTest>
+
+#include "scdocumentsavejobtests.h"
+#include "qtiocompressor.h"
+#include "scdocumentsavejob.h"
+
+namespace
+{
+	// Writes the document in pieces, the way QXmlStreamWriter does
+	void writeDocument(QIODevice* device, const QByteArray& document)
+	{
+		for (qsizetype i = 0; i < document.size(); i += 4096)
+			device->write(document.mid(i, 4096));
+	}
+
+	bool saveDocument(const QString& fileName, bool compress, const QByteArray& document)
+	{
+		ScDocumentSaveJob job(fileName, compress);
+		job.start();
+		writeDocument(job.device(), document);
+		job.endSnapshot();
+		return job.waitForFinished();
+	}
+
+	QByteArray readFile(const QString& fileName, bool compressed)
+	{
+		QFile file(fileName);
+		if (!compressed)
+			return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+		QtIOCompressor compressor(&file);
+		compressor.setStreamFormat(QtIOCompressor::GzipFormat);
+		return compressor.open(QIODevice::ReadOnly) ? compressor.readAll() : QByteArray();
+	}
+}
+
+void ScDocumentSaveJobTests::initTestCase()
+{
+	QVERIFY(m_dir.isValid());
+	QByteArray item("<PAGEOBJECT XPOS=\"%1\" YPOS=\"120.5\" WIDTH=\"200\" HEIGHT=\"100\" PTYPE=\"4\" ANNAME=\"Text%1\"/>\n");
+	m_document = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<SCRIBUSUTF8NEW Version=\"1.7.1\">\n";
+	for (int i = 0; m_document.size() < 32 * 1024 * 1024; ++i)
+		m_document += QString::fromLatin1(item).arg(i).toLatin1();
+	m_document += "</SCRIBUSUTF8NEW>\n";
+}
+
+void ScDocumentSaveJobTests::testRoundTrip()
+{
+	QString fileName = m_dir.filePath("roundtrip.sla");
+	QVERIFY(saveDocument(fileName, false, m_document));
+	QCOMPARE(readFile(fileName, false), m_document);
+	// Only the document file is left behind
+	QCOMPARE(QDir(m_dir.path()).entryList({ "roundtrip.sla*" }, QDir::Files).count(), 1);
+}
+
+void ScDocumentSaveJobTests::testCompressedRoundTrip()
+{
+	QString fileName = m_dir.filePath("roundtrip.sla.gz");
+	QVERIFY(saveDocument(fileName, true, m_document));
+	QVERIFY(QFileInfo(fileName).size() < m_document.size());
+	QCOMPARE(readFile(fileName, true), m_document);
+}
+
+void ScDocumentSaveJobTests::testCancelKeepsFile()
+{
+	QString fileName = m_dir.filePath("cancel.sla");
+	QVERIFY(saveDocument(fileName, false, "previous"));
+
+	ScDocumentSaveJob job(fileName, false);
+	job.start();
+	writeDocument(job.device(), m_document.left(4 * 1024 * 1024));
+	job.cancel();
+	// Serialization stops as soon as the job is canceled
+	QCOMPARE(job.device()->write("<PAGE/>"), qint64(-1));
+	job.endSnapshot();
+	QVERIFY(!job.waitForFinished());
+	QVERIFY(job.savedFileName().isEmpty());
+	QCOMPARE(readFile(fileName, false), QByteArray("previous"));
+	QCOMPARE(QDir(m_dir.path()).entryList({ "cancel.sla*" }, QDir::Files).count(), 1);
+
+	// An incomplete snapshot is never written either
+	ScDocumentSaveJob incomplete(fileName, false);
+	incomplete.start();
+	incomplete.device()->write("<SCRIBUSUTF8NEW>");
+	incomplete.endSnapshot(false);
+	QVERIFY(!incomplete.waitForFinished());
+	QCOMPARE(readFile(fileName, false), QByteArray("previous"));
+}
+
+void ScDocumentSaveJobTests::testWriteBeforeStart()
+{
+	// More than the queue limit is written before there is a worker to take it
+	QString fileName = m_dir.filePath("prestart.sla");
+	QByteArray document = m_document + m_document;
+	ScDocumentSaveJob job(fileName, false);
+	writeDocument(job.device(), document.left(document.size() / 2));
+	job.start();
+	writeDocument(job.device(), document.mid(document.size() / 2));
+	job.endSnapshot();
+	QVERIFY(job.waitForFinished());
+	QCOMPARE(readFile(fileName, false), document);
+}
+
+void ScDocumentSaveJobTests::testWriteWhileQueued()
+{
+	// The first job holds the worker until its snapshot is complete
+	QString firstFileName = m_dir.filePath("first.sla");
+	ScDocumentSaveJob first(firstFileName, false);
+	first.start();
+	writeDocument(first.device(), m_document.left(1024 * 1024));
+
+	// so the second one waits in the queue, and must not block while
+	// more than the queue limit is written
+	QString secondFileName = m_dir.filePath("second.sla");
+	QByteArray document = m_document + m_document;
+	ScDocumentSaveJob second(secondFileName, false);
+	second.start();
+	writeDocument(second.device(), document);
+	second.endSnapshot();
+
+	writeDocument(first.device(), m_document.mid(1024 * 1024));
+	first.endSnapshot();
+	QVERIFY(first.waitForFinished());
+	QVERIFY(second.waitForFinished());
+	QCOMPARE(readFile(firstFileName, false), m_document);
+	QCOMPARE(readFile(secondFileName, false), document);
+}
+
+void ScDocumentSaveJobTests::testFinishedSignal()
+{
+	ScDocumentSaveJob job(m_dir.filePath("signal.sla"), false);
+	QSignalSpy progressSpy(&job, &ScDocumentSaveJob::progress);
+	QSignalSpy finishedSpy(&job, &ScDocumentSaveJob::finished);
+	job.start();
+	// Three full chunks, the last one is written once the snapshot is complete
+	writeDocument(job.device(), m_document.left(3 * 1024 * 1024 + 10));
+	job.endSnapshot();
+	QVERIFY(finishedSpy.wait());
+	QCOMPARE(finishedSpy.count(), 1);
+	QCOMPARE(finishedSpy.at(0).at(0).toBool(), true);
+	QCOMPARE(progressSpy.count(), 4);
+	QCOMPARE(progressSpy.last().at(0).toLongLong(), qint64(3 * 1024 * 1024 + 10));
+	QCOMPARE(progressSpy.last().at(1).toLongLong(), qint64(3 * 1024 * 1024 + 10));
+}
+
+void ScDocumentSaveJobTests::benchmarkSave()
+{
+	QString fileName = m_dir.filePath("benchmark.sla");
+	QBENCHMARK
+	{
+		saveDocument(fileName, false, m_document);
+	}
+}
+
+void ScDocumentSaveJobTests::benchmarkCompressedSave()
+{
+	QString fileName = m_dir.filePath("benchmark.sla.gz");
+	QBENCHMARK
+	{
+		saveDocument(fileName, true, m_document);
+	}
+}
+
+QTEST_GUILESS_MAIN(ScDocumentSaveJobTests)
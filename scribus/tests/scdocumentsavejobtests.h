@@ -0,0 +1,43 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCDOCUMENTSAVEJOBTESTS_H
+#define SCDOCUMENTSAVEJOBTESTS_H
+
+#include <QByteArray>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+/**
+ * Unit tests and benchmarks for ScDocumentSaveJob.
+ *
+ * The benchmarks write a synthetic document of about 32 MB, the time
+ * reported is the time the caller is busy serializing plus waiting for
+ * the writer.
+ */
+class ScDocumentSaveJobTests : public QObject
+{
+	Q_OBJECT
+public:
+	ScDocumentSaveJobTests() {}
+
+private slots:
+	void initTestCase();
+	void testRoundTrip();
+	void testCompressedRoundTrip();
+	void testCancelKeepsFile();
+	void testWriteBeforeStart();
+	void testWriteWhileQueued();
+	void testFinishedSignal();
+	void benchmarkSave();
+	void benchmarkCompressedSave();
+
+private:
+	QTemporaryDir m_dir;
+	QByteArray m_document;
+};
+
+#endif // SCDOCUMENTSAVEJOBTESTS_H
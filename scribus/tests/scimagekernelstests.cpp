@@ -0,0 +1,291 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#include <cmath>
+
+#include <QRandomGenerator>
+#include <QtTest/QtTest>
+
+#include "scimagekernelstests.h"
+#include "scimagekernels.h"
+
+namespace
+{
+	const int imageWidth = 1024;
+
+	QVector<uchar> blurDivTable(int radius)
+	{
+		int divSum = (radius + 1) * (radius + 1);
+		QVector<uchar> divTable(256 * divSum);
+		for (int i = 0; i < divTable.size(); ++i)
+			divTable[i] = i / divSum;
+		return divTable;
+	}
+
+	// Stack blur as a weighted sum, the weights decreasing linearly from the center
+	QRgb referenceBlur(const QRgb* line, int count, qsizetype step, int radius, int x)
+	{
+		int divSum = (radius + 1) * (radius + 1);
+		QRgb result = 0;
+		for (int c = 0; c < 32; c += 8)
+		{
+			int sum = 0;
+			for (int i = -radius; i <= radius; ++i)
+				sum += (radius + 1 - qAbs(i)) * ((line[qBound(0, x + i, count - 1) * step] >> c) & 0xff);
+			result |= QRgb(sum / divSum) << c;
+		}
+		return result;
+	}
+
+	// Sharpening kernel as built by ScImage::sharpen() for a radius of 2, normalized
+	// as ScImage::convolveImage() does
+	QVector<double> sharpenKernel()
+	{
+		QVector<double> kernel;
+		double normalize = 0.0;
+		for (int v = -2; v <= 2; ++v)
+		{
+			for (int u = -2; u <= 2; ++u)
+			{
+				kernel.append(exp(-(u * u + v * v) / 2.0) / (2.0 * 3.14159265358979323846));
+				normalize += kernel.last();
+			}
+		}
+		kernel[12] = -2.0 * normalize;
+		double sum = 0.0;
+		for (double weight : kernel)
+			sum += weight;
+		for (double& weight : kernel)
+			weight /= sum;
+		return kernel;
+	}
+}
+
+void ScImageKernelsTests::initTestCase()
+{
+	m_pixels.resize(1024 * 1024);
+	QRandomGenerator random(1234);
+	for (QRgb& pixel : m_pixels)
+		pixel = random.generate();
+}
+
+void ScImageKernelsTests::testLuminance()
+{
+	// Same weights as the floating point formula used before, at most one level apart on ties
+	for (int i = 0; i < 4096; ++i)
+	{
+		QRgb c = m_pixels[i];
+		int reference = qRound(0.3 * qRed(c) + 0.59 * qGreen(c) + 0.11 * qBlue(c));
+		QVERIFY(qAbs(ScImageKernels::luminance(c) - reference) <= 1);
+	}
+	QCOMPARE(ScImageKernels::luminance(qRgb(255, 255, 255)), 255);
+	QCOMPARE(ScImageKernels::inkLevel(qRgb(255, 255, 255), false), 0);
+	QCOMPARE(ScImageKernels::inkLevel(qRgba(255, 255, 255, 255), true), 255);
+	QCOMPARE(ScImageKernels::inkLevel(qRgba(0, 0, 0, 40), true), 40);
+}
+
+void ScImageKernelsTests::testApplyTable()
+{
+	uchar table[256];
+	for (int i = 0; i < 256; ++i)
+		table[i] = 255 - i;
+	QRgb row[3] = { qRgba(0, 10, 20, 30), qRgba(255, 128, 1, 0), qRgba(7, 7, 7, 255) };
+	ScImageKernels::applyTableRGB(row, 3, table);
+	QCOMPARE(row[0], qRgba(255, 245, 235, 30));
+	QCOMPARE(row[1], qRgba(0, 127, 254, 0));
+	QCOMPARE(row[2], qRgba(248, 248, 248, 255));
+
+	ScImageKernels::applyTable(reinterpret_cast<uchar*>(row), 4, table);
+	QCOMPARE(row[0], qRgba(0, 10, 20, 225));
+}
+
+void ScImageKernelsTests::testInvert()
+{
+	QRgb rgb = qRgba(10, 20, 30, 40);
+	ScImageKernels::invert(&rgb, 1, false);
+	QCOMPARE(rgb, qRgba(245, 235, 225, 40));
+
+	// Inverted CMYK colors get all their gray component as black
+	QRgb cmyk = qRgba(100, 50, 0, 20);
+	ScImageKernels::invert(&cmyk, 1, true);
+	QCOMPARE(cmyk, qRgba(0, 50, 100, 135));
+}
+
+void ScImageKernelsTests::testPacking()
+{
+	QRgb row[2] = { qRgba(1, 2, 3, 4), qRgba(5, 6, 7, 8) };
+	uchar out[8];
+	ScImageKernels::packRGB(row, 2, out);
+	QCOMPARE(QByteArray(reinterpret_cast<char*>(out), 6), QByteArray("\x01\x02\x03\x05\x06\x07", 6));
+	ScImageKernels::packCMYK(row, 2, out);
+	QCOMPARE(QByteArray(reinterpret_cast<char*>(out), 8), QByteArray("\x01\x02\x03\x04\x05\x06\x07\x08", 8));
+	ScImageKernels::packRed(row, 2, out);
+	QCOMPARE(out[1], uchar(5));
+	ScImageKernels::swapRedBlue(row, 2);
+	QCOMPARE(row[0], qRgba(3, 2, 1, 4));
+}
+
+void ScImageKernelsTests::testBlurLine()
+{
+	// Every third pixel, the others must be left untouched
+	const int count = 1000;
+	const qsizetype step = 3;
+	for (int radius : { 1, 2, 7, 30 })
+	{
+		QVector<uchar> divTable = blurDivTable(radius);
+		QVector<QRgb> stack(2 * radius + 1);
+		QVector<QRgb> line = m_pixels.mid(0, count * step);
+		QVector<QRgb> scalarLine = line;
+		ScImageKernels::blurLine(line.data(), count, step, radius, divTable.constData(), stack.data());
+		ScImageKernels::blurLineScalar(scalarLine.data(), count, step, radius, divTable.constData(), stack.data());
+		for (int i = 0; i < line.size(); ++i)
+		{
+			if (i % step == 0)
+				QCOMPARE(line[i], referenceBlur(m_pixels.constData(), count, step, radius, i / step));
+			else
+				QCOMPARE(line[i], m_pixels[i]);
+		}
+		QCOMPARE(scalarLine, line);
+	}
+
+	// Lines shorter than the blur window
+	QRgb pixel = qRgba(10, 20, 30, 40);
+	QVector<uchar> divTable = blurDivTable(5);
+	QVector<QRgb> stack(11);
+	ScImageKernels::blurLine(&pixel, 1, 1, 5, divTable.constData(), stack.data());
+	QCOMPARE(pixel, qRgba(10, 20, 30, 40));
+}
+
+void ScImageKernelsTests::testConvolveRow()
+{
+	const int width = 300;
+	QVector<double> kernel = sharpenKernel();
+	const QRgb* rows[5];
+	for (int i = 0; i < 5; ++i)
+		rows[i] = m_pixels.constData() + qMax(0, i - 1) * width;
+	QVector<QRgb> out(width);
+	QVector<QRgb> scalarOut(width);
+	ScImageKernels::convolveRow(rows, width, kernel.constData(), 5, out.data());
+	ScImageKernels::convolveRowScalar(rows, width, kernel.constData(), 5, scalarOut.data());
+	QCOMPARE(out, scalarOut);
+
+	// A single unit weight copies the row
+	QVector<double> identity(25, 0.0);
+	identity[12] = 1.0;
+	ScImageKernels::convolveRow(rows, width, identity.constData(), 5, out.data());
+	QCOMPARE(out, m_pixels.mid(width, width));
+}
+
+void ScImageKernelsTests::blurImage(int radius, bool scalar)
+{
+	QVector<uchar> divTable = blurDivTable(radius);
+	QVector<QRgb> stack(2 * radius + 1);
+	QVector<QRgb> pixels = m_pixels;
+	int height = pixels.size() / imageWidth;
+	QBENCHMARK {
+		for (int y = 0; y < height; ++y)
+		{
+			if (scalar)
+				ScImageKernels::blurLineScalar(pixels.data() + y * imageWidth, imageWidth, 1, radius, divTable.constData(), stack.data());
+			else
+				ScImageKernels::blurLine(pixels.data() + y * imageWidth, imageWidth, 1, radius, divTable.constData(), stack.data());
+		}
+		for (int x = 0; x < imageWidth; ++x)
+		{
+			if (scalar)
+				ScImageKernels::blurLineScalar(pixels.data() + x, height, imageWidth, radius, divTable.constData(), stack.data());
+			else
+				ScImageKernels::blurLine(pixels.data() + x, height, imageWidth, radius, divTable.constData(), stack.data());
+		}
+	}
+}
+
+void ScImageKernelsTests::sharpenImage(bool scalar)
+{
+	QVector<double> kernel = sharpenKernel();
+	QVector<QRgb> out(imageWidth);
+	int height = m_pixels.size() / imageWidth;
+	const QRgb* rows[5];
+	QBENCHMARK {
+		for (int y = 0; y < height; ++y)
+		{
+			for (int i = 0; i < 5; ++i)
+				rows[i] = m_pixels.constData() + qBound(0, y + i - 2, height - 1) * imageWidth;
+			if (scalar)
+				ScImageKernels::convolveRowScalar(rows, imageWidth, kernel.constData(), 5, out.data());
+			else
+				ScImageKernels::convolveRow(rows, imageWidth, kernel.constData(), 5, out.data());
+		}
+	}
+}
+
+void ScImageKernelsTests::benchmarkApplyTableRGB()
+{
+	uchar table[256];
+	for (int i = 0; i < 256; ++i)
+		table[i] = qMin(255, i + 16);
+	QVector<QRgb> pixels = m_pixels;
+	QBENCHMARK {
+		ScImageKernels::applyTableRGB(pixels.data(), pixels.size(), table);
+	}
+}
+
+void ScImageKernelsTests::benchmarkApplyInkTable()
+{
+	QRgb table[256];
+	for (int i = 0; i < 256; ++i)
+		table[i] = qRgba(i, i / 2, i / 4, 0);
+	QVector<QRgb> pixels = m_pixels;
+	QBENCHMARK {
+		ScImageKernels::applyInkTable(pixels.data(), pixels.size(), table, false);
+	}
+}
+
+void ScImageKernelsTests::benchmarkToGrayscale()
+{
+	QVector<QRgb> pixels = m_pixels;
+	QBENCHMARK {
+		ScImageKernels::toGrayscale(pixels.data(), pixels.size(), true);
+	}
+}
+
+void ScImageKernelsTests::benchmarkPackRGB()
+{
+	QByteArray out(3 * m_pixels.size(), 0);
+	QBENCHMARK {
+		ScImageKernels::packRGB(m_pixels.constData(), m_pixels.size(), reinterpret_cast<uchar*>(out.data()));
+	}
+}
+
+void ScImageKernelsTests::benchmarkPackCMYK()
+{
+	QByteArray out(4 * m_pixels.size(), 0);
+	QBENCHMARK {
+		ScImageKernels::packCMYK(m_pixels.constData(), m_pixels.size(), reinterpret_cast<uchar*>(out.data()));
+	}
+}
+
+void ScImageKernelsTests::benchmarkBlurLine()
+{
+	blurImage(10, false);
+}
+
+void ScImageKernelsTests::benchmarkBlurLineScalar()
+{
+	blurImage(10, true);
+}
+
+void ScImageKernelsTests::benchmarkConvolveRow()
+{
+	sharpenImage(false);
+}
+
+void ScImageKernelsTests::benchmarkConvolveRowScalar()
+{
+	sharpenImage(true);
+}
+
+QTEST_APPLESS_MAIN(ScImageKernelsTests)
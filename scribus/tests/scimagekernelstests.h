@@ -0,0 +1,51 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCIMAGEKERNELSTESTS_H
+#define SCIMAGEKERNELSTESTS_H
+
+#include <QVector>
+#include <QtTest/QtTest>
+
+/**
+ * Unit tests and benchmarks for the scanline kernels of ScImage.
+ *
+ * The benchmarks run on one megapixel, use "-iterations" or "-tickcounter"
+ * to compare builds for different instruction sets. Blur and convolution
+ * are benchmarked against their scalar versions as well.
+ */
+class ScImageKernelsTests : public QObject
+{
+	Q_OBJECT
+public:
+	ScImageKernelsTests() {}
+
+private slots:
+	void initTestCase();
+	void testLuminance();
+	void testApplyTable();
+	void testInvert();
+	void testPacking();
+	void testBlurLine();
+	void testConvolveRow();
+	void benchmarkApplyTableRGB();
+	void benchmarkApplyInkTable();
+	void benchmarkToGrayscale();
+	void benchmarkPackRGB();
+	void benchmarkPackCMYK();
+	void benchmarkBlurLine();
+	void benchmarkBlurLineScalar();
+	void benchmarkConvolveRow();
+	void benchmarkConvolveRowScalar();
+
+private:
+	QVector<QRgb> m_pixels;
+
+	void blurImage(int radius, bool scalar);
+	void sharpenImage(bool scalar);
+};
+
+#endif // SCIMAGEKERNELSTESTS_H
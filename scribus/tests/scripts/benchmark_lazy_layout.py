@@ -0,0 +1,83 @@
+#!/usr/bin/env python
+
+"""
+Load-time benchmark for lazy text layout.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+The script builds a directory-like document with many pages of unlinked text
+frames, saves it, and then measures how long it takes to open it again and how
+long it takes afterwards to lay out every frame.
+
+Run it once with the LazyTextLayout attribute of the Miscellaneous element in
+prefs172.xml set to "0" and once with it set to "1", then compare the numbers.
+With lazy layout the open time drops to about the time needed to read the file,
+while laying out all frames at once costs about what the eager open used to.
+"""
+
+import os
+import tempfile
+from time import time
+
+from scribus import *
+
+PAGES = 300
+FRAMES_PER_PAGE = 8
+
+ENTRY = ("Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+         "eiusmod tempor incididunt ut labore et dolore magna aliqua. ")
+
+
+def build_document(file_name):
+    newDocument(PAPER_A4, (20, 20, 20, 20), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, PAGES)
+    page_width, page_height = getPageSize()
+    frame_height = (page_height - 40) / FRAMES_PER_PAGE
+    setRedraw(False)
+    for page in range(1, PAGES + 1):
+        gotoPage(page)
+        for i in range(FRAMES_PER_PAGE):
+            name = "entry_%i_%i" % (page, i)
+            createText(20, 20 + i * frame_height, page_width - 40, frame_height - 5, name)
+            setText("%i.%i " % (page, i) + ENTRY * 4, name)
+    setRedraw(True)
+    saveDocAs(file_name)
+    closeDoc()
+
+
+def text_frames():
+    frames = []
+    for page in range(1, pageCount() + 1):
+        gotoPage(page)
+        for name, item_type, order in getPageItems():
+            if item_type == 4:
+                frames.append(name)
+    return frames
+
+
+def main():
+    file_name = os.path.join(tempfile.gettempdir(), "benchmark_lazy_layout.sla")
+    build_document(file_name)
+
+    start_time = time()
+    openDoc(file_name)
+    open_time = time() - start_time
+
+    frames = text_frames()
+    start_time = time()
+    for name in frames:
+        layoutText(name)
+    layout_time = time() - start_time
+
+    closeDoc()
+    os.remove(file_name)
+
+    print('%i pages, %i text frames' % (PAGES, len(frames)))
+    print('open document     = %.3f s' % round(open_time, 3))
+    print('layout all frames = %.3f s' % round(layout_time, 3))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,94 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "testColorList.h"
+#include "sccolor.h"
+
+void TestColorList::addByValue()
+{
+	ColorList colors;
+	colors.ensureDefaultColors();
+	QCOMPARE(colors.tryAddColor("Ink", ScColor(0, 0, 0, 255)), QString("Black"));
+	QCOMPARE(colors.tryAddColor("Red", ScColor(255, 0, 0)), QString("Red"));
+	QCOMPARE(colors.tryAddColor("FromPDF#ff0000", ScColor(255, 0, 0)), QString("Red"));
+
+	// Spot colors only match spot colors
+	ScColor spot(0, 255, 0, 0);
+	spot.setSpotColor(true);
+	QCOMPARE(colors.tryAddColor("Magenta", ScColor(0, 255, 0, 0)), QString("Magenta"));
+	QCOMPARE(colors.tryAddColor("Spot Magenta", spot), QString("Spot Magenta"));
+
+	// The first color by name is returned, as with a linear search of the map
+	colors.insert("A Red", ScColor(255, 0, 0));
+	QCOMPARE(colors.tryAddColor("Another", ScColor(255, 0, 0)), QString("A Red"));
+
+	// Lab colors never compare equal
+	QCOMPARE(colors.tryAddColor("Lab 1", ScColor(50.0, 10.0, 10.0)), QString("Lab 1"));
+	QCOMPARE(colors.tryAddColor("Lab 2", ScColor(50.0, 10.0, 10.0)), QString("Lab 2"));
+}
+
+void TestColorList::modifiedColors()
+{
+	ColorList colors;
+	QCOMPARE(colors.tryAddColor("Red", ScColor(255, 0, 0)), QString("Red"));
+	colors.remove("Red");
+	QCOMPARE(colors.tryAddColor("Other Red", ScColor(255, 0, 0)), QString("Other Red"));
+
+	colors["Other Red"].setRgbColor(0, 0, 255);
+	QCOMPARE(colors.tryAddColor("Blue", ScColor(0, 0, 255)), QString("Other Red"));
+	QCOMPARE(colors.tryAddColor("Red", ScColor(255, 0, 0)), QString("Red"));
+
+	colors.find("Red").value().setRgbColor(0, 255, 0);
+	QCOMPARE(colors.tryAddColor("Green", ScColor(0, 255, 0)), QString("Red"));
+
+	ColorList copy;
+	copy = colors;
+	QCOMPARE(copy.tryAddColor("Blue", ScColor(0, 0, 255)), QString("Other Red"));
+	copy.clear();
+	QCOMPARE(copy.tryAddColor("Blue", ScColor(0, 0, 255)), QString("Blue"));
+}
+
+void TestColorList::mapOverloads()
+{
+	ColorList colors;
+	QCOMPARE(colors.tryAddColor("Red", ScColor(255, 0, 0)), QString("Red"));
+
+	// Replacing a color through the other QMap overloads keeps the count, but not the old value
+	colors.insert(colors.constFind("Red"), "Red", ScColor(0, 0, 255));
+	QCOMPARE(colors.tryAddColor("Blue", ScColor(0, 0, 255)), QString("Red"));
+	QCOMPARE(colors.tryAddColor("Other Red", ScColor(255, 0, 0)), QString("Other Red"));
+
+	QMap<QString, ScColor> replaced;
+	replaced.insert("Other Red", ScColor(0, 255, 0));
+	replaced.insert("Yellow", ScColor(255, 255, 0));
+	colors.insert(replaced);
+	QCOMPARE(colors.count(), 3);
+	QCOMPARE(colors.tryAddColor("Green", ScColor(0, 255, 0)), QString("Other Red"));
+	QCOMPARE(colors.tryAddColor("Red Again", ScColor(255, 0, 0)), QString("Red Again"));
+	QCOMPARE(colors.tryAddColor("Yellow 2", ScColor(255, 255, 0)), QString("Yellow"));
+
+	const ColorList& constColors = colors;
+	QVERIFY(constColors.find("Yellow") != constColors.constEnd());
+	QCOMPARE(constColors["Yellow"], ScColor(255, 255, 0));
+}
+
+void TestColorList::benchmarkImportColors()
+{
+	// A vector heavy import: 20000 fill changes over 5000 distinct colors
+	QBENCHMARK
+	{
+		ColorList colors;
+		colors.ensureDefaultColors();
+		for (int i = 0; i < 20000; ++i)
+		{
+			int value = (i * 7919) % 5000;
+			ScColor color(value % 256, (value / 256) * 13, 128);
+			colors.tryAddColor("FromPDF" + color.name(), color);
+		}
+		QCOMPARE(colors.count(), 5003);
+	}
+}
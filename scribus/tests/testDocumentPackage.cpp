@@ -0,0 +1,130 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QScopedPointer>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#include "testDocumentPackage.h"
+#include "scdocumentpackage.h"
+
+void TestDocumentPackage::initTestCase()
+{
+	QVERIFY(m_dir.isValid());
+	// Not a valid image, the package stores entries as they are
+	m_imageData.resize(4096);
+	for (int i = 0; i < m_imageData.size(); ++i)
+		m_imageData[i] = char(i * 7);
+	m_imageFile = m_dir.filePath("inline_image.png");
+	QFile file(m_imageFile);
+	QVERIFY(file.open(QIODevice::WriteOnly));
+	QCOMPARE(file.write(m_imageData), m_imageData.size());
+}
+
+// Collects a document referencing one image entry and zips it to fileName,
+// returns the image entry name
+QString TestDocumentPackage::writePackage(const QString& fileName)
+{
+	QTemporaryDir packageDir(m_dir.filePath("package_XXXXXX"));
+	if (!packageDir.isValid())
+		return QString();
+	QString entryName = ScDocumentPackage::addImageEntry(packageDir.path(), m_imageFile);
+	if (entryName.isEmpty())
+		return QString();
+
+	QFile document(packageDir.filePath(ScDocumentPackage::documentEntry));
+	if (!document.open(QIODevice::WriteOnly))
+		return QString();
+	QXmlStreamWriter docu(&document);
+	docu.writeStartDocument();
+	docu.writeStartElement("SCRIBUSUTF8NEW");
+	docu.writeStartElement("PAGEOBJECT");
+	docu.writeAttribute("isInlineImage", "1");
+	docu.writeAttribute("InlineImageExt", "png");
+	docu.writeAttribute("ImageDataEntry", entryName);
+	docu.writeEndElement();
+	docu.writeEndElement();
+	docu.writeEndDocument();
+	document.close();
+
+	if (!ScDocumentPackage::write(packageDir.path(), fileName))
+		return QString();
+	return entryName;
+}
+
+void TestDocumentPackage::isPackage()
+{
+	QVERIFY(ScDocumentPackage::isPackage("document.slaz"));
+	QVERIFY(ScDocumentPackage::isPackage("DOCUMENT.SLAZ"));
+	QVERIFY(!ScDocumentPackage::isPackage("document.sla"));
+	QVERIFY(!ScDocumentPackage::isPackage("document.sla.gz"));
+}
+
+void TestDocumentPackage::roundTrip()
+{
+	QString fileName = m_dir.filePath("roundtrip.slaz");
+	QString entryName = writePackage(fileName);
+	QCOMPARE(entryName, QString("images/inline_image.png"));
+
+	ScDocumentPackage package;
+	QVERIFY(package.open(fileName));
+	QVERIFY(package.contains(ScDocumentPackage::documentEntry));
+	QVERIFY(package.contains(entryName));
+
+	// The document references the image entry
+	QScopedPointer<QIODevice> document(package.readDocument());
+	QVERIFY(document);
+	QXmlStreamReader reader(document.data());
+	QString imageDataEntry;
+	while (!reader.atEnd())
+	{
+		if (reader.readNext() == QXmlStreamReader::StartElement && reader.name() == QLatin1String("PAGEOBJECT"))
+		{
+			QVERIFY(!reader.attributes().hasAttribute("ImageData"));
+			imageDataEntry = reader.attributes().value("ImageDataEntry").toString();
+		}
+	}
+	QVERIFY(!reader.hasError());
+	QCOMPARE(imageDataEntry, entryName);
+
+	// and the image is stored as is
+	QBuffer image;
+	QVERIFY(image.open(QIODevice::WriteOnly));
+	QVERIFY(package.readEntry(imageDataEntry, &image));
+	QCOMPARE(image.data(), m_imageData);
+
+	QVERIFY(!package.readEntry("images/missing.png", &image));
+}
+
+void TestDocumentPackage::replaceExistingFile()
+{
+	QString fileName = m_dir.filePath("existing.slaz");
+	QFile existing(fileName);
+	QVERIFY(existing.open(QIODevice::WriteOnly));
+	existing.write("not a package");
+	existing.close();
+
+	QVERIFY(!writePackage(fileName).isEmpty());
+	ScDocumentPackage package;
+	QVERIFY(package.open(fileName));
+	QVERIFY(package.contains(ScDocumentPackage::documentEntry));
+
+	// Only the package is left in the directory, no temporary file
+	QStringList leftOver = QDir(m_dir.path()).entryList({ "existing.slaz*" }, QDir::Files);
+	QCOMPARE(leftOver, QStringList({ "existing.slaz" }));
+}
+
+void TestDocumentPackage::missingImage()
+{
+	// The caller falls back to embedding the image when it can't be added
+	QTemporaryDir packageDir(m_dir.filePath("package_XXXXXX"));
+	QVERIFY(packageDir.isValid());
+	QVERIFY(ScDocumentPackage::addImageEntry(packageDir.path(), m_dir.filePath("missing.png")).isEmpty());
+}
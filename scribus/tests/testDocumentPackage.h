@@ -0,0 +1,33 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+#ifndef TESTDOCUMENTPACKAGE_H
+#define TESTDOCUMENTPACKAGE_H
+
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+class TestDocumentPackage: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void initTestCase();
+	void isPackage();
+	void roundTrip();
+	void replaceExistingFile();
+	void missingImage();
+
+private:
+	QTemporaryDir m_dir;
+	QByteArray m_imageData;
+	QString m_imageFile;
+
+	QString writePackage(const QString& fileName);
+};
+
+#endif // TESTDOCUMENTPACKAGE_H
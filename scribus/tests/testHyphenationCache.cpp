@@ -0,0 +1,173 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QFile>
+#include <QHash>
+#include <QTextCodec>
+#include <QtConcurrent>
+
+#include "testHyphenationCache.h"
+#include "schyphenationcache.h"
+#include "scpaths.h"
+#include "third_party/hyphen/hyphen.h"
+
+namespace
+{
+	const QString language("test");
+}
+
+void TestHyphenationCache::initTestCase()
+{
+	m_dictFile = ScPaths::instance().dictDir() + "hyph/hyph_en_US.dic";
+	if (!QFile::exists(m_dictFile))
+		m_dictFile.clear();
+
+	m_words = QString("hyphenation dictionary paragraph typesetting document publishing "
+	                  "layout frame character style the of and a supercalifragilistic "
+	                  "internationalization").split(' ');
+	// Stories repeat a limited vocabulary over and over
+	const QStringList suffixes = { "", "s", "ed", "ing", "er", "ly" };
+	for (int i = 0; i < 20000; ++i)
+		m_story.append(m_words[i % m_words.count()] + suffixes[(i / m_words.count()) % suffixes.count()]);
+}
+
+QByteArray TestHyphenationCache::hyphenateDirectly(const QString& word) const
+{
+	QFile file(m_dictFile);
+	if (!file.open(QIODevice::ReadOnly))
+		return QByteArray();
+	QTextCodec* codec = QTextCodec::codecForName(file.readLine());
+	file.close();
+	HyphenDict* dict = codec ? hnj_hyphen_load(m_dictFile.toLocal8Bit().data()) : nullptr;
+	if (!dict)
+		return QByteArray();
+
+	QByteArray te = codec->fromUnicode(word);
+	QByteArray hyphens(qMax(te.length(), word.length()) + 5, 0);
+	char **rep = nullptr;
+	int *pos = nullptr;
+	int *cut = nullptr;
+	if (hnj_hyphen_hyphenate2(dict, te.data(), te.length(), hyphens.data(), nullptr, &rep, &pos, &cut))
+		hyphens.clear();
+	else
+		hyphens[te.length()] = '\0';
+	if (rep)
+	{
+		for (int i = 0; i < te.length() - 1; ++i)
+			free(rep[i]);
+	}
+	free(rep);
+	free(pos);
+	free(cut);
+	hnj_hyphen_free(dict);
+	return hyphens;
+}
+
+void TestHyphenationCache::matchesDictionary()
+{
+	if (m_dictFile.isEmpty())
+		QSKIP("No en_US hyphenation dictionary installed");
+	ScHyphenationCache cache;
+	QVERIFY(cache.loadDictionary(language, m_dictFile));
+	QVERIFY(cache.hasDictionary(language));
+	// Dictionaries are never replaced once loaded
+	QVERIFY(!cache.loadDictionary(language, m_dictFile));
+
+	bool hasHyphens = false;
+	for (const QString& word : std::as_const(m_words))
+	{
+		QByteArray expected = hyphenateDirectly(word);
+		QVERIFY(!expected.isEmpty());
+		QVERIFY(!cache.isCached(language, word));
+		QCOMPARE(cache.hyphenate(language, word), expected);
+		QVERIFY(cache.isCached(language, word));
+		// and once more from the cache
+		QCOMPARE(cache.hyphenate(language, word), expected);
+		for (int i = 0; i < word.length(); ++i)
+			hasHyphens |= (expected[i] & 1) != 0;
+	}
+	QVERIFY(hasHyphens);
+}
+
+void TestHyphenationCache::evictLeastRecentlyUsed()
+{
+	if (m_dictFile.isEmpty())
+		QSKIP("No en_US hyphenation dictionary installed");
+	ScHyphenationCache cache(3);
+	QVERIFY(cache.loadDictionary(language, m_dictFile));
+	cache.hyphenate(language, "paragraph");
+	cache.hyphenate(language, "document");
+	cache.hyphenate(language, "character");
+	// A hit makes the word the most recently used one
+	cache.hyphenate(language, "paragraph");
+	cache.hyphenate(language, "typesetting");
+	QVERIFY(cache.isCached(language, "paragraph"));
+	QVERIFY(!cache.isCached(language, "document"));
+	QVERIFY(cache.isCached(language, "character"));
+	QVERIFY(cache.isCached(language, "typesetting"));
+	// Evicted words are hyphenated again
+	QCOMPARE(cache.hyphenate(language, "document"), hyphenateDirectly("document"));
+	QVERIFY(!cache.isCached(language, "character"));
+}
+
+void TestHyphenationCache::concurrentHyphenate()
+{
+	if (m_dictFile.isEmpty())
+		QSKIP("No en_US hyphenation dictionary installed");
+	QHash<QString, QByteArray> expected;
+	for (const QString& word : std::as_const(m_story))
+	{
+		if (!expected.contains(word))
+			expected.insert(word, hyphenateDirectly(word));
+	}
+
+	// Fewer words than the story holds are kept, so that threads evict each other's words
+	ScHyphenationCache cache(64);
+	QVERIFY(cache.loadDictionary(language, m_dictFile));
+	QList<QByteArray> hyphens = QtConcurrent::blockingMapped(m_story, [&cache](const QString& word) {
+		return cache.hyphenate(language, word);
+	});
+	QCOMPARE(hyphens.count(), m_story.count());
+	for (int i = 0; i < m_story.count(); ++i)
+		QCOMPARE(hyphens[i], expected.value(m_story[i]));
+}
+
+void TestHyphenationCache::noDictionary()
+{
+	ScHyphenationCache cache;
+	QVERIFY(!cache.hasDictionary("xx_NONE"));
+	QVERIFY(cache.hyphenate("xx_NONE", "paragraph").isEmpty());
+	QVERIFY(!cache.loadDictionary("xx_FILE", "/nonexistent/hyph_xx.dic"));
+	QVERIFY(!cache.hasDictionary("xx_FILE"));
+}
+
+void TestHyphenationCache::benchmarkRepeatedWords()
+{
+	if (m_dictFile.isEmpty())
+		QSKIP("No en_US hyphenation dictionary installed");
+	ScHyphenationCache cache;
+	QVERIFY(cache.loadDictionary(language, m_dictFile));
+	QBENCHMARK
+	{
+		for (const QString& word : std::as_const(m_story))
+			cache.hyphenate(language, word);
+	}
+}
+
+void TestHyphenationCache::benchmarkRepeatedWordsUncached()
+{
+	if (m_dictFile.isEmpty())
+		QSKIP("No en_US hyphenation dictionary installed");
+	// A cache keeping a single word mostly misses, as hyphenating did before
+	ScHyphenationCache cache(1);
+	QVERIFY(cache.loadDictionary(language, m_dictFile));
+	QBENCHMARK
+	{
+		for (const QString& word : std::as_const(m_story))
+			cache.hyphenate(language, word);
+	}
+}
@@ -0,0 +1,37 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+#ifndef TESTHYPHENATIONCACHE_H
+#define TESTHYPHENATIONCACHE_H
+
+#include <QStringList>
+#include <QtTest/QtTest>
+
+class TestHyphenationCache: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void initTestCase();
+	void matchesDictionary();
+	void evictLeastRecentlyUsed();
+	void concurrentHyphenate();
+	void noDictionary();
+
+	void benchmarkRepeatedWords();
+	void benchmarkRepeatedWordsUncached();
+
+private:
+	QString m_dictFile;
+	QStringList m_words;
+	QStringList m_story;
+
+	// Hyphenation points as computed by the dictionary, without cache
+	QByteArray hyphenateDirectly(const QString& word) const;
+};
+
+#endif // TESTHYPHENATIONCACHE_H
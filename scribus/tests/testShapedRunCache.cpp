@@ -0,0 +1,127 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QDataStream>
+#include <QFile>
+
+#include "testShapedRunCache.h"
+#include "fonts/scface.h"
+#include "text/shapedruncache.h"
+
+namespace
+{
+	const QString text("Hallo Welt");
+
+	QByteArray runKey(int start, int len)
+	{
+		return ShapedRunCache::instance().makeKey(text, start, len, ScFace(), 12, 0, 0, "de", QByteArray());
+	}
+
+	QVector<ShapedRunCache::Glyph> runGlyphs(int len)
+	{
+		QVector<ShapedRunCache::Glyph> glyphs(len);
+		for (int i = 0; i < len; ++i)
+		{
+			glyphs[i].codepoint = 40 + i;
+			glyphs[i].cluster = i;
+			glyphs[i].xAdvance = 600 + i;
+			glyphs[i].yOffset = -i;
+		}
+		return glyphs;
+	}
+
+	// Writes a sidecar holding one run with the given glyphs
+	bool writeCacheFile(const QString& fileName, const QByteArray& key, qint32 glyphCount, const QVector<ShapedRunCache::Glyph>& glyphs)
+	{
+		QFile file(fileName);
+		if (!file.open(QIODevice::WriteOnly))
+			return false;
+		QDataStream ds(&file);
+		ds.setVersion(QDataStream::Qt_6_0);
+		ds << quint32(0x53435352) << quint32(1) << qint32(1);
+		ds << key << glyphCount;
+		for (const ShapedRunCache::Glyph& glyph : glyphs)
+			ds << glyph.codepoint << glyph.cluster << glyph.xOffset << glyph.yOffset << glyph.xAdvance << glyph.yAdvance;
+		return ds.status() == QDataStream::Ok;
+	}
+}
+
+void TestShapedRunCache::init()
+{
+	QVERIFY(m_dir.isValid());
+	ShapedRunCache::instance().clear();
+}
+
+void TestShapedRunCache::cleanupTestCase()
+{
+	ShapedRunCache::instance().clear();
+}
+
+void TestShapedRunCache::saveAndLoad()
+{
+	ShapedRunCache& cache = ShapedRunCache::instance();
+	QByteArray documentKey = runKey(0, 5);
+	QByteArray otherKey = runKey(6, 4);
+	QVector<ShapedRunCache::Glyph> glyphs = runGlyphs(5);
+	cache.insert(documentKey, glyphs);
+	cache.insert(otherKey, runGlyphs(4));
+
+	// Only the runs of the document are written
+	QString fileName = ShapedRunCache::cacheFileName(m_dir.filePath("roundtrip.sla"));
+	QVERIFY(cache.save(fileName, { documentKey, documentKey, runKey(0, 10) }));
+	cache.clear();
+	QVERIFY(cache.load(fileName));
+	QVERIFY(!cache.contains(otherKey));
+	QVERIFY(!cache.contains(runKey(0, 10)));
+
+	QVector<ShapedRunCache::Glyph> loaded;
+	QVERIFY(cache.find(documentKey, loaded));
+	QCOMPARE(loaded.count(), glyphs.count());
+	for (int i = 0; i < glyphs.count(); ++i)
+	{
+		QCOMPARE(loaded[i].codepoint, glyphs[i].codepoint);
+		QCOMPARE(loaded[i].cluster, glyphs[i].cluster);
+		QCOMPARE(loaded[i].xOffset, glyphs[i].xOffset);
+		QCOMPARE(loaded[i].yOffset, glyphs[i].yOffset);
+		QCOMPARE(loaded[i].xAdvance, glyphs[i].xAdvance);
+		QCOMPARE(loaded[i].yAdvance, glyphs[i].yAdvance);
+	}
+}
+
+void TestShapedRunCache::rejectInconsistentFiles()
+{
+	ShapedRunCache& cache = ShapedRunCache::instance();
+	QByteArray key = runKey(0, 5);
+	QString fileName = m_dir.filePath("broken.sla.shaping");
+
+	QVERIFY(writeCacheFile(fileName, key, 5, runGlyphs(5)));
+	QVERIFY(cache.load(fileName));
+	QVERIFY(cache.contains(key));
+	cache.clear();
+
+	// More glyphs than the file holds
+	QVERIFY(writeCacheFile(fileName, key, 1 << 28, runGlyphs(5)));
+	QVERIFY(!cache.load(fileName));
+	QVERIFY(!cache.contains(key));
+
+	// Cluster past the end of the run
+	QVector<ShapedRunCache::Glyph> glyphs = runGlyphs(5);
+	glyphs[4].cluster = 5;
+	QVERIFY(writeCacheFile(fileName, key, 5, glyphs));
+	QVERIFY(!cache.load(fileName));
+	QVERIFY(!cache.contains(key));
+
+	// Malformed key
+	QVERIFY(writeCacheFile(fileName, QByteArray("key"), 5, runGlyphs(5)));
+	QVERIFY(!cache.load(fileName));
+
+	// Truncated file
+	QVERIFY(writeCacheFile(fileName, key, 5, runGlyphs(5)));
+	QVERIFY(QFile::resize(fileName, QFileInfo(fileName).size() - 3));
+	QVERIFY(!cache.load(fileName));
+	QVERIFY(!cache.contains(key));
+}
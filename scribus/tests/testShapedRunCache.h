@@ -0,0 +1,28 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+#ifndef TESTSHAPEDRUNCACHE_H
+#define TESTSHAPEDRUNCACHE_H
+
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+class TestShapedRunCache: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void init();
+	void cleanupTestCase();
+	void saveAndLoad();
+	void rejectInconsistentFiles();
+
+private:
+	QTemporaryDir m_dir;
+};
+
+#endif // TESTSHAPEDRUNCACHE_H
@@ -8,8 +8,36 @@
  */
 
 #include <QDebug>
+#include <QFile>
 #include "testStoryText.h"
 
+namespace
+{
+	const QString benchmarkParagraph("Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+									 "eiusmod tempor incididunt ut labore et dolore magna aliqua. ");
+
+	// About 2 MB of UTF-16 text in paragraphs of about 500 characters
+	QString benchmarkText()
+	{
+		QString result;
+		for (int i = 0; i < 2000; ++i)
+			result += benchmarkParagraph.repeated(4) + SpecialChars::PARSEP;
+		return result;
+	}
+
+	qint64 residentMemory()
+	{
+		// Linux only, returns 0 elsewhere
+		QFile statm("/proc/self/statm");
+		if (!statm.open(QIODevice::ReadOnly))
+			return 0;
+		QList<QByteArray> fields = statm.readAll().split(' ');
+		if (fields.count() < 2)
+			return 0;
+		return fields.at(1).toLongLong() * 4096;
+	}
+}
+
 void TestStoryText::initST()
 {
 	StoryText story;
@@ -127,3 +155,88 @@ void TestStoryText::removeCharStyle()
 	QCOMPARE(story.startOfRun(2), 5  + 26 + 1);
 	QCOMPARE(story.endOfRun(2), 11 + 26);
 }
+
+void TestStoryText::mergeCharStyleRuns()
+{
+	StoryText story;
+	story.insertChars(0,
+					  QString("0123456789") + SpecialChars::PARSEP + 
+					  QString("abcdefghijklmnopqrstuvwxyz") + SpecialChars::PARSEP + 
+					  QString("ABCDEFGHIJKLMNOPQRSTUVWXYZ"));
+	CharStyle cs;
+	cs.setFontSize(10);
+	story.applyCharStyle(11 + 5, 10, cs);
+	QCOMPARE(story.nrOfRuns(), 5u);
+	story.eraseCharStyle(11 + 5, 10, cs);
+	QCOMPARE(story.nrOfRuns(), 3u);
+	QCOMPARE(story.endOfRun(1), 11 + 26 + 1);
+	story.insertChars(11 + 5, "01234");
+	QCOMPARE(story.nrOfRuns(), 3u);
+	QCOMPARE(story.text(11, 10), QString("abcde01234"));
+}
+
+void TestStoryText::hyphenationRuns()
+{
+	StoryText story;
+	story.insertChars(0, QString("hyphenation"));
+	const char hyphens[] = { 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0 };
+	story.hyphenateWord(0, 11, hyphens);
+	QVERIFY(story.hasFlag(1, ScLayout_HyphenationPossible));
+	QVERIFY(story.hasFlag(6, ScLayout_HyphenationPossible));
+	QVERIFY(!story.hasFlag(2, ScLayout_HyphenationPossible));
+	QCOMPARE(story.nrOfRuns(), 5u);
+	story.hyphenateWord(0, 11, nullptr);
+	QCOMPARE(story.nrOfRuns(), 1u);
+}
+
+void TestStoryText::benchmarkInsertText()
+{
+	QString text = benchmarkText();
+	QBENCHMARK
+	{
+		StoryText story;
+		story.insertChars(0, text);
+		QCOMPARE(story.length(), static_cast<int>(text.length()));
+	}
+}
+
+void TestStoryText::benchmarkSearchText()
+{
+	StoryText story;
+	story.insertChars(0, benchmarkText());
+	int found = 0;
+	QBENCHMARK
+	{
+		found = 0;
+		for (int pos = story.indexOf("magna", 0); pos >= 0; pos = story.indexOf("magna", pos + 1))
+			++found;
+	}
+	QCOMPARE(found, 2000 * 4);
+}
+
+void TestStoryText::benchmarkApplyCharStyle()
+{
+	StoryText story;
+	story.insertChars(0, benchmarkText());
+	CharStyle cs;
+	cs.setFontSize(10);
+	QBENCHMARK
+	{
+		for (int pos = 0; pos + 20 < story.length(); pos += 1000)
+			story.applyCharStyle(pos, 20, cs);
+	}
+	QVERIFY(story.nrOfRuns() < 3 * story.nrOfParagraphs());
+}
+
+void TestStoryText::benchmarkMemory()
+{
+	QString text = benchmarkText();
+	qint64 before = residentMemory();
+	if (before == 0)
+		QSKIP("Resident memory size not available on this platform");
+	StoryText story;
+	story.insertChars(0, text);
+	qint64 after = residentMemory();
+	QCOMPARE(story.nrOfRuns(), story.nrOfParagraphs());
+	QTest::setBenchmarkResult(after - before, QTest::BytesAllocated);
+}
@@ -27,4 +27,11 @@ private slots:
 	void removePars();
 	void applyCharStyle();
 	void removeCharStyle();
+	void mergeCharStyleRuns();
+	void hyphenationRuns();
+
+	void benchmarkInsertText();
+	void benchmarkSearchText();
+	void benchmarkApplyCharStyle();
+	void benchmarkMemory();
 };
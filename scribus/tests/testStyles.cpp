@@ -0,0 +1,167 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "testStyles.h"
+#include "styles/charstyle.h"
+#include "styles/styleset.h"
+
+namespace
+{
+	// Default style, "Base", "Child" inheriting from "Base" and "Other"
+	void createStyles(StyleSet<CharStyle>& styles, double baseFontSize = 100)
+	{
+		CharStyle defaultStyle;
+		defaultStyle.setDefaultStyle(true);
+		defaultStyle.setFontSize(120);
+		styles.makeDefault(styles.create(defaultStyle));
+
+		CharStyle base;
+		base.setName("Base");
+		base.setFontSize(baseFontSize);
+		styles.create(base);
+
+		CharStyle child;
+		child.setName("Child");
+		child.setParent("Base");
+		child.setTracking(10);
+		styles.create(child);
+
+		CharStyle other;
+		other.setName("Other");
+		other.setTracking(20);
+		styles.create(other);
+	}
+}
+
+void TestStyles::resolveNames()
+{
+	StyleSet<CharStyle> styles;
+	createStyles(styles);
+	QCOMPARE(styles.find("Other"), 3);
+	QVERIFY(styles.contains("Child"));
+	QVERIFY(styles.resolve("") == styles.getDefault());
+	QVERIFY(styles.resolve("Missing") == nullptr);
+
+	// Renaming without invalidating the set still finds the style
+	styles[3].setName("Renamed");
+	QCOMPARE(styles.find("Renamed"), 3);
+	QCOMPARE(styles.find("Other"), -1);
+}
+
+void TestStyles::indexUpdates()
+{
+	StyleSet<CharStyle> styles;
+	createStyles(styles);
+	QCOMPARE(styles.find("Other"), 3);
+
+	// Appended styles are found, the first of two styles with the same name wins
+	CharStyle added;
+	added.setName("Added");
+	styles.create(added);
+	QCOMPARE(styles.find("Added"), 4);
+	styles.create(added);
+	QCOMPARE(styles.find("Added"), 4);
+	QCOMPARE(styles.count(), 6);
+
+	// Removing shifts the styles after it
+	styles.remove(1);
+	QCOMPARE(styles.find("Base"), -1);
+	QCOMPARE(styles.find("Child"), 1);
+	QCOMPARE(styles.find("Added"), 3);
+
+	// Redefining removes unused styles and adds new ones
+	StyleSet<CharStyle> defs;
+	createStyles(defs);
+	defs.remove(3);
+	CharStyle defined;
+	defined.setName("Defined");
+	defs.create(defined);
+	styles.redefine(defs, true);
+	QCOMPARE(styles.find("Other"), -1);
+	QCOMPARE(styles.find("Added"), -1);
+	QCOMPARE(styles[styles.find("Base")].name(), QString("Base"));
+	QCOMPARE(styles[styles.find("Child")].name(), QString("Child"));
+	QCOMPARE(styles[styles.find("Defined")].name(), QString("Defined"));
+	QCOMPARE(styles.count(), 4);
+}
+
+void TestStyles::inheritedValues()
+{
+	StyleSet<CharStyle> styles;
+	createStyles(styles);
+	QCOMPARE(styles.get("Child").fontSize(), 100.0);
+	QCOMPARE(styles.get("Other").fontSize(), 120.0);
+	quint64 childRevision = styles.get("Child").revision();
+	quint64 otherRevision = styles.get("Other").revision();
+
+	styles[1].setFontSize(140);
+	styles.invalidate();
+	QCOMPARE(styles.get("Child").fontSize(), 140.0);
+	QCOMPARE(styles.get("Child").tracking(), 10.0);
+	QVERIFY(styles.get("Child").revision() != childRevision);
+	styles.get("Other").validate();
+	QCOMPARE(styles.get("Other").revision(), otherRevision);
+
+	// Reparenting is noticed as well
+	styles[2].setParent("");
+	styles.invalidate();
+	QCOMPARE(styles.get("Child").fontSize(), 120.0);
+}
+
+void TestStyles::redefineUnchanged()
+{
+	StyleSet<CharStyle> styles;
+	createStyles(styles);
+	styles.get("Child").validate();
+	styles.get("Other").validate();
+	quint64 childRevision = styles.get("Child").revision();
+	quint64 otherRevision = styles.get("Other").revision();
+
+	StyleSet<CharStyle> same;
+	createStyles(same);
+	styles.redefine(same);
+	styles.get("Child").validate();
+	styles.get("Other").validate();
+	QCOMPARE(styles.get("Child").revision(), childRevision);
+	QCOMPARE(styles.get("Other").revision(), otherRevision);
+
+	StyleSet<CharStyle> changed;
+	createStyles(changed, 80);
+	styles.redefine(changed);
+	QCOMPARE(styles.get("Child").fontSize(), 80.0);
+	QVERIFY(styles.get("Child").revision() != childRevision);
+	styles.get("Other").validate();
+	QCOMPARE(styles.get("Other").revision(), otherRevision);
+}
+
+void TestStyles::benchmarkRevalidate()
+{
+	// A template with 300 styles in chains of 10, editing the first style of one chain
+	StyleSet<CharStyle> styles;
+	CharStyle defaultStyle;
+	defaultStyle.setDefaultStyle(true);
+	defaultStyle.setFontSize(120);
+	styles.makeDefault(styles.create(defaultStyle));
+	for (int i = 0; i < 300; ++i)
+	{
+		CharStyle style;
+		style.setName(QString("Style %1").arg(i));
+		if (i % 10 != 0)
+			style.setParent(QString("Style %1").arg(i - 1));
+		style.setTracking(i);
+		styles.create(style);
+	}
+
+	QBENCHMARK
+	{
+		styles[1].setFontSize(styles[1].fontSize() + 1);
+		styles.invalidate();
+		for (int i = 0; i < styles.count(); ++i)
+			styles[i].validate();
+	}
+	QCOMPARE(styles.get("Style 9").fontSize(), styles[1].fontSize());
+}
@@ -0,0 +1,173 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#include <QtTest/QtTest>
+
+#include "xpsmasterdictionarytests.h"
+#include "plugins/export/xpsexport/xpsmasterdictionary.h"
+
+namespace
+{
+	// A4 in XPS units
+	const double pageWidth = 793.7;
+	const double pageHeight = 1122.5;
+	const int pageCount = 100;
+	const int masterPaths = 2000;
+
+	QDomDocument newPage()
+	{
+		QDomDocument docu("xpsdoc");
+		docu.setContent(QString("<FixedPage></FixedPage>"));
+		QDomElement root = docu.documentElement();
+		root.setAttribute("Width", pageWidth);
+		root.setAttribute("Height", pageHeight);
+		root.setAttribute("xmlns", "http://schemas.microsoft.com/xps/2005/06");
+		root.setAttribute("xml:lang", "en");
+		return docu;
+	}
+
+	// Adds the items of the page itself, a text frame and a few shapes
+	void addPageItems(QDomDocument& docu, int pageNr)
+	{
+		QDomElement canvas = docu.createElement("Canvas");
+		for (int i = 0; i < 20; ++i)
+		{
+			QDomElement path = docu.createElement("Path");
+			path.setAttribute("Data", QString("M %1,%2 L %3,%2 L %3,%4 Z").arg(10 + i).arg(20 + pageNr).arg(50 + i).arg(90 + i));
+			path.setAttribute("Fill", "#FF000000");
+			canvas.appendChild(path);
+		}
+		docu.documentElement().appendChild(canvas);
+	}
+
+	QByteArray toXml(const QDomDocument& docu)
+	{
+		QString vo = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+		vo += docu.toString();
+		return vo.toUtf8();
+	}
+
+	// Size of the parts of all pages with the master content repeated on each of them
+	qint64 writeRepeatedPages(const QDomElement& masterCanvas)
+	{
+		qint64 size = 0;
+		for (int i = 0; i < pageCount; ++i)
+		{
+			QDomDocument docu = newPage();
+			docu.documentElement().appendChild(docu.importNode(masterCanvas, true));
+			addPageItems(docu, i);
+			size += toXml(docu).size();
+		}
+		return size;
+	}
+
+	// Size of the dictionary and the parts of all pages painting its brush
+	qint64 writeSharedPages(const QDomElement& masterCanvas)
+	{
+		XPSMasterDictionary dictionary(pageWidth, pageHeight);
+		dictionary.addBrush("mp0_0", masterCanvas);
+		qint64 size = dictionary.toXml().size();
+		for (int i = 0; i < pageCount; ++i)
+		{
+			QDomDocument docu = newPage();
+			QDomElement root = docu.documentElement();
+			root.insertBefore(XPSMasterDictionary::pageResources(docu, "/Resources/MasterPages/0.dict"), QDomNode());
+			QDomElement layer = docu.createElement("Canvas");
+			layer.appendChild(XPSMasterDictionary::brushPath(docu, "mp0_0", pageWidth, pageHeight));
+			root.appendChild(layer);
+			addPageItems(docu, i);
+			size += toXml(docu).size();
+		}
+		return size;
+	}
+}
+
+void XPSMasterDictionaryTests::initTestCase()
+{
+	// A dense master page: background shapes, rules and a logo drawn as many small paths
+	m_masterDocu.setContent(QString("<Canvas></Canvas>"));
+	m_masterCanvas = m_masterDocu.documentElement();
+	for (int i = 0; i < masterPaths; ++i)
+	{
+		double x = (i % 40) * 19.5;
+		double y = (i / 40) * 22.0;
+		QDomElement path = m_masterDocu.createElement("Path");
+		path.setAttribute("Data", QString("M %1,%2 C %3,%2 %3,%4 %1,%4 Z").arg(x).arg(y).arg(x + 15.25).arg(y + 18.75));
+		path.setAttribute("Fill", QString("#FF%1").arg(i * 2654435761u % 0xFFFFFF, 6, 16, QChar('0')).toUpper());
+		path.setAttribute("Stroke", "#FF000000");
+		path.setAttribute("StrokeThickness", "0.75");
+		m_masterCanvas.appendChild(path);
+	}
+}
+
+void XPSMasterDictionaryTests::testDictionary()
+{
+	XPSMasterDictionary dictionary(pageWidth, pageHeight);
+	QVERIFY(dictionary.isEmpty());
+	dictionary.addBrush("mp0_0", m_masterCanvas);
+	dictionary.addBrush("mp0_1", m_masterCanvas.firstChildElement());
+	QVERIFY(!dictionary.isEmpty());
+
+	QDomDocument docu;
+	QVERIFY(docu.setContent(dictionary.toXml()));
+	QDomElement root = docu.documentElement();
+	QCOMPARE(root.tagName(), QString("ResourceDictionary"));
+	QCOMPARE(root.attribute("xmlns"), QString("http://schemas.microsoft.com/xps/2005/06"));
+	QDomNodeList brushes = root.elementsByTagName("VisualBrush");
+	QCOMPARE(brushes.count(), 2);
+	QDomElement brush = brushes.at(0).toElement();
+	QCOMPARE(brush.attribute("x:Key"), QString("mp0_0"));
+	QCOMPARE(brush.attribute("Viewbox"), QString("0, 0, 793.7, 1122.5"));
+	QCOMPARE(brush.attribute("Viewport"), brush.attribute("Viewbox"));
+	QCOMPARE(brush.attribute("TileMode"), QString("None"));
+	QDomElement visual = brush.firstChildElement("VisualBrush.Visual");
+	QCOMPARE(visual.firstChildElement("Canvas").elementsByTagName("Path").count(), masterPaths);
+	QCOMPARE(brushes.at(1).toElement().attribute("x:Key"), QString("mp0_1"));
+}
+
+void XPSMasterDictionaryTests::testPageReferences()
+{
+	QDomDocument docu = newPage();
+	QDomElement resources = XPSMasterDictionary::pageResources(docu, "/Resources/MasterPages/0.dict");
+	QCOMPARE(resources.tagName(), QString("FixedPage.Resources"));
+	QCOMPARE(resources.firstChildElement("ResourceDictionary").attribute("Source"), QString("/Resources/MasterPages/0.dict"));
+
+	QDomElement path = XPSMasterDictionary::brushPath(docu, "mp0_0", pageWidth, pageHeight);
+	QCOMPARE(path.tagName(), QString("Path"));
+	QCOMPARE(path.attribute("Data"), QString("M 0,0 L 793.7,0 L 793.7,1122.5 L 0,1122.5 Z"));
+	QCOMPARE(path.attribute("Fill"), QString("{StaticResource mp0_0}"));
+}
+
+void XPSMasterDictionaryTests::testSharedSize()
+{
+	qint64 repeated = writeRepeatedPages(m_masterCanvas);
+	qint64 shared = writeSharedPages(m_masterCanvas);
+	qInfo("%d pages, %d master paths: %lld bytes repeated, %lld bytes shared", pageCount, masterPaths, repeated, shared);
+	// The master content is written once instead of once per page
+	QVERIFY(shared * 10 < repeated);
+}
+
+void XPSMasterDictionaryTests::benchmarkRepeatedMasterPages()
+{
+	qint64 size = 0;
+	QBENCHMARK
+	{
+		size = writeRepeatedPages(m_masterCanvas);
+	}
+	qInfo("%lld bytes", size);
+}
+
+void XPSMasterDictionaryTests::benchmarkSharedMasterPages()
+{
+	qint64 size = 0;
+	QBENCHMARK
+	{
+		size = writeSharedPages(m_masterCanvas);
+	}
+	qInfo("%lld bytes", size);
+}
+
+QTEST_GUILESS_MAIN(XPSMasterDictionaryTests)
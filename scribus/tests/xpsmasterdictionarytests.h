@@ -0,0 +1,42 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef XPSMASTERDICTIONARYTESTS_H
+#define XPSMASTERDICTIONARYTESTS_H
+
+#include <QDomDocument>
+#include <QDomElement>
+#include <QtTest/QtTest>
+
+/**
+ * Unit tests and benchmarks for the master page dictionary of the XPS export.
+ *
+ * The benchmarks write the pages of a 100 page document whose master page
+ * holds 2000 paths, once with the master content repeated on every page and
+ * once shared through the dictionary. The time reported covers building and
+ * serializing all pages, the total size of the parts is printed after each
+ * benchmark.
+ */
+class XPSMasterDictionaryTests : public QObject
+{
+	Q_OBJECT
+public:
+	XPSMasterDictionaryTests() {}
+
+private slots:
+	void initTestCase();
+	void testDictionary();
+	void testPageReferences();
+	void testSharedSize();
+	void benchmarkRepeatedMasterPages();
+	void benchmarkSharedMasterPages();
+
+private:
+	QDomDocument m_masterDocu;
+	QDomElement m_masterCanvas;
+};
+
+#endif // XPSMASTERDICTIONARYTESTS_H
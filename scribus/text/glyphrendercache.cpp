@@ -0,0 +1,144 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "glyphrendercache.h"
+
+#if CAIRO_HAS_FC_FONT
+#include <cairo-ft.h>
+#endif
+
+#include <QFile>
+#include <QMutexLocker>
+
+#include "fonts/scface.h"
+#include "fpointarray.h"
+
+GlyphRenderCache& GlyphRenderCache::instance()
+{
+	static GlyphRenderCache cache;
+	return cache;
+}
+
+GlyphRenderCache::GlyphRenderCache()
+{
+	m_faces.setMaxCost(64);
+	m_paths.setMaxCost(16 * 1024 * 1024);
+}
+
+cairo_font_face_t* GlyphRenderCache::fontFace(const ScFace& face)
+{
+#if CAIRO_HAS_FC_FONT
+	QString key = face.fontPath();
+	QMutexLocker locker(&m_mutex);
+	FontFace* cached = m_faces.object(key);
+	if (cached == nullptr)
+	{
+		// A very ugly hack as we can’t use the font().ftFace() because
+		// Scribus liberally calls FT_Set_CharSize() with all sorts of
+		// crazy values, breaking any subsequent call to the layout
+		// painter.  FIXME: drop the FontConfig dependency here once
+		// Scribus font handling code is made sane!
+		FcPattern *pattern = FcPatternBuild(nullptr,
+							FC_FILE, FcTypeString, QFile::encodeName(face.fontFilePath()).data(),
+							FC_INDEX, FcTypeInteger, face.faceIndex(),
+							nullptr);
+		cached = new FontFace(cairo_ft_font_face_create_for_pattern(pattern));
+		FcPatternDestroy(pattern);
+		m_faces.insert(key, cached, 1);
+	}
+	return cairo_font_face_reference(cached->face);
+#else
+	Q_UNUSED(face);
+	return nullptr;
+#endif
+}
+
+QSharedPointer<const cairo_path_t> GlyphRenderCache::glyphPath(const ScFace& face, uint gid)
+{
+	GlyphKey key(face.fontPath(), gid);
+	{
+		QMutexLocker locker(&m_mutex);
+		if (GlyphPath* cached = m_paths.object(key))
+			return *cached;
+	}
+
+	// Do not hold the lock while the outline is loaded from the font file
+	GlyphPath path = createPath(face, gid);
+	int cost = 1;
+	if (path)
+		cost += path->num_data * static_cast<int>(sizeof(cairo_path_data_t));
+
+	QMutexLocker locker(&m_mutex);
+	m_paths.insert(key, new GlyphPath(path), cost);
+	return path;
+}
+
+GlyphRenderCache::GlyphPath GlyphRenderCache::createPath(const ScFace& face, uint gid)
+{
+	FPointArray points = face.glyphOutline(gid);
+	if (points.size() <= 3)
+		return GlyphPath();
+
+	// Same path construction as ScPainter::setupPolygon() for closed polygons
+	cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1);
+	cairo_t* cr = cairo_create(surface);
+	bool nPath = true;
+	bool first = true;
+	FPoint np, np1, np2, np3, np4, firstP;
+	for (int poi = 0; poi < points.size() - 3; poi += 4)
+	{
+		if (points.isMarker(poi))
+		{
+			nPath = true;
+			continue;
+		}
+		if (nPath)
+		{
+			np = points.point(poi);
+			if (!first && (np4 == firstP))
+				cairo_close_path(cr);
+			cairo_move_to(cr, np.x(), np.y());
+			first = nPath = false;
+			firstP = np4 = np;
+		}
+		np  = points.point(poi);
+		np1 = points.point(poi + 1);
+		np2 = points.point(poi + 3);
+		np3 = points.point(poi + 2);
+		if (np4 == np3)
+			continue;
+		if ((np == np1) && (np2 == np3))
+			cairo_line_to(cr, np3.x(), np3.y());
+		else
+			cairo_curve_to(cr, np1.x(), np1.y(), np2.x(), np2.y(), np3.x(), np3.y());
+		np4 = np3;
+	}
+	cairo_close_path(cr);
+	GlyphPath path(cairo_copy_path(cr), cairo_path_destroy);
+	cairo_destroy(cr);
+	cairo_surface_destroy(surface);
+	return path;
+}
+
+void GlyphRenderCache::clear()
+{
+	QMutexLocker locker(&m_mutex);
+	m_faces.clear();
+	m_paths.clear();
+}
+
+int GlyphRenderCache::maxPathBytes() const
+{
+	QMutexLocker locker(&m_mutex);
+	return static_cast<int>(m_paths.maxCost());
+}
+
+void GlyphRenderCache::setMaxPathBytes(int maxBytes)
+{
+	QMutexLocker locker(&m_mutex);
+	m_paths.setMaxCost(maxBytes);
+}
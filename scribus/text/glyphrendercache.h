@@ -0,0 +1,78 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#ifndef GLYPHRENDERCACHE_H
+#define GLYPHRENDERCACHE_H
+
+#include <cairo.h>
+
+#include <QCache>
+#include <QMutex>
+#include <QPair>
+#include <QSharedPointer>
+#include <QString>
+
+#include "scribusapi.h"
+
+class ScFace;
+
+/**
+ * Process-wide cache of what ScreenPainter needs to draw glyphs, shared
+ * between all frames, canvas redraws and documents.
+ *
+ * Cairo font faces are kept per font file and face index. Cairo caches the
+ * rasterized glyphs it draws with cairo_show_glyphs() in the scaled fonts
+ * derived from a face, for each size, transformation and font options, so
+ * reusing the same face keeps those glyph masks alive from one redraw to the
+ * next instead of rasterizing every glyph again.
+ *
+ * Glyph outlines used when glyphs are drawn as paths (gradient or pattern
+ * fills, masks, strokes) are kept as cairo paths in font units. They are
+ * scaled by the transformation matrix when appended, instead of copying,
+ * mapping and converting the outline on every draw. Paths are bounded by
+ * their memory size and evicted least recently used first.
+ */
+class SCRIBUS_API GlyphRenderCache
+{
+public:
+	static GlyphRenderCache& instance();
+
+	/// Returns a new reference to the cairo font face of \a face, to be released with cairo_font_face_destroy()
+	cairo_font_face_t* fontFace(const ScFace& face);
+
+	/**
+	 * Returns the outline of glyph \a gid of \a face as returned by
+	 * ScFace::glyphOutline(), or a null pointer for an empty outline.
+	 */
+	QSharedPointer<const cairo_path_t> glyphPath(const ScFace& face, uint gid);
+
+	void clear();
+
+	int maxPathBytes() const;
+	void setMaxPathBytes(int maxBytes);
+
+private:
+	GlyphRenderCache();
+
+	struct FontFace
+	{
+		explicit FontFace(cairo_font_face_t* f) : face(f) {}
+		~FontFace() { cairo_font_face_destroy(face); }
+		cairo_font_face_t* face { nullptr };
+	};
+
+	using GlyphKey = QPair<QString, uint>;
+	using GlyphPath = QSharedPointer<const cairo_path_t>;
+
+	static GlyphPath createPath(const ScFace& face, uint gid);
+
+	mutable QMutex m_mutex;
+	QCache<QString, FontFace> m_faces;
+	QCache<GlyphKey, GlyphPath> m_paths;
+};
+
+#endif // GLYPHRENDERCACHE_H
@@ -6,11 +6,9 @@
  */
 
 #include <cairo.h>
-#if CAIRO_HAS_FC_FONT
-#include <cairo-ft.h>
-#endif
 
 #include "screenpainter.h"
+#include "glyphrendercache.h"
 #include "scpainter.h"
 #include "pageitem.h"
 #include "scribusdoc.h"
@@ -63,17 +61,10 @@ void ScreenPainter::drawGlyph(const GlyphCluster& gc)
 		{
 			m_fontPath = font().fontFilePath();
 			m_faceIndex = font().faceIndex();
-			// A very ugly hack as we can’t use the font().ftFace() because
-			// Scribus liberally calls FT_Set_CharSize() with all sorts of
-			// crazy values, breaking any subsequent call to the layout
-			// painter.  FIXME: drop the FontConfig dependency here once
-			// Scribus font handling code is made sane!
-			FcPattern *pattern = FcPatternBuild(nullptr,
-							    FC_FILE, FcTypeString, QFile::encodeName(font().fontFilePath()).data(),
-							    FC_INDEX, FcTypeInteger, font().faceIndex(),
-								nullptr);
-			m_cairoFace = cairo_ft_font_face_create_for_pattern(pattern);
-			FcPatternDestroy(pattern);
+			if (m_cairoFace != nullptr)
+				cairo_font_face_destroy(m_cairoFace);
+			// Shared with other painters, so that cairo keeps the glyphs it rasterized
+			m_cairoFace = GlyphRenderCache::instance().fontFace(font());
 		}
 
 		cairo_set_font_face(cr, m_cairoFace);
@@ -223,17 +214,12 @@ void ScreenPainter::drawGlyph(const GlyphCluster& gc)
 	else
 	{
 		double sizeFactor = fontSize() / 10.0;
-		QVector<FPointArray> outlines = gc.glyphClusterOutline();
-		const QList<GlyphLayout>& glyphs = gc.glyphs();
-		for (int i = 0; i < glyphs.count(); ++i)
+		for (const GlyphLayout& gl : gc.glyphs())
 		{
-			const FPointArray& outline = outlines.at(i);
-			const GlyphLayout& gl = glyphs.at(i);
 			m_painter->save();
 			m_painter->translate(gl.xoffset, - (fontSize() * gl.scaleV) + gl.yoffset);
 			m_painter->scale(gl.scaleH * sizeFactor, gl.scaleV * sizeFactor);
-			m_painter->setupPolygon(&outline, true);
-			if (outline.size() > 3)
+			if (setupGlyphPath(gl.glyph))
 				m_painter->fillPath();
 			m_painter->restore();
 			m_painter->translate(gl.xadvance * gl.scaleH, 0.0);
@@ -260,14 +246,14 @@ void ScreenPainter::drawGlyphOutline(const GlyphCluster& gc, bool fill)
 		m_painter->save();
 		m_painter->translate(gl.xoffset + current_x, - (fontSize() * gl.scaleV) + gl.yoffset );
 
-		FPointArray outline = font().glyphOutline(gl.glyph);
+		// Scale the path only, the stroke width is not scaled
 		double scaleHv = gl.scaleH * fontSize() / 10.0;
 		double scaleVv = gl.scaleV * fontSize() / 10.0;
-		QTransform trans;
-		trans.scale(scaleHv, scaleVv);
-		outline.map(trans);
-		m_painter->setupPolygon(&outline, true);
-		if (outline.size() > 3)
+		m_painter->save();
+		m_painter->scale(scaleHv, scaleVv);
+		bool hasPath = setupGlyphPath(gl.glyph);
+		m_painter->restore();
+		if (hasPath)
 		{
 			m_painter->setLineWidth(strokeWidth());
 			m_painter->strokePath();
@@ -352,6 +338,16 @@ void ScreenPainter::restoreState()
 	m_painter->restore();
 }
 
+bool ScreenPainter::setupGlyphPath(uint gid)
+{
+	QSharedPointer<const cairo_path_t> path = GlyphRenderCache::instance().glyphPath(font(), gid);
+	if (!path)
+		return false;
+	m_painter->newPath();
+	cairo_append_path(m_painter->context(), path.data());
+	return true;
+}
+
 void ScreenPainter::setupState(bool rect)
 {
 	if (selected() && rect)
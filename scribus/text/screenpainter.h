@@ -34,6 +34,8 @@ public:
 
 private:
 	void setupState(bool rect);
+	/// Replaces the current path with the cached outline of glyph \a gid, returns false if it is empty
+	bool setupGlyphPath(uint gid);
 
 	ScPainter *m_painter { nullptr };
 	PageItem *m_item { nullptr };
@@ -5,17 +5,26 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
+#include <algorithm>
 #include <cassert>  //added to make Fedora-5 happy
 
 //#include <QDebug>
 
 #include "fpoint.h"
+#include "marks.h"
 #include "scfonts.h"
 
 #include "scribusdoc.h"
 #include "sctext_shared.h"
 #include "util.h"
 
+namespace
+{
+	// How many runs around a new style are looked at for an equivalent
+	// style to share, e.g. the runs split by hyphenation points
+	const int styleSharingDistance = 8;
+}
+
 ScText_Shared::ScText_Shared(const StyleContext* pstyles) :
 	pstyleContext(nullptr)
 {
@@ -25,10 +34,10 @@ ScText_Shared::ScText_Shared(const StyleContext* pstyles) :
 	orphanedCharStyle.setContext( defaultStyle.charStyle().context() );
 //		qDebug() << QString("ScText_Shared() %1 %2 %3 %4").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&defaultStyle)).arg(reinterpret_cast<uint>(pstyles)).arg(reinterpret_cast<uint>(cstyles));
 }
-		
+
 
 ScText_Shared::ScText_Shared(const ScText_Shared& other) :
-	defaultStyle(other.defaultStyle), 
+	defaultStyle(other.defaultStyle),
 	pstyleContext(other.pstyleContext),
 	cursorPosition(other.cursorPosition),
 	selFirst(other.selFirst), selLast(other.selLast),
@@ -39,29 +48,17 @@ ScText_Shared::ScText_Shared(const ScText_Shared& other) :
 	trailingStyle.setContext( &pstyleContext );
 	orphanedCharStyle.setContext( defaultStyle.charStyle().context() );
 
-	QListIterator<ScText*> it( other );
-	const ScText* elem;
-	while ( it.hasNext() )
-	{
-		elem = it.next();
-		ScText* elem2 = new ScText(*elem);
-		append(elem2);
-		if (elem2->parstyle)
-		{
-			elem2->parstyle->setContext( & pstyleContext);
-			replaceCharStyleContextInParagraph(count() - 1, elem2->parstyle->charStyleContext());
-		}
-	}
-	len = count();
-	replaceCharStyleContextInParagraph(len,  trailingStyle.charStyleContext() );
+	copyFrom(other);
 //		qDebug() << QString("ScText_Shared(%2) %1").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&other));
 }
 
 void ScText_Shared::clear()
 {
-	while (!this->isEmpty())
-		delete this->takeFirst(); 
-	QList<ScText*>::clear();
+	for (const Special& sp : std::as_const(m_specials))
+		delete sp.parstyle;
+	m_specials.clear();
+	m_runs.clear();
+	m_text.clear();
 	cursorPosition = 0;
 	selFirst = 0;
 	selLast = -1;
@@ -70,9 +67,9 @@ void ScText_Shared::clear()
 	marksCount = 0;
 }
 
-ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other) 
+ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 {
-	if (this != &other) 
+	if (this != &other)
 	{
 		defaultStyle   = other.defaultStyle;
 		trailingStyle  = other.trailingStyle;
@@ -82,23 +79,7 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 		trailingStyle.setContext( &pstyleContext );
 		orphanedCharStyle.setContext( other.defaultStyle.charStyle().context() );
 		clear();
-		QListIterator<ScText*> it( other );
-		const ScText* elem;
-		while ( it.hasNext() )
-		{
-			elem = it.next();
-			ScText* elem2 = new ScText(*elem);
-			append(elem2);
-			if (elem2->parstyle)
-			{
-				elem2->parstyle->setContext( & pstyleContext );
-//					qDebug() << QString("StoryText::copy: * %1 align=%2").arg(elem2->parstyle->parent())
-//						   .arg(elem2->parstyle->alignment())
-//						   .arg((uint)elem2->parstyle->context()));
-				replaceCharStyleContextInParagraph(count()-1, elem2->parstyle->charStyleContext());
-			}
-		}
-		len = count();
+		copyFrom(other);
 		cursorPosition = other.cursorPosition;
 		selFirst = other.selFirst;
 		selLast = other.selLast;
@@ -107,65 +88,359 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 		pstyleContext.invalidate();
 //			qDebug() << QString("StoryText::copy: %1 align=%2 %3").arg(trailingStyle.parentStyle()->name())
 //				   .arg(trailingStyle.alignment()).arg((uint)trailingStyle.context());
-		replaceCharStyleContextInParagraph(len,  trailingStyle.charStyleContext());
 	}
 //			qDebug() << QString("ScText_Shared: %1 = %2").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&other));
 	return *this;
 }
 
-ScText_Shared::~ScText_Shared() 
+ScText_Shared::~ScText_Shared()
 {
 //		qDebug() << QString("~ScText_Shared() %1").arg(reinterpret_cast<uint>(this));
-	while (!this->isEmpty())
-		delete this->takeFirst(); 
+	for (const Special& sp : std::as_const(m_specials))
+		delete sp.parstyle;
+}
+
+void ScText_Shared::copyFrom(const ScText_Shared& other)
+{
+	// Styles are immutable and can be shared until the contexts are replaced below
+	m_text = other.m_text;
+	m_runs = other.m_runs;
+	m_checkedStylesVersion = -1;
+	m_specials.reserve(other.m_specials.count());
+	for (const Special& otherSp : other.m_specials)
+	{
+		Special sp;
+		sp.pos = otherSp.pos;
+		sp.embedded = otherSp.embedded;
+		if (otherSp.mark && !otherSp.mark->isUnique())
+			sp.mark = otherSp.mark;
+		if (otherSp.parstyle)
+		{
+			sp.parstyle = new ParagraphStyle(*otherSp.parstyle);
+			sp.parstyle->setContext( & pstyleContext);
+		}
+		m_specials.append(sp);
+	}
+	len = count();
+	for (const Special& sp : std::as_const(m_specials))
+	{
+		if (sp.parstyle)
+			replaceCharStyleContextInParagraph(sp.pos, sp.parstyle->charStyleContext());
+	}
+	replaceCharStyleContextInParagraph(len,  trailingStyle.charStyleContext() );
+}
+
+void ScText_Shared::insert(int pos, const QString& txt, const CharStyle& style)
+{
+	assert(pos >= 0);
+	assert(pos <= count());
+	if (txt.isEmpty())
+		return;
+
+	int n = txt.length();
+	int first = splitRun(pos);
+	for (int i = first; i < m_runs.count(); ++i)
+		m_runs[i].end += n;
+	StyleRun run;
+	run.end = pos + n;
+	run.style = shareStyle(style, first);
+	m_runs.insert(first, run);
+
+	for (int i = specialIndex(pos); i < m_specials.count(); ++i)
+		m_specials[i].pos += n;
+
+	m_text.insert(pos, txt);
+	mergeRuns(first - 1, first + 1);
+}
+
+void ScText_Shared::remove(int pos, int len)
+{
+	assert(pos >= 0);
+	assert(pos + len <= count());
+	if (len <= 0)
+		return;
+
+	int first = splitRun(pos);
+	int last = splitRun(pos + len);
+	m_runs.remove(first, last - first);
+	for (int i = first; i < m_runs.count(); ++i)
+		m_runs[i].end -= len;
+
+	int firstSpecial = specialIndex(pos);
+	int lastSpecial = specialIndex(pos + len);
+	for (int i = firstSpecial; i < lastSpecial; ++i)
+		delete m_specials.at(i).parstyle;
+	m_specials.remove(firstSpecial, lastSpecial - firstSpecial);
+	for (int i = firstSpecial; i < m_specials.count(); ++i)
+		m_specials[i].pos -= len;
+
+	m_text.remove(pos, len);
+	mergeRuns(first - 1, first);
+}
+
+const CharStyle& ScText_Shared::charStyle(int pos) const
+{
+	assert(pos >= 0);
+	assert(pos < count());
+	return *m_runs.at(runIndex(pos)).style;
+}
+
+void ScText_Shared::modifyCharStyles(int pos, int len, const std::function<void(CharStyle&)>& modify)
+{
+	assert(pos >= 0);
+	assert(pos + len <= count());
+	if (len <= 0)
+		return;
+
+	int first = splitRun(pos);
+	int last = splitRun(pos + len);
+	for (int i = first; i < last; ++i)
+	{
+		const CharStyle& oldStyle = *m_runs.at(i).style;
+		CharStyle newStyle(oldStyle);
+		modify(newStyle);
+		if (!sameStyle(newStyle, oldStyle))
+			m_runs[i].style = shareStyle(newStyle, i);
+	}
+	mergeRuns(first - 1, last);
+}
+
+ParagraphStyle* ScText_Shared::paragraphStyle(int pos) const
+{
+	const Special* sp = special(pos);
+	return sp ? sp->parstyle : nullptr;
+}
+
+void ScText_Shared::setParagraphStyle(int pos, ParagraphStyle* style)
+{
+	if (style)
+	{
+		Special& sp = ensureSpecial(pos);
+		if (sp.parstyle != style)
+			delete sp.parstyle;
+		sp.parstyle = style;
+		return;
+	}
+	int i = specialIndex(pos);
+	if ((i < m_specials.count()) && (m_specials.at(i).pos == pos))
+	{
+		delete m_specials.at(i).parstyle;
+		m_specials[i].parstyle = nullptr;
+		dropSpecialIfEmpty(pos);
+	}
+}
+
+int ScText_Shared::embedded(int pos) const
+{
+	const Special* sp = special(pos);
+	return sp ? sp->embedded : 0;
+}
+
+void ScText_Shared::setEmbedded(int pos, int embedded)
+{
+	ensureSpecial(pos).embedded = embedded;
+	dropSpecialIfEmpty(pos);
+}
+
+Mark* ScText_Shared::mark(int pos) const
+{
+	const Special* sp = special(pos);
+	return sp ? sp->mark : nullptr;
+}
+
+void ScText_Shared::setMark(int pos, Mark* mark)
+{
+	ensureSpecial(pos).mark = mark;
+	dropSpecialIfEmpty(pos);
+}
+
+void ScText_Shared::invalidateParagraphContexts(int from, int to)
+{
+	for (int i = specialIndex(from); i < m_specials.count() && m_specials.at(i).pos < to; ++i)
+	{
+		ParagraphStyle* par = m_specials.at(i).parstyle;
+		if (par)
+			par->charStyleContext()->invalidate();
+	}
+}
+
+bool ScText_Shared::revalidateStyles(qint64 stylesVersion, int& first, int& last)
+{
+	if (stylesVersion != m_checkedStylesVersion)
+	{
+		m_checkedStylesVersion = stylesVersion;
+
+		// Revisions are taken first as styles are shared between runs
+		QVector<quint64> parRevisions;
+		parRevisions.reserve(m_specials.count() + 1);
+		for (const Special& sp : std::as_const(m_specials))
+			parRevisions.append(sp.parstyle ? qMax(sp.parstyle->revision(), sp.parstyle->charStyle().revision()) : 0);
+		parRevisions.append(qMax(trailingStyle.revision(), trailingStyle.charStyle().revision()));
+		QVector<quint64> runRevisions;
+		runRevisions.reserve(m_runs.count());
+		for (const StyleRun& run : std::as_const(m_runs))
+			runRevisions.append(run.style->revision());
+
+		pstyleContext.invalidate();
+		invalidateParagraphContexts(0, count());
+		trailingStyle.charStyleContext()->invalidate();
+
+		int changedFirst = count() + 1;
+		int changedLast = -1;
+		auto addChanged = [&changedFirst, &changedLast](int from, int to) {
+			changedFirst = qMin(changedFirst, from);
+			changedLast = qMax(changedLast, to);
+		};
+		for (int i = 0; i < m_specials.count(); ++i)
+		{
+			const ParagraphStyle* par = m_specials.at(i).parstyle;
+			if (!par)
+				continue;
+			par->validate();
+			if (qMax(par->revision(), par->charStyle().revision()) != parRevisions.at(i))
+			{
+				int pos = m_specials.at(i).pos;
+				addChanged((pos > 0) ? m_text.lastIndexOf(SpecialChars::PARSEP, pos - 1) + 1 : 0, pos + 1);
+			}
+		}
+		trailingStyle.validate();
+		if (qMax(trailingStyle.revision(), trailingStyle.charStyle().revision()) != parRevisions.last())
+			addChanged(m_text.lastIndexOf(SpecialChars::PARSEP) + 1, count());
+		for (int i = 0; i < m_runs.count(); ++i)
+		{
+			m_runs.at(i).style->validate();
+			if (m_runs.at(i).style->revision() != runRevisions.at(i))
+				addChanged(startOfRun(i), endOfRun(i));
+		}
+
+		m_changedStyles = (changedLast >= 0);
+		m_changedFirst = m_changedStyles ? changedFirst : 0;
+		m_changedLast = m_changedStyles ? changedLast : 0;
+	}
+	first = m_changedFirst;
+	last = m_changedLast;
+	return m_changedStyles;
 }
 
 /**
-	A char's stylecontext is the containing paragraph's style, 
+	A char's stylecontext is the containing paragraph's style,
 	This routines makes sure that all charstyles look for defaults
 	in the parstyle first.
 	*/
 void ScText_Shared::replaceCharStyleContextInParagraph(int pos, const StyleContext* newContext)
 {
 	assert (pos >= 0);
-	assert (pos <= size());
-	
-	if (pos < size())
-		value(pos)->setContext(newContext);
-	for (int i = pos - 1; i >= 0; --i)
+	assert (pos <= count());
+
+	int start = (pos > 0) ? m_text.lastIndexOf(SpecialChars::PARSEP, pos - 1) + 1 : 0;
+	int end = qMin(pos + 1, count());
+	if (start >= end)
+		return;
+
+	// Only copy the styles which do not have the new context yet
+	int first = runIndex(start);
+	int last = runIndex(end - 1);
+	bool needed = false;
+	for (int i = first; i <= last && !needed; ++i)
+		needed = (m_runs.at(i).style->context() != newContext);
+	if (!needed)
+		return;
+
+	modifyCharStyles(start, end - start, [newContext](CharStyle& style) {
+		style.setContext(newContext);
+	});
+}
+
+int ScText_Shared::runIndex(int pos) const
+{
+	auto it = std::upper_bound(m_runs.cbegin(), m_runs.cend(), pos,
+							   [](int p, const StyleRun& run) { return p < run.end; });
+	return static_cast<int>(it - m_runs.cbegin());
+}
+
+int ScText_Shared::splitRun(int pos)
+{
+	if (pos >= count())
+		return m_runs.count();
+	int i = runIndex(pos);
+	if (startOfRun(i) == pos)
+		return i;
+	StyleRun head;
+	head.end = pos;
+	head.style = m_runs.at(i).style;
+	m_runs.insert(i, head);
+	return i + 1;
+}
+
+void ScText_Shared::mergeRuns(int first, int last)
+{
+	first = qMax(first, 0);
+	last = qMin(last, static_cast<int>(m_runs.count()) - 1);
+	for (int i = last; i > first; --i)
 	{
-		if (at(i)->ch == SpecialChars::PARSEP)
-			break;
-		value(i)->setContext(newContext);
+		const SharedCharStyle& style = m_runs.at(i).style;
+		const SharedCharStyle& prevStyle = m_runs.at(i - 1).style;
+		if ((style == prevStyle) || sameStyle(*style, *prevStyle))
+			m_runs.remove(i - 1);
 	}
-#ifndef NDEBUG // skip assertions if we aren't debugging
-	// Sanity check: verify that characters in the affected paragraph all
-	// point to the expected context. Only walk the affected paragraph
-	// rather than the whole story — the latter is O(n) per call, leading
-	// to O(n²) behaviour on large documents during load.
-	for (int i = pos - 1; i >= 0; --i)
+}
+
+ScText_Shared::SharedCharStyle ScText_Shared::shareStyle(const CharStyle& style, int nearRun) const
+{
+	int from = qMax(0, nearRun - styleSharingDistance);
+	int to = qMin(static_cast<int>(m_runs.count()), nearRun + styleSharingDistance);
+	for (int i = from; i < to; ++i)
 	{
-		ScText* elem = at(i);
-		assert(elem);
-		if (elem->ch == SpecialChars::PARSEP)
-			break;
-		if (elem->ch.isNull())
-			continue; // see code in removeParSep
-		assert(elem->context() == newContext);
+		if (sameStyle(style, *m_runs.at(i).style))
+			return m_runs.at(i).style;
 	}
-	if (pos < size())
+	return SharedCharStyle(new CharStyle(style));
+}
+
+bool ScText_Shared::sameStyle(const CharStyle& a, const CharStyle& b)
+{
+	if (&a == &b)
+		return true;
+	// equiv() ignores the layout flags which are kept in the effects
+	return (a.context() == b.context())
+		&& (a.effects().value == b.effects().value)
+		&& (a.name() == b.name())
+		&& a.equiv(b);
+}
+
+int ScText_Shared::specialIndex(int pos) const
+{
+	auto it = std::lower_bound(m_specials.cbegin(), m_specials.cend(), pos,
+							   [](const Special& sp, int p) { return sp.pos < p; });
+	return static_cast<int>(it - m_specials.cbegin());
+}
+
+const ScText_Shared::Special* ScText_Shared::special(int pos) const
+{
+	int i = specialIndex(pos);
+	if ((i < m_specials.count()) && (m_specials.at(i).pos == pos))
+		return &m_specials.at(i);
+	return nullptr;
+}
+
+ScText_Shared::Special& ScText_Shared::ensureSpecial(int pos)
+{
+	int i = specialIndex(pos);
+	if ((i >= m_specials.count()) || (m_specials.at(i).pos != pos))
 	{
-		ScText* elem = at(pos);
-		if (elem->ch == SpecialChars::PARSEP)
-		{
-			assert(elem->parstyle);
-			assert(newContext == elem->parstyle->charStyleContext());
-		}
-		else if (!elem->ch.isNull())
-		{
-			assert(elem->context() == newContext);
-		}
+		Special sp;
+		sp.pos = pos;
+		m_specials.insert(i, sp);
 	}
-#endif
+	return m_specials[i];
 }
 
+void ScText_Shared::dropSpecialIfEmpty(int pos)
+{
+	int i = specialIndex(pos);
+	if ((i >= m_specials.count()) || (m_specials.at(i).pos != pos))
+		return;
+	const Special& sp = m_specials.at(i);
+	if (!sp.parstyle && (sp.embedded == 0) && !sp.mark)
+		m_specials.remove(i);
+}
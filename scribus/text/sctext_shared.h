@@ -1,9 +1,13 @@
 #ifndef SCTEXT_SHARED_H
 #define SCTEXT_SHARED_H
 
+#include <functional>
+
 #include <QList>
 #include <QObject>
+#include <QSharedPointer>
 #include <QString>
+#include <QVector>
 #include <cassert>
 
 //#include "text/paragraphlayout.h"
@@ -13,11 +17,26 @@
 #include "styles/paragraphstyle.h"
 #include "styles/stylecontextproxy.h"
 
+class Mark;
+
+/**
+   Storage of the text of a StoryText.
 
-class SCRIBUS_API ScText_Shared : public QList<ScText*>
+   The characters are kept in one QString. Character styles are kept as runs:
+   consecutive characters with equivalent styles share a single, immutable
+   CharStyle, and styles are never shared across paragraph boundaries as
+   their context is the style of the paragraph they belong to. Paragraph
+   styles, inline objects and marks are rare and are kept in a sorted list
+   indexed by position.
+
+   Modifying the style of some characters splits the runs at the ends of the
+   modified range, gives the affected runs new styles and merges runs which
+   end up equivalent to their neighbours again.
+ */
+class SCRIBUS_API ScText_Shared
 {
 public:
-	ScText_Shared(const StyleContext* pstyles);	
+	ScText_Shared(const StyleContext* pstyles);
 	ScText_Shared(const ScText_Shared& other);
 	~ScText_Shared();
 
@@ -35,14 +54,90 @@ public:
 	ParagraphStyle trailingStyle;
 	CharStyle orphanedCharStyle;
 
+	int count() const { return m_text.length(); }
+	bool isEmpty() const { return m_text.isEmpty(); }
+	const QString& text() const { return m_text; }
+	QChar charAt(int pos) const { return m_text.at(pos); }
+	void setCharAt(int pos, QChar ch) { m_text[pos] = ch; }
+
+	/// Inserts \a txt at \a pos, the new characters get \a style including its context
+	void insert(int pos, const QString& txt, const CharStyle& style);
+	/// Removes \a len characters at \a pos together with their paragraph styles
+	void remove(int pos, int len);
 	void clear();
-	
+
+	const CharStyle& charStyle(int pos) const;
+	/// Calls \a modify on a copy of the style of each run in \a pos, \a len and stores the results
+	void modifyCharStyles(int pos, int len, const std::function<void(CharStyle&)>& modify);
+
+	/// Number of style runs, runs never span more than one paragraph
+	int runCount() const { return m_runs.count(); }
+	int startOfRun(int index) const { return (index > 0) ? m_runs.at(index - 1).end : 0; }
+	int endOfRun(int index) const { return m_runs.at(index).end; }
+
+	/// Paragraph style of the PARSEP at \a pos, or nullptr
+	ParagraphStyle* paragraphStyle(int pos) const;
+	/// Sets the paragraph style at \a pos, taking ownership of \a style and deleting the previous one
+	void setParagraphStyle(int pos, ParagraphStyle* style);
+	int embedded(int pos) const;
+	void setEmbedded(int pos, int embedded);
+	Mark* mark(int pos) const;
+	void setMark(int pos, Mark* mark);
+	/// Invalidates the character style contexts of the paragraph styles in \a from, \a to
+	void invalidateParagraphContexts(int from, int to);
+	/**
+	   Validates all paragraph and character styles after the document's
+	   styles changed. Returns false if none of them changed, otherwise the
+	   changed characters are between \a first and \a last. The result is
+	   kept for \a stylesVersion so that all StoryTexts sharing this text
+	   get it.
+	 */
+	bool revalidateStyles(qint64 stylesVersion, int& first, int& last);
+
 	/**
-	   A char's stylecontext is the containing paragraph's style, 
+	   A char's stylecontext is the containing paragraph's style,
        This routines makes sure that all charstyles look for defaults
 	   in the parstyle first.
 	 */
 	void replaceCharStyleContextInParagraph(int pos, const StyleContext* newContext);
+
+private:
+	using SharedCharStyle = QSharedPointer<const CharStyle>;
+
+	struct StyleRun
+	{
+		int end { 0 };
+		SharedCharStyle style;
+	};
+
+	/// Data of PARSEP and OBJECT characters
+	struct Special
+	{
+		int pos { 0 };
+		ParagraphStyle* parstyle { nullptr };
+		int embedded { 0 };
+		Mark* mark { nullptr };
+	};
+
+	void copyFrom(const ScText_Shared& other);
+	int runIndex(int pos) const;
+	int splitRun(int pos);
+	void mergeRuns(int first, int last);
+	SharedCharStyle shareStyle(const CharStyle& style, int nearRun) const;
+	static bool sameStyle(const CharStyle& a, const CharStyle& b);
+	int specialIndex(int pos) const;
+	const Special* special(int pos) const;
+	Special& ensureSpecial(int pos);
+	void dropSpecialIfEmpty(int pos);
+
+	QString m_text;
+	QVector<StyleRun> m_runs; // ordered, the last run ends at m_text.length()
+	QVector<Special> m_specials; // ordered by position
+
+	qint64 m_checkedStylesVersion { -1 };
+	bool m_changedStyles { false };
+	int m_changedFirst { 0 };
+	int m_changedLast { 0 };
 };
 
 #endif /*SCTEXT_SHARED_H*/
@@ -0,0 +1,224 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "shapedruncache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+
+#include "fonts/scface.h"
+
+namespace
+{
+	const quint32 cacheMagic = 0x53435352; // "SCSR"
+	const quint32 cacheVersion = 1;
+	// HarfBuzz looks at up to 5 characters around a run (HB_BUFFER_CONTEXT_LENGTH)
+	const int contextLength = 5;
+}
+
+ShapedRunCache& ShapedRunCache::instance()
+{
+	static ShapedRunCache cache;
+	return cache;
+}
+
+ShapedRunCache::ShapedRunCache()
+{
+	m_cache.setMaxCost(1000000);
+}
+
+QByteArray ShapedRunCache::fontIdentity(const ScFace& face)
+{
+	QString fontPath = face.fontPath();
+	auto it = m_fontIdentities.constFind(fontPath);
+	if (it != m_fontIdentities.constEnd())
+		return it.value();
+
+	// Include size and date of the font file so that persisted entries
+	// are not used with an updated font
+	QFileInfo fi(face.fontFilePath());
+	QByteArray identity = fontPath.toUtf8();
+	identity += '|' + QByteArray::number(fi.size());
+	identity += '|' + QByteArray::number(fi.lastModified().toSecsSinceEpoch());
+	m_fontIdentities.insert(fontPath, identity);
+	return identity;
+}
+
+QByteArray ShapedRunCache::makeKey(const QString& text, int start, int len, const ScFace& face, int fontSize,
+                                   int direction, int script, const QString& language, const QByteArray& features)
+{
+	int preStart = qMax(0, start - contextLength);
+	int postLen = qMin(contextLength, static_cast<int>(text.length()) - (start + len));
+
+	QByteArray key;
+	QDataStream ks(&key, QIODevice::WriteOnly);
+	{
+		QMutexLocker locker(&m_mutex);
+		ks << fontIdentity(face);
+	}
+	ks << fontSize << direction << script << language << features;
+	ks << QStringView(text).mid(preStart, start - preStart).toString();
+	ks << QStringView(text).mid(start, len).toString();
+	ks << QStringView(text).mid(start + len, qMax(0, postLen)).toString();
+	return key;
+}
+
+bool ShapedRunCache::contains(const QByteArray& key) const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_cache.contains(key);
+}
+
+bool ShapedRunCache::find(const QByteArray& key, QVector<Glyph>& glyphs)
+{
+	QMutexLocker locker(&m_mutex);
+	const QVector<Glyph>* cached = m_cache.object(key);
+	if (cached == nullptr)
+		return false;
+	glyphs = *cached;
+	return true;
+}
+
+void ShapedRunCache::insert(const QByteArray& key, const QVector<Glyph>& glyphs)
+{
+	QMutexLocker locker(&m_mutex);
+	m_cache.insert(key, new QVector<Glyph>(glyphs), qMax(1, static_cast<int>(glyphs.count())));
+}
+
+void ShapedRunCache::clear()
+{
+	QMutexLocker locker(&m_mutex);
+	m_cache.clear();
+	m_fontIdentities.clear();
+}
+
+int ShapedRunCache::maxGlyphs() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_cache.maxCost();
+}
+
+void ShapedRunCache::setMaxGlyphs(int maxGlyphs)
+{
+	QMutexLocker locker(&m_mutex);
+	m_cache.setMaxCost(maxGlyphs);
+}
+
+QString ShapedRunCache::cacheFileName(const QString& docFileName)
+{
+	return docFileName + ".shaping";
+}
+
+int ShapedRunCache::runLength(const QByteArray& key)
+{
+	QDataStream ks(key);
+	QByteArray identity;
+	int fontSize = 0;
+	int direction = 0;
+	int script = 0;
+	QString language;
+	QByteArray features;
+	QString preContext;
+	QString runText;
+	ks >> identity >> fontSize >> direction >> script >> language >> features >> preContext >> runText;
+	if (ks.status() != QDataStream::Ok)
+		return -1;
+	return runText.length();
+}
+
+bool ShapedRunCache::save(const QString& fileName, const QList<QByteArray>& keys)
+{
+	QSaveFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	ds << cacheMagic << cacheVersion;
+
+	QMutexLocker locker(&m_mutex);
+	// Stories often repeat runs, each one is only written once
+	QList<QByteArray> savedKeys;
+	QSet<QByteArray> seen;
+	for (const QByteArray& key : keys)
+	{
+		if (m_cache.contains(key) && !seen.contains(key))
+		{
+			seen.insert(key);
+			savedKeys.append(key);
+		}
+	}
+	ds << static_cast<qint32>(savedKeys.count());
+	for (const QByteArray& key : std::as_const(savedKeys))
+	{
+		const QVector<Glyph>* glyphs = m_cache.object(key);
+		ds << key << static_cast<qint32>(glyphs->count());
+		for (const Glyph& glyph : *glyphs)
+			ds << glyph.codepoint << glyph.cluster << glyph.xOffset << glyph.yOffset << glyph.xAdvance << glyph.yAdvance;
+	}
+	locker.unlock();
+
+	if (ds.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
+
+bool ShapedRunCache::load(const QString& fileName)
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	quint32 magic = 0;
+	quint32 version = 0;
+	qint32 count = 0;
+	ds >> magic >> version >> count;
+	if ((magic != cacheMagic) || (version != cacheVersion) || (count < 0))
+		return false;
+
+	// Codepoint, cluster, offsets and advances
+	const qint64 glyphSize = sizeof(quint32) + 5 * sizeof(qint32);
+	QList<QPair<QByteArray, QVector<Glyph> > > runs;
+	for (qint32 i = 0; i < count; ++i)
+	{
+		QByteArray key;
+		qint32 glyphCount = 0;
+		ds >> key >> glyphCount;
+		if (ds.status() != QDataStream::Ok)
+			return false;
+		int runLen = runLength(key);
+		if ((runLen < 0) || (glyphCount < 0) || (glyphCount > (file.size() - file.pos()) / glyphSize))
+			return false;
+		QVector<Glyph> glyphs(glyphCount);
+		for (Glyph& glyph : glyphs)
+		{
+			ds >> glyph.codepoint >> glyph.cluster >> glyph.xOffset >> glyph.yOffset >> glyph.xAdvance >> glyph.yAdvance;
+			// Clusters are used as indexes into the run by TextShaper
+			if ((glyph.cluster < 0) || (glyph.cluster >= runLen))
+				return false;
+		}
+		if (ds.status() != QDataStream::Ok)
+			return false;
+		runs.append(qMakePair(key, glyphs));
+	}
+	if (!ds.atEnd())
+		return false;
+
+	for (const auto& run : std::as_const(runs))
+		insert(run.first, run.second);
+	return true;
+}
@@ -0,0 +1,89 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#ifndef SHAPEDRUNCACHE_H
+#define SHAPEDRUNCACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include "scribusapi.h"
+
+class ScFace;
+
+/**
+ * Process-wide cache of HarfBuzz shaping results.
+ *
+ * TextShaper shapes text in runs of uniform font, size, features, language,
+ * script and direction. The glyphs and positions HarfBuzz returns for such a
+ * run depend only on these properties and on the UTF-16 text of the run and
+ * its immediate context, so they are cached here under a content key and
+ * shared between all frames and documents. The cache is bounded by the total
+ * number of cached glyphs and evicts least recently used runs.
+ *
+ * The runs of a document can be written to and read from a file, which is used
+ * to keep them next to the document when MiscellaneousPrefs::persistShapingCache
+ * is set.
+ */
+class SCRIBUS_API ShapedRunCache
+{
+public:
+	/// Glyph as returned by HarfBuzz, cluster is relative to the start of the run
+	struct Glyph
+	{
+		uint codepoint { 0 };
+		int cluster { 0 };
+		int xOffset { 0 };
+		int yOffset { 0 };
+		int xAdvance { 0 };
+		int yAdvance { 0 };
+	};
+
+	static ShapedRunCache& instance();
+
+	/**
+	 * Builds the lookup key for run \a start, \a len of \a text.
+	 * \a features holds the HarfBuzz feature strings with their start and end
+	 * relative to the run start.
+	 */
+	QByteArray makeKey(const QString& text, int start, int len, const ScFace& face, int fontSize,
+	                   int direction, int script, const QString& language, const QByteArray& features);
+
+	bool contains(const QByteArray& key) const;
+	bool find(const QByteArray& key, QVector<Glyph>& glyphs);
+	void insert(const QByteArray& key, const QVector<Glyph>& glyphs);
+	void clear();
+
+	int maxGlyphs() const;
+	void setMaxGlyphs(int maxGlyphs);
+
+	/// Writes the cached runs among \a keys to \a fileName
+	bool save(const QString& fileName, const QList<QByteArray>& keys);
+	/// Adds the runs from \a fileName, the file is ignored entirely if it is inconsistent
+	bool load(const QString& fileName);
+
+	/// Returns the file name used to persist the cache next to document \a docFileName
+	static QString cacheFileName(const QString& docFileName);
+
+private:
+	ShapedRunCache();
+
+	QByteArray fontIdentity(const ScFace& face);
+	/// Returns the length of the run text in \a key, -1 if \a key is malformed
+	static int runLength(const QByteArray& key);
+
+	mutable QMutex m_mutex;
+	QCache<QByteArray, QVector<Glyph> > m_cache;
+	QHash<QString, QByteArray> m_fontIdentities;
+};
+
+#endif // SHAPEDRUNCACHE_H
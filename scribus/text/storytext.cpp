@@ -49,8 +49,8 @@ StoryText::StoryText(ScribusDoc * doc_) : m_doc(doc_)
 	if (doc_)
 	{
 		d = new ScText_Shared(&doc_->paragraphStyles());
-		m_doc->paragraphStyles().connect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().connect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().connect(this, SLOT(invalidateChangedStyles()));
+		m_doc->charStyles().connect(this, SLOT(invalidateChangedStyles()));
 	}
 	else
 		d = new ScText_Shared(nullptr);
@@ -80,8 +80,8 @@ StoryText::StoryText(const StoryText & other) : m_doc(other.m_doc)
 	
 	if (m_doc)
 	{
-		m_doc->paragraphStyles().connect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().connect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().connect(this, SLOT(invalidateChangedStyles()));
+		m_doc->charStyles().connect(this, SLOT(invalidateChangedStyles()));
 	}
 	
 	d->selFirst = 0;
@@ -98,8 +98,8 @@ StoryText::~StoryText()
 	documents */
 /*	if (doc)
 	{
-		doc->paragraphStyles().disconnect(this, SLOT(invalidateAll()));
-		doc->charStyles().disconnect(this, SLOT(invalidateAll()));
+		doc->paragraphStyles().disconnect(this, SLOT(invalidateChangedStyles()));
+		doc->charStyles().disconnect(this, SLOT(invalidateChangedStyles()));
 	} */
 	d->refs--;
 	if (d->refs == 0)
@@ -118,7 +118,7 @@ bool StoryText::hasBulletOrNum() const
 	bool lastWasPARSEP = true;
 	for (int i = 0; i < length(); ++i)
 	{
-		lastWasPARSEP = (d->at(i)->ch == SpecialChars::PARSEP);
+		lastWasPARSEP = (d->charAt(i) == SpecialChars::PARSEP);
 		if (!lastWasPARSEP)
 			continue;
 		const ParagraphStyle& paraStyle = paragraphStyle(i);
@@ -153,16 +153,16 @@ void StoryText::setDoc(ScribusDoc *docin)
 {
 	if (m_doc)
 	{
-		m_doc->paragraphStyles().disconnect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().disconnect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().disconnect(this, SLOT(invalidateChangedStyles()));
+		m_doc->charStyles().disconnect(this, SLOT(invalidateChangedStyles()));
 	}
 
 	m_doc = docin;
 
 	if (m_doc)
 	{
-		m_doc->paragraphStyles().connect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().connect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().connect(this, SLOT(invalidateChangedStyles()));
+		m_doc->charStyles().connect(this, SLOT(invalidateChangedStyles()));
 	}
 }
 
@@ -186,8 +186,8 @@ StoryText& StoryText::operator= (const StoryText & other)
 	
 	if (m_doc)
 	{
-		m_doc->paragraphStyles().disconnect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().disconnect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().disconnect(this, SLOT(invalidateChangedStyles()));
+		m_doc->charStyles().disconnect(this, SLOT(invalidateChangedStyles()));
 	}
 	
 	m_doc = other.m_doc; 
@@ -195,8 +195,8 @@ StoryText& StoryText::operator= (const StoryText & other)
 	
 	if (m_doc)
 	{
-		m_doc->paragraphStyles().connect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().connect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().connect(this, SLOT(invalidateChangedStyles()));
+		m_doc->charStyles().connect(this, SLOT(invalidateChangedStyles()));
 	}
 	
 	d->selFirst = 0;
@@ -393,20 +393,14 @@ int StoryText::indexOf(QChar ch, int from, Qt::CaseSensitivity cs) const
 
 	if (cs == Qt::CaseSensitive)
 	{
-		for (int i = from; i < textLength; ++i)
-		{
-			if (d->at(i)->ch == ch)
-			{
-				foundIndex = i;
-				break;
-			}
-		}
+		if (from < textLength)
+			foundIndex = d->text().indexOf(ch, from);
 	}
 	else
 	{
 		for (int i = from; i < textLength; ++i)
 		{
-			if (d->at(i)->ch.toLower() == ch)
+			if (d->charAt(i).toLower() == ch)
 			{
 				foundIndex = i;
 				break;
@@ -448,13 +442,13 @@ int StoryText::lastIndexOf(QChar ch, int from, Qt::CaseSensitivity cs) const
 	if (cs == Qt::CaseSensitive)
 	{
 		for (int i = start; i >= 0; --i)
-			if (d->at(i)->ch == ch)
+			if (d->charAt(i) == ch)
 				return i;
 	}
 	else
 	{
 		for (int i = start; i >= 0; --i)
-			if (d->at(i)->ch.toLower() == ch)
+			if (d->charAt(i).toLower() == ch)
 				return i;
 	}
 	return -1;
@@ -508,9 +502,9 @@ void StoryText::insert(int pos, const StoryText& other, bool onlySelection)
 		else if (other.text(i) == SpecialChars::OBJECT)
 		{
 			insertChars(pos, SpecialChars::OBJECT);
-			item(pos)->embedded = other.item(i)->embedded;
-			item(pos)->mark = other.item(i)->mark;
-			if (item(pos)->mark)
+			d->setEmbedded(pos, other.d->embedded(i));
+			d->setMark(pos, other.d->mark(i));
+			if (d->mark(pos))
 			{
 				d->marksCount++;
 				d->marksCountChanged = true;
@@ -551,15 +545,10 @@ void StoryText::insert(int pos, const StoryText& other, bool onlySelection)
  */
 void StoryText::removeParSep(int pos)
 {
-	ScText* it = item(pos);
-	if (it->parstyle)
-	{
-		delete it->parstyle;
-		it->parstyle = nullptr;
-	}
-	// demote this parsep so the assert code in replaceCharStyleContextInParagraph()
-	// doesn't choke:
-	it->ch = QChar();
+	d->setParagraphStyle(pos, nullptr);
+	// demote this parsep so that replaceCharStyleContextInParagraph()
+	// treats it as part of the following paragraph:
+	d->setCharAt(pos, QChar());
 	d->replaceCharStyleContextInParagraph(pos, paragraphStyle(pos+1).charStyleContext());
 }
 
@@ -568,11 +557,12 @@ void StoryText::removeParSep(int pos)
  */
 void StoryText::insertParSep(int pos)
 {
-	ScText* it = item(pos);
-	if (!it->parstyle)
+	ParagraphStyle* parstyle = d->paragraphStyle(pos);
+	if (!parstyle)
 	{
-		it->parstyle = new ParagraphStyle(paragraphStyle(pos+1));
-		it->parstyle->setContext( & d->pstyleContext);
+		parstyle = new ParagraphStyle(paragraphStyle(pos+1));
+		parstyle->setContext( & d->pstyleContext);
+		d->setParagraphStyle(pos, parstyle);
 		// #7432 : when inserting a paragraph separator, apply/erase the trailing Style
 		if (pos >= signed(d->len - 1))
 		{
@@ -580,7 +570,7 @@ void StoryText::insertParSep(int pos)
 			d->trailingStyle.erase();
 		}
 	}
-	d->replaceCharStyleContextInParagraph(pos, it->parstyle->charStyleContext());
+	d->replaceCharStyleContextInParagraph(pos, parstyle->charStyleContext());
 }
 
 // Returns the matched story length (including skipped diacritics), or -1.
@@ -596,7 +586,7 @@ int StoryText::matchAt(int pos, const QString& qStr, Qt::CaseSensitivity cs, int
 		int index = 0;
 		while ((index < strLen) && ((index + pos) < storyLen))
 		{
-			if (qStr.at(index) != d->at(index + pos)->ch)
+			if (qStr.at(index) != d->charAt(index + pos))
 				break;
 			++index;
 		}
@@ -612,7 +602,7 @@ int StoryText::matchAt(int pos, const QString& qStr, Qt::CaseSensitivity cs, int
 	while ((index < strLen) && ((index + pos + diacriticsCounter) < storyLen))
 	{
 		const QChar& qChar   = qStr.at(index);
-		const QChar& curChar = d->at(index + diacriticsCounter + pos)->ch;
+		const QChar& curChar = d->charAt(index + diacriticsCounter + pos);
 		const bool qCharIsDiacritic   = SpecialChars::isArabicModifierLetter(qChar.unicode())   || (qChar.category()   == QChar::Mark_NonSpacing);
 		const bool curCharIsDiacritic = SpecialChars::isArabicModifierLetter(curChar.unicode()) || (curChar.category() == QChar::Mark_NonSpacing);
 		if (qCharIsDiacritic || curCharIsDiacritic)
@@ -636,7 +626,7 @@ int StoryText::matchAt(int pos, const QString& qStr, Qt::CaseSensitivity cs, int
 	// consume trailing diacritics so the reported length matches indexOf()
 	while ((index + pos + diacriticsCounter) < storyLen)
 	{
-		const QChar& curChar = d->at(index + diacriticsCounter + pos)->ch;
+		const QChar& curChar = d->charAt(index + diacriticsCounter + pos);
 		if (!SpecialChars::isArabicModifierLetter(curChar.unicode()) && (curChar.category() != QChar::Mark_NonSpacing))
 			break;
 		++diacriticsCounter;
@@ -671,14 +661,11 @@ void StoryText::removeChars(int pos, uint len)
 	}
 	for (int i = pos + static_cast<int>(len) - 1; i >= pos; --i)
 	{
-		ScText *it = d->at(i);
-		if (it->ch == SpecialChars::PARSEP)
+		QChar ch = d->charAt(i);
+		if (ch == SpecialChars::PARSEP)
 			removeParSep(i);
-		if ((it->ch == SpecialChars::OBJECT) && (it->mark != nullptr))
+		if ((ch == SpecialChars::OBJECT) && (d->mark(i) != nullptr))
 			d->marksCount--;
-		d->takeAt(i);
-		d->len--;
-		delete it;
 		// #9592 : adjust d->selFirst and d->selLast, those values have to be
 		// consistent in functions such as select()
 		if (i <= d->selLast)
@@ -689,6 +676,8 @@ void StoryText::removeChars(int pos, uint len)
 			d->cursorPosition--;
 	}
 
+	d->remove(pos, len);
+
 	if (oldMarksCount != d->marksCount)
 		d->marksCountChanged = true;
 
@@ -710,8 +699,8 @@ void StoryText::trim()
 	int pos = length() - 1;
 	for (int i = length() - 1; i >= 0; --i)
 	{
-		const ScText *it = d->at(i);
-		if ((it->ch == SpecialChars::PARSEP) || (it->ch.isSpace()))
+		QChar ch = d->charAt(i);
+		if ((ch == SpecialChars::PARSEP) || (ch.isSpace()))
 		{
 			pos--;
 			posCount++;
@@ -744,30 +733,33 @@ void StoryText::insertChars(int pos, const QString& txt, bool applyNeighbourStyl
 	if (txt.isEmpty())
 		return;
 	
-	const StyleContext* cStyleContext = paragraphStyle(pos).charStyleContext();
-
-	ScText clone;
+	CharStyle clone;
 	if (applyNeighbourStyle)
 	{
 		int referenceChar = qMax(0, qMin(pos - 1, length() - 1));
 		clone.applyCharStyle(charStyle(referenceChar));
 		clone.setEffects(ScStyle_Default);
 	}
+	clone.setContext(paragraphStyle(pos).charStyleContext());
+
+	if (d->cursorPosition >= static_cast<uint>(pos))
+		d->cursorPosition += txt.length();
 
-	for (int i = 0; i < txt.length(); ++i)
+	// Insert up to each paragraph separator at once, so that new paragraphs
+	// take their style from the paragraph following them as before
+	int start = 0;
+	while (start < txt.length())
 	{
-		ScText* item = new ScText(clone);
-		item->ch = txt.at(i);
-		item->setContext(cStyleContext);
-		d->insert(pos + i, item);
-		d->len++;
-		if (item->ch == SpecialChars::PARSEP)
+		int parSep = txt.indexOf(SpecialChars::PARSEP, start);
+		int end = (parSep >= 0) ? parSep + 1 : txt.length();
+		d->insert(pos + start, txt.mid(start, end - start), clone);
+		d->len = d->count();
+		if (parSep >= 0)
 		{
 //			qDebug() << QString("new PARSEP %2 at %1").arg(pos).arg(paragraphStyle(pos).name());
-			insertParSep(pos + i);
+			insertParSep(pos + parSep);
 		}
-		if (d->cursorPosition >= static_cast<uint>(pos + i))
-			d->cursorPosition++;
+		start = end;
 	}
 
 	d->len = d->count();
@@ -787,48 +779,66 @@ void StoryText::insertCharsWithSoftHyphens(int pos, const QString& txt, bool app
 	if (txt.isEmpty())
 		return;
 	
-	const StyleContext* cStyleContext = paragraphStyle(pos).charStyleContext();
-
-	ScText clone;
+	CharStyle clone;
 	if (applyNeighbourStyle)
 	{
 		int referenceChar = qMax(0, qMin(pos - 1, length() - 1));
 		clone.applyCharStyle(charStyle(referenceChar));
 		clone.setEffects(ScStyle_Default);
 	}
+	clone.setContext(paragraphStyle(pos).charStyleContext());
 
+	// Characters are collected and inserted at once up to the next soft hyphen
+	// or paragraph separator, which need the preceding text in place
+	QString pending;
 	int inserted = 0;
+	auto flushPending = [&]()
+	{
+		if (pending.isEmpty())
+			return;
+		int index = pos + inserted;
+		d->insert(index, pending, clone);
+		d->len = d->count();
+		if (d->cursorPosition >= static_cast<uint>(index))
+			d->cursorPosition += pending.length();
+		inserted += pending.length();
+		pending.clear();
+	};
+
 	for (int i = 0; i < txt.length(); ++i) 
 	{
 		QChar ch = txt.at(i);
-		int  index  = pos + inserted;
 		bool insert = true; 
-		if (ch == SpecialChars::SHYPHEN && index > 0)
+		if (ch == SpecialChars::SHYPHEN && (pos + inserted + pending.length()) > 0)
 		{
-			ScText* lastItem = this->item(index - 1);
+			flushPending();
+			int index = pos + inserted;
 			// qreal SHY means user provided SHY, single SHY is automatic one
-			if (lastItem->effects() & ScStyle_HyphenationPossible)
-				lastItem->setEffects(lastItem->effects() & ~ScStyle_HyphenationPossible);
+			if (d->charStyle(index - 1).effects() & ScStyle_HyphenationPossible)
+			{
+				d->modifyCharStyles(index - 1, 1, [](CharStyle& style) {
+					style.setEffects(style.effects() & ~ScStyle_HyphenationPossible);
+				});
+			}
 			else
 			{
-				lastItem->setEffects(lastItem->effects() | ScStyle_HyphenationPossible);
+				d->modifyCharStyles(index - 1, 1, [](CharStyle& style) {
+					style.setEffects(style.effects() | ScStyle_HyphenationPossible);
+				});
 				insert = false;
 			}
 		}
 		if (insert)
 		{
-			ScText * item = new ScText(clone);
-			item->ch = ch;
-			item->setContext(cStyleContext);
-			d->insert(index, item);
-			d->len++;
-			if (item->ch == SpecialChars::PARSEP)
-				insertParSep(index);
-			if (d->cursorPosition >= static_cast<uint>(index))
-				d->cursorPosition++;
-			++inserted;
+			pending += ch;
+			if (ch == SpecialChars::PARSEP)
+			{
+				flushPending();
+				insertParSep(pos + inserted - 1);
+			}
 		}
 	}
+	flushPending();
 
 	d->len = d->count();
 	if ((d->selLast >= d->selFirst) && (d->selFirst <= pos) && (pos <= d->selLast))
@@ -844,18 +854,18 @@ void StoryText::replaceChar(int pos, QChar ch)
 	assert(pos >= 0);
 	assert(pos < length());
 
-	ScText* item = d->at(pos);
-	if (item->ch == ch)
+	QChar oldCh = d->charAt(pos);
+	if (oldCh == ch)
 		return;
 
 	uint oldMarksCount = d->marksCount;
 	
-	if (item->ch == SpecialChars::PARSEP)
+	if (oldCh == SpecialChars::PARSEP)
 		removeParSep(pos);
-	if ((item->ch == SpecialChars::OBJECT) && (item->mark != nullptr))
+	if ((oldCh == SpecialChars::OBJECT) && (d->mark(pos) != nullptr))
 		d->marksCount--;
-	item->ch = ch;
-	if (d->at(pos)->ch == SpecialChars::PARSEP)
+	d->setCharAt(pos, ch);
+	if (d->charAt(pos) == SpecialChars::PARSEP)
 		insertParSep(pos);
 
 	if (oldMarksCount != d->marksCount)
@@ -947,14 +957,18 @@ void StoryText::hyphenateWord(int pos, uint len, const char* hyphens)
 //	QString dump("");
 	for (int i = pos; i < pos + signed(len); ++i)
 	{
-//		dump += d->at(i)->ch;
+//		dump += d->charAt(i);
 		if (hyphens && hyphens[i-pos] & 1)
 		{
-			d->at(i)->setEffects(d->at(i)->effects() | ScStyle_HyphenationPossible);
+			d->modifyCharStyles(i, 1, [](CharStyle& style) {
+				style.setEffects(style.effects() | ScStyle_HyphenationPossible);
+			});
 //			dump += "-";
 		}
 		else {
-			d->at(i)->setEffects(d->at(i)->effects() & ~ScStyle_HyphenationPossible);
+			d->modifyCharStyles(i, 1, [](CharStyle& style) {
+				style.setEffects(style.effects() & ~ScStyle_HyphenationPossible);
+			});
 		}
 	}
 //	qDebug() << QString("st: %1").arg(dump);
@@ -972,7 +986,7 @@ void StoryText::insertObject(int pos, int ob)
 		pos += length()+1;
 
 	insertChars(pos, SpecialChars::OBJECT);
-	this->d->at(pos)->embedded = ob;
+	d->setEmbedded(pos, ob);
 	m_doc->FrameItems[ob]->isEmbedded = true;   // this might not be enough...
 	m_doc->FrameItems[ob]->OwnPage = -1; // #10379: OwnPage is not meaningful for inline object
 }
@@ -985,7 +999,7 @@ void StoryText::insertMark(Mark* mark, int pos)
 		pos = d->cursorPosition;
 
 	insertChars(pos, SpecialChars::OBJECT, false);
-	d->at(pos)->mark = mark;
+	d->setMark(pos, mark);
 	if (mark)
 	{
 		d->marksCount++;
@@ -999,7 +1013,7 @@ void StoryText::replaceObject(int pos, int ob)
 		pos += length()+1;
 
 	replaceChar(pos, SpecialChars::OBJECT);
-	this->d->at(pos)->embedded = ob;
+	d->setEmbedded(pos, ob);
 	m_doc->FrameItems[ob]->isEmbedded = true;   // this might not be enough...
 	m_doc->FrameItems[ob]->OwnPage = -1; // #10379: OwnPage is not meaningful for inline object
 }
@@ -1024,20 +1038,8 @@ QString StoryText::plainText() const
 	if (length() <= 0)
 		return QString();
 
-	QChar   ch;
-	QString result;
-
-	int len = length();
-	result.reserve(len);
-
-	for (int i = 0; i < len; ++i)
-	{
-		ch = d->at(i)->ch;
-		if (ch == SpecialChars::PARSEP)
-			ch = QLatin1Char('\n');
-		result += ch;
-	}
-
+	QString result(d->text());
+	result.replace(SpecialChars::PARSEP, QLatin1Char('\n'));
 	return result;
 }
 #if 0
@@ -1055,7 +1057,7 @@ QChar StoryText::text(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return d->at(pos)->ch;
+	return d->charAt(pos);
 }
 
 QString StoryText::text(int pos, uint len) const
@@ -1066,11 +1068,7 @@ QString StoryText::text(int pos, uint len) const
 	assert(pos >= 0);
 	assert(pos + signed(len) <= length());
 
-	QString result;
-	for (int i = pos; i < pos + signed(len); ++i)
-		result += d->at(i)->ch;
-
-	return result;
+	return d->text().mid(pos, len);
 }
 
 
@@ -1102,7 +1100,7 @@ InlineFrame StoryText::object(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return InlineFrame(d->at(pos)->embedded);
+	return InlineFrame(d->embedded(pos));
 }
 
 
@@ -1186,9 +1184,10 @@ bool StoryText::hasObject(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	if (d->at(pos)->ch == SpecialChars::OBJECT)
-		return d->at(pos)->hasObject(m_doc);
-	return false;
+	if (d->charAt(pos) != SpecialChars::OBJECT)
+		return false;
+	int embedded = d->embedded(pos);
+	return ((embedded > 0) && (m_doc->FrameItems.contains(embedded)));
 }
 
 
@@ -1200,7 +1199,10 @@ PageItem* StoryText::getItem(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return d->at(pos)->getItem(m_doc);
+	int embedded = d->embedded(pos);
+	if ((embedded > 0) && (m_doc->FrameItems.contains(embedded)))
+		return m_doc->FrameItems[embedded];
+	return nullptr;
 }
 
 int StoryText::findMark(const Mark* mrk, int startPos) const
@@ -1210,9 +1212,7 @@ int StoryText::findMark(const Mark* mrk, int startPos) const
 	int len = d->len;
 	for (int i = startPos; i < len; ++i)
 	{
-		if (d->at(i)->ch != SpecialChars::OBJECT)
-			continue;
-		if (d->at(i)->hasMark(mrk))
+		if (hasMark(i, mrk))
 			return i;
 	}
 
@@ -1227,12 +1227,12 @@ int StoryText::findNote(const TextNote* textNote) const
 	int len = d->len;
 	for (int i = 0; i < len; ++i)
 	{
-		const ScText* textItem = d->at(i);
-		if (textItem->ch != SpecialChars::OBJECT || textItem->mark == nullptr)
+		if (d->charAt(i) != SpecialChars::OBJECT)
 			continue;
-		if (textItem->mark->getType() != MARKNoteFrameType)
+		const Mark* textMark = d->mark(i);
+		if (textMark == nullptr || textMark->getType() != MARKNoteFrameType)
 			continue;
-		if (textItem->mark->getNotePtr() == textNote)
+		if (textMark->getNotePtr() == textNote)
 			return i;
 	}
 
@@ -1247,9 +1247,11 @@ bool StoryText::hasMark(int pos, const Mark* mrk) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	if (d->at(pos)->ch == SpecialChars::OBJECT)
-		return d->at(pos)->hasMark(mrk);
-	return false;
+	if (d->charAt(pos) != SpecialChars::OBJECT)
+		return false;
+	if (mrk == nullptr)
+		return d->mark(pos) != nullptr;
+	return d->mark(pos) == mrk;
 }
 
 bool StoryText::hasMark(int pos, MarkType markType) const
@@ -1260,10 +1262,10 @@ bool StoryText::hasMark(int pos, MarkType markType) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	const ScText* textItem = d->at(pos);
-	if (textItem->ch != SpecialChars::OBJECT)
+	if (d->charAt(pos) != SpecialChars::OBJECT)
 		return false;
-	return (textItem->mark && textItem->mark->isType(markType));
+	const Mark* textMark = d->mark(pos);
+	return (textMark && textMark->isType(markType));
 }
 
 Mark* StoryText::mark(int pos) const
@@ -1274,7 +1276,7 @@ Mark* StoryText::mark(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return d->at(pos)->mark;
+	return d->mark(pos);
 }
 
 
@@ -1323,12 +1325,11 @@ void StoryText::replaceMark(int pos, Mark* mrk)
 	assert(pos >= 0);
 	assert(pos < length());
 
-	ScText* textItem = this->d->at(pos);
-	if (textItem->mark)
-		this->d->marksCount--;
-	this->d->at(pos)->mark = mrk;
-	if (textItem->mark)
-		this->d->marksCount++;
+	if (d->mark(pos))
+		d->marksCount--;
+	d->setMark(pos, mrk);
+	if (d->mark(pos))
+		d->marksCount++;
 
 	// Set marksCountChanged unconditionally to force text relayout
 	d->marksCountChanged = true;
@@ -1353,7 +1354,7 @@ LayoutFlags StoryText::flags(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return static_cast<LayoutFlags>(d->at(pos)->effects().value & ScStyle_NonUserStyles);
+	return static_cast<LayoutFlags>(d->charStyle(pos).effects().value & ScStyle_NonUserStyles);
 }
 
 bool StoryText::hasFlag(int pos, LayoutFlags flags) const
@@ -1365,7 +1366,7 @@ bool StoryText::hasFlag(int pos, LayoutFlags flags) const
 	assert(pos < length());
 	assert((flags & ScStyle_UserStyles) == ScStyle_None);
 
-	return (flags & d->at(pos)->effects().value) == flags;
+	return (flags & d->charStyle(pos).effects().value) == flags;
 }
 
 void StoryText::setFlag(int pos, LayoutFlags flags)
@@ -1377,7 +1378,9 @@ void StoryText::setFlag(int pos, LayoutFlags flags)
 	assert(pos < length());
 	assert((flags & ScStyle_UserStyles) == ScStyle_None);
 
-	d->at(pos)->setEffects(flags | d->at(pos)->effects().value);
+	d->modifyCharStyles(pos, 1, [flags](CharStyle& style) {
+		style.setEffects(flags | style.effects().value);
+	});
 }
 
 void StoryText::clearFlag(int pos, LayoutFlags flags)
@@ -1388,7 +1391,9 @@ void StoryText::clearFlag(int pos, LayoutFlags flags)
 	assert(pos >= 0);
 	assert(pos < length());
 
-	d->at(pos)->setEffects(~(flags & ScStyle_NonUserStyles) & d->at(pos)->effects().value);
+	d->modifyCharStyles(pos, 1, [flags](CharStyle& style) {
+		style.setEffects(~(flags & ScStyle_NonUserStyles) & style.effects().value);
+	});
 }
 
 
@@ -1419,15 +1424,16 @@ const CharStyle & StoryText::charStyle(int pos) const
 	if (text(pos) == SpecialChars::PARSEP)
 		return paragraphStyle(pos).charStyle();
 	
-	StoryText* that = const_cast<StoryText *>(this);
-
 	if (hasMark(pos))
 	{
+		// hack to keep note charstyles current, styles which do not change are kept
 		Mark* mrk = mark(pos);
-		applyMarkCharstyle(mrk, *that->d->at(pos)); // hack to keep note charstyles current
+		d->modifyCharStyles(pos, 1, [this, mrk](CharStyle& style) {
+			applyMarkCharstyle(mrk, style);
+		});
 	}
 	
-	return dynamic_cast<const CharStyle &> (*that->d->at(pos));
+	return d->charStyle(pos);
 }
 
 const ParagraphStyle & StoryText::paragraphStyle() const
@@ -1445,29 +1451,19 @@ const ParagraphStyle & StoryText::paragraphStyle(int pos) const
 
 	assert(d);
 	
-	StoryText * that = const_cast<StoryText *> (this);
-//	assert( that->at(pos)->cab >= 0 );
-//	assert( that->at(pos)->cab < doc->docParagraphStyles.count() );
-//	return doc->docParagraphStyles[that->at(pos)->cab];
-	
-	while (pos < length() && that->d->at(pos)->ch != SpecialChars::PARSEP)
-		++pos;
+	pos = d->text().indexOf(SpecialChars::PARSEP, pos);
+	if (pos < 0)
+		return d->trailingStyle;
 
-	if (pos >= length())
-		return that->d->trailingStyle;
-	if ( !that->d->at(pos)->parstyle )
+	ParagraphStyle* parstyle = d->paragraphStyle(pos);
+	if (!parstyle)
 	{
-		ScText* current = that->d->at(pos);
 		qDebug("inserting default parstyle at %i", pos);
-		current->parstyle = new ParagraphStyle();
-		current->parstyle->setContext( & d->pstyleContext);
+		parstyle = new ParagraphStyle();
+		parstyle->setContext( & d->pstyleContext);
+		d->setParagraphStyle(pos, parstyle);
 	}
-	else
-	{
-//		qDebug() << QString("using parstyle at %1").arg(pos);
-	}
-	assert (that->d->at(pos)->parstyle);
-	return *that->d->at(pos)->parstyle;
+	return *parstyle;
 }
 
 const ParagraphStyle& StoryText::defaultStyle() const
@@ -1501,31 +1497,13 @@ void StoryText::applyCharStyle(int pos, uint len, const CharStyle& style )
 	if (len == 0)
 		return;
 
-//	int lastParStart = pos == 0? 0 : -1;
-	ScText* itText;
-	for (uint i = pos; i < pos + len; ++i)
-	{
-		itText = d->at(i);
-		// #6165 : applying style on last character applies style on whole text on next open 
-		/*if (itText->ch == SpecialChars::PARSEP && itText->parstyle != nullptr)
-			itText->parstyle->charStyle().applyCharStyle(style);*/
-		
-		// Does not work well, do not reenable before checking #9337, #9376 and #9428
-		// #9173 et. al.: move charstyle to parstyle if whole paragraph is affected
-		/*if (itText->ch == SpecialChars::PARSEP && itText->parstyle != nullptr && lastParStart >= 0)
-		{
-			eraseCharStyle(lastParStart, i - lastParStart, style);
-			itText->parstyle->charStyle().applyCharStyle(style);
-			lastParStart = i + 1;
-		}*/
-		itText->applyCharStyle(style);
-	}
-	// Does not work well, do not reenable before checking #9337, #9376 and #9428
-	/*if (pos + signed(len) == length() && lastParStart >= 0)
-	{
-		eraseCharStyle(lastParStart, length() - lastParStart, style);
-		d->trailingStyle.charStyle().applyCharStyle(style);
-	}*/
+	// #6165 : applying style on last character applies style on whole text on next open,
+	// so the charstyle of paragraph styles is left alone here.
+	// #9173 et. al.: moving the charstyle to the parstyle if the whole paragraph is affected
+	// does not work well, do not reenable before checking #9337, #9376 and #9428
+	d->modifyCharStyles(pos, len, [style](CharStyle& runStyle) {
+		runStyle.applyCharStyle(style);
+	});
 	
 	invalidate(pos, pos + len);
 }
@@ -1543,15 +1521,17 @@ void StoryText::eraseCharStyle(int pos, uint len, const CharStyle& style )
 	if (len == 0)
 		return;
 	
-	ScText* itText;
-	for (uint i = pos; i < pos + len; ++i)
+	const QString& storyText = d->text();
+	for (int i = storyText.indexOf(SpecialChars::PARSEP, pos); (i >= 0) && (i < pos + signed(len)); i = storyText.indexOf(SpecialChars::PARSEP, i + 1))
 	{
-		itText = d->at(i);
 		// FIXME?? see #6165 : should we really erase charstyle of paragraph style??
-		if (itText->ch == SpecialChars::PARSEP && itText->parstyle != nullptr)
-			itText->parstyle->charStyle().eraseCharStyle(style);
-		itText->eraseCharStyle(style);
+		ParagraphStyle* parstyle = d->paragraphStyle(i);
+		if (parstyle != nullptr)
+			parstyle->charStyle().eraseCharStyle(style);
 	}
+	d->modifyCharStyles(pos, len, [style](CharStyle& runStyle) {
+		runStyle.eraseCharStyle(style);
+	});
 	// Does not work well, do not reenable before checking #9337, #9376 and #9428
 	/*if (pos + signed(len) == length())
 	{
@@ -1570,19 +1550,21 @@ void StoryText::applyStyle(int pos, const ParagraphStyle& style, bool rmDirectFo
 	assert(pos <= length());
 
 	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP)
+	while (i < length() && d->charAt(i) != SpecialChars::PARSEP)
 		++i;
 
 	if (i < length())
 	{
-		if (!d->at(i)->parstyle)
+		ParagraphStyle* parstyle = d->paragraphStyle(i);
+		if (!parstyle)
 		{
 			qDebug("PARSEP without style at pos %i", i);
-			d->at(i)->parstyle = new ParagraphStyle();
-			d->at(i)->parstyle->setContext( & d->pstyleContext);
+			parstyle = new ParagraphStyle();
+			parstyle->setContext( & d->pstyleContext);
+			d->setParagraphStyle(i, parstyle);
 		}
 //		qDebug() << QString("applying parstyle %2 at %1 for %3").arg(i).arg(paragraphStyle(pos).name()).arg(pos);
-		d->at(i)->parstyle->applyStyle(style);
+		parstyle->applyStyle(style);
 	}
 	else
 	{
@@ -1592,12 +1574,11 @@ void StoryText::applyStyle(int pos, const ParagraphStyle& style, bool rmDirectFo
 	}
 	if (rmDirectFormatting)
 	{
-		--i;
-		while (i >= 0 && d->at(i)->ch != SpecialChars::PARSEP)
-		{
-			d->at(i)->eraseDirectFormatting();
-			--i;
-		}
+		int end = qMin(i, length());
+		i = (end > 0) ? d->text().lastIndexOf(SpecialChars::PARSEP, end - 1) : -1;
+		d->modifyCharStyles(i + 1, end - i - 1, [](CharStyle& runStyle) {
+			runStyle.eraseDirectFormatting();
+		});
 	}
 	invalidate(pos, qMin(i, length()));
 }
@@ -1611,19 +1592,21 @@ void StoryText::eraseStyle(int pos, const ParagraphStyle& style)
 	assert(pos <= length());
 		
 	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP)
+	while (i < length() && d->charAt(i) != SpecialChars::PARSEP)
 		++i;
 
 	if (i < length())
 	{
-		if (!d->at(i)->parstyle)
+		ParagraphStyle* parstyle = d->paragraphStyle(i);
+		if (!parstyle)
 		{
 			qDebug("PARSEP without style at pos %i", i);
-			d->at(i)->parstyle = new ParagraphStyle();
-			d->at(i)->parstyle->setContext( & d->pstyleContext);
+			parstyle = new ParagraphStyle();
+			parstyle->setContext( & d->pstyleContext);
+			d->setParagraphStyle(i, parstyle);
 		}
 		//		qDebug() << QString("applying parstyle %2 at %1 for %3").arg(i).arg(paragraphStyle(pos).name()).arg(pos);
-		d->at(i)->parstyle->eraseStyle(style);
+		parstyle->eraseStyle(style);
 	}
 	else {
 		// not happy about this but inserting a new PARSEP makes more trouble
@@ -1651,15 +1634,11 @@ void StoryText::setCharStyle(int pos, uint len, const CharStyle& style)
 	if (len == 0)
 		return;
 	
-	ScText* itText;
-	for (uint i = pos; i < pos + len; ++i)
-	{
-		itText = d->at(i);
-		// #6165 : applying style on last character applies style on whole text on next open 
-		/*if (itText->ch == SpecialChars::PARSEP && itText->parstyle != nullptr)
-			itText->parstyle->charStyle() = style;*/
-		itText->setStyle(style);
-	}
+	// #6165 : applying style on last character applies style on whole text on next open,
+	// so the charstyle of paragraph styles is left alone here
+	d->modifyCharStyles(pos, len, [style](CharStyle& runStyle) {
+		runStyle.setStyle(style);
+	});
 	
 	invalidate(pos, pos + len);
 }
@@ -1697,15 +1676,16 @@ void StoryText::replaceNamedResources(ResourceCollection& newNames)
 	if (len == 0)
 		return;
 	
-	ScText* itText;
-	for (int i = 0; i < len; ++i)
+	const QString& storyText = d->text();
+	for (int i = storyText.indexOf(SpecialChars::PARSEP); i >= 0; i = storyText.indexOf(SpecialChars::PARSEP, i + 1))
 	{
-		itText = d->at(i);
-		if (itText->parstyle)
-			itText->parstyle->replaceNamedResources(newNames);
-		else
-			itText->replaceNamedResources(newNames);
+		ParagraphStyle* parstyle = d->paragraphStyle(i);
+		if (parstyle)
+			parstyle->replaceNamedResources(newNames);
 	}
+	d->modifyCharStyles(0, len, [&newNames](CharStyle& runStyle) {
+		runStyle.replaceNamedResources(newNames);
+	});
 	
 	invalidate(0, len);	
 }
@@ -1724,7 +1704,7 @@ void StoryText::fixLegacyFormatting()
 
 	for (int i = 0; i < length(); ++ i)
 	{
-		if (d->at(i)->ch == SpecialChars::PARSEP)
+		if (d->charAt(i) == SpecialChars::PARSEP)
 			fixLegacyFormatting(i);
 	}
 	fixLegacyFormatting( length() );
@@ -1742,7 +1722,7 @@ void StoryText::fixLegacyFormatting(int pos)
 	assert(pos <= length());
 
 	int i = pos;
-	while (i > 0 && d->at(i - 1)->ch != SpecialChars::PARSEP)
+	while (i > 0 && d->charAt(i - 1) != SpecialChars::PARSEP)
 		--i;
 
 	const ParagraphStyle& parStyle = this->paragraphStyle(pos);
@@ -1751,12 +1731,14 @@ void StoryText::fixLegacyFormatting(int pos)
 	if (parStyle.hasParent())
 	{
 		int start = i;
-		while ((i < length()) && (d->at(i)->ch != SpecialChars::PARSEP))
-		{
-			d->at(i)->validate();
-			d->at(i)->eraseCharStyle( parStyle.charStyle() );
-			++i;
-		}
+		i = d->text().indexOf(SpecialChars::PARSEP, start);
+		if (i < 0)
+			i = length();
+		CharStyle parCharStyle(parStyle.charStyle());
+		d->modifyCharStyles(start, i - start, [&parCharStyle](CharStyle& runStyle) {
+			runStyle.validate();
+			runStyle.eraseCharStyle(parCharStyle);
+		});
 		invalidate(start, qMin(i + 1, length()));
 	}
 }
@@ -1773,7 +1755,7 @@ uint StoryText::nrOfParagraph(int pos) const
 	pos = qMin(pos, length());
 	for (int i = 0; i < pos; ++i)
 	{
-		lastWasPARSEP = d->at(i)->ch == SpecialChars::PARSEP;
+		lastWasPARSEP = d->charAt(i) == SpecialChars::PARSEP;
 		if (lastWasPARSEP)
 			++result;
 	}
@@ -1786,7 +1768,7 @@ uint StoryText::nrOfParagraphs() const
 	bool lastWasPARSEP = true;
 	for (int i = 0; i < length(); ++i)
 	{
-		lastWasPARSEP = d->at(i)->ch == SpecialChars::PARSEP;
+		lastWasPARSEP = d->charAt(i) == SpecialChars::PARSEP;
 		if (lastWasPARSEP)
 			++result;
 	}
@@ -1805,7 +1787,7 @@ int StoryText::startOfParagraph(uint index) const
 
 	for (int i = 0; i < length(); ++i)
 	{
-		if (d->at(i)->ch != SpecialChars::PARSEP)
+		if (d->charAt(i) != SpecialChars::PARSEP)
 			continue;
 		if (--index == 0)
 			return i + 1;
@@ -1815,7 +1797,7 @@ int StoryText::startOfParagraph(uint index) const
 
 int StoryText::startOfNextParagraph(uint index) const
 {
-	if (d->at(index)->ch == SpecialChars::PARSEP)
+	if (d->charAt(index) == SpecialChars::PARSEP)
 		return index + 1;
 
 	return nextParagraph(index) + 1;
@@ -1831,7 +1813,7 @@ int StoryText::endOfParagraph(uint index) const
 	++index;
 	for (int i = 0; i < length(); ++i)
 	{
-		if (d->at(i)->ch != SpecialChars::PARSEP)
+		if (d->charAt(i) != SpecialChars::PARSEP)
 			continue;
 		if (--index == 0)
 			return i;
@@ -1841,17 +1823,17 @@ int StoryText::endOfParagraph(uint index) const
 
 uint StoryText::nrOfRuns() const
 {
-	return length();
+	return d->runCount();
 }
 
 int StoryText::startOfRun(uint index) const
 {
-	return index;
+	return d->startOfRun(index);
 }
 
 int StoryText::endOfRun(uint index) const
 {
-	return index + 1;
+	return d->endOfRun(index);
 }
 
 // positioning. all positioning methods return char positions
@@ -2253,14 +2235,25 @@ void StoryText::invalidateAll()
 	invalidate(0, length());
 }
 
-void StoryText::invalidate(int firstItem, int endItem)
+void StoryText::invalidateChangedStyles()
 {
-	for (int i = firstItem; i < endItem; ++i)
+	if (!m_doc)
 	{
-		ParagraphStyle* par = item(i)->parstyle;
-		if (par)
-			par->charStyleContext()->invalidate();
+		invalidateAll();
+		return;
 	}
+	qint64 stylesVersion = (static_cast<qint64>(m_doc->paragraphStyles().version()) << 32) | static_cast<quint32>(m_doc->charStyles().version());
+	int firstItem = 0;
+	int endItem = 0;
+	if (!d->revalidateStyles(stylesVersion, firstItem, endItem))
+		return;
+	if (!signalsBlocked())
+		emit changed(qMin(firstItem, length()), qMin(endItem, length()));
+}
+
+void StoryText::invalidate(int firstItem, int endItem)
+{
+	d->invalidateParagraphContexts(firstItem, endItem);
 	if (!signalsBlocked())
 		emit changed(firstItem, endItem);
 }
@@ -2285,18 +2278,6 @@ void StoryText::validate()
 }
 */
 
-ScText* StoryText::item(int index)
-{
-	assert( index < length() );
-	return this->d->at(index);
-}
-
-const ScText* StoryText::item(int index) const
-{
-	assert( index < length() );
-	return this->d->at(index);
-}
-
 
 using namespace desaxe;
 
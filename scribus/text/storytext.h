@@ -234,6 +234,7 @@ public:
 	uint nrOfParagraph() const;
 	uint nrOfParagraph(int pos) const;
 
+	/// Runs of characters sharing the same character style, within one paragraph
 	uint nrOfRuns() const;
 	int startOfRun(uint index) const;
 	int endOfRun(uint index) const;
@@ -300,6 +301,8 @@ public:
 public slots:
 	/// call this if some logical style changes (redos shaping and layout)
 	void invalidateAll();
+	/// called when the document's styles change, redoes shaping and layout of the paragraphs whose styles changed
+	void invalidateChangedStyles();
 
 	/**
 	 * @brief Create a thread-safe, immutable snapshot for spell/grammar checking
@@ -326,8 +329,6 @@ private:
 	static inline icu::BreakIterator* m_lineIterator { nullptr };
 
 
-	ScText * item(int index);
-	const ScText * item(int index) const;
 	void fixSurrogateSelection();
 
 	QString textWithSoftHyphens (int pos, uint len) const;
@@ -0,0 +1,99 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "textlayoutscheduler.h"
+
+#include <QFuture>
+#include <QHash>
+#include <QSet>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "pageitem.h"
+#include "pageitem_textframe.h"
+#include "textshaper.h"
+
+void TextLayoutScheduler::addItems(const QList<PageItem*>& items)
+{
+	QSet<PageItem*> known(m_chains.cbegin(), m_chains.cend());
+	QList<PageItem*> allItems = items;
+	while (!allItems.isEmpty())
+	{
+		PageItem* item = allItems.takeFirst();
+		if (item->isGroup() || item->isTable())
+		{
+			allItems = item->getChildren() + allItems;
+			continue;
+		}
+		if (!item->isTextFrame() || !item->invalid || !item->OnMasterPage.isEmpty())
+			continue;
+		PageItem* first = item->firstInChain();
+		if (known.contains(first) || !isIndependent(first))
+			continue;
+		known.insert(first);
+		m_chains.append(first);
+	}
+}
+
+bool TextLayoutScheduler::isIndependent(PageItem* firstInChain)
+{
+	if (firstInChain->itemText.hasTextMarks())
+		return false;
+	for (PageItem* frame = firstInChain; frame != nullptr; frame = frame->nextInChain())
+	{
+		if (frame->isNoteFrame())
+			return false;
+		PageItem_TextFrame* textFrame = frame->asTextFrame();
+		if ((textFrame == nullptr) || !textFrame->notesFramesList().isEmpty())
+			return false;
+	}
+	return true;
+}
+
+void TextLayoutScheduler::run()
+{
+	// Itemize on this thread, as it reads and partly updates the stories.
+	// Blocks are the same ShapedTextFeed asks for, so that the layout below
+	// finds each run under the same key.
+	QHash<void*, QList<TextShaper::ShapingRun> > runsByFont;
+	for (PageItem* item : std::as_const(m_chains))
+	{
+		StoryText& story = item->itemText;
+		TextShaper shaper(item, story, 0);
+		for (int fromPos = 0; fromPos < story.length(); )
+		{
+			int toPos = story.nextBlockStart(fromPos);
+			const QList<TextShaper::ShapingRun> runs = shaper.uncachedRuns(fromPos, toPos);
+			for (const TextShaper::ShapingRun& run : runs)
+				runsByFont[run.hbFont].append(run);
+			fromPos = toPos;
+		}
+	}
+
+	// Runs sharing a font would only wait for each other on the font mutex
+	QList<QFuture<void> > futures;
+	futures.reserve(runsByFont.count());
+	for (auto it = runsByFont.cbegin(); it != runsByFont.cend(); ++it)
+	{
+		const QList<TextShaper::ShapingRun>& runs = it.value();
+		futures.append(QtConcurrent::run([&runs]() {
+			for (const TextShaper::ShapingRun& run : runs)
+				TextShaper::shapeRun(run);
+		}));
+	}
+	for (QFuture<void>& future : futures)
+		future.waitForFinished();
+
+	for (PageItem* item : std::as_const(m_chains))
+	{
+		for (PageItem* frame = item; frame != nullptr; frame = frame->nextInChain())
+		{
+			if (frame->invalid)
+				frame->layout();
+		}
+	}
+	m_chains.clear();
+}
@@ -0,0 +1,48 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#ifndef TEXTLAYOUTSCHEDULER_H
+#define TEXTLAYOUTSCHEDULER_H
+
+#include <QList>
+
+#include "scribusapi.h"
+
+class PageItem;
+
+/**
+ * Lays out many text chains at once, shaping them concurrently.
+ *
+ * Line breaking in PageItem_TextFrame::layout() is tied to the document and
+ * has to stay on the GUI thread, but most of the time spent laying out a
+ * fresh frame goes into HarfBuzz. The scheduler therefore itemizes all
+ * collected chains on the calling thread, shapes the runs not yet in
+ * ShapedRunCache on the global thread pool, one task per font, and then
+ * lays the chains out on the calling thread, where shaping is served from
+ * the cache.
+ *
+ * Only chains which do not depend on other frames are scheduled: note frames,
+ * chains with notes frames and chains containing marks (notes, references,
+ * variable text) are left to the normal layout path, as are items on master
+ * pages, whose layout depends on the page they are shown on.
+ */
+class SCRIBUS_API TextLayoutScheduler
+{
+public:
+	/// Collects the invalid text chains among \a items and their children
+	void addItems(const QList<PageItem*>& items);
+
+	/// Shapes and lays out all collected chains, then forgets them
+	void run();
+
+private:
+	static bool isIndependent(PageItem* firstInChain);
+
+	QList<PageItem*> m_chains;
+};
+
+#endif // TEXTLAYOUTSCHEDULER_H
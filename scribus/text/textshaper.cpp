@@ -2,6 +2,8 @@
 
 #include <utility>
 
+#include <QMutexLocker>
+
 #include <harfbuzz/hb.h>
 #include <harfbuzz/hb-ft.h>
 #include <harfbuzz/hb-icu.h>
@@ -9,6 +11,7 @@
 #include <unicode/ubidi.h>
 
 #include "scrptrun.h"
+#include "shapedruncache.h"
 
 #include "glyphcluster.h"
 #include "pageitem.h"
@@ -264,6 +267,167 @@ void TextShaper::buildText(int fromPos, int toPos, QVector<int>& smallCaps)
 }
 
 
+TextShaper::ShapingRun TextShaper::makeShapingRun(const TextRun& textRun) const
+{
+	const CharStyle &style = m_story.charStyle(m_textMap.value(textRun.start));
+	const ScFace &scFace = style.font();
+
+	ShapingRun shapingRun;
+	shapingRun.text = m_text;
+	shapingRun.start = textRun.start;
+	shapingRun.len = textRun.len;
+	shapingRun.dir = textRun.dir;
+	shapingRun.script = textRun.script;
+	shapingRun.language = style.language();
+	shapingRun.fontSize = style.fontSize();
+	shapingRun.hbFont = scFace.hbFont();
+	shapingRun.hbFontMutex = scFace.hbFontMutex();
+
+	QByteArray featuresKey;
+	const QList<FeaturesRun> featuresRuns = itemizeFeatures(textRun);
+	for (const FeaturesRun& featuresRun : featuresRuns)
+	{
+		const QStringList& features = featuresRun.features;
+		shapingRun.features.reserve(features.length());
+		for (const QString& feature : features)
+		{
+			hb_feature_t hbFeature;
+			std::string strFeature(feature.toStdString());
+			hb_bool_t ok = hb_feature_from_string(strFeature.c_str(), strFeature.length(), &hbFeature);
+			if (ok)
+			{
+				hbFeature.start = featuresRun.start;
+				hbFeature.end = featuresRun.len + featuresRun.start;
+				shapingRun.features.append(hbFeature);
+				featuresKey += QByteArray::fromStdString(strFeature) + ':' + QByteArray::number(featuresRun.start - textRun.start)
+							 + ':' + QByteArray::number(featuresRun.len) + ';';
+			}
+		}
+	}
+
+	// Same truncation as hb_font_set_scale() and FT_Set_Char_Size() in shapeRun()
+	int fontSize = static_cast<int>(style.fontSize());
+	shapingRun.key = ShapedRunCache::instance().makeKey(m_text, textRun.start, textRun.len, scFace, fontSize,
+	                                                    textRun.dir, textRun.script, style.language(), featuresKey);
+	return shapingRun;
+}
+
+QVector<ShapedRunCache::Glyph> TextShaper::shapeRun(const ShapingRun& run)
+{
+	QVector<ShapedRunCache::Glyph> glyphs;
+	hb_font_t *hbFont = reinterpret_cast<hb_font_t*>(run.hbFont);
+	if (hbFont == nullptr)
+		return glyphs;
+
+	hb_direction_t hbDirection = (run.dir == UBIDI_LTR) ? HB_DIRECTION_LTR : HB_DIRECTION_RTL;
+	hb_script_t hbScript = hb_icu_script_to_script(run.script);
+	std::string language = run.language.toStdString();
+	hb_language_t hbLanguage = hb_language_from_string(language.c_str(), language.length());
+
+	hb_buffer_t *hbBuffer = hb_buffer_create();
+	hb_buffer_add_utf16(hbBuffer, run.text.utf16(), run.text.length(), run.start, run.len);
+	hb_buffer_set_direction(hbBuffer, hbDirection);
+	hb_buffer_set_script(hbBuffer, hbScript);
+	hb_buffer_set_language(hbBuffer, hbLanguage);
+	hb_buffer_set_cluster_level(hbBuffer, HB_BUFFER_CLUSTER_LEVEL_MONOTONE_CHARACTERS);
+
+	{
+		// The font scale is shared state, shaping with the same font
+		// from several threads has to be serialized
+		QMutexLocker locker(run.hbFontMutex);
+
+		hb_font_set_scale(hbFont, run.fontSize, run.fontSize);
+#if HB_VERSION_ATLEAST(11, 0, 0)
+		FT_Face ftFace = hb_ft_font_get_ft_face(hbFont);
+#else
+		FT_Face ftFace = hb_ft_font_get_face(hbFont);
+#endif
+		if (ftFace)
+		{
+			FT_Set_Char_Size(ftFace, run.fontSize, 0, 72, 0);
+			hb_ft_font_changed(hbFont);
+		}
+
+		// #14523: harfbuzz prioritize graphite for graphite enabled fonts, however
+		// at the point, shaping with graphite fonts is either buggy (harfbuzz 1.4.2)
+		// or trigger weird results (harfbuzz 1.4.3), so disable graphite for now.
+		// Prevent also use of platform specific shapers for cross-platform reasons
+		const char* shapers[] = { "ot", "fallback", nullptr };
+		hb_shape_full(hbFont, hbBuffer, run.features.data(), run.features.length(), shapers);
+	}
+
+	unsigned int hbCount = hb_buffer_get_length(hbBuffer);
+	hb_glyph_info_t *hbGlyphs = hb_buffer_get_glyph_infos(hbBuffer, nullptr);
+	hb_glyph_position_t *hbPositions = hb_buffer_get_glyph_positions(hbBuffer, nullptr);
+
+	glyphs.resize(hbCount);
+	for (unsigned int i = 0; i < hbCount; ++i)
+	{
+		ShapedRunCache::Glyph& glyph = glyphs[i];
+		glyph.codepoint = hbGlyphs[i].codepoint;
+		glyph.cluster = hbGlyphs[i].cluster - run.start;
+		glyph.xOffset = hbPositions[i].x_offset;
+		glyph.yOffset = hbPositions[i].y_offset;
+		glyph.xAdvance = hbPositions[i].x_advance;
+		glyph.yAdvance = hbPositions[i].y_advance;
+	}
+	hb_buffer_destroy(hbBuffer);
+	ShapedRunCache::instance().insert(run.key, glyphs);
+	return glyphs;
+}
+
+QList<TextShaper::ShapingRun> TextShaper::uncachedRuns(int fromPos, int toPos)
+{
+	QList<ShapingRun> shapingRuns;
+	QVector<int> smallCaps;
+
+	buildText(fromPos, toPos, smallCaps);
+
+	QList<TextRun> bidiRuns = itemizeBiDi(fromPos);
+	QList<TextRun> scriptRuns = itemizeScripts(bidiRuns);
+	QList<TextRun> textRuns = itemizeStyles(scriptRuns);
+
+	ShapedRunCache& runCache = ShapedRunCache::instance();
+	for (const TextRun& textRun : std::as_const(textRuns))
+	{
+		const CharStyle &style = m_story.charStyle(m_textMap.value(textRun.start));
+		// Also makes sure the HarfBuzz font exists before it is used from other threads
+		if (style.font().hbFont() == nullptr)
+			continue;
+		ShapingRun shapingRun = makeShapingRun(textRun);
+		if (!runCache.contains(shapingRun.key))
+			shapingRuns.append(shapingRun);
+	}
+
+	m_textMap.clear();
+	m_text = "";
+	return shapingRuns;
+}
+
+QList<QByteArray> TextShaper::runKeys(int fromPos, int toPos)
+{
+	QList<QByteArray> keys;
+	QVector<int> smallCaps;
+
+	buildText(fromPos, toPos, smallCaps);
+
+	QList<TextRun> bidiRuns = itemizeBiDi(fromPos);
+	QList<TextRun> scriptRuns = itemizeScripts(bidiRuns);
+	QList<TextRun> textRuns = itemizeStyles(scriptRuns);
+
+	for (const TextRun& textRun : std::as_const(textRuns))
+	{
+		const CharStyle &style = m_story.charStyle(m_textMap.value(textRun.start));
+		if (style.font().hbFont() == nullptr)
+			continue;
+		keys.append(makeShapingRun(textRun).key);
+	}
+
+	m_textMap.clear();
+	m_text = "";
+	return keys;
+}
+
 ShapedText TextShaper::shape(int fromPos, int toPos)
 {
 	m_contextNeeded = false;
@@ -330,70 +494,28 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 		}
 	}
 
+	ShapedRunCache& runCache = ShapedRunCache::instance();
+	QVector<ShapedRunCache::Glyph> glyphs;
+
 	for (const TextRun& textRun : std::as_const(textRuns))
 	{
 		const CharStyle &style = m_story.charStyle(m_textMap.value(textRun.start));
 
 		const ScFace &scFace = style.font();
-		hb_font_t *hbFont = reinterpret_cast<hb_font_t*>(scFace.hbFont());
-		if (hbFont == nullptr)
+		if (scFace.hbFont() == nullptr)
 			continue;
 
-		hb_font_set_scale(hbFont, style.fontSize(), style.fontSize());
-#if HB_VERSION_ATLEAST(11, 0, 0)
-		FT_Face ftFace = hb_ft_font_get_ft_face(hbFont);
-#else
-		FT_Face ftFace = hb_ft_font_get_face(hbFont);
-#endif
-		if (ftFace)
-		{
-			FT_Set_Char_Size(ftFace, style.fontSize(), 0, 72, 0);
-			hb_ft_font_changed(hbFont);
-		}
-
 		hb_direction_t hbDirection = (textRun.dir == UBIDI_LTR) ? HB_DIRECTION_LTR : HB_DIRECTION_RTL;
-		hb_script_t hbScript = hb_icu_script_to_script(textRun.script);
-		std::string language = style.language().toStdString();
-		hb_language_t hbLanguage = hb_language_from_string(language.c_str(), language.length());
-
-		hb_buffer_t *hbBuffer = hb_buffer_create();
-		hb_buffer_add_utf16(hbBuffer, m_text.utf16(), m_text.length(), textRun.start, textRun.len);
-		hb_buffer_set_direction(hbBuffer, hbDirection);
-		hb_buffer_set_script(hbBuffer, hbScript);
-		hb_buffer_set_language(hbBuffer, hbLanguage);
-		hb_buffer_set_cluster_level(hbBuffer, HB_BUFFER_CLUSTER_LEVEL_MONOTONE_CHARACTERS);
-
-		QVector<hb_feature_t> hbFeatures;
-		const QList<FeaturesRun> featuresRuns = itemizeFeatures(textRun);
-		for (const FeaturesRun& featuresRun : featuresRuns)
-		{
-			const QStringList& features = featuresRun.features;
-			hbFeatures.reserve(features.length());
-			for (const QString& feature : features)
-			{
-				hb_feature_t hbFeature;
-				std::string strFeature(feature.toStdString());
-				hb_bool_t ok = hb_feature_from_string(strFeature.c_str(), strFeature.length(), &hbFeature);
-				if (ok)
-				{
-					hbFeature.start = featuresRun.start;
-					hbFeature.end = featuresRun.len + featuresRun.start;
-					hbFeatures.append(hbFeature);
-				}
-			}
-		}
 
-		// #14523: harfbuzz prioritize graphite for graphite enabled fonts, however
-		// at the point, shaping with graphite fonts is either buggy (harfbuzz 1.4.2)
-		// or trigger weird results (harfbuzz 1.4.3), so disable graphite for now.
-		// Prevent also use of platform specific shapers for cross-platform reasons
-		const char* shapers[] = { "ot", "fallback", nullptr };
-		hb_shape_full(hbFont, hbBuffer, hbFeatures.data(), hbFeatures.length(), shapers);
+		ShapingRun shapingRun = makeShapingRun(textRun);
+		if (!runCache.find(shapingRun.key, glyphs))
+			glyphs = shapeRun(shapingRun);
 
-		unsigned int count = hb_buffer_get_length(hbBuffer);
-		hb_glyph_info_t *glyphs = hb_buffer_get_glyph_infos(hbBuffer, nullptr);
-		hb_glyph_position_t *positions = hb_buffer_get_glyph_positions(hbBuffer, nullptr);
+		// Cached clusters are relative to the run start
+		for (ShapedRunCache::Glyph& glyph : glyphs)
+			glyph.cluster += textRun.start;
 
+		size_t count = glyphs.count();
 		result.glyphs().reserve(result.glyphs().size() + count);
 		for (size_t i = 0; i < count; )
 		{
@@ -490,15 +612,15 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 					gl.glyph = scFace.emulateGlyph(ch.unicode());
 
 					GlyphMetrics metrics = scFace.glyphBBox(gl.glyph, style.fontSize());
-					positions[i].x_advance = metrics.width;
+					glyphs[i].xAdvance = metrics.width;
 				}
 
 				if (gl.glyph < ScFace::CONTROL_GLYPHS)
 				{
-					gl.xoffset = positions[i].x_offset / 10.0;
-					gl.yoffset = -positions[i].y_offset / 10.0;
-					gl.xadvance = positions[i].x_advance / 10.0;
-					gl.yadvance = positions[i].y_advance / 10.0;
+					gl.xoffset = glyphs[i].xOffset / 10.0;
+					gl.yoffset = -glyphs[i].yOffset / 10.0;
+					gl.xadvance = glyphs[i].xAdvance / 10.0;
+					gl.yadvance = glyphs[i].yAdvance / 10.0;
 				}
 
 #if 0
@@ -660,8 +782,6 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 
 			result.glyphs().append(run);
 		}
-		hb_buffer_destroy(hbBuffer);
-
 	}
 
 	m_textMap.clear();
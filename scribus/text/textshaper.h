@@ -5,16 +5,20 @@
 #include <QMap>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
+#include <harfbuzz/hb.h>
 #include <unicode/uscript.h>
 
 #include "itextsource.h"
 #include "itextcontext.h"
+#include "shapedruncache.h"
 #include "shapedtext.h"
 
 class GlyphCluster;
 class StoryText;
 class PageItem;
+class QMutex;
 
 using namespace icu;
 
@@ -24,8 +28,46 @@ public:
 	TextShaper(ITextContext* context, ITextSource& story, int firstChar, bool singlePar = false);
 	TextShaper(ITextSource &story, int firstChar);
 
+	/**
+	 * Run of uniform shaping properties, holding all data HarfBuzz needs so
+	 * that it can be shaped without access to the story or its styles.
+	 */
+	struct ShapingRun
+	{
+		QByteArray key;      //!< ShapedRunCache key
+		QString text;        //!< text of the whole shaped range
+		int start { 0 };
+		int len { 0 };
+		int dir { 0 };
+		UScriptCode script { USCRIPT_INVALID_CODE };
+		QString language;
+		double fontSize { 0.0 };
+		void* hbFont { nullptr };
+		QMutex* hbFontMutex { nullptr };
+		QVector<hb_feature_t> features;
+	};
+
 	ShapedText shape(int fromPos, int toPos);
 
+	/**
+	 * Itemizes text from \a fromPos to \a toPos the same way shape() does and
+	 * returns the runs which are not yet in ShapedRunCache.
+	 */
+	QList<ShapingRun> uncachedRuns(int fromPos, int toPos);
+
+	/**
+	 * Itemizes text from \a fromPos to \a toPos the same way shape() does and
+	 * returns the ShapedRunCache keys of all its runs.
+	 */
+	QList<QByteArray> runKeys(int fromPos, int toPos);
+
+	/**
+	 * Shapes \a run with HarfBuzz and stores the result in ShapedRunCache.
+	 * This is safe to call from any thread as long as the font of the run
+	 * is not destroyed.
+	 */
+	static QVector<ShapedRunCache::Glyph> shapeRun(const ShapingRun& run);
+
 private:
 	struct TextRun {
 		TextRun(int s, int l, int d)
@@ -60,6 +102,8 @@ private:
 	QList<TextRun> itemizeStyles(const QList<TextRun> &runs) const;
 	QList<FeaturesRun> itemizeFeatures(const TextRun &run) const;
 
+	ShapingRun makeShapingRun(const TextRun& textRun) const;
+
 	ITextContext* m_context { nullptr };
 	bool m_contextNeeded { false };
 	ITextSource& m_story;
@@ -59,6 +59,22 @@ bool ScZipHandler::open(const QString& fileName)
 	return retVal;
 }
 
+bool ScZipHandler::open(QIODevice* device)
+{
+	bool retVal = false;
+	if (m_uz != nullptr)
+	{
+		UnZip::ErrorCode ec = m_uz->openArchive(device);
+		retVal = (ec == UnZip::Ok);
+	}
+	if (m_zi != nullptr)
+	{
+		Zip::ErrorCode ec = m_zi->createArchive(device);
+		retVal = (ec == Zip::Ok);
+	}
+	return retVal;
+}
+
 bool ScZipHandler::close()
 {
 	bool retVal = false;
@@ -96,6 +112,14 @@ bool ScZipHandler::read(const QString& fileName, QByteArray &buf)
 	return retVal;
 }
 
+bool ScZipHandler::read(const QString& fileName, QIODevice* device)
+{
+	if (m_uz == nullptr)
+		return false;
+	UnZip::ErrorCode ec = m_uz->extractFile(fileName, device);
+	return (ec == UnZip::Ok);
+}
+
 bool ScZipHandler::write(const QString& dirName)
 {
 	if (m_zi == nullptr)
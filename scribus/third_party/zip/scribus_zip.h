@@ -40,9 +40,11 @@ class ScZipHandler
 		virtual ~ScZipHandler();
 
 		bool open(const QString& fileName);
+		bool open(QIODevice* device);
 		bool close();
 		bool contains(const QString& fileName) const;
 		bool read(const QString& fileName, QByteArray &buf);
+		bool read(const QString& fileName, QIODevice* device);
 		bool write(const QString& dirName);
 		bool extract(const QString& name, const QString& path, ExtractionOption eo);
 		QStringList files() const;
@@ -93,7 +93,7 @@ QIcon ImIconProvider::icon(const QFileInfo &fi) const
 		return txtpm;
 	if (ext.endsWith("scd", Qt::CaseInsensitive) || ext.endsWith("scd.gz", Qt::CaseInsensitive))
 		return docpm;
-	if (ext.endsWith("sla", Qt::CaseInsensitive) || ext.endsWith("sla.gz", Qt::CaseInsensitive))
+	if (ext.endsWith("sla", Qt::CaseInsensitive) || ext.endsWith("sla.gz", Qt::CaseInsensitive) || ext.endsWith("slaz", Qt::CaseInsensitive))
 		return docpm;
 	if (ext.endsWith("pdf", Qt::CaseInsensitive))
 		return pdfpm;
@@ -107,6 +107,9 @@ PDFExportDialog::PDFExportDialog( QWidget* parent, const QString & docFileName,
 	openAfterExportCheckBox = new QCheckBox( tr( "Open PDF after Export" ), Name );
 	openAfterExportCheckBox->setChecked(m_opts.openAfterExport);
 	NameLayout->addWidget( openAfterExportCheckBox, 2, 0 );
+	incrementalUpdateCheckBox = new QCheckBox( tr( "Update previously exported file incrementally" ), Name );
+	incrementalUpdateCheckBox->setChecked(m_opts.incrementalUpdate);
+	NameLayout->addWidget( incrementalUpdateCheckBox, 3, 0 );
 	PDFExportLayout->addWidget( Name );
 
 	Options = new TabPDFOptions( this, pdfOptions, AllFonts, PDFXProfiles, DocFonts, currView->m_doc );
@@ -130,6 +133,7 @@ PDFExportDialog::PDFExportDialog( QWidget* parent, const QString & docFileName,
 //tooltips
 	multiFile->setToolTip( "<qt>" + tr( "This enables exporting one individually named PDF file for each page in the document. Page numbers are added automatically. This is most useful for imposing PDF for commercial printing.") + "</qt>" );
 	openAfterExportCheckBox->setToolTip( "<qt>" + tr( "Open the exported PDF with the PDF viewer as set in External Tools preferences, when not exporting to a multi-file export destination") + "</qt>" );
+	incrementalUpdateCheckBox->setToolTip( "<qt>" + tr( "When the file was exported before and has not been modified since, append only the objects that changed to it instead of writing the whole file again. Large changes still rewrite the file.") + "</qt>" );
 	okButton->setToolTip( "<qt>" + tr( "The save button will be disabled if you are trying to export PDF/X and the info string is missing from the PDF/X tab") + "</qt>" );
 	// signals and slots connections
 	connect( changeButton, SIGNAL( clicked() ), this, SLOT( ChangeFile() ) );
@@ -261,6 +265,7 @@ void PDFExportDialog::updateDocOptions()
 	m_opts.fileName = QDir::fromNativeSeparators(fileNameLineEdit->text());
 	m_opts.doMultiFile = multiFile->isChecked();
 	m_opts.openAfterExport = openAfterExportCheckBox->isChecked();
+	m_opts.incrementalUpdate = incrementalUpdateCheckBox->isChecked();
 	m_opts.Thumbnails = Options->CheckBox1->isChecked();
 	m_opts.Compress = Options->Compression->isChecked();
 	m_opts.CompressMethod = (PDFOptions::PDFCompression) Options->CMethod->currentIndex();
@@ -69,6 +69,7 @@ protected:
 	QGroupBox* Name;
 	QCheckBox* multiFile;
 	QCheckBox* openAfterExportCheckBox;
+	QCheckBox* incrementalUpdateCheckBox;
 	QPushButton* changeButton;
 	QPushButton* okButton;
 	QPushButton* cancelButton;
@@ -65,6 +65,12 @@ ulong UndoObject::getUId() const
 	return m_id;
 }
 
+void UndoObject::renewUId()
+{
+	m_id = m_nextId;
+	++m_nextId;
+}
+
 QString UndoObject::getUName() const
 {
 	return m_uname;	
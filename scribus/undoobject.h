@@ -104,6 +104,14 @@ public:
 	 */
 	ulong getUId() const;
 
+	/**
+	 * @brief Gives the object a new unique identifier
+	 *
+	 * Used by copies, which must not be mistaken for their original by the
+	 * undo system.
+	 */
+	void renewUId();
+
 	/**
 	 * @brief Returns a guarded pointer
 	 */
@@ -406,6 +406,8 @@ void WordAndPara(PageItem* currItem, int *w, int *p, int *c, int *wN, int *pN, i
 	}
 	while (nextItem != nullptr)
 	{
+		if (nextItem->invalid)
+			nextItem->layout();
 		for (int a = qMax(nextItem->firstInFrame(),0); a <= nextItem->lastInFrame() && a < nextItem->itemText.length(); ++a)
 		{
 			QChar b = nextItem->itemText.text(a);